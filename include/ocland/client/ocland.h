@@ -21,10 +21,14 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <string.h>
+#include <stdint.h>
+#include <pthread.h>
 
 #include <CL/cl.h>
 #include <CL/cl_ext.h>
 
+#include <ocland/common/hashTable.h>
+
 #ifndef OCLAND_H_INCLUDED
 #define OCLAND_H_INCLUDED
 
@@ -41,10 +45,158 @@ struct oclandServers_st
     char** address;
     /// Sockets asigned to each server
     int* sockets;
-    /// Server status
-    cl_bool *locked;
+    /// Mutex protecting the access to each server connection
+    pthread_mutex_t *send_mutex;
+    /// Condition signaled each time a server connection is released
+    pthread_cond_t *send_cond;
+    /// Next ticket to access each server connection
+    unsigned long *send_ticket;
+    /// Ticket which owns each server connection
+    unsigned long *send_serving;
+    /// Identifier of the next request sent to each server
+    uint32_t *request_id;
+    /// Answers received from each server, not claimed yet
+    struct oclandAnswer_st **answers;
+    /// CL_TRUE if a thread is already receiving answers from the server
+    cl_bool *receiving;
+    /// Mutex protecting the requests identifiers and the answers
+    pthread_mutex_t *answers_mutex;
+    /// Condition signaled each time an answer is received
+    pthread_cond_t *answers_cond;
+    /// Packages waiting to be sent to each server in the next batch
+    char **batch;
+    /// Size of the packages waiting in each batch
+    size_t *batch_size;
+    /// First error reported by the batches sent to each server, not
+    /// notified yet
+    cl_int *batch_error;
+    /// Memory registered to receive the payload of the answers
+    struct oclandSink_st **sinks;
+    /// Data channel opened with each server
+    struct oclandChannel_st *channels;
+    /// Immutable info of the platforms, devices and contexts of each
+    /// server, already answered (object -> struct oclandInfo_st list)
+    hash_table *info;
+};
+
+/** @struct oclandAnswer_st
+ * Answer received from a server, waiting for the thread which
+ * sent the matching request.
+ */
+struct oclandAnswer_st
+{
+    /// Command index
+    uint32_t opcode;
+    /// Request identifier
+    uint32_t request_id;
+    /// Answer data size
+    size_t size;
+    /// Answer data
+    void *msg;
+    /// Next answer in the list
+    struct oclandAnswer_st *next;
 };
 
+/** @struct oclandSink_st
+ * Memory where the payload of an answer must be received, without
+ * storing it in the answer data.
+ */
+struct oclandSink_st
+{
+    /// Identifier of the request
+    uint32_t request_id;
+    /// Size of the answer data which precedes the payload
+    size_t offset;
+    /// Memory where the payload must be received
+    void *ptr;
+    /// Size of the memory
+    size_t cb;
+    /// Next sink in the list
+    struct oclandSink_st *next;
+};
+
+/** @struct oclandTransfer_st
+ * Asynchronous read transfer, which data will be received from the
+ * server data channel.
+ */
+struct oclandTransfer_st
+{
+    /// Identifier of the request which started the transfer
+    uint32_t request_id;
+    /// Memory where the data must be received
+    void *ptr;
+    /// Size of the data
+    size_t cb;
+    /// Size of the data already received
+    size_t received;
+    /// Command queue where the transfer has been enqueued
+    cl_command_queue command_queue;
+    /// Event associated with the transfer, NULL if it is still unknown
+    cl_event event;
+    /// Next transfer in the list
+    struct oclandTransfer_st *next;
+};
+
+/** @struct oclandNotify_st
+ * Asynchronous build, which result will be received from the server
+ * data channel, in order to call the user notification function.
+ */
+struct oclandNotify_st
+{
+    /// Identifier of the request which started the build
+    uint32_t request_id;
+    /// Program being built
+    cl_program program;
+    /// Notification function
+    void (CL_CALLBACK *pfn_notify)(cl_program program, void *user_data);
+    /// User data passed to the notification function
+    void *user_data;
+    /// Next build in the list
+    struct oclandNotify_st *next;
+};
+
+/** @struct oclandChannel_st
+ * Data channel of a server. It is a second connection to the server,
+ * opened the first time an asynchronous transfer is requested, where
+ * the bulk data is exchanged in packages tagged with the identifier of
+ * the request which started the transfer.
+ */
+struct oclandChannel_st
+{
+    /// Data connection socket, -1 if it is not opened
+    int socket;
+    /// CL_TRUE if the server has refused to open the data channel
+    cl_bool unavailable;
+    /// Read transfers pending to be received
+    struct oclandTransfer_st *transfers;
+    /// Builds pending to be notified
+    struct oclandNotify_st *notifies;
+    /// Mutex protecting the channel data
+    pthread_mutex_t mutex;
+    /// Mutex serializing the packages sent to the server
+    pthread_mutex_t send_mutex;
+    /// Condition signaled each time a transfer is received
+    pthread_cond_t cond;
+};
+
+/** @struct oclandInfo_st
+ * Info of a platform, device or context which never changes, so it
+ * is answered by the client after receiving it once.
+ */
+struct oclandInfo_st
+{
+    /// Requested info
+    cl_uint param_name;
+    /// Error code returned by the server
+    cl_int flag;
+    /// Size of the info
+    size_t size;
+    /// Info value, stored after this structure
+    void *value;
+    /// Next info of the same object
+    struct oclandInfo_st *next;
+};
+
 /** clGetPlatformIDs ocland abstraction method.
  */
 cl_int oclandGetPlatformIDs(cl_uint         num_entries,
@@ -229,6 +381,10 @@ cl_int oclandRetainProgram(cl_program  program);
 cl_int oclandReleaseProgram(cl_program  program);
 
 /** clBuildProgram ocland abstraction method.
+ * @note If pfn_notify is provided, the server builds the program
+ * asynchronously, notifying it through the data channel. pfn_notify is
+ * called (with the server program) if, and only if, CL_SUCCESS or
+ * CL_BUILD_PROGRAM_FAILURE is returned.
  */
 cl_int oclandBuildProgram(cl_program            program ,
                           cl_uint               num_devices ,
@@ -637,6 +793,19 @@ cl_int oclandGetKernelArgInfo(cl_kernel        kernel ,
                               void *           param_value ,
                               size_t *         param_value_size_ret);
 
+/** Get the address qualifier of all the arguments of a kernel with a
+ * single request to the server.
+ * @param kernel Kernel.
+ * @param num_args Number of arguments.
+ * @param arg_address Address qualifier of each argument, which must be
+ * released with free(). NULL if the kernel has no arguments.
+ * @return CL_SUCCESS, or the error code of the request (in which case
+ * no arguments are returned).
+ */
+cl_int oclandGetKernelArgsAddress(cl_kernel                          kernel ,
+                                  cl_uint *                          num_args ,
+                                  cl_kernel_arg_address_qualifier ** arg_address);
+
 /** clEnqueueFillBuffer ocland abstraction method.
  */
 cl_int oclandEnqueueFillBuffer(cl_command_queue    command_queue ,
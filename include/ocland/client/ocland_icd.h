@@ -18,6 +18,8 @@
 
 #include <CL/opencl.h>
 
+#include <ocland/common/hashTable.h>
+
 struct _cl_icd_dispatch;
 struct _cl_platform_id {
     /// Dispatch table
@@ -91,6 +93,12 @@ struct _cl_kernel
     cl_kernel ptr;
     /// Reference count to control when the object must be destroyed
     cl_uint rcount;
+    /// Whether the arguments metadata has been already fetched
+    cl_bool args_fetched;
+    /// Number of arguments
+    cl_uint num_args;
+    /// Address qualifier of each argument
+    cl_kernel_arg_address_qualifier *arg_address;
 };
 struct _cl_event
 {
@@ -102,6 +110,18 @@ struct _cl_event
     cl_uint rcount;
 };
 
+/** @struct icd_objects_st
+ * Registered ICD objects of a kind. Each object can be translated to
+ * the server instance which it wraps, and back, in constant time.
+ */
+struct icd_objects_st
+{
+    /// ICD object wrapping each server instance
+    hash_table objects;
+    /// Server instance wrapped by each ICD object
+    hash_table ptrs;
+};
+
 struct _cl_icd_dispatch {
   void(*func0)(void);
   void(*func1)(void);
@@ -21,27 +21,34 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <string.h>
+#include <stdint.h>
 
 #ifndef SHORTCUT_H_INCLUDED
 #define SHORTCUT_H_INCLUDED
 
-/** @struct shortcut_st
+/** @struct shortcut_table_st
  * Ocland pointers shortcuts. Shortcuts allows to access
  * faster to the right server, avoiding the need to quest
  * all servers looking for the correct one. Each pointer
  * returned by each server will be attached with the socket.
+ * The shortcuts are stored in an open addressing table which
+ * can be read without locking it: the slots are written with
+ * atomic stores, the removed shortcuts are marked instead of
+ * moving the following ones, and the whole table is replaced
+ * when it must be rehashed.
  */
-struct shortcut_st
+struct shortcut_table_st
 {
-    /// Pointer returned by server
-    void *ocl_ptr;
-    /// Socket implied
-    int *socket;
+    /// Number of slots, a power of 2
+    size_t capacity;
+    /// Number of slots ever used (including the removed shortcuts)
+    size_t used;
+    /// Pointer returned by server at each slot
+    uintptr_t *keys;
+    /// Socket implied at each slot
+    int **sockets;
 };
 
-/// shortcut_st structure abstraction
-typedef struct shortcut_st shortcut;
-
 /** Add a new shortcut.
  * @param ocl_ptr Ocland server pointer.
  * @param socket Server socket.
@@ -56,7 +63,9 @@ unsigned int addShortcut(void* ocl_ptr, int* socket);
  */
 unsigned int delShortcut(void* ocl_ptr);
 
-/** Get a socket associated with a ocland pointer.
+/** Get a socket associated with a ocland pointer. It can be called
+ * while other threads are adding or removing shortcuts, without
+ * blocking them.
  * @param ocl_ptr Ocland server pointer.
  * @return socket Server socket, NULL if not pointer found.
  */
@@ -16,9 +16,150 @@
  *  along with ocland.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+
 #ifndef DATAEXCHANGE_H_INCLUDED
 #define DATAEXCHANGE_H_INCLUDED
 
+/// Magic number which starts each ocland package ("OCLD")
+#define OCLAND_MAGIC 0x444C434Fu
+/// Protocol version, packages from other versions will be rejected
+#define OCLAND_PROTOCOL_VERSION 1u
+
+/// Package flag: the object created by the request will be identified
+/// in the following requests by the client generated handle
+/// OCLAND_HANDLE(request_id) instead of by its address
+#define OCLAND_FLAG_HANDLE 0x0001u
+/// Tag of the client generated handles. Such addresses are not canonical
+/// on 64 bits architectures, so they can't be confused with real objects
+#define OCLAND_HANDLE_TAG 0xFFFE000000000000ull
+/// Client generated handle of the object created by a request
+#define OCLAND_HANDLE(request_id) (OCLAND_HANDLE_TAG | (uint64_t)(request_id))
+/// Test if a pointer is a client generated handle
+#define OCLAND_IS_HANDLE(ptr) (((uint64_t)(uintptr_t)(ptr) & OCLAND_HANDLE_TAG) == OCLAND_HANDLE_TAG)
+
+/// Kind of objects which info is requested in bulk: platforms
+#define OCLAND_INFO_PLATFORM 0u
+/// Kind of objects which info is requested in bulk: devices
+#define OCLAND_INFO_DEVICE 1u
+/// Maximum number of objects, and info of each object, requested in bulk
+#define OCLAND_INFO_MAX 256u
+
+/// Kind of contents identified by its digest: programs sources
+#define OCLAND_CONTENTS_SOURCES 's'
+/// Kind of contents identified by its digest: programs binaries
+#define OCLAND_CONTENTS_BINARIES 'b'
+
+/** @struct oclandHeader_st Header which precedes each package exchanged
+ * between the clients and the servers. The answer to a request carries
+ * the same opcode and request identifier, so several requests can be
+ * sent to the server before receiving the answers, which can be matched
+ * with its requests later.
+ */
+struct oclandHeader_st{
+    /// Magic number, OCLAND_MAGIC
+    uint32_t magic;
+    /// Protocol version, OCLAND_PROTOCOL_VERSION
+    uint16_t version;
+    /// Package flags (OCLAND_FLAG_HANDLE, or 0)
+    uint16_t flags;
+    /// Command index
+    uint32_t opcode;
+    /// Request identifier, chosen by the client
+    uint32_t request_id;
+    /// Length of the data which follows the header
+    uint64_t length;
+};
+
+/// Phase of the requests served by the server: receiving the request
+#define OCLAND_PHASE_DECODE 0u
+/// Phase of the requests served by the server: validating the objects
+#define OCLAND_PHASE_VALIDATE 1u
+/// Phase of the requests served by the server: performing the OpenCL
+/// call (and everything else not accounted in the other phases)
+#define OCLAND_PHASE_CALL 2u
+/// Phase of the requests served by the server: sending the answer
+#define OCLAND_PHASE_REPLY 3u
+/// Number of phases of the requests served by the server
+#define OCLAND_NUM_PHASES 4u
+/// Number of buckets of the latency histograms. The first bucket counts
+/// the phases which lasted less than 1 microsecond, the bucket i the
+/// ones which lasted from 2^(i-1) to 2^i microseconds, and the last one
+/// all the longer ones
+#define OCLAND_LATENCY_BUCKETS 24u
+
+/** @struct oclandOpcodeStats_st Counters of the requests with an opcode
+ * served by the server. The answer to the stats request starts with the
+ * error code, followed by the number of opcodes (uint32_t), and the
+ * counters of each opcode.
+ */
+struct oclandOpcodeStats_st{
+    /// Number of requests served
+    uint64_t calls;
+    /// Number of requests answered with an error code
+    uint64_t errors;
+    /// Size of the requests received (headers included)
+    uint64_t bytes_in;
+    /// Size of the answers sent (headers included)
+    uint64_t bytes_out;
+    /// Time spent in each phase, in nanoseconds
+    uint64_t time[OCLAND_NUM_PHASES];
+    /// Latency histogram of each phase
+    uint64_t latency[OCLAND_NUM_PHASES][OCLAND_LATENCY_BUCKETS];
+};
+
+/** @struct oclandCacheStats_st Counters of the programs binaries and
+ * sources cache of the server, which follow the counters of the opcodes
+ * in the answer to the stats request.
+ */
+struct oclandCacheStats_st{
+    /// Builds served from the cached binaries
+    uint64_t hits;
+    /// Builds which required compiling the program
+    uint64_t misses;
+    /// Binaries stored
+    uint64_t stores;
+    /// Binaries discarded to keep the cache size bounded
+    uint64_t evictions;
+    /// Number of binaries and sources in the cache
+    uint64_t entries;
+    /// Size of the binaries and sources in the cache
+    uint64_t size;
+    /// Programs created from the cached sources
+    uint64_t source_hits;
+    /// Programs which sources were not cached
+    uint64_t source_misses;
+};
+
+/** @struct oclandTransferStats_st Asynchronous transfers in flight in
+ * the server, which follow the programs cache counters in the answer to
+ * the stats request.
+ */
+struct oclandTransferStats_st{
+    /// Number of transfers queued or running
+    uint64_t depth;
+    /// Memory held by the running transfers
+    uint64_t outstanding;
+    /// Maximum memory which can be held by the transfers
+    uint64_t budget;
+};
+
+/** @struct oclandQueueStats_st Work in flight in a command queue of the
+ * server. The transfers counters are followed by the number of command
+ * queues with work in flight (uint32_t), and the work of each one in
+ * the answer to the stats request.
+ */
+struct oclandQueueStats_st{
+    /// Command queue
+    uint64_t command_queue;
+    /// Number of events in flight
+    uint64_t depth;
+    /// Time (in seconds) since the command queue has work in flight
+    double age;
+};
+
 /** Returns the last socket error detected
  * @return Error detected.
  */
@@ -49,4 +190,38 @@ ssize_t Recv(int *socket, void *buffer, size_t length, int flags);
  */
 ssize_t Send(int *socket, const void *buffer, size_t length, int flags);
 
+/** Send several pieces of data in a single message (see sendmsg), so
+ * the packages can be sent with just one call. The call is repeated
+ * until all the data is sent.
+ * @param socket Specifies the socket file descriptor.
+ * @param iov Pieces of data to send.
+ * @param iovcnt Number of pieces of data.
+ * @return Upon successful completion, SendVector() shall return the
+ * number of bytes sent. Otherwise, -1 shall be returned and errno set
+ * to indicate the error.
+ */
+ssize_t SendVector(int *socket, const struct iovec *iov, int iovcnt);
+
+/** Send a package, i.e. the header followed by its data.
+ * @param socket Specifies the socket file descriptor.
+ * @param header Package header, where the length of the data is set.
+ * @param data Package data.
+ * @return Upon successful completion, SendPackage() shall return the
+ * number of data bytes sent. Otherwise, -1 shall be returned and errno
+ * set to indicate the error.
+ */
+ssize_t SendPackage(int *socket, const struct oclandHeader_st *header, const void *data);
+
+/** Receive a package header, checking that the magic number and the
+ * protocol version are right.
+ * @param socket Specifies the socket file descriptor.
+ * @param header Header to be filled.
+ * @param flags Specifies the type of message reception.
+ * @return Upon successful completion, RecvHeader() shall return the
+ * length of the header in bytes. If the peer has performed an orderly
+ * shutdown RecvHeader() shall return 0. Otherwise, -1 shall be returned
+ * and errno set to indicate the error (EPROTO for unrecognized headers).
+ */
+ssize_t RecvHeader(int *socket, struct oclandHeader_st *header, int flags);
+
 #endif // DATAEXCHANGE_H_INCLUDED
@@ -0,0 +1,95 @@
+/*
+ *  This file is part of ocland, a free cloud OpenCL interface.
+ *  Copyright (C) 2012  Jose Luis Cercos Pita <jl.cercos@upm.es>
+ *
+ *  ocland is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ocland is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ocland.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#ifndef HASHTABLE_H_INCLUDED
+#define HASHTABLE_H_INCLUDED
+
+/** @struct hash_table_st Table associating values to 64 bits keys
+ * (typically addresses of objects), with constant time insertion,
+ * lookup and removal. The table uses open addressing, growing when it
+ * becomes too full. The key 0 is reserved to mark the empty slots.
+ */
+struct hash_table_st{
+    /// Number of slots, a power of 2
+    size_t capacity;
+    /// Number of stored keys
+    size_t count;
+    /// Key of each slot, 0 if it is empty
+    uint64_t *keys;
+    /// Value of each slot
+    void **values;
+};
+
+/// Abstraction of hash_table_st structure
+typedef struct hash_table_st* hash_table;
+
+/** Create an empty hash table.
+ * @return Hash table, NULL if it can't be allocated.
+ */
+hash_table createHashTable();
+
+/** Destroy a hash table. The stored values are not released.
+ * @param t Hash table.
+ */
+void destroyHashTable(hash_table t);
+
+/** Store a value in the hash table. If the key is already stored its
+ * value is replaced.
+ * @param t Hash table.
+ * @param key Key, which can't be 0.
+ * @param value Value.
+ * @return 0 if the value has been stored, -1 otherwise.
+ */
+int hashTableInsert(hash_table t, uint64_t key, void *value);
+
+/** Look for a key in the hash table.
+ * @param t Hash table.
+ * @param key Key.
+ * @param value Value associated to the key. Can be NULL.
+ * @return 1 if the key is stored, 0 otherwise.
+ */
+int hashTableFind(hash_table t, uint64_t key, void **value);
+
+/** Remove a key from the hash table.
+ * @param t Hash table.
+ * @param key Key.
+ * @param value Value which was associated to the key. Can be NULL.
+ * @return 1 if the key has been removed, 0 if it was not stored.
+ */
+int hashTableRemove(hash_table t, uint64_t key, void **value);
+
+/** Number of keys stored in the hash table.
+ * @param t Hash table.
+ * @return Number of keys.
+ */
+size_t hashTableCount(hash_table t);
+
+/** Iterate over the keys stored in the hash table. The table can't be
+ * modified meanwhile.
+ * @param t Hash table.
+ * @param index Iterator, which must be 0 at the first call.
+ * @param key Next key. Can be NULL.
+ * @param value Value associated to the next key. Can be NULL.
+ * @return 1 if a key has been returned, 0 if there are no more keys.
+ */
+int hashTableNext(hash_table t, size_t *index, uint64_t *key, void **value);
+
+#endif // HASHTABLE_H_INCLUDED
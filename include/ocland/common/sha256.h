@@ -0,0 +1,80 @@
+/*
+ *  This file is part of ocland, a free cloud OpenCL interface.
+ *  Copyright (C) 2012  Jose Luis Cercos Pita <jl.cercos@upm.es>
+ *
+ *  ocland is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ocland is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ocland.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#ifndef SHA256_H_INCLUDED
+#define SHA256_H_INCLUDED
+
+/// Size of a SHA-256 digest
+#define SHA256_SIZE 32u
+
+/** @struct sha256_st SHA-256 digest being computed. It is used to
+ * identify the contents (e.g. programs sources and binaries) exchanged
+ * or stored by ocland.
+ */
+struct sha256_st{
+    /// Intermediate hash value
+    uint32_t state[8];
+    /// Number of bytes hashed
+    uint64_t length;
+    /// Bytes not hashed yet, until a full block is available
+    unsigned char block[64];
+    /// Number of bytes in block
+    size_t used;
+};
+
+/// Abstraction of sha256_st structure
+typedef struct sha256_st sha256;
+
+/** Start a new digest.
+ * @param c Digest to initialize.
+ */
+void sha256Init(sha256 *c);
+
+/** Add data to the digest.
+ * @param c Digest.
+ * @param data Data to hash.
+ * @param size Size of the data.
+ */
+void sha256Update(sha256 *c, const void *data, size_t size);
+
+/** Finish the digest.
+ * @param c Digest, which can't be updated anymore.
+ * @param digest Resulting SHA256_SIZE bytes.
+ */
+void sha256Final(sha256 *c, unsigned char *digest);
+
+/** Digest of a list of contents, e.g. the sources of a program. The
+ * kind, the number of contents, and the size of each one are hashed as
+ * well, so the client and the server get the same digest for the same
+ * list regardless of how it is transmitted.
+ * @param kind Kind of the contents.
+ * @param count Number of contents.
+ * @param data Contents.
+ * @param lengths Size of each content.
+ * @param digest Resulting SHA256_SIZE bytes.
+ */
+void sha256Contents(unsigned char        kind,
+                    uint32_t             count,
+                    const void * const * data,
+                    const size_t *       lengths,
+                    unsigned char *      digest);
+
+#endif // SHA256_H_INCLUDED
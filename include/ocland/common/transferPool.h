@@ -0,0 +1,103 @@
+/*
+ *  This file is part of ocland, a free cloud OpenCL interface.
+ *  Copyright (C) 2012  Jose Luis Cercos Pita <jl.cercos@upm.es>
+ *
+ *  ocland is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ocland is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ocland.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <sys/types.h>
+#include <pthread.h>
+
+#ifndef TRANSFERPOOL_H_INCLUDED
+#define TRANSFERPOOL_H_INCLUDED
+
+/** @struct transfer_task_st Asynchronous transfer waiting for a worker.
+ */
+struct transfer_task_st{
+    /// Method which performs the transfer
+    void *(*run)(void*);
+    /// Transfer data, passed to run
+    void *data;
+    /// Memory held by the transfer until it finishes
+    size_t cb;
+    /// Next task in the queue
+    struct transfer_task_st *next;
+};
+
+/** @struct transfer_pool_st Pool of persistent worker threads performing
+ * the asynchronous transfers. The workers are launched on demand, up to
+ * a maximum, and they are reused by the following transfers. The memory
+ * held by the outstanding transfers is accounted, so new transfers can
+ * be held back until the previous ones release enough memory.
+ */
+struct transfer_pool_st{
+    /// Maximum number of workers
+    unsigned int max_workers;
+    /// Number of launched workers
+    unsigned int num_workers;
+    /// Number of workers waiting for a task
+    unsigned int idle_workers;
+    /// First task in the queue
+    struct transfer_task_st *first;
+    /// Last task in the queue
+    struct transfer_task_st *last;
+    /// Number of transfers in the queue, not taken by any worker yet
+    unsigned int queued;
+    /// Number of transfers queued or running
+    unsigned int depth;
+    /// Memory held by the transfers queued or running
+    size_t outstanding;
+    /// Maximum memory held by the transfers before holding back the new
+    /// ones (0 to don't limit it)
+    size_t budget;
+    /// Mutex protecting the pool data
+    pthread_mutex_t mutex;
+    /// Condition signaled when a task is queued
+    pthread_cond_t work_cond;
+    /// Condition signaled when a transfer finishes
+    pthread_cond_t done_cond;
+};
+
+/// Abstraction of transfer_pool_st structure
+typedef struct transfer_pool_st* transfer_pool;
+
+/** Create a transfer pool. No worker is launched until the first
+ * transfer is submitted.
+ * @param max_workers Maximum number of workers.
+ * @param budget Maximum memory held by the outstanding transfers before
+ * holding back the new ones (0 to don't limit it).
+ * @return Transfer pool, NULL if it can't be allocated.
+ */
+transfer_pool createTransferPool(unsigned int max_workers, size_t budget);
+
+/** Submit an asynchronous transfer to the pool. If the outstanding
+ * transfers already hold more memory than the pool budget, the calling
+ * thread is blocked until they release enough (backpressure). A transfer
+ * is never held back if no other one is outstanding. If the transfer
+ * can't be queued it is performed by the calling thread.
+ * @param p Transfer pool.
+ * @param run Method which performs the transfer.
+ * @param data Transfer data, passed to run.
+ * @param cb Memory held by the transfer until it finishes.
+ */
+void transferPoolSubmit(transfer_pool p, void *(*run)(void*), void *data, size_t cb);
+
+/** Get the transfers queued or running in the pool.
+ * @param p Transfer pool.
+ * @param depth Number of transfers queued or running. Can be NULL.
+ * @param outstanding Memory held by such transfers. Can be NULL.
+ */
+void transferPoolStatus(transfer_pool p, unsigned int *depth, size_t *outstanding);
+
+#endif // TRANSFERPOOL_H_INCLUDED
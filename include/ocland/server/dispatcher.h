@@ -16,25 +16,161 @@
  *  along with ocland.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <pthread.h>
+
+#include <ocland/common/dataExchange.h>
 #include <ocland/server/validator.h>
+#include <ocland/server/ocland_channel.h>
+
+#ifndef DISPATCHER_H_INCLUDED
+#define DISPATCHER_H_INCLUDED
 
-#ifndef DISPATCHER_H_INCLUDED
-#define DISPATCHER_H_INCLUDED
+/** @struct client_st Connected client data.
+ */
+struct client_st{
+    /// Connection socket, -1 if the client slot is free.
+    int socket;
+    /// Validator of the client.
+    validator v;
+    /// Data channel of the client.
+    data_channel channel;
+};
 
-/** In ocland each client is assigned to an independent
- * thread. Using this approach, an error caused by a client
- * will shutdown only the involved client thread.
- * @param socket Pointer to the socket decriptor integer.
+/** @struct workers_st Pool of threads serving the clients requests.
+ * The server events loop queues the clients with pending requests,
+ * and the workers pick them from the queue. A client is not watched
+ * by the events loop until the worker has finished its request, so
+ * the requests of each client are ever served in order.
  */
-void *client_thread(void *socket);
-
+struct workers_st{
+    /// Number of worker threads
+    unsigned int num_workers;
+    /// Worker threads
+    pthread_t *threads;
+    /// Maximum number of queued clients
+    unsigned int queue_size;
+    /// Queued clients slots (circular buffer)
+    unsigned int *queue;
+    /// First queued client
+    unsigned int queue_head;
+    /// Number of queued clients
+    unsigned int queue_count;
+    /// Queue access mutex
+    pthread_mutex_t mutex;
+    /// Condition signaled when a client is queued
+    pthread_cond_t not_empty;
+    /// Condition signaled when a client is removed from the queue
+    pthread_cond_t not_full;
+    /// Clients array, the queued slots refer to it
+    struct client_st *clients;
+    /// Events poll where the clients sockets must be rearmed
+    int epollfd;
+    /// Pipe where the slots of the disconnected clients are written
+    int closedfd;
+};
+
+/// Abstraction of workers_st structure
+typedef struct workers_st* workers;
+
+/** Launch the workers pool.
+ * @param num_workers Number of threads. If 0, one thread for each
+ * online processor will be launched.
+ * @param queue_size Maximum number of clients waiting to be served.
+ * @param clients Clients array.
+ * @param epollfd Events poll where the clients sockets are registered
+ * with EPOLLONESHOT, and where they must be rearmed after each request.
+ * @param closedfd Pipe write end where the slot of each disconnected
+ * client will be written, after closing its validator and its data
+ * channel.
+ * @return Workers pool, NULL if it can't be built.
+ */
+workers initWorkers(unsigned int num_workers,
+                    unsigned int queue_size,
+                    struct client_st *clients,
+                    int epollfd,
+                    int closedfd);
+
+/** Queue a client with pending requests. If the queue is full the
+ * caller will be blocked until a worker becomes available.
+ * @param w Workers pool.
+ * @param slot Client slot.
+ */
+void queueClient(workers w, unsigned int slot);
+
+/** Worker thread. Each worker takes a client from the queue, serves
+ * one request, and rearms the client socket in the events poll. Using
+ * this approach a client blocked in a long operation only holds one
+ * worker, and the other clients can be still served.
+ * @param w Workers pool.
+ */
+void *client_thread(void *w);
+
 /** Read command received and process it. Some commands
- * requires several data exchanges.
+ * requires several data exchanges. Each package starts with a
+ * oclandHeader_st header, which is validated before calling the
+ * command.
  * @param clientfd Client connection socket.
  * @param buffer Buffer to exchange data.
  * @param v Validator.
  * @return 0 if message can't be dispatched, 1 otherwise.
  */
-int dispatch(int* clientfd, char* buffer, validator v);
-
-#endif // DISPATCHER_H_INCLUDED
+int dispatch(int* clientfd, char* buffer, validator v);
+
+/** Send the answer to the request which is being dispatched by the
+ * calling thread. The answer header will carry the opcode and the
+ * request identifier of the request. If the request asked for a client
+ * generated handle (OCLAND_FLAG_HANDLE), the created object, which must
+ * follow the flag in the answer, is registered with such handle.
+ * @param clientfd Client connection socket.
+ * @param msg Answer data.
+ * @param msgSize Answer data size.
+ * @return Number of data bytes sent, -1 if errors happened.
+ */
+ssize_t Reply(int* clientfd, const void* msg, size_t msgSize);
+
+/** Send the answer to the request which is being dispatched, followed by
+ * a bulk payload. The payload is sent straight from its memory, so it
+ * does not need to be copied after the answer data. See Reply.
+ * @param clientfd Client connection socket.
+ * @param msg Answer data.
+ * @param msgSize Answer data size.
+ * @param data Payload.
+ * @param dataSize Payload size.
+ * @return Number of data bytes sent, -1 if errors happened.
+ */
+ssize_t ReplyData(int* clientfd, const void* msg, size_t msgSize, const void* data, size_t dataSize);
+
+/** Allocate memory for the request which is being dispatched by the
+ * calling thread, e.g. to build its answer. The memory is taken from an
+ * arena owned by the worker thread, which is reset when the request is
+ * finished, so it must not be freed, neither used after the command
+ * returns.
+ * @param size Size of the memory.
+ * @return Allocated memory, NULL if it can't be allocated.
+ */
+void* requestAlloc(size_t size);
+
+/** Get the header of the request which is being dispatched by the
+ * calling thread. The asynchronous transfers started by the request
+ * are tagged with its opcode and request identifier in the data
+ * channel.
+ * @return Request header.
+ */
+const struct oclandHeader_st* requestHeader();
+
+/** Get the data channel of the client which request is being
+ * dispatched by the calling thread.
+ * @return Data channel, NULL if the client has not data channel.
+ */
+data_channel requestChannel();
+
+/** Print the counters of the requests served by the server: calls,
+ * errors, bytes received and sent, and the time spent receiving the
+ * request, validating the objects, performing the OpenCL call and
+ * sending the answer. The counters of the programs cache, the transfers
+ * in flight, and the work in flight of each command queue are printed as
+ * well.
+ */
+void dispatcherStats();
+
+#endif // DISPATCHER_H_INCLUDED
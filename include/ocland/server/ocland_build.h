@@ -0,0 +1,57 @@
+/*
+ *  This file is part of ocland, a free cloud OpenCL interface.
+ *  Copyright (C) 2012  Jose Luis Cercos Pita <jl.cercos@upm.es>
+ *
+ *  ocland is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ocland is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ocland.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <sys/types.h>
+#include <stdint.h>
+
+#include <CL/cl.h>
+
+#include <ocland/server/ocland_channel.h>
+
+#ifndef OCLAND_BUILD_H_INCLUDED
+#define OCLAND_BUILD_H_INCLUDED
+
+/** Build a program in the pool of workers dedicated to the builds. When
+ * the program targets several devices, each device is built by a
+ * different worker, in parallel. The binaries are stored in the cache
+ * once the program has been successfully built.
+ * @param program Program to build.
+ * @param num_devices Number of devices in device_list.
+ * @param device_list Devices to build the program for. If NULL, the
+ * program is built for all the devices associated to it.
+ * @param options Build options. Can be NULL.
+ * @param channel Data channel of the client. If NULL, the method waits
+ * until the program is built. Otherwise the method returns as soon as
+ * the build is launched, and the resulting error code is sent to the
+ * client through the data channel when the build finishes.
+ * @param opcode Command index which tags the error code sent to the
+ * client.
+ * @param request_id Request identifier which tags the error code sent
+ * to the client.
+ * @return Error code of the build, as clBuildProgram ones. If a data
+ * channel is provided, CL_SUCCESS if the build has been launched.
+ */
+cl_int buildProgram(cl_program           program,
+                    cl_uint              num_devices,
+                    const cl_device_id * device_list,
+                    const char *         options,
+                    data_channel         channel,
+                    uint32_t             opcode,
+                    uint32_t             request_id);
+
+#endif // OCLAND_BUILD_H_INCLUDED
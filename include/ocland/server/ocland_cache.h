@@ -0,0 +1,140 @@
+/*
+ *  This file is part of ocland, a free cloud OpenCL interface.
+ *  Copyright (C) 2012  Jose Luis Cercos Pita <jl.cercos@upm.es>
+ *
+ *  ocland is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ocland is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ocland.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <sys/types.h>
+#include <stdint.h>
+
+#include <CL/cl.h>
+
+#include <ocland/common/dataExchange.h>
+
+#ifndef OCLAND_CACHE_H_INCLUDED
+#define OCLAND_CACHE_H_INCLUDED
+
+/** Initialize the programs binaries cache. The binaries built by the
+ * server are stored in a directory, so the following builds of the same
+ * program, with the same options and devices, are performed from them
+ * instead of compiling again, even after restarting the server. The
+ * least recently used binaries are discarded when the cache exceeds its
+ * maximum size. The programs sources are stored as well, so the clients
+ * can create the programs without uploading them again.
+ * @param dir Directory where the binaries are stored, which is created
+ * if it does not exist.
+ * @param max_size Maximum size of the stored binaries. If 0, the cache
+ * is disabled.
+ * @return CL_SUCCESS, CL_INVALID_VALUE if the directory can't be used.
+ */
+cl_int initProgramCache(const char *dir, size_t max_size);
+
+/** Remember the contents which a program has been created from, that
+ * identify it in the cache.
+ * @param program Program.
+ * @param contents Digest of the sources or binaries of the program
+ * (see sha256Contents).
+ */
+void setProgramContents(cl_program program, const unsigned char *contents);
+
+/** Forget the contents of a released program.
+ * @param program Program.
+ */
+void unsetProgramContents(cl_program program);
+
+/** Build a program from the cached binaries. If the binaries of all
+ * the devices are cached, a new program is created and built from them,
+ * which must replace the given one.
+ * @param program Program to build.
+ * @param num_devices Number of devices in device_list.
+ * @param device_list Devices to build the program for. If NULL, the
+ * program is built for all the devices associated to it.
+ * @param options Build options. Can be NULL.
+ * @param errcode_ret Returned error code, CL_SUCCESS if the program has
+ * been built from the cached binaries. Not modified otherwise.
+ * @return Program built from the cached binaries, NULL if some binary
+ * is not cached, so the given program must be compiled.
+ */
+cl_program loadCachedProgram(cl_program           program,
+                             cl_uint              num_devices,
+                             const cl_device_id * device_list,
+                             const char *         options,
+                             cl_int *             errcode_ret);
+
+/** Remember that a program built from the cached binaries (see
+ * loadCachedProgram) replaces another one, which is kept alive to get
+ * its sources, or to build it again with other options. The contents
+ * of the replaced program are set on the cached one.
+ * @param program Replaced program.
+ * @param cached Program built from the cached binaries.
+ */
+void substituteProgram(cl_program program, cl_program cached);
+
+/** Get the program replaced by a program built from the cached
+ * binaries.
+ * @param program Program.
+ * @return Replaced program, or program itself if it has not replaced
+ * any other.
+ */
+cl_program substitutedProgram(cl_program program);
+
+/** Forget the program replaced by a program built from the cached
+ * binaries.
+ * @param cached Program built from the cached binaries.
+ * @return Replaced program, NULL if it has not replaced any other.
+ */
+cl_program unsubstituteProgram(cl_program cached);
+
+/** Store in the cache the binaries of a program already built.
+ * @param program Program built.
+ * @param num_devices Number of devices in device_list.
+ * @param device_list Devices the program has been built for. If NULL,
+ * all the devices associated to the program.
+ * @param options Build options. Can be NULL.
+ */
+void storeCachedProgram(cl_program           program,
+                        cl_uint              num_devices,
+                        const cl_device_id * device_list,
+                        const char *         options);
+
+/** Store the sources of a program in the cache, so they are not
+ * uploaded again by the clients (see createCachedProgram).
+ * @param contents Digest of the sources (see sha256Contents).
+ * @param count Number of sources.
+ * @param strings Sources.
+ * @param lengths Size of each source.
+ */
+void storeProgramSources(const unsigned char * contents,
+                         cl_uint               count,
+                         const char * const *  strings,
+                         const size_t *        lengths);
+
+/** clCreateProgramWithSource replacement using the cached sources.
+ * @param context Context.
+ * @param contents Digest of the sources (see sha256Contents).
+ * @param errcode_ret Returned error code, as clCreateProgramWithSource
+ * ones, or CL_INVALID_VALUE if the sources are not cached.
+ * @return Program, NULL if errors happened.
+ */
+cl_program createCachedProgram(cl_context            context,
+                               const unsigned char * contents,
+                               cl_int *              errcode_ret);
+
+/** Get the counters of the programs binaries and sources cache.
+ * @param stats Counters.
+ */
+void programCacheStats(struct oclandCacheStats_st *stats);
+
+#endif // OCLAND_CACHE_H_INCLUDED
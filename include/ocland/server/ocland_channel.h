@@ -0,0 +1,217 @@
+/*
+ *  This file is part of ocland, a free cloud OpenCL interface.
+ *  Copyright (C) 2012  Jose Luis Cercos Pita <jl.cercos@upm.es>
+ *
+ *  ocland is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ocland is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ocland.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#include <CL/cl.h>
+
+#ifndef OCLAND_CHANNEL_H_INCLUDED
+#define OCLAND_CHANNEL_H_INCLUDED
+
+/** @struct channel_chunk_st Piece of a streamed transfer, received
+ * but not consumed yet.
+ */
+struct channel_chunk_st{
+    /// Chunk data
+    void *ptr;
+    /// Offset of the chunk in the transfer
+    size_t offset;
+    /// Size of the chunk
+    size_t size;
+    /// Next chunk of the transfer
+    struct channel_chunk_st *next;
+};
+
+/** @struct channel_transfer_st Data expected from the client in the
+ * data channel.
+ */
+struct channel_transfer_st{
+    /// Identifier of the request which started the transfer
+    uint32_t request_id;
+    /// Memory where the data must be received, NULL if the transfer is
+    /// streamed in chunks
+    void *ptr;
+    /// Size of the data
+    size_t cb;
+    /// Size of the data already received
+    size_t received;
+    /// First chunk received and not consumed yet (streamed transfers)
+    struct channel_chunk_st *first;
+    /// Last chunk received and not consumed yet (streamed transfers)
+    struct channel_chunk_st *last;
+    /// Chunks received and not released yet (streamed transfers)
+    unsigned int staged;
+    /// CL_TRUE once the consumer has started reading the chunks
+    /// (streamed transfers)
+    cl_bool consuming;
+    /// 0 while the data is arriving, 1 if it has been received, -1 if
+    /// the data channel has been lost
+    int status;
+    /// Next expected transfer
+    struct channel_transfer_st *next;
+};
+
+/** @struct channel_st Data channel of a client session. The client
+ * opens a second connection to the server port, which is attached to
+ * its session with the token provided by the server. The bulk data of
+ * the asynchronous transfers is exchanged through such connection, in
+ * packages tagged with the identifier of the request which started
+ * the transfer, so the commands channel is never blocked by them.
+ */
+struct channel_st{
+    /// Secret token required to attach the data connection
+    uint64_t token;
+    /// Data connection socket, -1 if it has not been attached yet
+    int socket;
+    /// CL_TRUE if the session has been closed
+    cl_bool closed;
+    /// Number of references (the session, the receiver thread, and
+    /// each pending transfer)
+    unsigned int refs;
+    /// Transfers expected from the client
+    struct channel_transfer_st *transfers;
+    /// Mutex protecting the channel data
+    pthread_mutex_t mutex;
+    /// Mutex serializing the packages sent to the client
+    pthread_mutex_t send_mutex;
+    /// Condition signaled each time a transfer is received
+    pthread_cond_t cond;
+    /// Thread receiving the data from the client
+    pthread_t thread;
+    /// Next channel in the registered list
+    struct channel_st *next;
+};
+
+/// Abstraction of channel_st structure
+typedef struct channel_st* data_channel;
+
+/** Create the data channel of a new client session.
+ * @return Data channel, NULL if it can't be created.
+ */
+data_channel createChannel();
+
+/** Close the data channel of a client session. The pending transfers
+ * are aborted, and the channel is destroyed when the last transfer
+ * using it releases it.
+ * @param c Data channel.
+ */
+void closeChannel(data_channel c);
+
+/** Retain the data channel, so it will not be destroyed until
+ * releaseChannel is called.
+ * @param c Data channel.
+ */
+void retainChannel(data_channel c);
+
+/** Release the data channel.
+ * @param c Data channel.
+ */
+void releaseChannel(data_channel c);
+
+/** Attach a connection to the data channel identified by a token.
+ * @param token Token of the data channel.
+ * @param socket Connection socket. On success the socket is owned by
+ * the data channel.
+ * @return CL_SUCCESS if the connection has been attached,
+ * CL_INVALID_VALUE if the token does not match any data channel, or
+ * it already has a connection attached, and CL_OUT_OF_HOST_MEMORY if
+ * the receiver thread can't be launched.
+ */
+cl_int attachChannel(uint64_t token, int socket);
+
+/** Send data to the client through the data channel. Large data is
+ * split in packages of OCLAND_TRANSFER_CHUNK bytes, so the transfers
+ * sent at the same time are interleaved.
+ * @param c Data channel.
+ * @param opcode Command index of the request which started the
+ * transfer.
+ * @param request_id Identifier of the request which started the
+ * transfer.
+ * @param ptr Data to send.
+ * @param cb Size of the data.
+ * @return Number of data bytes sent, -1 if errors happened.
+ */
+ssize_t channelSend(data_channel c, uint32_t opcode, uint32_t request_id, const void *ptr, size_t cb);
+
+/** Register a transfer which data will be sent by the client through
+ * the data channel. It must be called before answering the request,
+ * because the client will send the data after receiving the answer.
+ * @param c Data channel.
+ * @param request_id Identifier of the request which started the
+ * transfer.
+ * @param ptr Memory where the data must be received.
+ * @param cb Size of the data.
+ * @return CL_SUCCESS, CL_INVALID_VALUE if the data channel has not been
+ * attached, or CL_OUT_OF_HOST_MEMORY.
+ */
+cl_int channelExpect(data_channel c, uint32_t request_id, void *ptr, size_t cb);
+
+/** Register a transfer which data will be sent by the client through
+ * the data channel, to be consumed in chunks while it is still arriving
+ * (see channelNextChunk). It must be called before answering the
+ * request.
+ * @param c Data channel.
+ * @param request_id Identifier of the request which started the
+ * transfer.
+ * @param cb Size of the data.
+ * @return CL_SUCCESS, CL_INVALID_VALUE if the data channel has not been
+ * attached, or CL_OUT_OF_HOST_MEMORY.
+ */
+cl_int channelExpectStream(data_channel c, uint32_t request_id, size_t cb);
+
+/** Wait for the next chunk of a transfer registered with
+ * channelExpectStream. The chunks are returned in order.
+ * The consumer should call it once it is ready to consume the whole
+ * transfer, e.g. when the commands it depends on have finished, see
+ * channelReleaseChunk.
+ * @param c Data channel.
+ * @param request_id Identifier of the request which started the
+ * transfer.
+ * @return Next chunk, which must be released with channelReleaseChunk.
+ * NULL if the data channel has been lost, or all the chunks have been
+ * already consumed.
+ */
+struct channel_chunk_st* channelNextChunk(data_channel c, uint32_t request_id);
+
+/** Release a chunk returned by channelNextChunk. Once the consumer has
+ * started reading a transfer, just a few chunks of it can be staged at
+ * the same time, so the data channel stops receiving until the
+ * consumer releases them. Before that the chunks are kept as they
+ * arrive, so a transfer which is still waiting for its dependencies
+ * never stalls the data channel.
+ * @param c Data channel.
+ * @param request_id Identifier of the request which started the
+ * transfer.
+ * @param chunk Chunk to release.
+ */
+void channelReleaseChunk(data_channel c, uint32_t request_id, struct channel_chunk_st *chunk);
+
+/** Wait until the data of a transfer registered with channelExpect is
+ * received. It must be also called to unregister the transfers
+ * registered with channelExpectStream, after consuming its chunks.
+ * @param c Data channel.
+ * @param request_id Identifier of the request which started the
+ * transfer.
+ * @return CL_SUCCESS if the data has been received, CL_OUT_OF_RESOURCES
+ * if the data channel has been lost.
+ */
+cl_int channelWait(data_channel c, uint32_t request_id);
+
+#endif // OCLAND_CHANNEL_H_INCLUDED
@@ -71,6 +71,21 @@ int ocland_clGetDeviceIDs(int* clientfd, char* buffer, validator v, void* data);
  */
 int ocland_clGetDeviceInfo(int* clientfd, char* buffer, validator v, void* data);
 
+/** Answer several info of several platforms or devices at once, so the
+ * client can store the info which never changes with a single request.
+ * The client sends the kind of the objects (OCLAND_INFO_PLATFORM or
+ * OCLAND_INFO_DEVICE), the number of objects, the number of info, the
+ * objects, and the info names. The answer contains the error code of
+ * the request, followed by the error code, size, and value of each info
+ * of each object.
+ * @param clientfd Client connection socket.
+ * @param buffer Buffer to exchange data.
+ * @param v Validator.
+ * @param data Data received by the client.
+ * @return 0 if message can't be dispatched, 1 otherwise.
+ */
+int ocland_prefetchInfo(int* clientfd, char* buffer, validator v, void* data);
+
 /** clCreateContext ocland abstraction.
  * @param clientfd Client connection socket.
  * @param buffer Buffer to exchange data.
@@ -251,6 +266,20 @@ int ocland_clGetSamplerInfo(int* clientfd, char* buffer, validator v, void* data
  */
 int ocland_clCreateProgramWithSource(int* clientfd, char* buffer, validator v, void* data);
 
+/** clCreateProgramWithSource ocland abstraction, from the sources
+ * already stored by the server. The client sends the context, and the
+ * digest of the sources (see sha256Contents), and receives the error
+ * code and the program, as in clCreateProgramWithSource. If the sources
+ * are not stored CL_INVALID_VALUE is answered, and the client must send
+ * them with clCreateProgramWithSource.
+ * @param clientfd Client connection socket.
+ * @param buffer Buffer to exchange data.
+ * @param v Validator.
+ * @param data Data received by the client.
+ * @return 0 if message can't be dispatched, 1 otherwise.
+ */
+int ocland_createProgramWithDigest(int* clientfd, char* buffer, validator v, void* data);
+
 /** clCreateProgramWithBinary ocland abstraction.
  * @param clientfd Client connection socket.
  * @param buffer Buffer to exchange data.
@@ -680,6 +709,19 @@ int ocland_clUnloadPlatformCompiler(int* clientfd, char* buffer, validator v);
  */
 int ocland_clGetKernelArgInfo(int* clientfd, char* buffer, validator v, void* data);
 
+/** Answer the address qualifier of all the arguments of a kernel at
+ * once, so the client can get them with a single request. The answer
+ * contains the error code, the number of arguments, and the address
+ * qualifier of each argument. The arguments which can't be queried
+ * (i.e. OpenCL < 1.2 platforms) are considered global.
+ * @param clientfd Client connection socket.
+ * @param buffer Buffer to exchange data.
+ * @param v Validator.
+ * @param data Data received by the client.
+ * @return 0 if message can't be dispatched, 1 otherwise.
+ */
+int ocland_kernelArgsAddress(int* clientfd, char* buffer, validator v, void* data);
+
 /** clEnqueueFillBuffer ocland abstraction.
  * @param clientfd Client connection socket.
  * @param buffer Buffer to exchange data.
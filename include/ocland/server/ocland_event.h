@@ -38,6 +38,8 @@ struct _ocland_event
     /** ocland status, if you want to wait
      * for this event, you may look for
      * this variable turns into CL_COMPLETE
+     * with oclandWaitForEvents, which is
+     * signaled by oclandSetUserEventComplete
      */
     cl_int status;
     /// OpenCL associated to this context.
@@ -48,6 +50,12 @@ struct _ocland_event
      * into context.
      */
     cl_command_queue command_queue;
+    /** Number of references to this event, i.e. the client, the
+     * asynchronous transfer which will complete it, and the threads
+     * waiting for it. The event is destroyed when it reaches 0 (see
+     * oclandReleaseEvent).
+     */
+    cl_uint refs;
 };
 
 /** @typedef ocland_event
@@ -55,8 +63,23 @@ struct _ocland_event
  */
 typedef struct _ocland_event* ocland_event;
 
+/** Add a reference to an ocland event.
+ * @param event ocland event.
+ */
+void oclandRetainEvent(ocland_event event);
+
+/** Remove a reference to an ocland event, destroying it when no
+ * references are left.
+ * @param event ocland event.
+ * @note The OpenCL event is not released, the owner of each reference
+ * to it should release it before.
+ */
+void oclandReleaseEvent(ocland_event event);
+
 /** clWaitForEvents extension in order to wait to network
- * traffic has been completed too.
+ * traffic has been completed too. The calling thread sleeps until the
+ * whole list is completed, being woken up as soon as each event is
+ * completed.
  * @param num_events Number of events inside event_list.
  * @param event_list List of events to wait.
  * @return CL_SUCCESS if the function was executed
@@ -67,5 +90,66 @@ typedef struct _ocland_event* ocland_event;
  * event_list are not valid event objects.
  */
 cl_int oclandWaitForEvents(cl_uint num_events, const ocland_event *event_list);
+
+/** Get the OpenCL events associated to a list of ocland events,
+ * in order to pass them as the wait list of a clEnqueue* command.
+ * Therefore OpenCL will resolve the dependencies without blocking
+ * the server.
+ * @param num_events Number of events inside event_list.
+ * @param event_list List of ocland events. The list is overwritten
+ * with the OpenCL events.
+ * @return The OpenCL events list (the same memory than event_list).
+ * @note All the ocland events must have an OpenCL event associated,
+ * see oclandInitUserEvent for the commands which can't be enqueued
+ * immediately.
+ */
+cl_event* oclandGetEvents(cl_uint num_events, ocland_event *event_list);
+
+/** Associate an OpenCL user event to an ocland event, which command
+ * can't be enqueued yet because it depends on a network transfer.
+ * Thus the event can be used in the wait list of following commands
+ * before the transfer has been completed.
+ * @param event ocland event.
+ * @return CL_SUCCESS if the user event is created, an error code
+ * otherwise (see clCreateUserEvent).
+ * @note An extra reference to the user event, and to the ocland event,
+ * is retained, that will be released by oclandSetUserEventComplete.
+ * @note The work is accounted as in flight in the event command queue
+ * until oclandSetUserEventComplete is called.
+ */
+cl_int oclandInitUserEvent(ocland_event event);
+
+/** Mark as completed an event initialized with oclandInitUserEvent,
+ * releasing the commands that are waiting for it.
+ * @param event ocland event.
+ * @warning The event can't be used anymore by the calling thread,
+ * unless it holds another reference to it.
+ */
+void oclandSetUserEventComplete(ocland_event event);
+
+/** Wait until the work in flight in a command queue, i.e. the events
+ * initialized with oclandInitUserEvent and not completed yet, has
+ * finished. The OpenCL commands must be waited later (see clFinish).
+ * @param command_queue OpenCL command queue.
+ * @return CL_SUCCESS.
+ */
+cl_int oclandWaitForQueue(cl_command_queue command_queue);
+
+/** Get the work in flight in a command queue.
+ * @param command_queue OpenCL command queue.
+ * @param depth Number of events in flight. Can be NULL.
+ * @param age Time (in seconds) since the command queue has work in
+ * flight, 0 if it has not. Can be NULL.
+ */
+void oclandQueueStatus(cl_command_queue command_queue, cl_uint *depth, double *age);
+
+/** Get the command queues with work in flight (see oclandQueueStatus).
+ * @param num_entries Number of command queues that can be stored.
+ * @param command_queues Command queues with work in flight. Can be
+ * NULL if num_entries is 0.
+ * @return Number of command queues with work in flight, which can be
+ * greater than num_entries.
+ */
+cl_uint oclandQueuesInFlight(cl_uint num_entries, cl_command_queue *command_queues);
 
 #endif // OCLAND_EVENT_H_INCLUDED
@@ -19,6 +19,7 @@
 #include <CL/cl.h>
 #include <CL/cl_ext.h>
 
+#include <ocland/common/dataExchange.h>
 #include <ocland/server/ocland_event.h>
 
 #ifndef OCLAND_MEM_H_INCLUDED
@@ -29,15 +30,14 @@
  * command documentation for further details on the parameters
  * and returned values.
  * @param clientfd Socket already open with the client.
- * @note Memory transfer will be done in a new thread, and in a
- * new socket.
+ * @note Memory transfer will be done in a new thread, and through
+ * the client data channel, in chunks of OCLAND_TRANSFER_CHUNK bytes.
  */
 cl_int oclandEnqueueReadBuffer(int *                clientfd ,
                                cl_command_queue     command_queue ,
                                cl_mem               buffer ,
                                size_t               offset ,
                                size_t               cb ,
-                               void *               ptr ,
                                cl_uint              num_events_in_wait_list ,
                                ocland_event *       event_wait_list ,
                                cl_bool              want_event ,
@@ -48,15 +48,14 @@ cl_int oclandEnqueueReadBuffer(int *                clientfd ,
  * command documentation for further details on the parameters
  * and returned values.
  * @param clientfd Socket already open with the client.
- * @note Memory transfer will be done in a new thread, and in a
- * new socket.
+ * @note Memory transfer will be done in a new thread, and through
+ * the client data channel, in chunks of OCLAND_TRANSFER_CHUNK bytes.
  */
 cl_int oclandEnqueueWriteBuffer(int *               clientfd ,
                                 cl_command_queue     command_queue ,
                                 cl_mem               buffer ,
                                 size_t               offset ,
                                 size_t               cb ,
-                                void *               ptr ,
                                 cl_uint              num_events_in_wait_list ,
                                 ocland_event *       event_wait_list ,
                                 cl_bool              want_event ,
@@ -68,8 +67,8 @@ cl_int oclandEnqueueWriteBuffer(int *               clientfd ,
  * and returned values.
  * @param clientfd Socket already open with the client.
  * @param element_size Image element size.
- * @note Memory transfer will be done in a new thread, and in a
- * new socket.
+ * @note Memory transfer will be done in a new thread, and through
+ * the client data channel.
  */
 cl_int oclandEnqueueReadImage(int *                clientfd ,
                               cl_command_queue     command_queue ,
@@ -91,8 +90,8 @@ cl_int oclandEnqueueReadImage(int *                clientfd ,
  * and returned values.
  * @param clientfd Socket already open with the client.
  * @param element_size Image element size.
- * @note Memory transfer will be done in a new thread, and in a
- * new socket.
+ * @note Memory transfer will be done in a new thread, and through
+ * the client data channel.
  */
 cl_int oclandEnqueueWriteImage(int *                clientfd ,
                                cl_command_queue     command_queue ,
@@ -114,8 +113,8 @@ cl_int oclandEnqueueWriteImage(int *                clientfd ,
  * command documentation for further details on the parameters
  * and returned values.
  * @param clientfd Socket already open with the client.
- * @note Memory transfer will be done in a new thread, and in a
- * new socket.
+ * @note Memory transfer will be done in a new thread, and through
+ * the client data channel.
  */
 cl_int oclandEnqueueReadBufferRect(int *                clientfd ,
                                    cl_command_queue     command_queue ,
@@ -137,8 +136,8 @@ cl_int oclandEnqueueReadBufferRect(int *                clientfd ,
  * command documentation for further details on the parameters
  * and returned values.
  * @param clientfd Socket already open with the client.
- * @note Memory transfer will be done in a new thread, and in a
- * new socket.
+ * @note Memory transfer will be done in a new thread, and through
+ * the client data channel.
  */
 cl_int oclandEnqueueWriteBufferRect(int *                clientfd ,
                                     cl_command_queue     command_queue ,
@@ -156,4 +155,9 @@ cl_int oclandEnqueueWriteBufferRect(int *                clientfd ,
                                     ocland_event         event);
 #endif // CL_API_SUFFIX__VERSION_1_1
 
+/** Get the asynchronous transfers in flight.
+ * @param stats Transfers queue depth and memory held.
+ */
+void oclandTransfersStatus(struct oclandTransferStats_st *stats);
+
 #endif // OCLAND_MEM_H_INCLUDED
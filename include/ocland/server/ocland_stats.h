@@ -0,0 +1,95 @@
+/*
+ *  This file is part of ocland, a free cloud OpenCL interface.
+ *  Copyright (C) 2012  Jose Luis Cercos Pita <jl.cercos@upm.es>
+ *
+ *  ocland is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ocland is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ocland.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <sys/types.h>
+#include <stdint.h>
+
+#include <CL/cl.h>
+
+#include <ocland/common/dataExchange.h>
+
+#ifndef OCLAND_STATS_H_INCLUDED
+#define OCLAND_STATS_H_INCLUDED
+
+/// Maximum number of opcodes accounted
+#define OCLAND_STATS_OPCODES 128u
+
+/** @struct request_stats_st Request being timed by a worker thread.
+ * The requests can be nested (e.g. the packages of a batch), in which
+ * case the time spent serving the nested request is not accounted in
+ * the parent one.
+ */
+struct request_stats_st{
+    /// Command index
+    uint32_t opcode;
+    /// Current phase (OCLAND_PHASE_*)
+    unsigned int phase;
+    /// Time when the current phase has started, in nanoseconds
+    uint64_t since;
+    /// Time spent in each phase, in nanoseconds
+    uint64_t time[OCLAND_NUM_PHASES];
+    /// Size of the request
+    uint64_t bytes_in;
+    /// Size of the answers
+    uint64_t bytes_out;
+    /// CL_TRUE if the request has been answered with an error code
+    cl_bool error;
+    /// Request which was being timed when this one started
+    struct request_stats_st *parent;
+};
+
+/** Start timing a request served by the calling thread, in the
+ * OCLAND_PHASE_DECODE phase.
+ * @param s Request data, which must be kept until statsEnd is called.
+ * @param opcode Command index.
+ * @param bytes_in Size of the request.
+ */
+void statsBegin(struct request_stats_st *s, uint32_t opcode, size_t bytes_in);
+
+/** Change the phase of the request being timed by the calling thread.
+ * Nothing is done if the thread is not timing a request.
+ * @param phase New phase (OCLAND_PHASE_*).
+ */
+void statsPhase(unsigned int phase);
+
+/** Account an answer of the request being timed by the calling thread.
+ * @param bytes_out Size of the answer.
+ * @param flag Error code of the answer.
+ */
+void statsReply(size_t bytes_out, cl_int flag);
+
+/** Finish timing a request, accounting it in the counters of its
+ * opcode. The parent request is timed again, if any.
+ * @param s Request data.
+ */
+void statsEnd(struct request_stats_st *s);
+
+/** Get the counters of the requests served.
+ * @param stats Counters of each opcode.
+ * @param num_opcodes Number of opcodes.
+ */
+void getStats(struct oclandOpcodeStats_st *stats, unsigned int num_opcodes);
+
+/** Print the counters of the requests served, for the opcodes which
+ * have been requested.
+ * @param names Name of each opcode. NULL names are printed as numbers.
+ * @param num_opcodes Number of opcodes.
+ */
+void dumpStats(const char * const *names, unsigned int num_opcodes);
+
+#endif // OCLAND_STATS_H_INCLUDED
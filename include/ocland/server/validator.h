@@ -18,7 +18,9 @@
 
 #include <CL/cl.h>
 #include <CL/cl_ext.h>
+#include <stdint.h>
 
+#include <ocland/common/hashTable.h>
 #include <ocland/server/ocland_event.h>
 
 #ifndef VALIDATOR_H_INCLUDED
@@ -33,38 +35,33 @@
  * server with a bad pointer.
  */
 struct validator_st{
-    /// Number of devices registered
-    cl_uint num_devices;
-    /// Recognized platforms array
-    cl_device_id *devices;
-    /// Number of context created
-    cl_uint num_contexts;
+    /// Platforms found on the server, NULL if they are not known yet
+    cl_platform_id *platforms;
+    /// Number of platforms found on the server
+    cl_uint num_platforms;
+    /// Registered devices
+    hash_table devices;
     /// Generated contexts
-    cl_context *contexts;
-    /// Number of queues created
-    cl_uint num_queues;
+    hash_table contexts;
     /// Generated queues
-    cl_command_queue *queues;
-    /// Number of memory objects created
-    cl_uint num_buffers;
+    hash_table queues;
     /// Generated memory objects
-    cl_mem *buffers;
-    /// Number of samplers created
-    cl_uint num_samplers;
+    hash_table buffers;
     /// Generated samplers
-    cl_sampler *samplers;
-    /// Number of programs created
-    cl_uint num_programs;
+    hash_table samplers;
     /// Generated programs
-    cl_program *programs;
-    /// Number of kernels created
-    cl_uint num_kernels;
+    hash_table programs;
     /// Generated kernels
-    cl_kernel *kernels;
-    /// Number of events created
-    cl_uint num_events;
+    hash_table kernels;
     /// Generated events
-    ocland_event *events;
+    hash_table events;
+    /// Objects identified by each client generated handle
+    hash_table handles;
+    /// Client generated handle of each object
+    hash_table handle_objects;
+    /// Number of objects identified by the address of another object
+    /// (see registerAlias)
+    cl_uint num_aliases;
 };
 
 /// Abstraction of validator_st structure
@@ -84,8 +81,9 @@ void closeValidator(validator* v);
  * @param v Active validator.
  * @param platform OpenCL platform.
  * @return CL_SUCCESS if platform is found, CL_INVALID_PLATFORM otherwise.
- * @note Platforms can't be stored, or following clients may fail creating
- * contexts, so only real time validation can be performed.
+ * @note Platforms can't be stored by the server, or following clients may
+ * fail creating contexts, so they are queried the first time each client
+ * validates a platform, and kept while the client is connected.
  */
 cl_int isPlatform(validator v, cl_platform_id platform);
 
@@ -267,4 +265,53 @@ cl_uint registerEvent(validator v, ocland_event event);
  */
 cl_uint unregisterEvent(validator v, ocland_event event);
 
+/** Register an object created with a client generated handle. The
+ * client will use the handle instead of the object address, so it can
+ * use the object before receiving the creation answer.
+ * @param v Active validator.
+ * @param handle Client generated handle.
+ * @param object OpenCL object.
+ * @return number of handles stored.
+ */
+cl_uint registerHandle(validator v, uint64_t handle, void *object);
+
+/** Removes the handles of an object from the list.
+ * @param v Active validator.
+ * @param object OpenCL object.
+ * @return number of handles stored.
+ */
+cl_uint unregisterHandle(validator v, void *object);
+
+/** Get the object identified by a pointer received from the client.
+ * @param v Active validator.
+ * @param ptr Object address, or client generated handle.
+ * @return Object identified by the handle. If ptr is not a registered
+ * handle, ptr itself is returned.
+ */
+void* handleObject(validator v, void *ptr);
+
+/** Get the pointer which identifies an object in the client.
+ * @param v Active validator.
+ * @param object OpenCL object.
+ * @return Handle of the object if it was created with a client generated
+ * handle, the object itself otherwise.
+ */
+void* objectHandle(validator v, void *object);
+
+/** Let the pointer which identifies an object in the client identify
+ * another object instead, e.g. a program replaced by one built from
+ * cached binaries. The aliased object is removed when the alias is
+ * unregistered with unregisterHandle. If the pointer is the address of
+ * alias, e.g. to give it back to a replaced program, it is just
+ * unregistered.
+ * @param v Active validator.
+ * @param object OpenCL object currently identified by the pointer.
+ * @param alias OpenCL object which will be identified by the pointer.
+ * @return Pointer which identifies the alias in the client. If it is not
+ * a client generated handle, it is the address of object, which must be
+ * kept alive until the alias is unregistered, or it could be reused by
+ * other object.
+ */
+void* registerAlias(validator v, void *object, void *alias);
+
 #endif // VALIDATOR_H_INCLUDED
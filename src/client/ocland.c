@@ -28,6 +28,8 @@
 #include <ocland/client/ocland_icd.h>
 #include <ocland/client/ocland.h>
 #include <ocland/client/shortcut.h>
+#include <ocland/common/transferPool.h>
+#include <ocland/common/sha256.h>
 
 #ifndef OCLAND_PORT
     #define OCLAND_PORT 51000u
@@ -37,10 +39,34 @@
     #define BUFF_SIZE 1025u
 #endif
 
+#ifndef OCLAND_BATCH_SIZE
+    #define OCLAND_BATCH_SIZE 65536u
+#endif
+
+#ifndef OCLAND_TRANSFER_WORKERS
+    #define OCLAND_TRANSFER_WORKERS 32u
+#endif
+
+#ifndef OCLAND_TRANSFER_BUDGET
+    #define OCLAND_TRANSFER_BUDGET 1073741824u
+#endif
+
+#ifndef OCLAND_TRANSFER_CHUNK
+    #define OCLAND_TRANSFER_CHUNK 4194304u
+#endif
+
+#ifndef OCLAND_SOURCE_DIGEST_SIZE
+    #define OCLAND_SOURCE_DIGEST_SIZE 16384u
+#endif
+
 /// Servers data storage
 static oclandServers* servers = NULL;
 /// Servers initialization flag
 static cl_bool initialized = CL_FALSE;
+/// Workers sending the asynchronous transfers data
+static transfer_pool transfers = NULL;
+/// Transfers pool initialization control
+static pthread_once_t transfers_once = PTHREAD_ONCE_INIT;
 
 enum {
     ocland_clGetPlatformIDs,
@@ -117,52 +143,874 @@ enum {
     ocland_clEnqueueMarkerWithWaitList,
     ocland_clEnqueueBarrierWithWaitList,
     ocland_clCreateImage2D,
-    ocland_clCreateImage3D
+    ocland_clCreateImage3D,
+    ocland_batch,
+    ocland_channelToken,
+    ocland_channelAttach,
+    ocland_prefetchInfo,
+    ocland_createProgramWithDigest,
+    ocland_serverStats,
+    ocland_kernelArgsAddress
 };
 
-/** Waits until the server is locked, and then gives access
- * and block for other instances. You may lock the servers
- * in order to avoid parallel packages send/receive that can
- * arrive to the wrong method.
- * @param socket Server socket.
+/** Look for the server which owns a socket.
+ * @param sockfd Server socket.
+ * @return Server index, servers->num_servers if it can't be found.
  */
-void lock(int socket){
+static unsigned int serverIndex(int *sockfd){
     unsigned int i;
-    // Find the server
+    // The shortcuts point to the sockets stored in the servers list
+    if( ((uintptr_t)sockfd >= (uintptr_t)servers->sockets) &&
+        ((uintptr_t)sockfd < (uintptr_t)(servers->sockets + servers->num_servers)) )
+        return (unsigned int)(sockfd - servers->sockets);
     for(i=0;i<servers->num_servers;i++){
-        if(servers->sockets[i] == socket)
+        if(servers->sockets[i] == *sockfd)
+            return i;
+    }
+    return servers->num_servers;
+}
+
+/** Waits until the server connection is released, and then gives
+ * access and block for other threads. You may lock the servers in
+ * order to avoid parallel packages send that can be mixed. The
+ * threads get the access in the same order they asked for it.
+ * @param i Server index.
+ */
+static void lockServer(unsigned int i){
+    pthread_mutex_lock(&(servers->send_mutex[i]));
+    unsigned long ticket = servers->send_ticket[i]++;
+    while(servers->send_serving[i] != ticket)
+        pthread_cond_wait(&(servers->send_cond[i]), &(servers->send_mutex[i]));
+    pthread_mutex_unlock(&(servers->send_mutex[i]));
+}
+
+/** Unlock the server connection for other threads.
+ * @param i Server index.
+ */
+static void unlockServer(unsigned int i){
+    pthread_mutex_lock(&(servers->send_mutex[i]));
+    servers->send_serving[i]++;
+    pthread_cond_broadcast(&(servers->send_cond[i]));
+    pthread_mutex_unlock(&(servers->send_mutex[i]));
+}
+
+/** Receive the next answer from a server. If a sink has been registered
+ * for the request (see oclandSinkRequest), the answer payload is received
+ * straight into its memory. If the answer can't be received, the
+ * connection is closed.
+ * @param i Server index.
+ * @param sockfd Server socket.
+ * @return Received answer, NULL if the connection has been lost.
+ */
+static struct oclandAnswer_st* recvAnswer(unsigned int i, int *sockfd){
+    struct oclandHeader_st header;
+    struct oclandSink_st *sink;
+    if(RecvHeader(sockfd, &header, MSG_WAITALL) != sizeof(struct oclandHeader_st)){
+        if(*sockfd >= 0){
+            close(*sockfd);
+            *sockfd = -1;
+        }
+        return NULL;
+    }
+    // Look for the memory where the payload must be received. The sink
+    // is not unregistered until its answer is received
+    pthread_mutex_lock(&(servers->answers_mutex[i]));
+    for(sink=servers->sinks[i];sink;sink=sink->next){
+        if(sink->request_id == header.request_id)
             break;
     }
-    if(i == servers->num_servers){
-        // Server not found
+    pthread_mutex_unlock(&(servers->answers_mutex[i]));
+    size_t size = header.length, direct = 0;
+    if( sink && (header.length > sink->offset) &&
+        (header.length - sink->offset <= sink->cb) ){
+        size   = sink->offset;
+        direct = header.length - size;
+    }
+    struct oclandAnswer_st *answer = (struct oclandAnswer_st*)malloc(sizeof(struct oclandAnswer_st));
+    void *msg = malloc(size);
+    if( !answer || (size && !msg) ||
+        (size && (Recv(sockfd, msg, size, MSG_WAITALL) != (ssize_t)size)) ||
+        (direct && (Recv(sockfd, sink->ptr, direct, MSG_WAITALL) != (ssize_t)direct)) ){
+        free(answer);
+        free(msg);
+        close(*sockfd);
+        *sockfd = -1;
+        return NULL;
+    }
+    answer->opcode     = header.opcode;
+    answer->request_id = header.request_id;
+    answer->size       = size;
+    answer->msg        = msg;
+    answer->next       = NULL;
+    return answer;
+}
+
+/** Send the packages queued in the batch of a server. The batch answer
+ * will be processed by the thread which is receiving answers.
+ * @param i Server index.
+ * @param sockfd Server socket.
+ * @note Call this method with the server locked.
+ */
+static void flushBatch(unsigned int i, int *sockfd){
+    struct oclandHeader_st header;
+    if(!servers->batch_size[i])
         return;
+    header.magic   = OCLAND_MAGIC;
+    header.version = OCLAND_PROTOCOL_VERSION;
+    header.flags   = 0;
+    header.opcode  = ocland_batch;
+    header.length  = servers->batch_size[i];
+    pthread_mutex_lock(&(servers->answers_mutex[i]));
+    header.request_id = servers->request_id[i]++;
+    pthread_mutex_unlock(&(servers->answers_mutex[i]));
+    SendPackage(sockfd, &header, servers->batch[i]);
+    servers->batch_size[i] = 0;
+}
+
+/** Build the header of a new request to a server, assigning it a new
+ * request identifier.
+ * @param i Server index.
+ * @param header Header to fill.
+ * @param opcode Command index.
+ * @param msgSize Request data size.
+ */
+static void newRequest(unsigned int i, struct oclandHeader_st *header, unsigned int opcode, size_t msgSize){
+    header->magic   = OCLAND_MAGIC;
+    header->version = OCLAND_PROTOCOL_VERSION;
+    header->flags   = 0;
+    header->opcode  = opcode;
+    header->length  = msgSize;
+    pthread_mutex_lock(&(servers->answers_mutex[i]));
+    header->request_id = servers->request_id[i]++;
+    pthread_mutex_unlock(&(servers->answers_mutex[i]));
+}
+
+/** Send a request to a server. The packages queued in the server batch
+ * are sent before the request.
+ * @param i Server index.
+ * @param sockfd Server socket.
+ * @param header Request header.
+ * @param msg Request data.
+ */
+static void sendRequest(unsigned int i, int *sockfd, const struct oclandHeader_st *header, const void *msg){
+    lockServer(i);
+    flushBatch(i, sockfd);
+    SendPackage(sockfd, header, msg);
+    unlockServer(i);
+}
+
+/** Wait for the answer of a request. Several threads can send requests
+ * to the same server at the same time, each one taking the answer with
+ * its request identifier. The first waiting thread reads the answers
+ * from the socket, storing the ones requested by other threads.
+ * @param i Server index.
+ * @param sockfd Server socket.
+ * @param request_id Request identifier.
+ * @return Answer, NULL if the connection with the server has been lost.
+ */
+static struct oclandAnswer_st* waitAnswer(unsigned int i, int *sockfd, uint32_t request_id){
+    struct oclandAnswer_st *answer = NULL, **prev;
+    pthread_mutex_lock(&(servers->answers_mutex[i]));
+    while(1){
+        // Look for it in the already received answers
+        prev = &(servers->answers[i]);
+        for(answer=*prev;answer;answer=answer->next){
+            if(answer->request_id == request_id){
+                *prev = answer->next;
+                break;
+            }
+            prev = &(answer->next);
+        }
+        if(answer || (*sockfd < 0))
+            break;
+        if(servers->receiving[i]){
+            // Other thread is already reading the answers
+            pthread_cond_wait(&(servers->answers_cond[i]), &(servers->answers_mutex[i]));
+            continue;
+        }
+        servers->receiving[i] = CL_TRUE;
+        pthread_mutex_unlock(&(servers->answers_mutex[i]));
+        answer = recvAnswer(i, sockfd);
+        pthread_mutex_lock(&(servers->answers_mutex[i]));
+        servers->receiving[i] = CL_FALSE;
+        pthread_cond_broadcast(&(servers->answers_cond[i]));
+        if(!answer || (answer->request_id == request_id))
+            break;
+        if(answer->opcode == ocland_batch){
+            // Batches answers are not claimed by anyone, just keep
+            // the error to be notified later
+            if( (servers->batch_error[i] == CL_SUCCESS) &&
+                (answer->size >= sizeof(cl_int)) )
+                servers->batch_error[i] = ((cl_int*)answer->msg)[0];
+            free(answer->msg);
+            free(answer);
+            answer = NULL;
+            continue;
+        }
+        // Store the answer for its thread
+        answer->next = servers->answers[i];
+        servers->answers[i] = answer;
+        answer = NULL;
     }
-    // Wait while server is locked
-    while(servers->locked[i]){
-        fflush(stdout);
+    pthread_mutex_unlock(&(servers->answers_mutex[i]));
+    return answer;
+}
+
+/** Extract the data of an answer, destroying it.
+ * @param answer Answer, NULL if the connection has been lost.
+ * @param msgSize Answer data size.
+ * @return Answer data, which must be freed. If the answer is NULL, data
+ * with just the CL_OUT_OF_RESOURCES error code will be returned.
+ */
+static void* answerData(struct oclandAnswer_st *answer, size_t *msgSize){
+    void *data;
+    if(!answer){
+        // Connection lost
+        *msgSize = sizeof(cl_int);
+        data = malloc(*msgSize);
+        ((cl_int*)data)[0] = CL_OUT_OF_RESOURCES;
+        return data;
+    }
+    data     = answer->msg;
+    *msgSize = answer->size;
+    free(answer);
+    return data;
+}
+
+/** Send a request to a server, and wait for its answer. Several
+ * threads can send requests to the same server at the same time
+ * (see waitAnswer). The packages queued in the server batch are sent
+ * before the request.
+ * @param sockfd Server socket.
+ * @param opcode Command index.
+ * @param msg Request data.
+ * @param msgSize Request data size. The answer data size will be
+ * returned here.
+ * @return Answer data, which must be freed. If the connection with the
+ * server has been lost, an answer with just the CL_OUT_OF_RESOURCES
+ * error code will be returned.
+ */
+static void* oclandRequest(int *sockfd, unsigned int opcode, const void *msg, size_t *msgSize){
+    struct oclandHeader_st header;
+    struct oclandAnswer_st *answer = NULL;
+    unsigned int i = serverIndex(sockfd);
+    if(i < servers->num_servers){
+        newRequest(i, &header, opcode, *msgSize);
+        sendRequest(i, sockfd, &header, msg);
+        answer = waitAnswer(i, sockfd, header.request_id);
+    }
+    return answerData(answer, msgSize);
+}
+
+/** Send a request to a server, and wait for its answer, receiving the
+ * answer payload straight into the provided memory. The answer data
+ * preceding the payload is returned as usual. If the payload does not
+ * fit in the memory, it is kept in the answer data as well.
+ * @param sockfd Server socket.
+ * @param opcode Command index.
+ * @param msg Request data.
+ * @param msgSize Request data size. The answer data size, without the
+ * payload received in the memory, will be returned here.
+ * @param offset Size of the answer data which precedes the payload.
+ * @param ptr Memory where the payload must be received.
+ * @param cb Size of the memory.
+ * @return Answer data, which must be freed. If the connection with the
+ * server has been lost, an answer with just the CL_OUT_OF_RESOURCES
+ * error code will be returned.
+ */
+static void* oclandSinkRequest(int *sockfd, unsigned int opcode, const void *msg, size_t *msgSize,
+                               size_t offset, void *ptr, size_t cb){
+    struct oclandHeader_st header;
+    struct oclandAnswer_st *answer = NULL;
+    struct oclandSink_st sink, **prev;
+    unsigned int i = serverIndex(sockfd);
+    if(i == servers->num_servers)
+        return answerData(NULL, msgSize);
+    newRequest(i, &header, opcode, *msgSize);
+    // The sink must be registered before the answer can arrive
+    sink.request_id = header.request_id;
+    sink.offset     = offset;
+    sink.ptr        = ptr;
+    sink.cb         = cb;
+    pthread_mutex_lock(&(servers->answers_mutex[i]));
+    sink.next         = servers->sinks[i];
+    servers->sinks[i] = &sink;
+    pthread_mutex_unlock(&(servers->answers_mutex[i]));
+    sendRequest(i, sockfd, &header, msg);
+    answer = waitAnswer(i, sockfd, header.request_id);
+    pthread_mutex_lock(&(servers->answers_mutex[i]));
+    for(prev=&(servers->sinks[i]);*prev;prev=&((*prev)->next)){
+        if(*prev == &sink){
+            *prev = sink.next;
+            break;
+        }
     }
-    // Lock the server
-    servers->locked[i] = CL_TRUE;
+    pthread_mutex_unlock(&(servers->answers_mutex[i]));
+    return answerData(answer, msgSize);
 }
 
-/** Unlock the server for other instances.
- * @param socket Server socket. You may lock the servers
- * in order to avoid parallel packages send/receive that can
- * arrive to the wrong method.
+/** Append a package to the batch of a server.
+ * @param i Server index.
+ * @param sockfd Server socket.
+ * @param header Package header. If OCLAND_FLAG_HANDLE is set, a new
+ * request identifier will be assigned to the package.
+ * @param msg Package data.
+ * @return CL_SUCCESS, or CL_OUT_OF_HOST_MEMORY if the batch can't be
+ * allocated.
  */
-void unlock(int socket){
-    unsigned int i;
-    // Find the server
-    for(i=0;i<servers->num_servers;i++){
-        if(servers->sockets[i] == socket)
+static cl_int batchPackage(unsigned int i, int *sockfd, struct oclandHeader_st *header, const void *msg){
+    size_t size = sizeof(struct oclandHeader_st) + header->length;
+    lockServer(i);
+    if(!servers->batch[i]){
+        servers->batch[i] = (char*)malloc(OCLAND_BATCH_SIZE);
+        if(!servers->batch[i]){
+            unlockServer(i);
+            return CL_OUT_OF_HOST_MEMORY;
+        }
+    }
+    if(servers->batch_size[i] + size > OCLAND_BATCH_SIZE)
+        flushBatch(i, sockfd);
+    if(header->flags & OCLAND_FLAG_HANDLE){
+        pthread_mutex_lock(&(servers->answers_mutex[i]));
+        header->request_id = servers->request_id[i]++;
+        pthread_mutex_unlock(&(servers->answers_mutex[i]));
+    }
+    memcpy(servers->batch[i] + servers->batch_size[i], header, sizeof(struct oclandHeader_st));
+    memcpy(servers->batch[i] + servers->batch_size[i] + sizeof(struct oclandHeader_st), msg, header->length);
+    servers->batch_size[i] += size;
+    unlockServer(i);
+    return CL_SUCCESS;
+}
+
+/** Queue a request which answer is not required, to be sent to the
+ * server in a batch with the next request (or when the batch becomes
+ * full). Errors will be deferred, and notified by the next
+ * synchronizing command (see oclandBatchError).
+ * @param sockfd Server socket.
+ * @param opcode Command index.
+ * @param msg Request data.
+ * @param msgSize Request data size.
+ * @return CL_SUCCESS, or the request error code if it has been sent
+ * without batching.
+ */
+static cl_int oclandBatchRequest(int *sockfd, unsigned int opcode, const void *msg, size_t msgSize){
+    struct oclandHeader_st header;
+    unsigned int i = serverIndex(sockfd);
+    if( (i == servers->num_servers) ||
+        (sizeof(struct oclandHeader_st) + msgSize > OCLAND_BATCH_SIZE) ){
+        // Send it as a regular request
+        void *answer = oclandRequest(sockfd, opcode, msg, &msgSize);
+        cl_int flag = ((cl_int*)answer)[0];
+        free(answer); answer=NULL;
+        return flag;
+    }
+    header.magic      = OCLAND_MAGIC;
+    header.version    = OCLAND_PROTOCOL_VERSION;
+    header.flags      = 0;
+    header.opcode     = opcode;
+    header.request_id = 0;
+    header.length     = msgSize;
+    return batchPackage(i, sockfd, &header, msg);
+}
+
+/** Send a request which creates an OpenCL object. The server answer
+ * must start with the error code, followed by the created object.
+ * If OCLAND_CLIENT_HANDLES is defined the request is queued in the
+ * server batch, and a client generated handle is returned without
+ * waiting for the server. The server will identify the object by such
+ * handle, and the creation errors will be reported when the object is
+ * used (as an invalid object), or by the next synchronizing command.
+ * @param sockfd Server socket.
+ * @param opcode Command index.
+ * @param msg Request data.
+ * @param msgSize Request data size.
+ * @param errcode_ret Returned error code.
+ * @return Created object, or its client generated handle. NULL if
+ * errors happened.
+ */
+static void* oclandHandleRequest(int *sockfd, unsigned int opcode, const void *msg, size_t msgSize, cl_int *errcode_ret){
+    void *object = NULL;
+    cl_int flag;
+    #if defined(OCLAND_CLIENT_HANDLES) && (UINTPTR_MAX > 0xFFFFFFFFu)
+        struct oclandHeader_st header;
+        unsigned int i = serverIndex(sockfd);
+        if( (i < servers->num_servers) &&
+            (sizeof(struct oclandHeader_st) + msgSize <= OCLAND_BATCH_SIZE) ){
+            header.magic      = OCLAND_MAGIC;
+            header.version    = OCLAND_PROTOCOL_VERSION;
+            header.flags      = OCLAND_FLAG_HANDLE;
+            header.opcode     = opcode;
+            header.request_id = 0;
+            header.length     = msgSize;
+            flag = batchPackage(i, sockfd, &header, msg);
+            if(errcode_ret) *errcode_ret = flag;
+            if(flag != CL_SUCCESS)
+                return NULL;
+            return (void*)(uintptr_t)OCLAND_HANDLE(header.request_id);
+        }
+    #endif
+    void *answer = oclandRequest(sockfd, opcode, msg, &msgSize);
+    flag = ((cl_int*)answer)[0];
+    if(flag == CL_SUCCESS)
+        object = ((void**)((cl_int*)answer + 1))[0];
+    free(answer); answer=NULL;
+    if(errcode_ret) *errcode_ret = flag;
+    return object;
+}
+
+/** Returns the first error reported by the batches sent to a server,
+ * which has not been notified yet. OpenCL allows to report the errors
+ * of the queued commands in the synchronizing commands, so this method
+ * should be called by clFlush, clFinish and clWaitForEvents.
+ * @param sockfd Server socket.
+ * @return First deferred error, CL_SUCCESS if no errors have been
+ * reported.
+ */
+static cl_int oclandBatchError(int *sockfd){
+    cl_int flag = CL_SUCCESS;
+    unsigned int i = serverIndex(sockfd);
+    if(i == servers->num_servers)
+        return CL_SUCCESS;
+    pthread_mutex_lock(&(servers->answers_mutex[i]));
+    flag = servers->batch_error[i];
+    servers->batch_error[i] = CL_SUCCESS;
+    pthread_mutex_unlock(&(servers->answers_mutex[i]));
+    return flag;
+}
+
+/** Thread that calls the notification function of a finished build.
+ * @param data Build notification, which is destroyed.
+ * @return NULL
+ */
+static void *notify_thread(void *data)
+{
+    struct oclandNotify_st *n = (struct oclandNotify_st*)data;
+    n->pfn_notify(n->program, n->user_data);
+    free(n);
+    return NULL;
+}
+
+/** Call the notification function of a finished build. The user code
+ * is not executed by the data channel receiver thread, which would be
+ * blocked meanwhile.
+ * @param n Build notification, which is destroyed.
+ */
+static void launchNotify(struct oclandNotify_st *n)
+{
+    pthread_t thread;
+    if(pthread_create(&thread, NULL, notify_thread, (void *)n)){
+        notify_thread((void *)n);
+        return;
+    }
+    pthread_detach(thread);
+}
+
+/** Thread that receives the data sent by a server through its data
+ * channel, storing it in the memory of the matching read transfer, or
+ * notifying the matching build.
+ * @param data Data channel.
+ * @return NULL
+ */
+static void *channel_thread(void *data)
+{
+    char buffer[BUFF_SIZE];
+    struct oclandChannel_st *c = (struct oclandChannel_st*)data;
+    struct oclandHeader_st header;
+    struct oclandTransfer_st *t, **prev;
+    struct oclandNotify_st *n, **prev_n, *notifies;
+    cl_int flag;
+    int fd = c->socket;
+    while(RecvHeader(&fd, &header, MSG_WAITALL) == sizeof(struct oclandHeader_st)){
+        // Look for the transfer, or the build notification
+        n = NULL;
+        pthread_mutex_lock(&(c->mutex));
+        for(t=c->transfers;t;t=t->next){
+            if(t->request_id == header.request_id)
+                break;
+        }
+        if(!t && (header.length == sizeof(cl_int))){
+            for(prev_n=&(c->notifies);*prev_n;prev_n=&((*prev_n)->next)){
+                if((*prev_n)->request_id == header.request_id){
+                    n = *prev_n;
+                    *prev_n = n->next;
+                    break;
+                }
+            }
+        }
+        pthread_mutex_unlock(&(c->mutex));
+        if(n){
+            // The build has finished. Its error code is not passed to the
+            // user, who should query the build status of the program
+            if(Recv(&fd, &flag, sizeof(cl_int), MSG_WAITALL) != sizeof(cl_int)){
+                launchNotify(n);
+                break;
+            }
+            launchNotify(n);
+            continue;
+        }
+        if(!t || (header.length > t->cb - t->received)){
+            // Nobody is expecting this data, discard it
+            printf("WARNING: Unexpected data received in the data channel (request %u)\n", header.request_id); fflush(stdout);
+            uint64_t remaining = header.length;
+            while(remaining){
+                size_t n = (remaining > BUFF_SIZE) ? BUFF_SIZE : (size_t)remaining;
+                if(Recv(&fd, buffer, n, MSG_WAITALL) != (ssize_t)n)
+                    break;
+                remaining -= n;
+            }
+            if(remaining)
+                break;
+            continue;
+        }
+        // The server only sends the data of the succeeded requests, so
+        // nobody else will remove the transfer meanwhile. Large data is
+        // received in several chunks
+        if(header.length && (Recv(&fd, (char*)t->ptr + t->received, header.length, MSG_WAITALL) != (ssize_t)header.length))
+            break;
+        t->received += header.length;
+        if(t->received < t->cb)
+            continue;
+        pthread_mutex_lock(&(c->mutex));
+        for(prev=&(c->transfers);*prev;prev=&((*prev)->next)){
+            if(*prev == t){
+                *prev = t->next;
+                break;
+            }
+        }
+        free(t);
+        pthread_cond_broadcast(&(c->cond));
+        pthread_mutex_unlock(&(c->mutex));
+    }
+    // Connection lost, the pending transfers will never be received
+    printf("ERROR: The data channel has been lost\n"); fflush(stdout);
+    pthread_mutex_lock(&(c->mutex));
+    while(c->transfers){
+        t = c->transfers;
+        c->transfers = t->next;
+        free(t);
+    }
+    notifies = c->notifies;
+    c->notifies = NULL;
+    close(c->socket);
+    c->socket = -1;
+    pthread_cond_broadcast(&(c->cond));
+    pthread_mutex_unlock(&(c->mutex));
+    // The builds will never be notified by the server, so the users are
+    // notified now, and they will find the programs not built
+    while(notifies){
+        n = notifies;
+        notifies = n->next;
+        launchNotify(n);
+    }
+    return NULL;
+}
+
+/** Open the data channel of a server, if it is not already opened. The
+ * server provides a token, which is sent through a new connection in
+ * order to attach it to this session.
+ * @param sockfd Server socket.
+ * @return CL_SUCCESS if the data channel is opened, an error code
+ * otherwise. In such case the transfers must be blocking ones.
+ */
+static cl_int openChannel(int *sockfd)
+{
+    int switch_on  = 1;
+    struct oclandHeader_st header;
+    struct sockaddr_in serv_addr;
+    pthread_t thread;
+    uint64_t token;
+    unsigned int i = serverIndex(sockfd);
+    if(i == servers->num_servers)
+        return CL_INVALID_VALUE;
+    struct oclandChannel_st *c = &(servers->channels[i]);
+    pthread_mutex_lock(&(c->mutex));
+    if(c->socket >= 0){
+        pthread_mutex_unlock(&(c->mutex));
+        return CL_SUCCESS;
+    }
+    if(c->unavailable){
+        pthread_mutex_unlock(&(c->mutex));
+        return CL_OUT_OF_RESOURCES;
+    }
+    // Ask for the token
+    size_t msgSize = 0;
+    void *answer = oclandRequest(sockfd, ocland_channelToken, NULL, &msgSize);
+    cl_int flag = ((cl_int*)answer)[0];
+    if((flag == CL_SUCCESS) && (msgSize < sizeof(cl_int) + sizeof(uint64_t)))
+        flag = CL_OUT_OF_RESOURCES;
+    if(flag == CL_SUCCESS)
+        memcpy(&token, (cl_int*)answer + 1, sizeof(uint64_t));
+    free(answer); answer=NULL;
+    // Connect to the server, and attach the connection to the session
+    int fd = -1;
+    if(flag == CL_SUCCESS){
+        flag = CL_OUT_OF_RESOURCES;
+        memset(&serv_addr, '0', sizeof(serv_addr));
+        serv_addr.sin_family = AF_INET;
+        serv_addr.sin_port   = htons(OCLAND_PORT);
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        if( (fd >= 0) &&
+            (inet_pton(AF_INET, servers->address[i], &serv_addr.sin_addr) > 0) &&
+            (connect(fd, (struct sockaddr *)&serv_addr, sizeof(serv_addr)) >= 0) ){
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, (char *) &switch_on, sizeof(int));
+            header.magic      = OCLAND_MAGIC;
+            header.version    = OCLAND_PROTOCOL_VERSION;
+            header.flags      = 0;
+            header.opcode     = ocland_channelAttach;
+            header.request_id = 0;
+            header.length     = sizeof(uint64_t);
+            if( (SendPackage(&fd, &header, &token) == sizeof(uint64_t)) &&
+                (RecvHeader(&fd, &header, MSG_WAITALL) == sizeof(struct oclandHeader_st)) &&
+                (header.length == sizeof(cl_int)) ){
+                if(Recv(&fd, &flag, sizeof(cl_int), MSG_WAITALL) != sizeof(cl_int))
+                    flag = CL_OUT_OF_RESOURCES;
+            }
+        }
+    }
+    if(flag == CL_SUCCESS){
+        c->socket = fd;
+        if(pthread_create(&thread, NULL, channel_thread, (void *)c)){
+            c->socket = -1;
+            flag = CL_OUT_OF_RESOURCES;
+        }
+        else{
+            pthread_detach(thread);
+        }
+    }
+    if(flag != CL_SUCCESS){
+        printf("WARNING: The data channel can't be opened with %s, the transfers will be blocking ones\n", servers->address[i]); fflush(stdout);
+        if(fd >= 0)
+            close(fd);
+        c->unavailable = CL_TRUE;
+    }
+    pthread_mutex_unlock(&(c->mutex));
+    return flag;
+}
+
+/** Send a request which starts an asynchronous transfer, and wait for
+ * its answer. The answer must start with the error code, followed by
+ * the event associated with the transfer.
+ * @param sockfd Server socket.
+ * @param opcode Command index.
+ * @param msg Request data.
+ * @param msgSize Request data size. The answer data size will be
+ * returned here.
+ * @param command_queue Command queue where the transfer is enqueued.
+ * @param ptr Memory where the data will be received, NULL if the data
+ * will be sent to the server (see channelSend).
+ * @param cb Size of the data.
+ * @param request_id Identifier of the request, which will tag the data
+ * in the data channel.
+ * @return Answer data, which must be freed.
+ * @note openChannel must be called before.
+ */
+static void* oclandTransferRequest(int *sockfd, unsigned int opcode, const void *msg, size_t *msgSize,
+                                   cl_command_queue command_queue, void *ptr, size_t cb, uint32_t *request_id){
+    struct oclandHeader_st header;
+    struct oclandAnswer_st *answer = NULL;
+    struct oclandTransfer_st *t, **prev;
+    unsigned int i = serverIndex(sockfd);
+    if(i == servers->num_servers)
+        return answerData(NULL, msgSize);
+    struct oclandChannel_st *c = &(servers->channels[i]);
+    newRequest(i, &header, opcode, *msgSize);
+    *request_id = header.request_id;
+    if(ptr){
+        // The transfer must be registered before the server can send
+        // the data
+        t = (struct oclandTransfer_st*)malloc(sizeof(struct oclandTransfer_st));
+        if(!t)
+            return answerData(NULL, msgSize);
+        t->request_id    = header.request_id;
+        t->ptr           = ptr;
+        t->cb            = cb;
+        t->received      = 0;
+        t->command_queue = command_queue;
+        t->event         = NULL;
+        pthread_mutex_lock(&(c->mutex));
+        t->next      = c->transfers;
+        c->transfers = t;
+        pthread_mutex_unlock(&(c->mutex));
+    }
+    sendRequest(i, sockfd, &header, msg);
+    answer = waitAnswer(i, sockfd, header.request_id);
+    if(ptr){
+        // Look for the transfer, which may have been already received
+        pthread_mutex_lock(&(c->mutex));
+        for(prev=&(c->transfers);*prev;prev=&((*prev)->next)){
+            if((*prev)->request_id == header.request_id)
+                break;
+        }
+        t = *prev;
+        if(t){
+            if( !answer ||
+                (answer->size < sizeof(cl_int) + sizeof(cl_event)) ||
+                (((cl_int*)answer->msg)[0] != CL_SUCCESS) ){
+                // The data will never be sent
+                *prev = t->next;
+                free(t);
+                pthread_cond_broadcast(&(c->cond));
+            }
+            else{
+                t->event = ((cl_event*)((cl_int*)answer->msg + 1))[0];
+            }
+        }
+        pthread_mutex_unlock(&(c->mutex));
+    }
+    return answerData(answer, msgSize);
+}
+
+/** Send a request which starts an asynchronous build, and wait for its
+ * answer. The answer must start with the error code. When the build
+ * finishes, the server sends its error code through the data channel,
+ * and the notification function is called.
+ * @param sockfd Server socket.
+ * @param opcode Command index.
+ * @param msg Request data.
+ * @param msgSize Request data size. The answer data size will be
+ * returned here.
+ * @param program Program passed to the notification function.
+ * @param pfn_notify Notification function.
+ * @param user_data User data passed to the notification function.
+ * @return Answer data, which must be freed. If the build has been
+ * notified anyway (the data channel has been lost meanwhile), an
+ * answer with just the CL_SUCCESS error code is returned.
+ * @note openChannel must be called before.
+ */
+static void* oclandNotifyRequest(int *sockfd, unsigned int opcode, const void *msg, size_t *msgSize,
+                                 cl_program program,
+                                 void (CL_CALLBACK *pfn_notify)(cl_program, void*),
+                                 void *user_data){
+    struct oclandHeader_st header;
+    struct oclandAnswer_st *answer = NULL;
+    struct oclandNotify_st *n, **prev;
+    void *data;
+    unsigned int i = serverIndex(sockfd);
+    if(i == servers->num_servers)
+        return answerData(NULL, msgSize);
+    struct oclandChannel_st *c = &(servers->channels[i]);
+    // The notification must be registered before the server can send
+    // the result of the build
+    n = (struct oclandNotify_st*)malloc(sizeof(struct oclandNotify_st));
+    if(!n)
+        return answerData(NULL, msgSize);
+    newRequest(i, &header, opcode, *msgSize);
+    n->request_id = header.request_id;
+    n->program    = program;
+    n->pfn_notify = pfn_notify;
+    n->user_data  = user_data;
+    pthread_mutex_lock(&(c->mutex));
+    n->next     = c->notifies;
+    c->notifies = n;
+    pthread_mutex_unlock(&(c->mutex));
+    sendRequest(i, sockfd, &header, msg);
+    answer = waitAnswer(i, sockfd, header.request_id);
+    if( answer &&
+        (answer->size >= sizeof(cl_int)) &&
+        (((cl_int*)answer->msg)[0] == CL_SUCCESS) )
+        return answerData(answer, msgSize);
+    // The build will never be notified by the server
+    pthread_mutex_lock(&(c->mutex));
+    for(prev=&(c->notifies);*prev;prev=&((*prev)->next)){
+        if(*prev == n)
             break;
     }
-    if(i == servers->num_servers){
-        // Server not found
+    if(*prev)
+        *prev = n->next;
+    else
+        n = NULL;
+    pthread_mutex_unlock(&(c->mutex));
+    data = answerData(answer, msgSize);
+    if(n){
+        free(n);
+        return data;
+    }
+    // Already notified
+    free(data);
+    *msgSize = sizeof(cl_int);
+    data = malloc(*msgSize);
+    ((cl_int*)data)[0] = CL_SUCCESS;
+    return data;
+}
+
+/** Send data to a server through its data channel. Large data is split
+ * in packages of OCLAND_TRANSFER_CHUNK bytes, so the server can start
+ * writing it in the device before receiving everything, and the
+ * transfers sent at the same time are interleaved.
+ * @param i Server index.
+ * @param opcode Command index of the request which started the
+ * transfer.
+ * @param request_id Identifier of the request which started the
+ * transfer.
+ * @param ptr Data to send.
+ * @param cb Size of the data.
+ * @return Number of data bytes sent, -1 if errors happened.
+ */
+static ssize_t channelSend(unsigned int i, uint32_t opcode, uint32_t request_id, const void *ptr, size_t cb){
+    struct oclandHeader_st header;
+    struct oclandChannel_st *c = &(servers->channels[i]);
+    ssize_t sent;
+    header.magic      = OCLAND_MAGIC;
+    header.version    = OCLAND_PROTOCOL_VERSION;
+    header.flags      = 0;
+    header.opcode     = opcode;
+    header.request_id = request_id;
+    pthread_mutex_lock(&(c->mutex));
+    int fd = c->socket;
+    pthread_mutex_unlock(&(c->mutex));
+    if(fd < 0)
+        return -1;
+    // At least one package is sent, even if there is no data
+    size_t offset = 0;
+    do{
+        size_t n = cb - offset;
+        if(n > OCLAND_TRANSFER_CHUNK)
+            n = OCLAND_TRANSFER_CHUNK;
+        header.length = n;
+        pthread_mutex_lock(&(c->send_mutex));
+        sent = SendPackage(&fd, &header, (const char*)ptr + offset);
+        pthread_mutex_unlock(&(c->send_mutex));
+        if(sent != (ssize_t)n)
+            return -1;
+        offset += n;
+    } while(offset < cb);
+    return (ssize_t)offset;
+}
+
+/** Wait until the pending read transfers of a command queue, or the
+ * ones associated with a list of events, have been received. The server
+ * completes the transfer events when the data is sent, but the data may
+ * be still arriving.
+ * @param sockfd Server socket.
+ * @param command_queue Command queue, NULL if the transfers should be
+ * selected by their events.
+ * @param num_events Number of events.
+ * @param event_list List of events.
+ */
+static void waitTransfers(int *sockfd, cl_command_queue command_queue, cl_uint num_events, const cl_event *event_list){
+    struct oclandTransfer_st *t;
+    cl_uint j;
+    unsigned int i = serverIndex(sockfd);
+    if(i == servers->num_servers)
         return;
+    struct oclandChannel_st *c = &(servers->channels[i]);
+    pthread_mutex_lock(&(c->mutex));
+    while(1){
+        for(t=c->transfers;t;t=t->next){
+            if(command_queue && (t->command_queue == command_queue))
+                break;
+            for(j=0;j<num_events;j++){
+                if(t->event && (t->event == event_list[j]))
+                    break;
+            }
+            if(j < num_events)
+                break;
+        }
+        if(!t)
+            break;
+        pthread_cond_wait(&(c->cond), &(c->mutex));
     }
-    // Unlock the server
-    servers->locked[i] = CL_FALSE;
+    pthread_mutex_unlock(&(c->mutex));
 }
 
 /** Load servers file "ocland". File must contain
@@ -177,7 +1025,21 @@ unsigned int loadServers()
     servers->num_servers = 0;
     servers->address = NULL;
     servers->sockets = NULL;
-    servers->locked  = NULL;
+    servers->send_mutex    = NULL;
+    servers->send_cond     = NULL;
+    servers->send_ticket   = NULL;
+    servers->send_serving  = NULL;
+    servers->request_id    = NULL;
+    servers->answers       = NULL;
+    servers->receiving     = NULL;
+    servers->answers_mutex = NULL;
+    servers->answers_cond  = NULL;
+    servers->batch         = NULL;
+    servers->batch_size    = NULL;
+    servers->batch_error   = NULL;
+    servers->sinks         = NULL;
+    servers->channels      = NULL;
+    servers->info          = NULL;
     // Load servers definition files
     FILE *fin = NULL;
     fin = fopen("ocland", "r");
@@ -199,7 +1061,21 @@ unsigned int loadServers()
     rewind(fin);
     servers->address = (char**)malloc(servers->num_servers*sizeof(char*));
     servers->sockets = (int*)malloc(servers->num_servers*sizeof(int));
-    servers->locked  = (cl_bool*)malloc(servers->num_servers*sizeof(cl_bool));
+    servers->send_mutex    = (pthread_mutex_t*)malloc(servers->num_servers*sizeof(pthread_mutex_t));
+    servers->send_cond     = (pthread_cond_t*)malloc(servers->num_servers*sizeof(pthread_cond_t));
+    servers->send_ticket   = (unsigned long*)malloc(servers->num_servers*sizeof(unsigned long));
+    servers->send_serving  = (unsigned long*)malloc(servers->num_servers*sizeof(unsigned long));
+    servers->request_id    = (uint32_t*)malloc(servers->num_servers*sizeof(uint32_t));
+    servers->answers       = (struct oclandAnswer_st**)malloc(servers->num_servers*sizeof(struct oclandAnswer_st*));
+    servers->receiving     = (cl_bool*)malloc(servers->num_servers*sizeof(cl_bool));
+    servers->answers_mutex = (pthread_mutex_t*)malloc(servers->num_servers*sizeof(pthread_mutex_t));
+    servers->answers_cond  = (pthread_cond_t*)malloc(servers->num_servers*sizeof(pthread_cond_t));
+    servers->batch         = (char**)malloc(servers->num_servers*sizeof(char*));
+    servers->batch_size    = (size_t*)malloc(servers->num_servers*sizeof(size_t));
+    servers->batch_error   = (cl_int*)malloc(servers->num_servers*sizeof(cl_int));
+    servers->sinks         = (struct oclandSink_st**)malloc(servers->num_servers*sizeof(struct oclandSink_st*));
+    servers->channels      = (struct oclandChannel_st*)malloc(servers->num_servers*sizeof(struct oclandChannel_st));
+    servers->info          = (hash_table*)malloc(servers->num_servers*sizeof(hash_table));
     i = 0;
     line = NULL;linelen = 0;
     while((read = getline(&line, &linelen, fin)) != -1) {
@@ -211,7 +1087,27 @@ unsigned int loadServers()
         strcpy(servers->address[i], line);
         strcpy(strstr(servers->address[i], "\n"), "");
         servers->sockets[i] = -1;
-        servers->locked[i]  = CL_FALSE;
+        pthread_mutex_init(&(servers->send_mutex[i]), NULL);
+        pthread_cond_init(&(servers->send_cond[i]), NULL);
+        servers->send_ticket[i]  = 0;
+        servers->send_serving[i] = 0;
+        servers->request_id[i] = 0;
+        servers->answers[i]    = NULL;
+        servers->receiving[i]  = CL_FALSE;
+        pthread_mutex_init(&(servers->answers_mutex[i]), NULL);
+        pthread_cond_init(&(servers->answers_cond[i]), NULL);
+        servers->batch[i]       = NULL;
+        servers->batch_size[i]  = 0;
+        servers->batch_error[i] = CL_SUCCESS;
+        servers->sinks[i]       = NULL;
+        servers->channels[i].socket      = -1;
+        servers->channels[i].unavailable = CL_FALSE;
+        servers->channels[i].transfers   = NULL;
+        servers->channels[i].notifies    = NULL;
+        pthread_mutex_init(&(servers->channels[i].mutex), NULL);
+        pthread_mutex_init(&(servers->channels[i].send_mutex), NULL);
+        pthread_cond_init(&(servers->channels[i].cond), NULL);
+        servers->info[i] = NULL;
         free(line); line = NULL;linelen = 0;
         i++;
     }
@@ -284,6 +1180,293 @@ unsigned int oclandInit()
     return connectServers();
 }
 
+/// Mutex protecting the info stored by the client
+static pthread_mutex_t info_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/// Hash table key of a platform, device or context
+#define INFO_KEY(object) ((uint64_t)(uintptr_t)(object))
+
+/// Platforms info requested in bulk when the platforms are enumerated
+static const cl_uint platform_params[] = {
+    CL_PLATFORM_PROFILE,
+    CL_PLATFORM_VERSION,
+    CL_PLATFORM_NAME,
+    CL_PLATFORM_VENDOR,
+    CL_PLATFORM_EXTENSIONS
+};
+
+/// Devices info requested in bulk when the devices are enumerated
+static const cl_uint device_params[] = {
+    CL_DEVICE_TYPE,
+    CL_DEVICE_VENDOR_ID,
+    CL_DEVICE_MAX_COMPUTE_UNITS,
+    CL_DEVICE_MAX_WORK_ITEM_DIMENSIONS,
+    CL_DEVICE_MAX_WORK_GROUP_SIZE,
+    CL_DEVICE_MAX_WORK_ITEM_SIZES,
+    CL_DEVICE_PREFERRED_VECTOR_WIDTH_CHAR,
+    CL_DEVICE_PREFERRED_VECTOR_WIDTH_SHORT,
+    CL_DEVICE_PREFERRED_VECTOR_WIDTH_INT,
+    CL_DEVICE_PREFERRED_VECTOR_WIDTH_LONG,
+    CL_DEVICE_PREFERRED_VECTOR_WIDTH_FLOAT,
+    CL_DEVICE_PREFERRED_VECTOR_WIDTH_DOUBLE,
+    CL_DEVICE_PREFERRED_VECTOR_WIDTH_HALF,
+    CL_DEVICE_NATIVE_VECTOR_WIDTH_CHAR,
+    CL_DEVICE_NATIVE_VECTOR_WIDTH_SHORT,
+    CL_DEVICE_NATIVE_VECTOR_WIDTH_INT,
+    CL_DEVICE_NATIVE_VECTOR_WIDTH_LONG,
+    CL_DEVICE_NATIVE_VECTOR_WIDTH_FLOAT,
+    CL_DEVICE_NATIVE_VECTOR_WIDTH_DOUBLE,
+    CL_DEVICE_NATIVE_VECTOR_WIDTH_HALF,
+    CL_DEVICE_MAX_CLOCK_FREQUENCY,
+    CL_DEVICE_ADDRESS_BITS,
+    CL_DEVICE_MAX_READ_IMAGE_ARGS,
+    CL_DEVICE_MAX_WRITE_IMAGE_ARGS,
+    CL_DEVICE_MAX_MEM_ALLOC_SIZE,
+    CL_DEVICE_IMAGE2D_MAX_WIDTH,
+    CL_DEVICE_IMAGE2D_MAX_HEIGHT,
+    CL_DEVICE_IMAGE3D_MAX_WIDTH,
+    CL_DEVICE_IMAGE3D_MAX_HEIGHT,
+    CL_DEVICE_IMAGE3D_MAX_DEPTH,
+    CL_DEVICE_IMAGE_MAX_BUFFER_SIZE,
+    CL_DEVICE_IMAGE_MAX_ARRAY_SIZE,
+    CL_DEVICE_IMAGE_SUPPORT,
+    CL_DEVICE_MAX_PARAMETER_SIZE,
+    CL_DEVICE_MAX_SAMPLERS,
+    CL_DEVICE_MEM_BASE_ADDR_ALIGN,
+    CL_DEVICE_MIN_DATA_TYPE_ALIGN_SIZE,
+    CL_DEVICE_SINGLE_FP_CONFIG,
+    CL_DEVICE_DOUBLE_FP_CONFIG,
+    CL_DEVICE_GLOBAL_MEM_CACHE_TYPE,
+    CL_DEVICE_GLOBAL_MEM_CACHELINE_SIZE,
+    CL_DEVICE_GLOBAL_MEM_CACHE_SIZE,
+    CL_DEVICE_GLOBAL_MEM_SIZE,
+    CL_DEVICE_MAX_CONSTANT_BUFFER_SIZE,
+    CL_DEVICE_MAX_CONSTANT_ARGS,
+    CL_DEVICE_LOCAL_MEM_TYPE,
+    CL_DEVICE_LOCAL_MEM_SIZE,
+    CL_DEVICE_ERROR_CORRECTION_SUPPORT,
+    CL_DEVICE_HOST_UNIFIED_MEMORY,
+    CL_DEVICE_PROFILING_TIMER_RESOLUTION,
+    CL_DEVICE_ENDIAN_LITTLE,
+    CL_DEVICE_AVAILABLE,
+    CL_DEVICE_COMPILER_AVAILABLE,
+    CL_DEVICE_LINKER_AVAILABLE,
+    CL_DEVICE_EXECUTION_CAPABILITIES,
+    CL_DEVICE_QUEUE_PROPERTIES,
+    CL_DEVICE_BUILT_IN_KERNELS,
+    CL_DEVICE_PLATFORM,
+    CL_DEVICE_NAME,
+    CL_DEVICE_VENDOR,
+    CL_DEVICE_DRIVER_VERSION,
+    CL_DEVICE_PROFILE,
+    CL_DEVICE_VERSION,
+    CL_DEVICE_OPENCL_C_VERSION,
+    CL_DEVICE_EXTENSIONS,
+    CL_DEVICE_PRINTF_BUFFER_SIZE,
+    CL_DEVICE_PREFERRED_INTEROP_USER_SYNC,
+    CL_DEVICE_PARENT_DEVICE,
+    CL_DEVICE_PARTITION_MAX_SUB_DEVICES,
+    CL_DEVICE_PARTITION_PROPERTIES,
+    CL_DEVICE_PARTITION_AFFINITY_DOMAIN,
+    CL_DEVICE_PARTITION_TYPE
+};
+
+/** Test if an info of a platform, device or context never changes, so
+ * it can be stored by the client.
+ * @param param_name Info name.
+ * @return CL_TRUE if the info can be stored, CL_FALSE otherwise.
+ */
+static cl_bool isImmutableInfo(cl_uint param_name)
+{
+    return (param_name != CL_DEVICE_REFERENCE_COUNT) &&
+           (param_name != CL_CONTEXT_REFERENCE_COUNT);
+}
+
+/** Store an info of a platform, device or context answered by a server.
+ * Already stored info is not modified.
+ * @param i Server index.
+ * @param object Platform, device or context.
+ * @param param_name Info name.
+ * @param flag Error code returned by the server.
+ * @param size Size of the info.
+ * @param value Info value.
+ */
+static void storeInfo(unsigned int i, const void *object, cl_uint param_name,
+                      cl_int flag, size_t size, const void *value)
+{
+    struct oclandInfo_st *info, *first = NULL;
+    pthread_mutex_lock(&info_mutex);
+    if(!servers->info[i])
+        servers->info[i] = createHashTable();
+    if(!servers->info[i]){
+        pthread_mutex_unlock(&info_mutex);
+        return;
+    }
+    hashTableFind(servers->info[i], INFO_KEY(object), (void**)&first);
+    for(info=first;info;info=info->next){
+        if(info->param_name == param_name){
+            pthread_mutex_unlock(&info_mutex);
+            return;
+        }
+    }
+    info = (struct oclandInfo_st*)malloc(sizeof(struct oclandInfo_st) + size);
+    if(!info){
+        pthread_mutex_unlock(&info_mutex);
+        return;
+    }
+    info->param_name = param_name;
+    info->flag       = flag;
+    info->size       = size;
+    info->value      = (void*)(info + 1);
+    info->next       = first;
+    memcpy(info->value, value, size);
+    if(hashTableInsert(servers->info[i], INFO_KEY(object), info))
+        free(info);
+    pthread_mutex_unlock(&info_mutex);
+}
+
+/** Answer an info of a platform, device or context already stored by
+ * the client, with the same semantics than clGet*Info.
+ * @param i Server index.
+ * @param object Platform, device or context.
+ * @param param_name Info name.
+ * @param param_value_size Size of param_value.
+ * @param param_value Memory where the info must be copied. Can be NULL.
+ * @param param_value_size_ret Size of the info. Can be NULL.
+ * @param flag Error code of the answer.
+ * @return CL_TRUE if the info has been answered, CL_FALSE if it is not
+ * stored.
+ */
+static cl_bool loadInfo(unsigned int i, const void *object, cl_uint param_name,
+                        size_t param_value_size, void *param_value,
+                        size_t *param_value_size_ret, cl_int *flag)
+{
+    struct oclandInfo_st *info = NULL;
+    cl_bool found = CL_FALSE;
+    pthread_mutex_lock(&info_mutex);
+    if(servers->info[i])
+        hashTableFind(servers->info[i], INFO_KEY(object), (void**)&info);
+    for(;info;info=info->next){
+        if(info->param_name != param_name)
+            continue;
+        found = CL_TRUE;
+        *flag = info->flag;
+        if(info->flag != CL_SUCCESS)
+            break;
+        if(param_value && (param_value_size < info->size)){
+            *flag = CL_INVALID_VALUE;
+            break;
+        }
+        if(param_value)
+            memcpy(param_value, info->value, info->size);
+        if(param_value_size_ret)
+            *param_value_size_ret = info->size;
+        break;
+    }
+    pthread_mutex_unlock(&info_mutex);
+    return found;
+}
+
+/** Discard the info stored for an object which has been released, so
+ * it is not answered if the server reuses the object address.
+ * @param object Device or context.
+ */
+static void forgetInfo(const void *object)
+{
+    unsigned int i;
+    struct oclandInfo_st *info, *next;
+    pthread_mutex_lock(&info_mutex);
+    for(i=0;i<servers->num_servers;i++){
+        info = NULL;
+        if(!servers->info[i] ||
+           !hashTableRemove(servers->info[i], INFO_KEY(object), (void**)&info))
+            continue;
+        while(info){
+            next = info->next;
+            free(info);
+            info = next;
+        }
+    }
+    pthread_mutex_unlock(&info_mutex);
+}
+
+/** Request in bulk the info of several platforms or devices which never
+ * changes, storing it. The objects which info was already stored are
+ * not requested again.
+ * @param i Server index.
+ * @param kind OCLAND_INFO_PLATFORM or OCLAND_INFO_DEVICE.
+ * @param num_objects Number of objects.
+ * @param objects Platforms or devices of the server.
+ * @param num_params Number of info of each object.
+ * @param params Info names.
+ */
+static void prefetchInfo(unsigned int i, cl_uint kind, cl_uint num_objects,
+                         void* const* objects, cl_uint num_params,
+                         const cl_uint *params)
+{
+    cl_uint j, k, n = 0;
+    // The server rejects the too large requests
+    if(num_objects > OCLAND_INFO_MAX){
+        prefetchInfo(i, kind, OCLAND_INFO_MAX, objects, num_params, params);
+        prefetchInfo(i, kind, num_objects - OCLAND_INFO_MAX,
+                     objects + OCLAND_INFO_MAX, num_params, params);
+        return;
+    }
+    if(!num_objects || (num_params > OCLAND_INFO_MAX))
+        return;
+    size_t msgSize  = 3*sizeof(cl_uint);           // kind, num_objects, num_params
+    msgSize        += num_objects*sizeof(void*);   // objects
+    msgSize        += num_params*sizeof(cl_uint);  // params
+    void* msg = (void*)malloc(msgSize);
+    if(!msg)
+        return;
+    void* ptr = (cl_uint*)msg + 3;
+    // Skip the objects already stored
+    pthread_mutex_lock(&info_mutex);
+    for(j=0;j<num_objects;j++){
+        if(servers->info[i] && hashTableFind(servers->info[i], INFO_KEY(objects[j]), NULL))
+            continue;
+        ((void**)ptr)[n++] = objects[j];
+    }
+    pthread_mutex_unlock(&info_mutex);
+    if(!n){
+        free(msg); msg=NULL;
+        return;
+    }
+    ((cl_uint*)msg)[0] = kind;
+    ((cl_uint*)msg)[1] = n;
+    ((cl_uint*)msg)[2] = num_params;
+    memcpy((void**)ptr + n, params, num_params*sizeof(cl_uint));
+    msgSize -= (num_objects - n)*sizeof(void*);
+    // Send the package, and wait for the answer
+    int *sockfd = &(servers->sockets[i]);
+    void *answer = oclandRequest(sockfd, ocland_prefetchInfo, msg, &msgSize);
+    // Decript the data
+    size_t offset = sizeof(cl_int);
+    if((msgSize < offset) || (((cl_int*)answer)[0] != CL_SUCCESS)){
+        free(msg); msg=NULL;
+        free(answer); answer=NULL;
+        return;
+    }
+    for(j=0;j<n;j++){
+        for(k=0;k<num_params;k++){
+            cl_int flag;
+            size_t size;
+            if(msgSize - offset < sizeof(cl_int) + sizeof(size_t))
+                break;
+            memcpy(&flag, (char*)answer + offset, sizeof(cl_int)); offset += sizeof(cl_int);
+            memcpy(&size, (char*)answer + offset, sizeof(size_t)); offset += sizeof(size_t);
+            if(msgSize - offset < size)
+                break;
+            if((flag != CL_INVALID_PLATFORM) && (flag != CL_INVALID_DEVICE))
+                storeInfo(i, ((void**)ptr)[j], params[k], flag, size, (char*)answer + offset);
+            offset += size;
+        }
+    }
+    free(msg); msg=NULL;
+    free(answer); answer=NULL;
+}
+
 cl_int oclandGetPlatformIDs(cl_uint         num_entries,
                             cl_platform_id* platforms,
                             cl_uint*        num_platforms)
@@ -307,29 +1490,19 @@ cl_int oclandGetPlatformIDs(cl_uint         num_entries,
         // in order to accelerate as much as possible
         // the data transmission, requesting only one
         // connection to send, and another one to receive
-        size_t msgSize  = sizeof(unsigned int);  // Command index
-        msgSize        += sizeof(cl_uint);       // num_entries
+        size_t msgSize  = sizeof(cl_uint);       // num_entries
         void* msg = (void*)malloc(msgSize);
         void* ptr = msg;
-        ((unsigned int*)ptr)[0] = ocland_clGetPlatformIDs; ptr = (unsigned int*)ptr + 1;
         ((cl_uint*)ptr)[0]      = r_num_entries;
-        // Send the package (first the size, and then the data)
-        lock(servers->sockets[i]);
+        // Send the package, and wait for the answer
         int *sockfd = &(servers->sockets[i]);
-        Send(sockfd, &msgSize, sizeof(size_t), 0);
-        Send(sockfd, msg, msgSize, 0);
-        free(msg); msg=NULL;
-        // Receive the package (first size, and then data)
-        Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-        msg = (void*)malloc(msgSize);
+        void *answer = oclandRequest(sockfd, ocland_clGetPlatformIDs, msg, &msgSize);
+        free(msg); msg=answer;
         ptr = msg;
-        Recv(sockfd, msg, msgSize, MSG_WAITALL);
-        unlock(servers->sockets[i]);
         // Decript the data
         cl_int  flag = ((cl_int*)ptr)[0];  ptr = (cl_int*)ptr  + 1;
         if(flag != CL_SUCCESS){
             free(msg); msg=NULL;
-            unlock(servers->sockets[i]);
             return flag;
         }
         cl_uint l_num_platforms = ((cl_uint*)ptr)[0]; ptr = (cl_uint*)ptr + 1;
@@ -337,8 +1510,11 @@ cl_int oclandGetPlatformIDs(cl_uint         num_entries,
         for(j=0;j<n;j++){
             platforms[t_num_platforms + j] = ((cl_platform_id*)ptr)[j];
         }
-        t_num_platforms += l_num_platforms;
         free(msg); msg=NULL;
+        // Get the platforms info which never changes in a single request
+        prefetchInfo(i, OCLAND_INFO_PLATFORM, n, (void* const*)(platforms + t_num_platforms),
+                     sizeof(platform_params) / sizeof(cl_uint), platform_params);
+        t_num_platforms += l_num_platforms;
     }
     if(num_platforms) *num_platforms = t_num_platforms;
     return CL_SUCCESS;
@@ -360,31 +1536,30 @@ cl_int oclandGetPlatformInfo(cl_platform_id    platform,
         // Ensure that the server still being active
         if(servers->sockets[i] < 0)
             continue;
+        // Look for the info in the stored ones
+        cl_int flag;
+        if(loadInfo(i, platform, param_name, param_value_size, param_value,
+                    param_value_size_ret, &flag))
+            return flag;
         // Create the package send
-        size_t msgSize  = sizeof(unsigned int);     // Command index
-        msgSize        += sizeof(cl_platform_id);   // platform
+        size_t msgSize  = sizeof(cl_platform_id);   // platform
         msgSize        += sizeof(cl_platform_info); // param_name
         msgSize        += sizeof(size_t);           // param_value_size
         void* msg = (void*)malloc(msgSize);
         void* ptr = msg;
-        ((unsigned int*)ptr)[0]     = ocland_clGetPlatformInfo; ptr = (unsigned int*)ptr + 1;
         ((cl_platform_id*)ptr)[0]   = platform;                 ptr = (cl_platform_id*)ptr + 1;
         ((cl_platform_info*)ptr)[0] = param_name;               ptr = (cl_platform_info*)ptr + 1;
         ((size_t*)ptr)[0]           = param_value_size;
-        // Send the package (first the size, and then the data)
-        lock(servers->sockets[i]);
+        // Send the package, and wait for the answer
         int *sockfd = &(servers->sockets[i]);
-        Send(sockfd, &msgSize, sizeof(size_t), 0);
-        Send(sockfd, msg, msgSize, 0);
-        free(msg); msg=NULL;
-        // Receive the package (first the size, and then the data)
-        Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-        msg = (void*)malloc(msgSize);
+        // The value is received straight into param_value
+        void *answer = oclandSinkRequest(sockfd, ocland_clGetPlatformInfo, msg, &msgSize,
+                                         sizeof(cl_int) + sizeof(size_t),
+                                         param_value, param_value ? param_value_size : 0);
+        free(msg); msg=answer;
         ptr = msg;
-        Recv(sockfd, msg, msgSize, MSG_WAITALL);
-        unlock(servers->sockets[i]);
         // Decript the data
-        cl_int  flag = ((cl_int*)ptr)[0]; ptr = (cl_int*)ptr  + 1;
+        flag = ((cl_int*)ptr)[0]; ptr = (cl_int*)ptr  + 1;
         if(flag != CL_SUCCESS){
             free(msg); msg=NULL;
             if(flag == CL_INVALID_PLATFORM){
@@ -394,8 +1569,12 @@ cl_int oclandGetPlatformInfo(cl_platform_id    platform,
         }
         size_t size_ret = ((size_t*)ptr)[0]; ptr = (size_t*)ptr  + 1;
         if(param_value_size_ret) *param_value_size_ret = size_ret;
-        if(param_value) memcpy(param_value, ptr, size_ret);
+        if( param_value &&
+            (msgSize >= sizeof(cl_int) + sizeof(size_t) + size_ret) )
+            memcpy(param_value, ptr, size_ret);
         free(msg); msg=NULL;
+        if(param_value && isImmutableInfo(param_name))
+            storeInfo(i, platform, param_name, CL_SUCCESS, size_ret, param_value);
         return CL_SUCCESS;
     }
     // If we reach this point, the platform was not found in any server
@@ -420,28 +1599,19 @@ cl_int oclandGetDeviceIDs(cl_platform_id   platform,
         if(servers->sockets[i] < 0)
             continue;
         // Build the package
-        size_t msgSize  = sizeof(unsigned int);   // Command index
-        msgSize        += sizeof(cl_platform_id); // platform
+        size_t msgSize  = sizeof(cl_platform_id); // platform
         msgSize        += sizeof(cl_device_type); // device_type
         msgSize        += sizeof(cl_uint);        // num_entries
         void* msg = (void*)malloc(msgSize);
         void* ptr = msg;
-        ((unsigned int*)ptr)[0]   = ocland_clGetDeviceIDs; ptr = (unsigned int*)ptr   + 1;
         ((cl_platform_id*)ptr)[0] = platform;              ptr = (cl_platform_id*)ptr + 1;
         ((cl_device_type*)ptr)[0] = device_type;           ptr = (cl_device_type*)ptr + 1;
         ((cl_uint*)ptr)[0]        = num_entries;
-        // Send the package (first the size, and then the data)
-        lock(servers->sockets[i]);
+        // Send the package, and wait for the answer
         int *sockfd = &(servers->sockets[i]);
-        Send(sockfd, &msgSize, sizeof(size_t), 0);
-        Send(sockfd, msg, msgSize, 0);
-        free(msg); msg=NULL;
-        // Receive the package (first size, and then data)
-        Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-        msg = (void*)malloc(msgSize);
+        void *answer = oclandRequest(sockfd, ocland_clGetDeviceIDs, msg, &msgSize);
+        free(msg); msg=answer;
         ptr = msg;
-        Recv(sockfd, msg, msgSize, MSG_WAITALL);
-        unlock(servers->sockets[i]);
         // Decript the data
         cl_int  flag = ((cl_int*)ptr)[0];  ptr = (cl_int*)ptr  + 1;
         if(flag != CL_SUCCESS){
@@ -456,6 +1626,10 @@ cl_int oclandGetDeviceIDs(cl_platform_id   platform,
             n = num_entries;
         if(devices) memcpy((void*)devices, ptr, n*sizeof(cl_device_id));
         free(msg); msg=NULL;
+        // Get the devices info which never changes in a single request
+        if(devices)
+            prefetchInfo(i, OCLAND_INFO_DEVICE, n, (void* const*)devices,
+                         sizeof(device_params) / sizeof(cl_uint), device_params);
         return CL_SUCCESS;
     }
     // The platform has not been found in any server
@@ -479,31 +1653,30 @@ cl_int oclandGetDeviceInfo(cl_device_id    device,
         // Ensure that the server still being active
         if(servers->sockets[i] < 0)
             continue;
+        // Look for the info in the stored ones
+        cl_int flag;
+        if(loadInfo(i, device, param_name, param_value_size, param_value,
+                    param_value_size_ret, &flag))
+            return flag;
         // Build the package
-        size_t msgSize  = sizeof(unsigned int);   // Command index
-        msgSize        += sizeof(cl_device_id);   // device
+        size_t msgSize  = sizeof(cl_device_id);   // device
         msgSize        += sizeof(cl_device_info); // param_name
         msgSize        += sizeof(size_t);         // param_value_size
         void* msg = (void*)malloc(msgSize);
         void* ptr = msg;
-        ((unsigned int*)ptr)[0]   = ocland_clGetDeviceInfo; ptr = (unsigned int*)ptr   + 1;
         ((cl_device_id*)ptr)[0]   = device;                 ptr = (cl_device_id*)ptr   + 1;
         ((cl_device_info*)ptr)[0] = param_name;             ptr = (cl_device_info*)ptr + 1;
         ((size_t*)ptr)[0]         = param_value_size;
-        // Send the package (first the size, and then the data)
-        lock(servers->sockets[i]);
+        // Send the package, and wait for the answer
         int *sockfd = &(servers->sockets[i]);
-        Send(sockfd, &msgSize, sizeof(size_t), 0);
-        Send(sockfd, msg, msgSize, 0);
-        free(msg); msg=NULL;
-        // Receive the package (first size, and then data)
-        Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-        msg = (void*)malloc(msgSize);
+        // The value is received straight into param_value
+        void *answer = oclandSinkRequest(sockfd, ocland_clGetDeviceInfo, msg, &msgSize,
+                                         sizeof(cl_int) + sizeof(size_t),
+                                         param_value, param_value ? param_value_size : 0);
+        free(msg); msg=answer;
         ptr = msg;
-        Recv(sockfd, msg, msgSize, MSG_WAITALL);
-        unlock(servers->sockets[i]);
         // Decript the data
-        cl_int  flag = ((cl_int*)ptr)[0]; ptr = (cl_int*)ptr  + 1;
+        flag = ((cl_int*)ptr)[0]; ptr = (cl_int*)ptr  + 1;
         if(flag != CL_SUCCESS){
             free(msg); msg=NULL;
             if(flag == CL_INVALID_DEVICE)
@@ -512,8 +1685,12 @@ cl_int oclandGetDeviceInfo(cl_device_id    device,
         }
         size_t size_ret = ((size_t*)ptr)[0]; ptr = (size_t*)ptr  + 1;
         if(param_value_size_ret) *param_value_size_ret = size_ret;
-        if(param_value) memcpy((void*)param_value, ptr, size_ret);
+        if( param_value &&
+            (msgSize >= sizeof(cl_int) + sizeof(size_t) + size_ret) )
+            memcpy(param_value, ptr, size_ret);
         free(msg); msg=NULL;
+        if(param_value && isImmutableInfo(param_name))
+            storeInfo(i, device, param_name, CL_SUCCESS, size_ret, param_value);
         return CL_SUCCESS;
     }
     // The platform has not been found in any server
@@ -542,30 +1719,21 @@ cl_context oclandCreateContext(const cl_context_properties * properties,
         if(servers->sockets[i] < 0)
             continue;
         // Build the package
-        size_t msgSize  = sizeof(unsigned int);   // Command index
-        msgSize        += sizeof(cl_uint);        // num_properties
+        size_t msgSize  = sizeof(cl_uint);        // num_properties
         msgSize        += num_properties*sizeof(cl_context_properties); // properties
         msgSize        += sizeof(cl_uint);        // num_devices
         msgSize        += num_devices*sizeof(cl_device_id);             // devices
         void* msg = (void*)malloc(msgSize);
         void* ptr = msg;
-        ((unsigned int*)ptr)[0]   = ocland_clCreateContext; ptr = (unsigned int*)ptr   + 1;
         ((cl_uint*)ptr)[0]        = num_properties;         ptr = (cl_uint*)ptr   + 1;
         memcpy(ptr, (void*)properties, num_properties*sizeof(cl_context_properties)); ptr = (cl_context_properties*)ptr + num_properties;
         ((cl_uint*)ptr)[0]        = num_devices;            ptr = (cl_uint*)ptr + 1;
         memcpy(ptr, (void*)devices, num_devices*sizeof(cl_device_id)); ptr = (cl_device_id*)ptr + num_devices;
-        // Send the package (first the size, and then the data)
-        lock(servers->sockets[i]);
+        // Send the package, and wait for the answer
         int *sockfd = &(servers->sockets[i]);
-        Send(sockfd, &msgSize, sizeof(size_t), 0);
-        Send(sockfd, msg, msgSize, 0);
-        free(msg); msg=NULL;
-        // Receive the package (first size, and then data)
-        Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-        msg = (void*)malloc(msgSize);
+        void *answer = oclandRequest(sockfd, ocland_clCreateContext, msg, &msgSize);
+        free(msg); msg=answer;
         ptr = msg;
-        Recv(sockfd, msg, msgSize, MSG_WAITALL);
-        unlock(servers->sockets[i]);
         // Decript the data
         cl_int  flag = ((cl_int*)ptr)[0]; ptr = (cl_int*)ptr  + 1;
         if(errcode_ret) *errcode_ret = flag;
@@ -605,28 +1773,19 @@ cl_context oclandCreateContextFromType(const cl_context_properties * properties,
         if(servers->sockets[i] < 0)
             continue;
         // Build the package
-        size_t msgSize  = sizeof(unsigned int);   // Command index
-        msgSize        += sizeof(cl_uint);        // num_properties
+        size_t msgSize  = sizeof(cl_uint);        // num_properties
         msgSize        += num_properties*sizeof(cl_context_properties); // properties
         msgSize        += sizeof(cl_device_type); // device_type
         void* msg = (void*)malloc(msgSize);
         void* ptr = msg;
-        ((unsigned int*)ptr)[0]   = ocland_clCreateContextFromType; ptr = (unsigned int*)ptr + 1;
         ((cl_uint*)ptr)[0]        = num_properties;                 ptr = (cl_uint*)ptr + 1;
         memcpy(ptr, (void*)properties, num_properties*sizeof(cl_context_properties)); ptr = (cl_context_properties*)ptr + num_properties;
         ((cl_device_type*)ptr)[0] = device_type;                    ptr = (cl_device_type*)ptr + 1;
-        // Send the package (first the size, and then the data)
-        lock(servers->sockets[i]);
+        // Send the package, and wait for the answer
         int *sockfd = &(servers->sockets[i]);
-        Send(sockfd, &msgSize, sizeof(size_t), 0);
-        Send(sockfd, msg, msgSize, 0);
-        free(msg); msg=NULL;
-        // Receive the package (first size, and then data)
-        Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-        msg = (void*)malloc(msgSize);
+        void *answer = oclandRequest(sockfd, ocland_clCreateContextFromType, msg, &msgSize);
+        free(msg); msg=answer;
         ptr = msg;
-        Recv(sockfd, msg, msgSize, MSG_WAITALL);
-        unlock(servers->sockets[i]);
         // Decript the data
         cl_int flag = ((cl_int*)ptr)[0]; ptr = (cl_int*)ptr  + 1;
         if(errcode_ret) *errcode_ret = flag;
@@ -653,25 +1812,13 @@ cl_int oclandRetainContext(cl_context context)
         return CL_INVALID_CONTEXT;
     }
     // Build the package
-    size_t msgSize  = sizeof(unsigned int);   // Command index
-    msgSize        += sizeof(cl_context);     // context
+    size_t msgSize  = sizeof(cl_context);     // context
     void* msg = (void*)malloc(msgSize);
     void* ptr = msg;
-    ((unsigned int*)ptr)[0]   = ocland_clRetainContext; ptr = (unsigned int*)ptr + 1;
     ((cl_context*)ptr)[0]     = context;
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
+    // Queue the package, it will be sent with the next request
+    cl_int flag = oclandBatchRequest(sockfd, ocland_clRetainContext, msg, msgSize);
     free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
-    ptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
-    // Decript the data
-    cl_int flag = ((cl_int*)ptr)[0];
     return flag;
 }
 
@@ -683,27 +1830,17 @@ cl_int oclandReleaseContext(cl_context context)
         return CL_INVALID_CONTEXT;
     }
     // Build the package
-    size_t msgSize  = sizeof(unsigned int);   // Command index
-    msgSize        += sizeof(cl_context);     // context
+    size_t msgSize  = sizeof(cl_context);     // context
     void* msg = (void*)malloc(msgSize);
     void* ptr = msg;
-    ((unsigned int*)ptr)[0]   = ocland_clReleaseContext; ptr = (unsigned int*)ptr + 1;
     ((cl_context*)ptr)[0]     = context;
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
+    // Queue the package, it will be sent with the next request
+    cl_int flag = oclandBatchRequest(sockfd, ocland_clReleaseContext, msg, msgSize);
     free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
-    ptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
-    // Decript the data
-    cl_int flag = ((cl_int*)ptr)[0];
-    if(flag == CL_SUCCESS)
+    if(flag == CL_SUCCESS){
         delShortcut(context);
+        forgetInfo(context);
+    }
     return flag;
 }
 
@@ -718,34 +1855,36 @@ cl_int oclandGetContextInfo(cl_context         context,
     if(!sockfd){
         return CL_INVALID_CONTEXT;
     }
+    // Look for the info in the stored ones
+    cl_int flag;
+    unsigned int i = serverIndex(sockfd);
+    if( (i < servers->num_servers) &&
+        loadInfo(i, context, param_name, param_value_size, param_value,
+                 param_value_size_ret, &flag) )
+        return flag;
     // Build the package
-    size_t msgSize  = sizeof(unsigned int);    // Command index
-    msgSize        += sizeof(cl_context);      // context
+    size_t msgSize  = sizeof(cl_context);      // context
     msgSize        += sizeof(cl_context_info); // param_name
     msgSize        += sizeof(size_t);          // param_value_size
     void* msg = (void*)malloc(msgSize);
     void* ptr = msg;
-    ((unsigned int*)ptr)[0]    = ocland_clGetContextInfo; ptr = (unsigned int*)ptr + 1;
     ((cl_context*)ptr)[0]      = context;                 ptr = (cl_context*)ptr + 1;
     ((cl_context_info*)ptr)[0] = param_name;              ptr = (cl_context_info*)ptr + 1;
     ((size_t*)ptr)[0]          = param_value_size;        ptr = (size_t*)ptr + 1;
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
-    free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
+    // Send the package, and wait for the answer
+    void *answer = oclandRequest(sockfd, ocland_clGetContextInfo, msg, &msgSize);
+    free(msg); msg=answer;
     ptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
     // Decript the data
-    cl_int flag     = ((cl_int*)ptr)[0]; ptr = (cl_int*)ptr + 1;
+    flag            = ((cl_int*)ptr)[0]; ptr = (cl_int*)ptr + 1;
     size_t size_ret = ((size_t*)ptr)[0]; ptr = (size_t*)ptr + 1;
     if(param_value_size_ret) *param_value_size_ret = size_ret;
     if( (flag == CL_SUCCESS) && param_value )
         memcpy(param_value, ptr, size_ret);
+    free(msg); msg=NULL;
+    if( (flag == CL_SUCCESS) && param_value && isImmutableInfo(param_name) &&
+        (i < servers->num_servers) )
+        storeInfo(i, context, param_name, CL_SUCCESS, size_ret, param_value);
     return flag;
 }
 
@@ -760,33 +1899,19 @@ cl_command_queue oclandCreateCommandQueue(cl_context                     context
         return CL_INVALID_CONTEXT;
     }
     // Build the package
-    size_t msgSize  = sizeof(unsigned int);   // Command index
-    msgSize        += sizeof(cl_context);     // context
+    size_t msgSize  = sizeof(cl_context);     // context
     msgSize        += sizeof(cl_device_id);   // device
     msgSize        += sizeof(cl_command_queue_properties);   // properties
     void* msg = (void*)malloc(msgSize);
     void* ptr = msg;
-    ((unsigned int*)ptr)[0]   = ocland_clCreateCommandQueue; ptr = (unsigned int*)ptr + 1;
     ((cl_context*)ptr)[0]     = context;                     ptr = (cl_context*)ptr + 1;
     ((cl_device_id*)ptr)[0]   = device;                      ptr = (cl_device_id*)ptr + 1;
     ((cl_command_queue_properties*)ptr)[0] = properties;     ptr = (cl_command_queue_properties*)ptr + 1;
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
+    // Send the package, and get the created object
+    cl_command_queue command_queue = (cl_command_queue)oclandHandleRequest(sockfd, ocland_clCreateCommandQueue, msg, msgSize, errcode_ret);
     free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
-    ptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
-    // Decript the data
-    cl_int flag = ((cl_int*)ptr)[0]; ptr = (cl_int*)ptr  + 1;
-    if(errcode_ret) *errcode_ret = flag;
-    if(flag != CL_SUCCESS)
+    if(!command_queue)
         return NULL;
-    cl_command_queue command_queue = ((cl_command_queue*)ptr)[0];
     addShortcut((void*)command_queue, sockfd);
     return command_queue;
 }
@@ -799,25 +1924,13 @@ cl_int oclandRetainCommandQueue(cl_command_queue command_queue)
         return CL_INVALID_COMMAND_QUEUE;
     }
     // Build the package
-    size_t msgSize  = sizeof(unsigned int);     // Command index
-    msgSize        += sizeof(cl_command_queue); // command_queue
+    size_t msgSize  = sizeof(cl_command_queue); // command_queue
     void* msg = (void*)malloc(msgSize);
     void* ptr = msg;
-    ((unsigned int*)ptr)[0]   = ocland_clRetainCommandQueue; ptr = (unsigned int*)ptr + 1;
     ((cl_context*)ptr)[0]     = command_queue;
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
+    // Queue the package, it will be sent with the next request
+    cl_int flag = oclandBatchRequest(sockfd, ocland_clRetainCommandQueue, msg, msgSize);
     free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
-    ptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
-    // Decript the data
-    cl_int flag = ((cl_int*)ptr)[0];
     return flag;
 }
 
@@ -829,25 +1942,13 @@ cl_int oclandReleaseCommandQueue(cl_command_queue command_queue)
         return CL_INVALID_COMMAND_QUEUE;
     }
     // Build the package
-    size_t msgSize  = sizeof(unsigned int);     // Command index
-    msgSize        += sizeof(cl_command_queue); // command_queue
+    size_t msgSize  = sizeof(cl_command_queue); // command_queue
     void* msg = (void*)malloc(msgSize);
     void* ptr = msg;
-    ((unsigned int*)ptr)[0]   = ocland_clReleaseCommandQueue; ptr = (unsigned int*)ptr + 1;
     ((cl_context*)ptr)[0]     = command_queue;
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
+    // Queue the package, it will be sent with the next request
+    cl_int flag = oclandBatchRequest(sockfd, ocland_clReleaseCommandQueue, msg, msgSize);
     free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
-    ptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
-    // Decript the data
-    cl_int flag = ((cl_int*)ptr)[0];
     if(flag == CL_SUCCESS)
         delShortcut(command_queue);
     return flag;
@@ -865,27 +1966,18 @@ cl_int oclandGetCommandQueueInfo(cl_command_queue      command_queue,
         return CL_INVALID_COMMAND_QUEUE;
     }
     // Build the package
-    size_t msgSize  = sizeof(unsigned int);          // Command index
-    msgSize        += sizeof(cl_command_queue);      // command_queue
+    size_t msgSize  = sizeof(cl_command_queue);      // command_queue
     msgSize        += sizeof(cl_command_queue_info); // param_name
     msgSize        += sizeof(size_t);                // param_value_size
     void* msg = (void*)malloc(msgSize);
     void* ptr = msg;
-    ((unsigned int*)ptr)[0]    = ocland_clGetCommandQueueInfo; ptr = (unsigned int*)ptr + 1;
     ((cl_command_queue*)ptr)[0]      = command_queue;          ptr = (cl_command_queue*)ptr + 1;
     ((cl_command_queue_info*)ptr)[0] = param_name;             ptr = (cl_command_queue_info*)ptr + 1;
     ((size_t*)ptr)[0]          = param_value_size;             ptr = (size_t*)ptr + 1;
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
-    free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
+    // Send the package, and wait for the answer
+    void *answer = oclandRequest(sockfd, ocland_clGetCommandQueueInfo, msg, &msgSize);
+    free(msg); msg=answer;
     ptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
     // Decript the data
     cl_int flag     = ((cl_int*)ptr)[0]; ptr = (cl_int*)ptr + 1;
     size_t size_ret = ((size_t*)ptr)[0]; ptr = (size_t*)ptr + 1;
@@ -909,37 +2001,23 @@ cl_mem oclandCreateBuffer(cl_context    context ,
     // Build the package
     cl_bool hasPtr = CL_FALSE;
     if(host_ptr) hasPtr = CL_TRUE;
-    size_t msgSize  = sizeof(unsigned int);   // Command index
-    msgSize        += sizeof(cl_context);     // context
+    size_t msgSize  = sizeof(cl_context);     // context
     msgSize        += sizeof(cl_mem_flags);   // flags
     msgSize        += sizeof(size_t);         // size
     msgSize        += sizeof(cl_bool);        // hasPtr
     if(host_ptr) msgSize += size;             // host_ptr
     void* msg = (void*)malloc(msgSize);
     void* ptr = msg;
-    ((unsigned int*)ptr)[0]   = ocland_clCreateBuffer; ptr = (unsigned int*)ptr + 1;
     ((cl_context*)ptr)[0]     = context;               ptr = (cl_context*)ptr + 1;
     ((cl_mem_flags*)ptr)[0]   = flags;                 ptr = (cl_mem_flags*)ptr + 1;
     ((size_t*)ptr)[0]         = size;                  ptr = (size_t*)ptr + 1;
     ((cl_bool*)ptr)[0]        = hasPtr;                ptr = (cl_bool*)ptr + 1;
     if(host_ptr) memcpy(ptr, host_ptr, size);
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
+    // Send the package, and get the created object
+    cl_mem memobj = (cl_mem)oclandHandleRequest(sockfd, ocland_clCreateBuffer, msg, msgSize, errcode_ret);
     free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
-    ptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
-    // Decript the data
-    cl_int flag = ((cl_int*)ptr)[0]; ptr = (cl_int*)ptr  + 1;
-    if(errcode_ret) *errcode_ret = flag;
-    if(flag != CL_SUCCESS)
+    if(!memobj)
         return NULL;
-    cl_mem memobj = ((cl_mem*)ptr)[0];
     addShortcut((void*)memobj, sockfd);
     return memobj;
 }
@@ -952,25 +2030,13 @@ cl_int oclandRetainMemObject(cl_mem memobj)
         return CL_INVALID_MEM_OBJECT;
     }
     // Build the package
-    size_t msgSize  = sizeof(unsigned int);   // Command index
-    msgSize        += sizeof(cl_mem);     // memobj
+    size_t msgSize  = sizeof(cl_mem);     // memobj
     void* msg = (void*)malloc(msgSize);
     void* ptr = msg;
-    ((unsigned int*)ptr)[0]   = ocland_clRetainMemObject; ptr = (unsigned int*)ptr + 1;
     ((cl_mem*)ptr)[0]         = memobj;
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
+    // Queue the package, it will be sent with the next request
+    cl_int flag = oclandBatchRequest(sockfd, ocland_clRetainMemObject, msg, msgSize);
     free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
-    ptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
-    // Decript the data
-    cl_int flag = ((cl_int*)ptr)[0];
     return flag;
 }
 
@@ -982,25 +2048,13 @@ cl_int oclandReleaseMemObject(cl_mem memobj)
         return CL_INVALID_MEM_OBJECT;
     }
     // Build the package
-    size_t msgSize  = sizeof(unsigned int);   // Command index
-    msgSize        += sizeof(cl_mem);     // memobj
+    size_t msgSize  = sizeof(cl_mem);     // memobj
     void* msg = (void*)malloc(msgSize);
     void* ptr = msg;
-    ((unsigned int*)ptr)[0]   = ocland_clReleaseMemObject; ptr = (unsigned int*)ptr + 1;
     ((cl_mem*)ptr)[0]         = memobj;
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
+    // Queue the package, it will be sent with the next request
+    cl_int flag = oclandBatchRequest(sockfd, ocland_clReleaseMemObject, msg, msgSize);
     free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
-    ptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
-    // Decript the data
-    cl_int flag = ((cl_int*)ptr)[0];
     if(flag == CL_SUCCESS)
         delShortcut(memobj);
     return flag;
@@ -1019,28 +2073,19 @@ cl_int oclandGetSupportedImageFormats(cl_context           context,
         return CL_INVALID_MEM_OBJECT;
     }
     // Build the package
-    size_t msgSize  = sizeof(unsigned int);       // Command index
-    msgSize        += sizeof(cl_context);         // context
+    size_t msgSize  = sizeof(cl_context);         // context
     msgSize        += sizeof(cl_mem_object_type); // image_type
     msgSize        += sizeof(cl_uint);            // num_entries
     void* msg = (void*)malloc(msgSize);
     void* ptr = msg;
-    ((unsigned int*)ptr)[0] = ocland_clGetSupportedImageFormats; ptr = (unsigned int*)ptr   + 1;
     ((cl_context*)ptr)[0]         = context;    ptr = (cl_context*)ptr + 1;
     ((cl_mem_flags*)ptr)[0]       = flags;      ptr = (cl_mem_flags*)ptr + 1;
     ((cl_mem_object_type*)ptr)[0] = image_type; ptr = (cl_mem_object_type*)ptr + 1;
     ((cl_uint*)ptr)[0]            = num_entries;
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
-    free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
+    // Send the package, and wait for the answer
+    void *answer = oclandRequest(sockfd, ocland_clGetSupportedImageFormats, msg, &msgSize);
+    free(msg); msg=answer;
     ptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
     // Decript the data
     cl_int  flag = ((cl_int*)ptr)[0];  ptr = (cl_int*)ptr  + 1;
     if(flag != CL_SUCCESS){
@@ -1068,27 +2113,18 @@ cl_int oclandGetMemObjectInfo(cl_mem            memobj ,
         return CL_INVALID_MEM_OBJECT;
     }
     // Build the package
-    size_t msgSize  = sizeof(unsigned int); // Command index
-    msgSize        += sizeof(cl_mem);       // memobj
+    size_t msgSize  = sizeof(cl_mem);       // memobj
     msgSize        += sizeof(cl_mem_info);  // param_name
     msgSize        += sizeof(size_t);       // param_value_size
     void* msg = (void*)malloc(msgSize);
     void* ptr = msg;
-    ((unsigned int*)ptr)[0] = ocland_clGetMemObjectInfo; ptr = (unsigned int*)ptr + 1;
     ((cl_mem*)ptr)[0]       = memobj;                    ptr = (cl_mem*)ptr + 1;
     ((cl_mem_info*)ptr)[0]  = param_name;                ptr = (cl_mem_info*)ptr + 1;
     ((size_t*)ptr)[0]       = param_value_size;          ptr = (size_t*)ptr + 1;
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
-    free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
+    // Send the package, and wait for the answer
+    void *answer = oclandRequest(sockfd, ocland_clGetMemObjectInfo, msg, &msgSize);
+    free(msg); msg=answer;
     ptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
     // Decript the data
     cl_int flag     = ((cl_int*)ptr)[0]; ptr = (cl_int*)ptr + 1;
     size_t size_ret = ((size_t*)ptr)[0]; ptr = (size_t*)ptr + 1;
@@ -1110,27 +2146,18 @@ cl_int oclandGetImageInfo(cl_mem            image ,
         return CL_INVALID_CONTEXT;
     }
     // Build the package
-    size_t msgSize  = sizeof(unsigned int);  // Command index
-    msgSize        += sizeof(cl_mem);        // image
+    size_t msgSize  = sizeof(cl_mem);        // image
     msgSize        += sizeof(cl_image_info); // param_name
     msgSize        += sizeof(size_t);        // param_value_size
     void* msg = (void*)malloc(msgSize);
     void* ptr = msg;
-    ((unsigned int*)ptr)[0]  = ocland_clGetMemObjectInfo; ptr = (unsigned int*)ptr + 1;
     ((cl_mem*)ptr)[0]        = image;                     ptr = (cl_mem*)ptr + 1;
     ((cl_image_info*)ptr)[0] = param_name;                ptr = (cl_image_info*)ptr + 1;
     ((size_t*)ptr)[0]        = param_value_size;          ptr = (size_t*)ptr + 1;
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
-    free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
+    // Send the package, and wait for the answer
+    void *answer = oclandRequest(sockfd, ocland_clGetMemObjectInfo, msg, &msgSize);
+    free(msg); msg=answer;
     ptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
     // Decript the data
     cl_int flag     = ((cl_int*)ptr)[0]; ptr = (cl_int*)ptr + 1;
     size_t size_ret = ((size_t*)ptr)[0]; ptr = (size_t*)ptr + 1;
@@ -1152,35 +2179,21 @@ cl_sampler oclandCreateSampler(cl_context           context ,
         return CL_INVALID_CONTEXT;
     }
     // Build the package
-    size_t msgSize  = sizeof(unsigned int);       // Command index
-    msgSize        += sizeof(cl_context);         // context
+    size_t msgSize  = sizeof(cl_context);         // context
     msgSize        += sizeof(cl_bool);            // normalized_coords
     msgSize        += sizeof(cl_addressing_mode); // addressing_mode
     msgSize        += sizeof(cl_filter_mode);     // filter_mode
     void* msg = (void*)malloc(msgSize);
     void* ptr = msg;
-    ((unsigned int*)ptr)[0]       = ocland_clCreateSampler; ptr = (unsigned int*)ptr + 1;
     ((cl_context*)ptr)[0]         = context;                ptr = (cl_context*)ptr + 1;
     ((cl_bool*)ptr)[0]            = normalized_coords;      ptr = (cl_bool*)ptr + 1;
     ((cl_addressing_mode*)ptr)[0] = addressing_mode;        ptr = (cl_addressing_mode*)ptr + 1;
     ((cl_filter_mode*)ptr)[0]     = filter_mode;            ptr = (cl_filter_mode*)ptr + 1;
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
+    // Send the package, and get the created object
+    cl_sampler sampler = (cl_sampler)oclandHandleRequest(sockfd, ocland_clCreateSampler, msg, msgSize, errcode_ret);
     free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
-    ptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
-    // Decript the data
-    cl_int flag = ((cl_int*)ptr)[0]; ptr = (cl_int*)ptr  + 1;
-    if(errcode_ret) *errcode_ret = flag;
-    if(flag != CL_SUCCESS)
+    if(!sampler)
         return NULL;
-    cl_sampler sampler = ((cl_sampler*)ptr)[0];
     addShortcut((void*)sampler, sockfd);
     return sampler;
 }
@@ -1193,25 +2206,13 @@ cl_int oclandRetainSampler(cl_sampler sampler)
         return CL_INVALID_SAMPLER;
     }
     // Build the package
-    size_t msgSize  = sizeof(unsigned int);   // Command index
-    msgSize        += sizeof(cl_sampler);     // sampler
+    size_t msgSize  = sizeof(cl_sampler);     // sampler
     void* msg = (void*)malloc(msgSize);
     void* ptr = msg;
-    ((unsigned int*)ptr)[0] = ocland_clRetainSampler; ptr = (unsigned int*)ptr + 1;
     ((cl_sampler*)ptr)[0]   = sampler;
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
+    // Queue the package, it will be sent with the next request
+    cl_int flag = oclandBatchRequest(sockfd, ocland_clRetainSampler, msg, msgSize);
     free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
-    ptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
-    // Decript the data
-    cl_int flag = ((cl_int*)ptr)[0];
     return flag;
 }
 
@@ -1223,25 +2224,13 @@ cl_int oclandReleaseSampler(cl_sampler sampler)
         return CL_INVALID_SAMPLER;
     }
     // Build the package
-    size_t msgSize  = sizeof(unsigned int);   // Command index
-    msgSize        += sizeof(cl_sampler);     // sampler
+    size_t msgSize  = sizeof(cl_sampler);     // sampler
     void* msg = (void*)malloc(msgSize);
     void* ptr = msg;
-    ((unsigned int*)ptr)[0] = ocland_clReleaseSampler; ptr = (unsigned int*)ptr + 1;
     ((cl_sampler*)ptr)[0]   = sampler;
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
+    // Queue the package, it will be sent with the next request
+    cl_int flag = oclandBatchRequest(sockfd, ocland_clReleaseSampler, msg, msgSize);
     free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
-    ptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
-    // Decript the data
-    cl_int flag = ((cl_int*)ptr)[0];
     if(flag == CL_SUCCESS)
         delShortcut(sampler);
     return flag;
@@ -1259,27 +2248,18 @@ cl_int oclandGetSamplerInfo(cl_sampler          sampler ,
         return CL_INVALID_SAMPLER;
     }
     // Build the package
-    size_t msgSize  = sizeof(unsigned int);  // Command index
-    msgSize        += sizeof(cl_sampler);    // sampler
+    size_t msgSize  = sizeof(cl_sampler);    // sampler
     msgSize        += sizeof(cl_sampler_info); // param_name
     msgSize        += sizeof(size_t);        // param_value_size
     void* msg = (void*)malloc(msgSize);
     void* ptr = msg;
-    ((unsigned int*)ptr)[0]    = ocland_clGetSamplerInfo; ptr = (unsigned int*)ptr + 1;
     ((cl_sampler*)ptr)[0]      = sampler;                 ptr = (cl_sampler*)ptr + 1;
     ((cl_sampler_info*)ptr)[0] = param_name;              ptr = (cl_sampler_info*)ptr + 1;
     ((size_t*)ptr)[0]          = param_value_size;        ptr = (size_t*)ptr + 1;
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
-    free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
+    // Send the package, and wait for the answer
+    void *answer = oclandRequest(sockfd, ocland_clGetSamplerInfo, msg, &msgSize);
+    free(msg); msg=answer;
     ptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
     // Decript the data
     cl_int flag     = ((cl_int*)ptr)[0]; ptr = (cl_int*)ptr + 1;
     size_t size_ret = ((size_t*)ptr)[0]; ptr = (size_t*)ptr + 1;
@@ -1296,43 +2276,71 @@ cl_program oclandCreateProgramWithSource(cl_context         context ,
                                          cl_int *           errcode_ret)
 {
     unsigned int i;
+    size_t total = 0;
+    cl_program program = NULL;
     // Get the server
     int *sockfd = getShortcut(context);
     if(!sockfd){
         return CL_INVALID_CONTEXT;
     }
+    // The strings without length are null terminated
+    size_t *sizes = (size_t*)malloc(count*sizeof(size_t));
+    if(!sizes){
+        if(errcode_ret) *errcode_ret = CL_OUT_OF_HOST_MEMORY;
+        return NULL;
+    }
+    for(i=0;i<count;i++){
+        sizes[i] = (lengths && lengths[i]) ? lengths[i] : strlen(strings[i]);
+        total   += sizes[i];
+    }
+    // Large sources are offered by their digest first, so they are not
+    // uploaded again if the server already stores them
+    if(OCLAND_SOURCE_DIGEST_SIZE && (total >= OCLAND_SOURCE_DIGEST_SIZE)){
+        size_t msgSize  = sizeof(cl_context);     // context
+        msgSize        += SHA256_SIZE;            // digest
+        void* msg = (void*)malloc(msgSize);
+        if(msg){
+            ((cl_context*)msg)[0] = context;
+            sha256Contents(OCLAND_CONTENTS_SOURCES, count, (const void* const*)strings,
+                           sizes, (unsigned char*)((cl_context*)msg + 1));
+            void *answer = oclandRequest(sockfd, ocland_createProgramWithDigest, msg, &msgSize);
+            free(msg); msg=NULL;
+            if( (msgSize >= sizeof(cl_int) + sizeof(cl_program)) &&
+                (((cl_int*)answer)[0] == CL_SUCCESS) )
+                program = ((cl_program*)((cl_int*)answer + 1))[0];
+            free(answer); answer=NULL;
+        }
+        if(program){
+            free(sizes); sizes=NULL;
+            if(errcode_ret) *errcode_ret = CL_SUCCESS;
+            addShortcut((void*)program, sockfd);
+            return program;
+        }
+    }
     // Build the package
-    size_t msgSize  = sizeof(unsigned int);       // Command index
-    msgSize        += sizeof(cl_context);         // context
+    size_t msgSize  = sizeof(cl_context);         // context
     msgSize        += sizeof(cl_uint);            // count
     msgSize        += count*sizeof(size_t);       // lengths
-    for(i=0;i<count;i++)
-        msgSize    += lengths[i]*sizeof(char);     // strings
+    msgSize        += total*sizeof(char);         // strings
     void* msg = (void*)malloc(msgSize);
+    if(!msg){
+        free(sizes); sizes=NULL;
+        if(errcode_ret) *errcode_ret = CL_OUT_OF_HOST_MEMORY;
+        return NULL;
+    }
     void* ptr = msg;
-    ((unsigned int*)ptr)[0]       = ocland_clCreateProgramWithSource; ptr = (unsigned int*)ptr + 1;
     ((cl_context*)ptr)[0]         = context;    ptr = (cl_context*)ptr + 1;
     ((cl_uint*)ptr)[0]            = count;      ptr = (cl_uint*)ptr + 1;
-    memcpy(ptr, lengths, count*sizeof(size_t)); ptr = (size_t*)ptr + count;
-    for(i=0;i<count;i++)
-        memcpy(ptr, strings[i], lengths[i]*sizeof(char)); ptr = (char*)ptr + lengths[i];
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
+    memcpy(ptr, sizes, count*sizeof(size_t));   ptr = (size_t*)ptr + count;
+    for(i=0;i<count;i++){
+        memcpy(ptr, strings[i], sizes[i]*sizeof(char)); ptr = (char*)ptr + sizes[i];
+    }
+    free(sizes); sizes=NULL;
+    // Send the package, and get the created object
+    program = (cl_program)oclandHandleRequest(sockfd, ocland_clCreateProgramWithSource, msg, msgSize, errcode_ret);
     free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
-    ptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
-    // Decript the data
-    cl_int flag = ((cl_int*)ptr)[0]; ptr = (cl_int*)ptr  + 1;
-    if(errcode_ret) *errcode_ret = flag;
-    if(flag != CL_SUCCESS)
+    if(!program)
         return NULL;
-    cl_program program = ((cl_program*)ptr)[0];
     addShortcut((void*)program, sockfd);
     return program;
 }
@@ -1352,8 +2360,7 @@ cl_program oclandCreateProgramWithBinary(cl_context                      context
         return CL_INVALID_CONTEXT;
     }
     // Build the package
-    size_t msgSize  = sizeof(unsigned int);             // Command index
-    msgSize        += sizeof(cl_context);               // context
+    size_t msgSize  = sizeof(cl_context);               // context
     msgSize        += sizeof(cl_uint);                  // num_devices
     msgSize        += num_devices*sizeof(cl_device_id); // device_list
     msgSize        += num_devices*sizeof(size_t);       // lengths
@@ -1361,24 +2368,16 @@ cl_program oclandCreateProgramWithBinary(cl_context                      context
         msgSize    += lengths[i]*sizeof(unsigned char); // binaries
     void* msg = (void*)malloc(msgSize);
     void* ptr = msg;
-    ((unsigned int*)ptr)[0]       = ocland_clCreateProgramWithBinary; ptr = (unsigned int*)ptr + 1;
     ((cl_context*)ptr)[0]         = context;     ptr = (cl_context*)ptr + 1;
     ((cl_uint*)ptr)[0]            = num_devices; ptr = (cl_uint*)ptr + 1;
     memcpy(ptr, device_list, num_devices*sizeof(cl_device_id)); ptr = (cl_device_id*)ptr + num_devices;
     memcpy(ptr, lengths, num_devices*sizeof(size_t));           ptr = (size_t*)ptr + num_devices;
     for(i=0;i<num_devices;i++)
         memcpy(ptr, binaries[i], lengths[i]*sizeof(unsigned char)); ptr = (unsigned char*)ptr + lengths[i];
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
-    free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
+    // Send the package, and wait for the answer
+    void *answer = oclandRequest(sockfd, ocland_clCreateProgramWithBinary, msg, &msgSize);
+    free(msg); msg=answer;
     ptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
     // Decript the data
     cl_int flag = ((cl_int*)ptr)[0];            ptr = (cl_int*)ptr  + 1;
     cl_program program = ((cl_program*)ptr)[0]; ptr = (cl_program*)ptr  + 1;
@@ -1399,25 +2398,13 @@ cl_int oclandRetainProgram(cl_program  program)
         return CL_INVALID_PROGRAM;
     }
     // Build the package
-    size_t msgSize  = sizeof(unsigned int);   // Command index
-    msgSize        += sizeof(cl_program);     // program
+    size_t msgSize  = sizeof(cl_program);     // program
     void* msg = (void*)malloc(msgSize);
     void* ptr = msg;
-    ((unsigned int*)ptr)[0] = ocland_clRetainProgram; ptr = (unsigned int*)ptr + 1;
     ((cl_program*)ptr)[0]   = program;
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
+    // Queue the package, it will be sent with the next request
+    cl_int flag = oclandBatchRequest(sockfd, ocland_clRetainProgram, msg, msgSize);
     free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
-    ptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
-    // Decript the data
-    cl_int flag = ((cl_int*)ptr)[0];
     return flag;
 }
 
@@ -1429,25 +2416,13 @@ cl_int oclandReleaseProgram(cl_program  program)
         return CL_INVALID_PROGRAM;
     }
     // Build the package
-    size_t msgSize  = sizeof(unsigned int);   // Command index
-    msgSize        += sizeof(cl_program);     // program
+    size_t msgSize  = sizeof(cl_program);     // program
     void* msg = (void*)malloc(msgSize);
     void* ptr = msg;
-    ((unsigned int*)ptr)[0] = ocland_clReleaseProgram; ptr = (unsigned int*)ptr + 1;
     ((cl_program*)ptr)[0]   = program;
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
+    // Queue the package, it will be sent with the next request
+    cl_int flag = oclandBatchRequest(sockfd, ocland_clReleaseProgram, msg, msgSize);
     free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
-    ptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
-    // Decript the data
-    cl_int flag = ((cl_int*)ptr)[0];
     if(flag == CL_SUCCESS)
         delShortcut(program);
     return flag;
@@ -1460,41 +2435,49 @@ cl_int oclandBuildProgram(cl_program            program ,
                           void (CL_CALLBACK *   pfn_notify)(cl_program  program , void *  user_data),
                           void *                user_data)
 {
-    unsigned int i;
     // Get the server
     int *sockfd = getShortcut(program);
     if(!sockfd){
         return CL_INVALID_PROGRAM;
     }
+    // The server notifies the build through the data channel. Without
+    // it the build is synchronous, and notified when it finishes
+    cl_bool notify = CL_FALSE;
+    if(pfn_notify && (openChannel(sockfd) == CL_SUCCESS))
+        notify = CL_TRUE;
     // Build the package
-    size_t options_size = (strlen(options) + 1)*sizeof(char);
-    size_t msgSize  = sizeof(unsigned int);       // Command index
-    msgSize        += sizeof(cl_program);         // program
+    size_t options_size = options ? (strlen(options) + 1)*sizeof(char) : 0;
+    size_t msgSize  = sizeof(cl_program);         // program
     msgSize        += sizeof(cl_uint);            // num_devices
     msgSize        += num_devices*sizeof(size_t); // device_list
     msgSize        += sizeof(size_t);             // options_size
     msgSize        += options_size;               // options
+    msgSize        += sizeof(cl_bool);            // notify
     void* msg = (void*)malloc(msgSize);
     void* ptr = msg;
-    ((unsigned int*)ptr)[0] = ocland_clBuildProgram; ptr = (unsigned int*)ptr + 1;
     ((cl_program*)ptr)[0]   = program;      ptr = (cl_program*)ptr + 1;
     ((cl_uint*)ptr)[0]      = num_devices;  ptr = (cl_uint*)ptr + 1;
     memcpy(ptr, device_list, num_devices*sizeof(cl_device_id)); ptr = (cl_device_id*)ptr + num_devices;
     ((size_t*)ptr)[0]       = options_size; ptr = (size_t*)ptr + 1;
-    memcpy(ptr, options, options_size);
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
-    free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
+    if(options_size)
+        memcpy(ptr, options, options_size);
+    ptr = (char*)ptr + options_size;
+    ((cl_bool*)ptr)[0]      = notify;
+    // Send the package, and wait for the answer
+    void *answer;
+    if(notify)
+        answer = oclandNotifyRequest(sockfd, ocland_clBuildProgram, msg, &msgSize,
+                                     program, pfn_notify, user_data);
+    else
+        answer = oclandRequest(sockfd, ocland_clBuildProgram, msg, &msgSize);
+    free(msg); msg=answer;
     ptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
     // Decript the data
     cl_int flag = ((cl_int*)ptr)[0]; ptr = (cl_int*)ptr  + 1;
+    free(msg); msg=NULL;
+    if( pfn_notify && !notify &&
+        ((flag == CL_SUCCESS) || (flag == CL_BUILD_PROGRAM_FAILURE)) )
+        pfn_notify(program, user_data);
     return flag;
 }
 
@@ -1510,33 +2493,29 @@ cl_int oclandGetProgramInfo(cl_program          program ,
         return CL_INVALID_PROGRAM;
     }
     // Build the package
-    size_t msgSize  = sizeof(unsigned int);    // Command index
-    msgSize        += sizeof(cl_program);      // program
+    size_t msgSize  = sizeof(cl_program);      // program
     msgSize        += sizeof(cl_program_info); // param_name
     msgSize        += sizeof(size_t);          // param_value_size
     void* msg = (void*)malloc(msgSize);
     void* ptr = msg;
-    ((unsigned int*)ptr)[0]    = ocland_clGetProgramInfo; ptr = (unsigned int*)ptr + 1;
     ((cl_program*)ptr)[0]      = program;                 ptr = (cl_program*)ptr + 1;
     ((cl_program_info*)ptr)[0] = param_name;              ptr = (cl_program_info*)ptr + 1;
     ((size_t*)ptr)[0]          = param_value_size;        ptr = (size_t*)ptr + 1;
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
-    free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
+    // Send the package, and wait for the answer
+    // The value is received straight into param_value
+    void *answer = oclandSinkRequest(sockfd, ocland_clGetProgramInfo, msg, &msgSize,
+                                     sizeof(cl_int) + sizeof(size_t),
+                                     param_value, param_value ? param_value_size : 0);
+    free(msg); msg=answer;
     ptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
     // Decript the data
     cl_int flag     = ((cl_int*)ptr)[0]; ptr = (cl_int*)ptr + 1;
     size_t size_ret = ((size_t*)ptr)[0]; ptr = (size_t*)ptr + 1;
     if(param_value_size_ret) *param_value_size_ret = size_ret;
-    if( (flag == CL_SUCCESS) && param_value )
+    if( (flag == CL_SUCCESS) && param_value &&
+        (msgSize >= sizeof(cl_int) + sizeof(size_t) + size_ret) )
         memcpy(param_value, ptr, size_ret);
+    free(msg); msg=NULL;
     return flag;
 }
 
@@ -1553,35 +2532,31 @@ cl_int oclandGetProgramBuildInfo(cl_program             program ,
         return CL_INVALID_PROGRAM;
     }
     // Build the package
-    size_t msgSize  = sizeof(unsigned int);    // Command index
-    msgSize        += sizeof(cl_program);      // program
+    size_t msgSize  = sizeof(cl_program);      // program
     msgSize        += sizeof(cl_device_id);    // device
     msgSize        += sizeof(cl_program_info); // param_name
     msgSize        += sizeof(size_t);          // param_value_size
     void* msg = (void*)malloc(msgSize);
     void* ptr = msg;
-    ((unsigned int*)ptr)[0]    = ocland_clGetProgramBuildInfo; ptr = (unsigned int*)ptr + 1;
     ((cl_program*)ptr)[0]      = program;                 ptr = (cl_program*)ptr + 1;
     ((cl_device_id*)ptr)[0]    = device;                  ptr = (cl_device_id*)ptr + 1;
     ((cl_program_info*)ptr)[0] = param_name;              ptr = (cl_program_info*)ptr + 1;
     ((size_t*)ptr)[0]          = param_value_size;        ptr = (size_t*)ptr + 1;
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
-    free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
+    // Send the package, and wait for the answer
+    // The value is received straight into param_value
+    void *answer = oclandSinkRequest(sockfd, ocland_clGetProgramBuildInfo, msg, &msgSize,
+                                     sizeof(cl_int) + sizeof(size_t),
+                                     param_value, param_value ? param_value_size : 0);
+    free(msg); msg=answer;
     ptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
     // Decript the data
     cl_int flag     = ((cl_int*)ptr)[0]; ptr = (cl_int*)ptr + 1;
     size_t size_ret = ((size_t*)ptr)[0]; ptr = (size_t*)ptr + 1;
     if(param_value_size_ret) *param_value_size_ret = size_ret;
-    if( (flag == CL_SUCCESS) && param_value )
+    if( (flag == CL_SUCCESS) && param_value &&
+        (msgSize >= sizeof(cl_int) + sizeof(size_t) + size_ret) )
         memcpy(param_value, ptr, size_ret);
+    free(msg); msg=NULL;
     return flag;
 }
 
@@ -1596,33 +2571,19 @@ cl_kernel oclandCreateKernel(cl_program       program ,
     }
     // Build the package
     size_t kernel_name_size = (strlen(kernel_name)+1)*sizeof(char);
-    size_t msgSize  = sizeof(unsigned int);   // Command index
-    msgSize        += sizeof(cl_program);     // program
+    size_t msgSize  = sizeof(cl_program);     // program
     msgSize        += sizeof(size_t);         // kernel_name_size
     msgSize        += kernel_name_size;       // kernel_name
     void* msg = (void*)malloc(msgSize);
     void* ptr = msg;
-    ((unsigned int*)ptr)[0]       = ocland_clCreateKernel; ptr = (unsigned int*)ptr + 1;
     ((cl_program*)ptr)[0]         = program;               ptr = (cl_program*)ptr + 1;
     ((size_t*)ptr)[0]             = kernel_name_size;      ptr = (size_t*)ptr + 1;
     memcpy(ptr, kernel_name, kernel_name_size);
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
+    // Send the package, and get the created object
+    cl_kernel kernel = (cl_kernel)oclandHandleRequest(sockfd, ocland_clCreateKernel, msg, msgSize, errcode_ret);
     free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
-    ptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
-    // Decript the data
-    cl_int flag = ((cl_int*)ptr)[0]; ptr = (cl_int*)ptr  + 1;
-    if(errcode_ret) *errcode_ret = flag;
-    if(flag != CL_SUCCESS)
+    if(!kernel)
         return NULL;
-    cl_kernel kernel = ((cl_kernel*)ptr)[0];
     addShortcut((void*)kernel, sockfd);
     return kernel;
 }
@@ -1639,25 +2600,16 @@ cl_int oclandCreateKernelsInProgram(cl_program      program ,
         return CL_INVALID_PROGRAM;
     }
     // Build the package
-    size_t msgSize  = sizeof(unsigned int);   // Command index
-    msgSize        += sizeof(cl_program);     // program
+    size_t msgSize  = sizeof(cl_program);     // program
     msgSize        += sizeof(cl_uint);        // num_kernels
     void* msg = (void*)malloc(msgSize);
     void* ptr = msg;
-    ((unsigned int*)ptr)[0]       = ocland_clCreateKernel; ptr = (unsigned int*)ptr + 1;
     ((cl_program*)ptr)[0]         = program;               ptr = (cl_program*)ptr + 1;
     ((cl_uint*)ptr)[0]            = num_kernels;           ptr = (cl_uint*)ptr + 1;
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
-    free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
+    // Send the package, and wait for the answer
+    void *answer = oclandRequest(sockfd, ocland_clCreateKernel, msg, &msgSize);
+    free(msg); msg=answer;
     ptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
     // Decript the data
     cl_int flag = ((cl_int*)ptr)[0];  ptr = (cl_int*)ptr  + 1;
     cl_uint n   = ((cl_uint*)ptr)[0]; ptr = (cl_uint*)ptr + 1;
@@ -1679,25 +2631,13 @@ cl_int oclandRetainKernel(cl_kernel     kernel)
         return CL_INVALID_KERNEL;
     }
     // Build the package
-    size_t msgSize  = sizeof(unsigned int);  // Command index
-    msgSize        += sizeof(cl_kernel);     // kernel
+    size_t msgSize  = sizeof(cl_kernel);     // kernel
     void* msg = (void*)malloc(msgSize);
     void* ptr = msg;
-    ((unsigned int*)ptr)[0] = ocland_clRetainKernel; ptr = (unsigned int*)ptr + 1;
     ((cl_kernel*)ptr)[0]    = kernel;
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
+    // Queue the package, it will be sent with the next request
+    cl_int flag = oclandBatchRequest(sockfd, ocland_clRetainKernel, msg, msgSize);
     free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
-    ptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
-    // Decript the data
-    cl_int flag = ((cl_int*)ptr)[0];
     return flag;
 }
 
@@ -1709,25 +2649,13 @@ cl_int oclandReleaseKernel(cl_kernel    kernel)
         return CL_INVALID_KERNEL;
     }
     // Build the package
-    size_t msgSize  = sizeof(unsigned int);  // Command index
-    msgSize        += sizeof(cl_kernel);     // kernel
+    size_t msgSize  = sizeof(cl_kernel);     // kernel
     void* msg = (void*)malloc(msgSize);
     void* ptr = msg;
-    ((unsigned int*)ptr)[0] = ocland_clReleaseKernel; ptr = (unsigned int*)ptr + 1;
     ((cl_kernel*)ptr)[0]    = kernel;
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
+    // Queue the package, it will be sent with the next request
+    cl_int flag = oclandBatchRequest(sockfd, ocland_clReleaseKernel, msg, msgSize);
     free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
-    ptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
-    // Decript the data
-    cl_int flag = ((cl_int*)ptr)[0];
     if(flag == CL_SUCCESS)
         delShortcut(kernel);
     return flag;
@@ -1746,33 +2674,21 @@ cl_int oclandSetKernelArg(cl_kernel     kernel ,
     // Build the package
     size_t arg_value_size = arg_size;
     if(!arg_value) arg_value_size = 0;
-    size_t msgSize  = sizeof(unsigned int);   // Command index
-    msgSize        += sizeof(cl_kernel);      // kernel
+    size_t msgSize  = sizeof(cl_kernel);      // kernel
     msgSize        += sizeof(cl_uint);        // arg_index
     msgSize        += sizeof(size_t);         // arg_size
     msgSize        += sizeof(size_t);         // arg_value_size
     msgSize        += arg_value_size;         // arg_value
     void* msg = (void*)malloc(msgSize);
     void* ptr = msg;
-    ((unsigned int*)ptr)[0]       = ocland_clSetKernelArg; ptr = (unsigned int*)ptr + 1;
     ((cl_kernel*)ptr)[0]          = kernel;                ptr = (cl_kernel*)ptr + 1;
     ((cl_uint*)ptr)[0]            = arg_index;             ptr = (cl_uint*)ptr + 1;
     ((size_t*)ptr)[0]             = arg_size;              ptr = (size_t*)ptr + 1;
     ((size_t*)ptr)[0]             = arg_value_size;        ptr = (size_t*)ptr + 1;
     memcpy(ptr, arg_value, arg_value_size);
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
+    // Queue the package, it will be sent with the next request
+    cl_int flag = oclandBatchRequest(sockfd, ocland_clSetKernelArg, msg, msgSize);
     free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
-    ptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
-    // Decript the data
-    cl_int flag = ((cl_int*)ptr)[0];
     return flag;
 }
 
@@ -1788,33 +2704,29 @@ cl_int oclandGetKernelInfo(cl_kernel        kernel ,
         return CL_INVALID_KERNEL;
     }
     // Build the package
-    size_t msgSize  = sizeof(unsigned int);    // Command index
-    msgSize        += sizeof(cl_kernel);       // kernel
+    size_t msgSize  = sizeof(cl_kernel);       // kernel
     msgSize        += sizeof(cl_kernel_info);  // param_name
     msgSize        += sizeof(size_t);          // param_value_size
     void* msg = (void*)malloc(msgSize);
     void* ptr = msg;
-    ((unsigned int*)ptr)[0]   = ocland_clGetKernelInfo; ptr = (unsigned int*)ptr + 1;
     ((cl_kernel*)ptr)[0]      = kernel;                 ptr = (cl_kernel*)ptr + 1;
     ((cl_kernel_info*)ptr)[0] = param_name;             ptr = (cl_kernel_info*)ptr + 1;
     ((size_t*)ptr)[0]         = param_value_size;       ptr = (size_t*)ptr + 1;
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
-    free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
+    // Send the package, and wait for the answer
+    // The value is received straight into param_value
+    void *answer = oclandSinkRequest(sockfd, ocland_clGetKernelInfo, msg, &msgSize,
+                                     sizeof(cl_int) + sizeof(size_t),
+                                     param_value, param_value ? param_value_size : 0);
+    free(msg); msg=answer;
     ptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
     // Decript the data
     cl_int flag     = ((cl_int*)ptr)[0]; ptr = (cl_int*)ptr + 1;
     size_t size_ret = ((size_t*)ptr)[0]; ptr = (size_t*)ptr + 1;
     if(param_value_size_ret) *param_value_size_ret = size_ret;
-    if( (flag == CL_SUCCESS) && param_value )
+    if( (flag == CL_SUCCESS) && param_value &&
+        (msgSize >= sizeof(cl_int) + sizeof(size_t) + size_ret) )
         memcpy(param_value, ptr, size_ret);
+    free(msg); msg=NULL;
     return flag;
 }
 
@@ -1831,29 +2743,20 @@ cl_int oclandGetKernelWorkGroupInfo(cl_kernel                   kernel ,
         return CL_INVALID_KERNEL;
     }
     // Build the package
-    size_t msgSize  = sizeof(unsigned int);               // Command index
-    msgSize        += sizeof(cl_kernel);                  // kernel
+    size_t msgSize  = sizeof(cl_kernel);                  // kernel
     msgSize        += sizeof(cl_device_id);               // device
     msgSize        += sizeof(cl_kernel_work_group_info);  // param_name
     msgSize        += sizeof(size_t);                     // param_value_size
     void* msg = (void*)malloc(msgSize);
     void* ptr = msg;
-    ((unsigned int*)ptr)[0]   = ocland_clGetKernelWorkGroupInfo; ptr = (unsigned int*)ptr + 1;
     ((cl_kernel*)ptr)[0]      = kernel;                 ptr = (cl_kernel*)ptr + 1;
     ((cl_device_id*)ptr)[0]   = device;                 ptr = (cl_device_id*)ptr + 1;
     ((cl_kernel_work_group_info*)ptr)[0] = param_name;  ptr = (cl_kernel_work_group_info*)ptr + 1;
     ((size_t*)ptr)[0]         = param_value_size;       ptr = (size_t*)ptr + 1;
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
-    free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
+    // Send the package, and wait for the answer
+    void *answer = oclandRequest(sockfd, ocland_clGetKernelWorkGroupInfo, msg, &msgSize);
+    free(msg); msg=answer;
     ptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
     // Decript the data
     cl_int flag     = ((cl_int*)ptr)[0]; ptr = (cl_int*)ptr + 1;
     size_t size_ret = ((size_t*)ptr)[0]; ptr = (size_t*)ptr + 1;
@@ -1872,27 +2775,25 @@ cl_int oclandWaitForEvents(cl_uint              num_events ,
         return CL_INVALID_EVENT;
     }
     // Build the package
-    size_t msgSize  = sizeof(unsigned int);        // Command index
-    msgSize        += sizeof(cl_uint);             // num_events
+    size_t msgSize  = sizeof(cl_uint);             // num_events
     msgSize        += num_events*sizeof(cl_event); // event_list
     void* msg = (void*)malloc(msgSize);
     void* ptr = msg;
-    ((unsigned int*)ptr)[0]   = ocland_clWaitForEvents; ptr = (unsigned int*)ptr + 1;
     ((cl_uint*)ptr)[0]        = num_events;             ptr = (cl_uint*)ptr + 1;
     memcpy(ptr, (void*)event_list, num_events*sizeof(cl_event));
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
-    free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
+    // Send the package, and wait for the answer
+    void *answer = oclandRequest(sockfd, ocland_clWaitForEvents, msg, &msgSize);
+    free(msg); msg=answer;
     ptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
     // Decript the data
     cl_int flag = ((cl_int*)ptr)[0];
+    free(msg); msg=NULL;
+    // The data of the asynchronous reads may be still arriving
+    if(flag == CL_SUCCESS)
+        waitTransfers(sockfd, NULL, num_events, event_list);
+    // Notify the errors of the batched commands
+    if(flag == CL_SUCCESS)
+        flag = oclandBatchError(sockfd);
     return flag;
 }
 
@@ -1908,27 +2809,18 @@ cl_int oclandGetEventInfo(cl_event          event ,
         return CL_INVALID_EVENT;
     }
     // Build the package
-    size_t msgSize  = sizeof(unsigned int);   // Command index
-    msgSize        += sizeof(cl_event);       // event
+    size_t msgSize  = sizeof(cl_event);       // event
     msgSize        += sizeof(cl_event_info);  // param_name
     msgSize        += sizeof(size_t);         // param_value_size
     void* msg = (void*)malloc(msgSize);
     void* ptr = msg;
-    ((unsigned int*)ptr)[0]   = ocland_clGetEventInfo; ptr = (unsigned int*)ptr + 1;
     ((cl_event*)ptr)[0]       = event;                 ptr = (cl_event*)ptr + 1;
     ((cl_event_info*)ptr)[0]  = param_name;            ptr = (cl_event_info*)ptr + 1;
     ((size_t*)ptr)[0]         = param_value_size;      ptr = (size_t*)ptr + 1;
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
-    free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
+    // Send the package, and wait for the answer
+    void *answer = oclandRequest(sockfd, ocland_clGetEventInfo, msg, &msgSize);
+    free(msg); msg=answer;
     ptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
     // Decript the data
     cl_int flag     = ((cl_int*)ptr)[0]; ptr = (cl_int*)ptr + 1;
     size_t size_ret = ((size_t*)ptr)[0]; ptr = (size_t*)ptr + 1;
@@ -1946,25 +2838,13 @@ cl_int oclandRetainEvent(cl_event  event)
         return CL_INVALID_EVENT;
     }
     // Build the package
-    size_t msgSize  = sizeof(unsigned int);  // Command index
-    msgSize        += sizeof(cl_event);      // event
+    size_t msgSize  = sizeof(cl_event);      // event
     void* msg = (void*)malloc(msgSize);
     void* ptr = msg;
-    ((unsigned int*)ptr)[0] = ocland_clRetainEvent; ptr = (unsigned int*)ptr + 1;
     ((cl_event*)ptr)[0]     = event;
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
+    // Queue the package, it will be sent with the next request
+    cl_int flag = oclandBatchRequest(sockfd, ocland_clRetainEvent, msg, msgSize);
     free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
-    ptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
-    // Decript the data
-    cl_int flag = ((cl_int*)ptr)[0];
     return flag;
 }
 
@@ -1976,25 +2856,13 @@ cl_int oclandReleaseEvent(cl_event  event)
         return CL_INVALID_EVENT;
     }
     // Build the package
-    size_t msgSize  = sizeof(unsigned int);  // Command index
-    msgSize        += sizeof(cl_event);      // event
+    size_t msgSize  = sizeof(cl_event);      // event
     void* msg = (void*)malloc(msgSize);
     void* ptr = msg;
-    ((unsigned int*)ptr)[0] = ocland_clReleaseEvent; ptr = (unsigned int*)ptr + 1;
     ((cl_event*)ptr)[0]     = event;
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
+    // Queue the package, it will be sent with the next request
+    cl_int flag = oclandBatchRequest(sockfd, ocland_clReleaseEvent, msg, msgSize);
     free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
-    ptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
-    // Decript the data
-    cl_int flag = ((cl_int*)ptr)[0];
     if(flag == CL_SUCCESS)
         delShortcut(event);
     return flag;
@@ -2012,27 +2880,18 @@ cl_int oclandGetEventProfilingInfo(cl_event             event ,
         return CL_INVALID_EVENT;
     }
     // Build the package
-    size_t msgSize  = sizeof(unsigned int);       // Command index
-    msgSize        += sizeof(cl_event);           // event
+    size_t msgSize  = sizeof(cl_event);           // event
     msgSize        += sizeof(cl_profiling_info);  // param_name
     msgSize        += sizeof(size_t);             // param_value_size
     void* msg = (void*)malloc(msgSize);
     void* ptr = msg;
-    ((unsigned int*)ptr)[0]       = ocland_clGetEventProfilingInfo; ptr = (unsigned int*)ptr + 1;
     ((cl_event*)ptr)[0]           = event;                          ptr = (cl_event*)ptr + 1;
     ((cl_profiling_info*)ptr)[0]  = param_name;                     ptr = (cl_profiling_info*)ptr + 1;
     ((size_t*)ptr)[0]             = param_value_size;               ptr = (size_t*)ptr + 1;
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
-    free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
+    // Send the package, and wait for the answer
+    void *answer = oclandRequest(sockfd, ocland_clGetEventProfilingInfo, msg, &msgSize);
+    free(msg); msg=answer;
     ptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
     // Decript the data
     cl_int flag     = ((cl_int*)ptr)[0]; ptr = (cl_int*)ptr + 1;
     size_t size_ret = ((size_t*)ptr)[0]; ptr = (size_t*)ptr + 1;
@@ -2050,25 +2909,20 @@ cl_int oclandFlush(cl_command_queue command_queue)
         return CL_INVALID_COMMAND_QUEUE;
     }
     // Build the package
-    size_t msgSize  = sizeof(unsigned int);     // Command index
-    msgSize        += sizeof(cl_command_queue); // command_queue
+    size_t msgSize  = sizeof(cl_command_queue); // command_queue
     void* msg = (void*)malloc(msgSize);
     void* ptr = msg;
-    ((unsigned int*)ptr)[0]     = ocland_clFlush; ptr = (unsigned int*)ptr + 1;
     ((cl_command_queue*)ptr)[0] = command_queue;
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
-    free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
+    // Send the package, and wait for the answer
+    void *answer = oclandRequest(sockfd, ocland_clFlush, msg, &msgSize);
+    free(msg); msg=answer;
     ptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
     // Decript the data
     cl_int flag = ((cl_int*)ptr)[0];
+    free(msg); msg=NULL;
+    // Notify the errors of the batched commands
+    if(flag == CL_SUCCESS)
+        flag = oclandBatchError(sockfd);
     return flag;
 }
 
@@ -2080,25 +2934,23 @@ cl_int oclandFinish(cl_command_queue  command_queue)
         return CL_INVALID_COMMAND_QUEUE;
     }
     // Build the package
-    size_t msgSize  = sizeof(unsigned int);     // Command index
-    msgSize        += sizeof(cl_command_queue); // command_queue
+    size_t msgSize  = sizeof(cl_command_queue); // command_queue
     void* msg = (void*)malloc(msgSize);
     void* ptr = msg;
-    ((unsigned int*)ptr)[0]     = ocland_clFinish; ptr = (unsigned int*)ptr + 1;
     ((cl_command_queue*)ptr)[0] = command_queue;
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
-    free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
+    // Send the package, and wait for the answer
+    void *answer = oclandRequest(sockfd, ocland_clFinish, msg, &msgSize);
+    free(msg); msg=answer;
     ptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
     // Decript the data
     cl_int flag = ((cl_int*)ptr)[0];
+    free(msg); msg=NULL;
+    // The data of the asynchronous reads may be still arriving
+    if(flag == CL_SUCCESS)
+        waitTransfers(sockfd, command_queue, 0, NULL);
+    // Notify the errors of the batched commands
+    if(flag == CL_SUCCESS)
+        flag = oclandBatchError(sockfd);
     return flag;
 }
 
@@ -2106,85 +2958,57 @@ cl_int oclandFinish(cl_command_queue  command_queue)
  * an asynchronously data transfer.
  */
 struct dataTransfer{
-    /// Port
-    unsigned int port;
-    /// Socket
-    int fd;
+    /// Server index
+    unsigned int server;
+    /// Command index of the request which started the transfer
+    uint32_t opcode;
+    /// Identifier of the request which started the transfer
+    uint32_t request_id;
     /// Size of data
     size_t cb;
     /// Data array
-    void *ptr;
+    const void *ptr;
 };
 
-/** Thread that receives data from server.
+/** Thread that sends data to server through the data channel.
  * @param data struct dataTransfer casted variable.
  * @return NULL
  */
-void *asyncDataRecv_thread(void *data)
+void *asyncDataSend_thread(void *data)
 {
     struct dataTransfer* _data = (struct dataTransfer*)data;
-    // Connect to the received port.
-    unsigned int port = _data->port;
-    struct sockaddr_in serv_addr, adr_inet;
-    int fd = socket(AF_INET, SOCK_STREAM, 0);
-    if(fd < 0){
-        printf("ERROR: Can't register a new socket for the asynchronous data transfer\n"); fflush(stdout);
-        return;
-    }
-    memset(&serv_addr, '0', sizeof(serv_addr));
-    socklen_t len_inet;
-    len_inet = sizeof(serv_addr);
-    char* ip = serverAddress(_data->fd);
-    if(!ip){
-        printf("ERROR: Can't find the server associated with the socket\n"); fflush(stdout);
-        shutdown(fd, 2);
-        fd = -1;
-        return;
-    }
-    serv_addr.sin_family = AF_INET;
-    serv_addr.sin_port   = htons(port);
-    if(inet_pton(AF_INET, ip, &serv_addr.sin_addr)<=0){
-        // we can't work, disconnect from server
-        printf("ERROR: Invalid address assigment (%s)\n", ip); fflush(stdout);
-        shutdown(fd, 2);
-        fd = -1;
-        return;
-    }
-    while( connect(fd, (struct sockaddr *)&serv_addr, sizeof(serv_addr)) < 0 ){
-        if(errno == ECONNREFUSED){
-            // Pobably the server is not ready yet, simply retry
-            // it until the server start listening
-            continue;
-        }
-        // we can't work, disconnect from server
-        printf("ERROR: Can't connect for the asynchronous data transfer\n"); fflush(stdout);
-        printf("\t%s\n", SocketsError()); fflush(stdout);
-        shutdown(fd, 2);
-        fd = -1;
-        return;
+    if(channelSend(_data->server, _data->opcode, _data->request_id, _data->ptr, _data->cb) != (ssize_t)_data->cb){
+        printf("ERROR: The data of the request %u can't be sent\n", _data->request_id); fflush(stdout);
     }
-    // Receive the data
-    Recv(&fd, _data->ptr, _data->cb, MSG_WAITALL);
     free(_data); _data=NULL;
-    pthread_exit(NULL);
     return NULL;
 }
 
-/** Performs a data reception asynchronously on a new thread and socket.
+/** Create the pool of workers sending the asynchronous transfers data.
+ */
+static void initTransfers()
+{
+    transfers = createTransferPool(OCLAND_TRANSFER_WORKERS, OCLAND_TRANSFER_BUDGET);
+}
+
+/** Performs a data sending asynchronously on a pool worker, through the
+ * data channel of the server. If the pending transfers are holding too
+ * much memory, the calling thread is blocked until they finish.
  * @param sockfd Connection socket.
  * @param data Data to transfer.
  */
-void asyncDataRecv(int* sockfd, struct dataTransfer data)
+void asyncDataSend(int* sockfd, struct dataTransfer data)
 {
-    // Open a new thread to connect to the new port
-    // and receive the data
-    pthread_t thread;
+    data.server = serverIndex(sockfd);
     struct dataTransfer* _data = (struct dataTransfer*)malloc(sizeof(struct dataTransfer));
-    _data->port  = data.port;
-    _data->fd    = data.fd;
-    _data->cb    = data.cb;
-    _data->ptr   = data.ptr;
-    int rc = pthread_create(&thread, NULL, asyncDataRecv_thread, (void *)(_data));
+    if(!_data){
+        // Send it in this thread
+        channelSend(data.server, data.opcode, data.request_id, data.ptr, data.cb);
+        return;
+    }
+    *_data = data;
+    pthread_once(&transfers_once, initTransfers);
+    transferPoolSubmit(transfers, asyncDataSend_thread, (void *)(_data), _data->cb);
 }
 
 cl_int oclandEnqueueReadBuffer(cl_command_queue     command_queue ,
@@ -2203,11 +3027,13 @@ cl_int oclandEnqueueReadBuffer(cl_command_queue     command_queue ,
     if(!sockfd){
         return CL_INVALID_EVENT;
     }
+    // The asynchronous transfers require the data channel
+    if((blocking_read != CL_TRUE) && (openChannel(sockfd) != CL_SUCCESS))
+        blocking_read = CL_TRUE;
     // Build the package
     cl_bool want_event = CL_FALSE;
     if(event) want_event = CL_TRUE;
-    size_t msgSize  = sizeof(unsigned int);                            // Command index
-    msgSize        += sizeof(cl_command_queue);                        // command_queue
+    size_t msgSize  = sizeof(cl_command_queue);                        // command_queue
     msgSize        += sizeof(cl_mem);                                  // buffer
     msgSize        += sizeof(cl_bool);                                 // blocking_read
     msgSize        += sizeof(size_t);                                  // offset
@@ -2217,7 +3043,6 @@ cl_int oclandEnqueueReadBuffer(cl_command_queue     command_queue ,
     msgSize        += num_events_in_wait_list*sizeof(event_wait_list); // event_wait_list
     void* msg = (void*)malloc(msgSize);
     void* mptr = msg;
-    ((unsigned int*)mptr)[0]     = ocland_clEnqueueReadBuffer; mptr = (unsigned int*)mptr + 1;
     ((cl_command_queue*)mptr)[0] = command_queue;              mptr = (cl_command_queue*)mptr + 1;
     ((cl_mem*)mptr)[0]           = buffer;                     mptr = (cl_mem*)mptr + 1;
     ((cl_bool*)mptr)[0]          = blocking_read;              mptr = (cl_bool*)mptr + 1;
@@ -2226,25 +3051,28 @@ cl_int oclandEnqueueReadBuffer(cl_command_queue     command_queue ,
     ((cl_bool*)mptr)[0]          = want_event;                 mptr = (cl_bool*)mptr + 1;
     ((cl_uint*)mptr)[0]          = num_events_in_wait_list;    mptr = (cl_uint*)mptr + 1;
     memcpy(mptr, event_wait_list, num_events_in_wait_list*sizeof(cl_event));
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
-    free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
+    // Send the package, and wait for the answer
+    uint32_t request_id;
+    void *answer;
+    if(blocking_read == CL_TRUE)
+        answer = oclandSinkRequest(sockfd, ocland_clEnqueueReadBuffer, msg, &msgSize,
+                                   sizeof(cl_int) + sizeof(cl_event), ptr, cb);
+    else
+        answer = oclandTransferRequest(sockfd, ocland_clEnqueueReadBuffer, msg, &msgSize,
+                                       command_queue, ptr, cb, &request_id);
+    free(msg); msg=answer;
     mptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
     // Decript the flag, if CL_SUCCESS don't received, we can't
     // still working
     cl_int flag = ((cl_int*)mptr)[0]; mptr = (cl_int*)mptr + 1;
-    if(flag != CL_SUCCESS)
+    if(flag != CL_SUCCESS){
+        free(msg); msg=NULL;
         return flag;
+    }
     // ------------------------------------------------------------
     // Blocking read case:
-    // We may have received the flag, the event, and the data.
+    // We may have received the flag, and the event. The data has
+    // been received straight into ptr, unless it does not fit.
     // ------------------------------------------------------------
     if(blocking_read == CL_TRUE){
         revent = ((cl_event*)mptr)[0]; mptr = (cl_event*)mptr + 1;
@@ -2252,100 +3080,25 @@ cl_int oclandEnqueueReadBuffer(cl_command_queue     command_queue ,
             *event = revent;
             addShortcut(*event, sockfd);
         }
-        memcpy(ptr, mptr, cb);
+        if(msgSize >= sizeof(cl_int) + sizeof(cl_event) + cb)
+            memcpy(ptr, mptr, cb);
+        free(msg); msg=NULL;
         return flag;
     }
     // ------------------------------------------------------------
     // Asynchronous read case:
-    // We may have received the flag, the event, and a port to open
-    // a parallel transfer channel.
+    // We may have received the flag, and the event. The data will
+    // arrive through the data channel.
     // ------------------------------------------------------------
     revent = ((cl_event*)mptr)[0]; mptr = (cl_event*)mptr + 1;
     if(event){
         *event = revent;
         addShortcut(*event, sockfd);
     }
-    unsigned int port = ((unsigned int*)mptr)[0];
-    struct dataTransfer data;
-    data.port  = port;
-    data.fd    = *sockfd;
-    data.cb    = cb;
-    data.ptr   = ptr;
-    asyncDataRecv(sockfd, data);
+    free(msg); msg=NULL;
     return flag;
 }
 
-/** Thread that sends data to server.
- * @param data struct dataTransfer casted variable.
- * @return NULL
- */
-void *asyncDataSend_thread(void *data)
-{
-    struct dataTransfer* _data = (struct dataTransfer*)data;
-    // Connect to the received port.
-    unsigned int port = _data->port;
-    struct sockaddr_in serv_addr;
-    int fd = socket(AF_INET, SOCK_STREAM, 0);
-    if(fd < 0){
-        printf("ERROR: Can't register a new socket for the asynchronous data transfer\n"); fflush(stdout);
-        return;
-    }
-    memset(&serv_addr, '0', sizeof(serv_addr));
-    socklen_t len_inet;
-    len_inet = sizeof(serv_addr);
-    char* ip = serverAddress(_data->fd);
-    if(!ip){
-        printf("ERROR: Can't find the server associated with the socket\n"); fflush(stdout);
-        shutdown(fd, 2);
-        fd = -1;
-        return;
-    }
-    serv_addr.sin_family = AF_INET;
-    serv_addr.sin_port   = htons(port);
-    if(inet_pton(AF_INET, ip, &serv_addr.sin_addr)<=0){
-        // we can't work, disconnect from server
-        printf("ERROR: Invalid address assigment (%s)\n", ip); fflush(stdout);
-        shutdown(fd, 2);
-        fd = -1;
-        return;
-    }
-    while( connect(fd, (struct sockaddr *)&serv_addr, sizeof(serv_addr)) < 0 ){
-        if(errno == ECONNREFUSED){
-            // Pobably the server is not ready yet, simply retry
-            // it until the server start listening
-            continue;
-        }
-        // we can't work, disconnect from server
-        printf("ERROR: Can't connect for the asynchronous data transfer\n"); fflush(stdout);
-        printf("\t%s\n", SocketsError()); fflush(stdout);
-        shutdown(fd, 2);
-        fd = -1;
-        return;
-    }
-    // Send the data
-    Send(&fd, _data->ptr, _data->cb, 0);
-    free(_data); _data=NULL;
-    pthread_exit(NULL);
-    return NULL;
-}
-
-/** Performs a data reception asynchronously on a new thread and socket.
- * @param sockfd Connection socket.
- * @param data Data to transfer.
- */
-void asyncDataSend(int* sockfd, struct dataTransfer data)
-{
-    // Open a new thread to connect to the new port
-    // and receive the data
-    pthread_t thread;
-    struct dataTransfer* _data = (struct dataTransfer*)malloc(sizeof(struct dataTransfer));
-    _data->port  = data.port;
-    _data->fd    = data.fd;
-    _data->cb    = data.cb;
-    _data->ptr   = data.ptr;
-    int rc = pthread_create(&thread, NULL, asyncDataSend_thread, (void *)(_data));
-}
-
 cl_int oclandEnqueueWriteBuffer(cl_command_queue    command_queue ,
                                 cl_mem              buffer ,
                                 cl_bool             blocking_write ,
@@ -2362,11 +3115,13 @@ cl_int oclandEnqueueWriteBuffer(cl_command_queue    command_queue ,
     if(!sockfd){
         return CL_INVALID_EVENT;
     }
+    // The asynchronous transfers require the data channel
+    if((blocking_write != CL_TRUE) && (openChannel(sockfd) != CL_SUCCESS))
+        blocking_write = CL_TRUE;
     // Build the package
     cl_bool want_event = CL_FALSE;
     if(event) want_event = CL_TRUE;
-    size_t msgSize  = sizeof(unsigned int);                            // Command index
-    msgSize        += sizeof(cl_command_queue);                        // command_queue
+    size_t msgSize  = sizeof(cl_command_queue);                        // command_queue
     msgSize        += sizeof(cl_mem);                                  // buffer
     msgSize        += sizeof(cl_bool);                                 // blocking_write
     msgSize        += sizeof(size_t);                                  // offset
@@ -2378,7 +3133,6 @@ cl_int oclandEnqueueWriteBuffer(cl_command_queue    command_queue ,
         msgSize    += cb;                                              // ptr
     void* msg = (void*)malloc(msgSize);
     void* mptr = msg;
-    ((unsigned int*)mptr)[0]     = ocland_clEnqueueWriteBuffer; mptr = (unsigned int*)mptr + 1;
     ((cl_command_queue*)mptr)[0] = command_queue;              mptr = (cl_command_queue*)mptr + 1;
     ((cl_mem*)mptr)[0]           = buffer;                     mptr = (cl_mem*)mptr + 1;
     ((cl_bool*)mptr)[0]          = blocking_write;             mptr = (cl_bool*)mptr + 1;
@@ -2391,17 +3145,16 @@ cl_int oclandEnqueueWriteBuffer(cl_command_queue    command_queue ,
         mptr = (cl_event*)mptr + num_events_in_wait_list;
         memcpy(mptr, ptr, cb);
     }
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
-    free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
+    // Send the package, and wait for the answer
+    uint32_t request_id;
+    void *answer;
+    if(blocking_write == CL_TRUE)
+        answer = oclandRequest(sockfd, ocland_clEnqueueWriteBuffer, msg, &msgSize);
+    else
+        answer = oclandTransferRequest(sockfd, ocland_clEnqueueWriteBuffer, msg, &msgSize,
+                                       command_queue, NULL, cb, &request_id);
+    free(msg); msg=answer;
     mptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
     // Decript the flag, if CL_SUCCESS don't received, we can't
     // still working
     cl_int flag = ((cl_int*)mptr)[0]; mptr = (cl_int*)mptr + 1;
@@ -2420,21 +3173,20 @@ cl_int oclandEnqueueWriteBuffer(cl_command_queue    command_queue ,
         return flag;
     }
     // ------------------------------------------------------------
-    // Asynchronous read case:
-    // We may have received the flag, the event, and a port to open
-    // a parallel transfer channel.
+    // Asynchronous write case:
+    // We may have received the flag, and the event. The server is
+    // waiting for the data in the data channel.
     // ------------------------------------------------------------
     revent = ((cl_event*)mptr)[0]; mptr = (cl_event*)mptr + 1;
     if(event){
         *event = revent;
         addShortcut(*event, sockfd);
     }
-    unsigned int port = ((unsigned int*)mptr)[0];
     struct dataTransfer data;
-    data.port  = port;
-    data.fd    = *sockfd;
-    data.cb    = cb;
-    data.ptr   = (void*)ptr;
+    data.opcode     = ocland_clEnqueueWriteBuffer;
+    data.request_id = request_id;
+    data.cb         = cb;
+    data.ptr        = ptr;
     asyncDataSend(sockfd, data);
     return flag;
 }
@@ -2458,8 +3210,7 @@ cl_int oclandEnqueueCopyBuffer(cl_command_queue     command_queue ,
     // Build the package
     cl_bool want_event = CL_FALSE;
     if(event) want_event = CL_TRUE;
-    size_t msgSize  = sizeof(unsigned int);                            // Command index
-    msgSize        += sizeof(cl_command_queue);                        // command_queue
+    size_t msgSize  = sizeof(cl_command_queue);                        // command_queue
     msgSize        += sizeof(cl_mem);                                  // src_buffer
     msgSize        += sizeof(cl_mem);                                  // dst_buffer
     msgSize        += sizeof(size_t);                                  // src_offset
@@ -2470,7 +3221,6 @@ cl_int oclandEnqueueCopyBuffer(cl_command_queue     command_queue ,
     msgSize        += num_events_in_wait_list*sizeof(event_wait_list); // event_wait_list
     void* msg = (void*)malloc(msgSize);
     void* mptr = msg;
-    ((unsigned int*)mptr)[0]     = ocland_clEnqueueCopyBuffer; mptr = (unsigned int*)mptr + 1;
     ((cl_command_queue*)mptr)[0] = command_queue;              mptr = (cl_command_queue*)mptr + 1;
     ((cl_mem*)mptr)[0]           = src_buffer;                 mptr = (cl_mem*)mptr + 1;
     ((cl_mem*)mptr)[0]           = dst_buffer;                 mptr = (cl_mem*)mptr + 1;
@@ -2480,17 +3230,10 @@ cl_int oclandEnqueueCopyBuffer(cl_command_queue     command_queue ,
     ((cl_bool*)mptr)[0]          = want_event;                 mptr = (cl_bool*)mptr + 1;
     ((cl_uint*)mptr)[0]          = num_events_in_wait_list;    mptr = (cl_uint*)mptr + 1;
     memcpy(mptr, event_wait_list, num_events_in_wait_list*sizeof(cl_event));
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
-    free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
+    // Send the package, and wait for the answer
+    void *answer = oclandRequest(sockfd, ocland_clEnqueueCopyBuffer, msg, &msgSize);
+    free(msg); msg=answer;
     mptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
     // Decript the flag, if CL_SUCCESS don't received, we can't
     // still working
     cl_int flag = ((cl_int*)mptr)[0]; mptr = (cl_int*)mptr + 1;
@@ -2523,8 +3266,7 @@ cl_int oclandEnqueueCopyImage(cl_command_queue      command_queue ,
     // Build the package
     cl_bool want_event = CL_FALSE;
     if(event) want_event = CL_TRUE;
-    size_t msgSize  = sizeof(unsigned int);                            // Command index
-    msgSize        += sizeof(cl_command_queue);                        // command_queue
+    size_t msgSize  = sizeof(cl_command_queue);                        // command_queue
     msgSize        += sizeof(cl_mem);                                  // src_image
     msgSize        += sizeof(cl_mem);                                  // dst_image
     msgSize        += 3*sizeof(size_t);                                // src_origin
@@ -2535,7 +3277,6 @@ cl_int oclandEnqueueCopyImage(cl_command_queue      command_queue ,
     msgSize        += num_events_in_wait_list*sizeof(event_wait_list); // event_wait_list
     void* msg = (void*)malloc(msgSize);
     void* mptr = msg;
-    ((unsigned int*)mptr)[0]     = ocland_clEnqueueCopyImage; mptr = (unsigned int*)mptr + 1;
     ((cl_command_queue*)mptr)[0] = command_queue;             mptr = (cl_command_queue*)mptr + 1;
     ((cl_mem*)mptr)[0]           = src_image;                 mptr = (cl_mem*)mptr + 1;
     ((cl_mem*)mptr)[0]           = dst_image;                 mptr = (cl_mem*)mptr + 1;
@@ -2545,17 +3286,10 @@ cl_int oclandEnqueueCopyImage(cl_command_queue      command_queue ,
     ((cl_bool*)mptr)[0]          = want_event;                mptr = (cl_bool*)mptr + 1;
     ((cl_uint*)mptr)[0]          = num_events_in_wait_list;   mptr = (cl_uint*)mptr + 1;
     memcpy(mptr, event_wait_list, num_events_in_wait_list*sizeof(cl_event));
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
-    free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
+    // Send the package, and wait for the answer
+    void *answer = oclandRequest(sockfd, ocland_clEnqueueCopyImage, msg, &msgSize);
+    free(msg); msg=answer;
     mptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
     // Decript the flag, if CL_SUCCESS don't received, we can't
     // still working
     cl_int flag = ((cl_int*)mptr)[0]; mptr = (cl_int*)mptr + 1;
@@ -2588,8 +3322,7 @@ cl_int oclandEnqueueCopyImageToBuffer(cl_command_queue  command_queue ,
     // Build the package
     cl_bool want_event = CL_FALSE;
     if(event) want_event = CL_TRUE;
-    size_t msgSize  = sizeof(unsigned int);                            // Command index
-    msgSize        += sizeof(cl_command_queue);                        // command_queue
+    size_t msgSize  = sizeof(cl_command_queue);                        // command_queue
     msgSize        += sizeof(cl_mem);                                  // src_image
     msgSize        += sizeof(cl_mem);                                  // dst_buffer
     msgSize        += 3*sizeof(size_t);                                // src_origin
@@ -2600,7 +3333,6 @@ cl_int oclandEnqueueCopyImageToBuffer(cl_command_queue  command_queue ,
     msgSize        += num_events_in_wait_list*sizeof(event_wait_list); // event_wait_list
     void* msg = (void*)malloc(msgSize);
     void* mptr = msg;
-    ((unsigned int*)mptr)[0]     = ocland_clEnqueueCopyImageToBuffer; mptr = (unsigned int*)mptr + 1;
     ((cl_command_queue*)mptr)[0] = command_queue;                     mptr = (cl_command_queue*)mptr + 1;
     ((cl_mem*)mptr)[0]           = src_image;                         mptr = (cl_mem*)mptr + 1;
     ((cl_mem*)mptr)[0]           = dst_buffer;                        mptr = (cl_mem*)mptr + 1;
@@ -2610,17 +3342,10 @@ cl_int oclandEnqueueCopyImageToBuffer(cl_command_queue  command_queue ,
     ((cl_bool*)mptr)[0]          = want_event;                        mptr = (cl_bool*)mptr + 1;
     ((cl_uint*)mptr)[0]          = num_events_in_wait_list;           mptr = (cl_uint*)mptr + 1;
     memcpy(mptr, event_wait_list, num_events_in_wait_list*sizeof(cl_event));
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
-    free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
+    // Send the package, and wait for the answer
+    void *answer = oclandRequest(sockfd, ocland_clEnqueueCopyImageToBuffer, msg, &msgSize);
+    free(msg); msg=answer;
     mptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
     // Decript the flag, if CL_SUCCESS don't received, we can't
     // still working
     cl_int flag = ((cl_int*)mptr)[0]; mptr = (cl_int*)mptr + 1;
@@ -2653,8 +3378,7 @@ cl_int oclandEnqueueCopyBufferToImage(cl_command_queue  command_queue ,
     // Build the package
     cl_bool want_event = CL_FALSE;
     if(event) want_event = CL_TRUE;
-    size_t msgSize  = sizeof(unsigned int);                            // Command index
-    msgSize        += sizeof(cl_command_queue);                        // command_queue
+    size_t msgSize  = sizeof(cl_command_queue);                        // command_queue
     msgSize        += sizeof(cl_mem);                                  // src_buffer
     msgSize        += sizeof(cl_mem);                                  // dst_image
     msgSize        += sizeof(size_t);                                  // src_offset
@@ -2665,7 +3389,6 @@ cl_int oclandEnqueueCopyBufferToImage(cl_command_queue  command_queue ,
     msgSize        += num_events_in_wait_list*sizeof(event_wait_list); // event_wait_list
     void* msg = (void*)malloc(msgSize);
     void* mptr = msg;
-    ((unsigned int*)mptr)[0]     = ocland_clEnqueueCopyBufferToImage; mptr = (unsigned int*)mptr + 1;
     ((cl_command_queue*)mptr)[0] = command_queue;                     mptr = (cl_command_queue*)mptr + 1;
     ((cl_mem*)mptr)[0]           = src_buffer;                        mptr = (cl_mem*)mptr + 1;
     ((cl_mem*)mptr)[0]           = dst_image;                         mptr = (cl_mem*)mptr + 1;
@@ -2675,17 +3398,10 @@ cl_int oclandEnqueueCopyBufferToImage(cl_command_queue  command_queue ,
     ((cl_bool*)mptr)[0]          = want_event;                        mptr = (cl_bool*)mptr + 1;
     ((cl_uint*)mptr)[0]          = num_events_in_wait_list;           mptr = (cl_uint*)mptr + 1;
     memcpy(mptr, event_wait_list, num_events_in_wait_list*sizeof(cl_event));
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
-    free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
+    // Send the package, and wait for the answer
+    void *answer = oclandRequest(sockfd, ocland_clEnqueueCopyBufferToImage, msg, &msgSize);
+    free(msg); msg=answer;
     mptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
     // Decript the flag, if CL_SUCCESS don't received, we can't
     // still working
     cl_int flag = ((cl_int*)mptr)[0]; mptr = (cl_int*)mptr + 1;
@@ -2722,8 +3438,7 @@ cl_int oclandEnqueueNDRangeKernel(cl_command_queue  command_queue ,
     if(global_work_offset) has_global_work_offset = CL_TRUE;
     cl_bool has_local_work_size = CL_FALSE;
     if(local_work_size) has_local_work_size = CL_TRUE;
-    size_t msgSize  = sizeof(unsigned int);                            // Command index
-    msgSize        += sizeof(cl_command_queue);                        // command_queue
+    size_t msgSize  = sizeof(cl_command_queue);                        // command_queue
     msgSize        += sizeof(cl_kernel);                               // kernel
     msgSize        += sizeof(cl_uint);                                 // work_dim
     msgSize        += sizeof(cl_bool);                                 // has_global_work_offset
@@ -2738,7 +3453,6 @@ cl_int oclandEnqueueNDRangeKernel(cl_command_queue  command_queue ,
     msgSize        += num_events_in_wait_list*sizeof(event_wait_list); // event_wait_list
     void* msg = (void*)malloc(msgSize);
     void* mptr = msg;
-    ((unsigned int*)mptr)[0]     = ocland_clEnqueueNDRangeKernel; mptr = (unsigned int*)mptr + 1;
     ((cl_command_queue*)mptr)[0] = command_queue;              mptr = (cl_command_queue*)mptr + 1;
     ((cl_kernel*)mptr)[0]        = kernel;                     mptr = (cl_kernel*)mptr + 1;
     ((cl_uint*)mptr)[0]          = work_dim;                   mptr = (cl_uint*)mptr + 1;
@@ -2757,17 +3471,17 @@ cl_int oclandEnqueueNDRangeKernel(cl_command_queue  command_queue ,
     ((cl_bool*)mptr)[0]          = want_event;                 mptr = (cl_bool*)mptr + 1;
     ((cl_uint*)mptr)[0]          = num_events_in_wait_list;    mptr = (cl_uint*)mptr + 1;
     memcpy(mptr, event_wait_list, num_events_in_wait_list*sizeof(cl_event));
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
-    free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
+    if(!event){
+        // The answer is not required, queue the package to be sent with
+        // the next request
+        cl_int flag = oclandBatchRequest(sockfd, ocland_clEnqueueNDRangeKernel, msg, msgSize);
+        free(msg); msg=NULL;
+        return flag;
+    }
+    // Send the package, and wait for the answer
+    void *answer = oclandRequest(sockfd, ocland_clEnqueueNDRangeKernel, msg, &msgSize);
+    free(msg); msg=answer;
     mptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
     // Decript the flag, if CL_SUCCESS don't received, we can't
     // still working
     cl_int flag = ((cl_int*)mptr)[0]; mptr = (cl_int*)mptr + 1;
@@ -2781,103 +3495,6 @@ cl_int oclandEnqueueNDRangeKernel(cl_command_queue  command_queue ,
     return flag;
 }
 
-/** @struct dataTransferRect Vars needed for
- * an asynchronously data transfer in 2D,3D
- * rectangle.
- */
-struct dataTransferRect{
-    /// Port
-    unsigned int port;
-    /// Socket
-    int fd;
-    /// Region to read
-    const size_t *region;
-    /// Size of a row
-    size_t row;
-    /// Size of a 2D slice (row*column)
-    size_t slice;
-    /// Size of data
-    size_t cb;
-    /// Data array (conviniently sifted with origin)
-    void *ptr;
-};
-
-/** Thread that receives data from server for
- * a clEnqueueReadBufferRect specific command.
- * @param data struct dataTransfer casted variable.
- * @return NULL
- */
-void *asyncDataRecvRect_thread(void *data)
-{
-    struct dataTransferRect* _data = (struct dataTransferRect*)data;
-    // Connect to the received port.
-    unsigned int port = _data->port;
-    struct sockaddr_in serv_addr;
-    int fd = socket(AF_INET, SOCK_STREAM, 0);
-    if(fd < 0){
-        printf("ERROR: Can't register a new socket for the asynchronous data transfer\n"); fflush(stdout);
-        return;
-    }
-    memset(&serv_addr, '0', sizeof(serv_addr));
-    socklen_t len_inet;
-    len_inet = sizeof(serv_addr);
-    char* ip = serverAddress(_data->fd);
-    if(!ip){
-        printf("ERROR: Can't find the server associated with the socket\n"); fflush(stdout);
-        shutdown(fd, 2);
-        fd = -1;
-        return;
-    }
-    serv_addr.sin_family = AF_INET;
-    serv_addr.sin_port   = htons(port);
-    if(inet_pton(AF_INET, ip, &serv_addr.sin_addr)<=0){
-        // we can't work, disconnect from server
-        printf("ERROR: Invalid address assigment (%s)\n", ip); fflush(stdout);
-        shutdown(fd, 2);
-        fd = -1;
-        return;
-    }
-    while( connect(fd, (struct sockaddr *)&serv_addr, sizeof(serv_addr)) < 0 ){
-        if(errno == ECONNREFUSED){
-            // Pobably the server is not ready yet, simply retry
-            // it until the server start listening
-            continue;
-        }
-        // we can't work, disconnect from server
-        printf("ERROR: Can't connect for the asynchronous data transfer\n"); fflush(stdout);
-        printf("\t%s\n", SocketsError()); fflush(stdout);
-        shutdown(fd, 2);
-        fd = -1;
-        return;
-    }
-    // Receive the data
-    Recv(&fd, _data->ptr, _data->cb, MSG_WAITALL);
-    free(_data); _data=NULL;
-    pthread_exit(NULL);
-    return NULL;
-}
-
-/** Performs a data reception asynchronously on a new thread and socket, for
- * a clEnqueueReadBufferRect specific command.
- * @param sockfd Connection socket.
- * @param data Data to transfer.
- */
-void asyncDataRecvRect(int* sockfd, struct dataTransferRect data)
-{
-    // Open a new thread to connect to the new port
-    // and receive the data
-    pthread_t thread;
-    struct dataTransferRect* _data = (struct dataTransferRect*)malloc(sizeof(struct dataTransferRect));
-    _data->port  = data.port;
-    _data->fd    = data.fd;
-    _data->region = data.region;
-    _data->row    = data.row;
-    _data->slice  = data.slice;
-    _data->cb    = data.cb;
-    _data->ptr   = data.ptr;
-    int rc = pthread_create(&thread, NULL, asyncDataRecvRect_thread, (void *)(_data));
-}
-
 cl_int oclandEnqueueReadImage(cl_command_queue      command_queue ,
                               cl_mem                image ,
                               cl_bool               blocking_read ,
@@ -2897,11 +3514,14 @@ cl_int oclandEnqueueReadImage(cl_command_queue      command_queue ,
     if(!sockfd){
         return CL_INVALID_EVENT;
     }
+    // The asynchronous transfers require the data channel
+    if((blocking_read != CL_TRUE) && (openChannel(sockfd) != CL_SUCCESS))
+        blocking_read = CL_TRUE;
+    size_t cb = region[2]*slice_pitch + region[1]*row_pitch + region[0]*element_size;
     // Build the package
     cl_bool want_event = CL_FALSE;
     if(event) want_event = CL_TRUE;
-    size_t msgSize  = sizeof(unsigned int);                            // Command index
-    msgSize        += sizeof(cl_command_queue);                        // command_queue
+    size_t msgSize  = sizeof(cl_command_queue);                        // command_queue
     msgSize        += sizeof(cl_mem);                                  // image
     msgSize        += sizeof(cl_bool);                                 // blocking_read
     msgSize        += 3*sizeof(size_t);                                // origin
@@ -2913,7 +3533,6 @@ cl_int oclandEnqueueReadImage(cl_command_queue      command_queue ,
     msgSize        += num_events_in_wait_list*sizeof(event_wait_list); // event_wait_list
     void* msg = (void*)malloc(msgSize);
     void* mptr = msg;
-    ((unsigned int*)mptr)[0]     = ocland_clEnqueueReadImage; mptr = (unsigned int*)mptr + 1;
     ((cl_command_queue*)mptr)[0] = command_queue;             mptr = (cl_command_queue*)mptr + 1;
     ((cl_mem*)mptr)[0]           = image;                     mptr = (cl_mem*)mptr + 1;
     ((cl_bool*)mptr)[0]          = blocking_read;             mptr = (cl_bool*)mptr + 1;
@@ -2924,26 +3543,28 @@ cl_int oclandEnqueueReadImage(cl_command_queue      command_queue ,
     ((cl_bool*)mptr)[0]          = want_event;                mptr = (cl_bool*)mptr + 1;
     ((cl_uint*)mptr)[0]          = num_events_in_wait_list;   mptr = (cl_uint*)mptr + 1;
     memcpy(mptr, event_wait_list, num_events_in_wait_list*sizeof(cl_event));
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
-    free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
+    // Send the package, and wait for the answer
+    uint32_t request_id;
+    void *answer;
+    if(blocking_read == CL_TRUE)
+        answer = oclandSinkRequest(sockfd, ocland_clEnqueueReadImage, msg, &msgSize,
+                                   sizeof(cl_int) + sizeof(cl_event), ptr, cb);
+    else
+        answer = oclandTransferRequest(sockfd, ocland_clEnqueueReadImage, msg, &msgSize,
+                                       command_queue, ptr, cb, &request_id);
+    free(msg); msg=answer;
     mptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
     // Decript the flag, if CL_SUCCESS don't received, we can't
     // still working
     cl_int flag = ((cl_int*)mptr)[0]; mptr = (cl_int*)mptr + 1;
-    if(flag != CL_SUCCESS)
+    if(flag != CL_SUCCESS){
+        free(msg); msg=NULL;
         return flag;
-    size_t cb = region[2]*slice_pitch + region[1]*row_pitch + region[0]*element_size;
+    }
     // ------------------------------------------------------------
     // Blocking read case:
-    // We may have received the flag, the event, and the data.
+    // We may have received the flag, and the event. The data has
+    // been received straight into ptr, unless it does not fit.
     // ------------------------------------------------------------
     if(blocking_read == CL_TRUE){
         revent = ((cl_event*)mptr)[0]; mptr = (cl_event*)mptr + 1;
@@ -2951,106 +3572,25 @@ cl_int oclandEnqueueReadImage(cl_command_queue      command_queue ,
             *event = revent;
             addShortcut(*event, sockfd);
         }
-        memcpy(ptr, mptr, cb);
+        if(msgSize >= sizeof(cl_int) + sizeof(cl_event) + cb)
+            memcpy(ptr, mptr, cb);
+        free(msg); msg=NULL;
         return flag;
     }
     // ------------------------------------------------------------
     // Asynchronous read case:
-    // We may have received the flag, the event, and a port to open
-    // a parallel transfer channel.
+    // We may have received the flag, and the event. The data will
+    // arrive through the data channel.
     // ------------------------------------------------------------
     revent = ((cl_event*)mptr)[0]; mptr = (cl_event*)mptr + 1;
     if(event){
         *event = revent;
         addShortcut(*event, sockfd);
     }
-    unsigned int port = ((unsigned int*)mptr)[0];
-    struct dataTransferRect data;
-    data.port   = port;
-    data.fd     = *sockfd;
-    data.region = region;
-    data.row    = row_pitch;
-    data.slice  = slice_pitch;
-    data.cb     = cb;
-    data.ptr    = ptr;
-    asyncDataRecvRect(sockfd, data);
+    free(msg); msg=NULL;
     return flag;
 }
 
-/** Thread that sends data to server.
- * @param data struct dataTransfer casted variable.
- * @return NULL
- */
-void *asyncDataSendRect_thread(void *data)
-{
-    struct dataTransferRect* _data = (struct dataTransferRect*)data;
-    // Connect to the received port.
-    unsigned int port = _data->port;
-    struct sockaddr_in serv_addr;
-    int fd = socket(AF_INET, SOCK_STREAM, 0);
-    if(fd < 0){
-        printf("ERROR: Can't register a new socket for the asynchronous data transfer\n"); fflush(stdout);
-        return;
-    }
-    memset(&serv_addr, '0', sizeof(serv_addr));
-    socklen_t len_inet;
-    len_inet = sizeof(serv_addr);
-    char* ip = serverAddress(_data->fd);
-    if(!ip){
-        printf("ERROR: Can't find the server associated with the socket\n"); fflush(stdout);
-        shutdown(fd, 2);
-        fd = -1;
-        return;
-    }
-    serv_addr.sin_family = AF_INET;
-    serv_addr.sin_port   = htons(port);
-    if(inet_pton(AF_INET, ip, &serv_addr.sin_addr)<=0){
-        // we can't work, disconnect from server
-        printf("ERROR: Invalid address assigment (%s)\n", ip); fflush(stdout);
-        shutdown(fd, 2);
-        fd = -1;
-        return;
-    }
-    while( connect(fd, (struct sockaddr *)&serv_addr, sizeof(serv_addr)) < 0 ){
-        if(errno == ECONNREFUSED){
-            // Pobably the server is not ready yet, simply retry
-            // it until the server start listening
-            continue;
-        }
-        // we can't work, disconnect from server
-        printf("ERROR: Can't connect for the asynchronous data transfer\n"); fflush(stdout);
-        printf("\t%s\n", SocketsError()); fflush(stdout);
-        shutdown(fd, 2);
-        fd = -1;
-        return;
-    }
-    // Send the data
-    Send(&fd, _data->ptr, _data->cb, 0);
-    free(_data); _data=NULL;
-    pthread_exit(NULL);
-    return NULL;
-}
-
-/** Performs a data reception asynchronously on a new thread and socket.
- * @param sockfd Connection socket.
- * @param data Data to transfer.
- */
-void asyncDataSendRect(int* sockfd, struct dataTransferRect data)
-{
-    // Open a new thread to connect to the new port
-    // and receive the data
-    pthread_t thread;
-    struct dataTransferRect* _data = (struct dataTransferRect*)malloc(sizeof(struct dataTransferRect));
-    _data->port  = data.port;
-    _data->fd    = data.fd;
-    _data->region = data.region;
-    _data->row    = data.row;
-    _data->slice  = data.slice;
-    _data->cb    = data.cb;
-    _data->ptr   = data.ptr;
-    int rc = pthread_create(&thread, NULL, asyncDataSendRect_thread, (void *)(_data));
-}
-
 cl_int oclandEnqueueWriteImage(cl_command_queue     command_queue ,
                                cl_mem               image ,
                                cl_bool              blocking_write ,
@@ -3070,12 +3610,14 @@ cl_int oclandEnqueueWriteImage(cl_command_queue     command_queue ,
     if(!sockfd){
         return CL_INVALID_EVENT;
     }
+    // The asynchronous transfers require the data channel
+    if((blocking_write != CL_TRUE) && (openChannel(sockfd) != CL_SUCCESS))
+        blocking_write = CL_TRUE;
     // Build the package
     size_t cb = region[2]*slice_pitch + region[1]*row_pitch + region[0]*element_size;
     cl_bool want_event = CL_FALSE;
     if(event) want_event = CL_TRUE;
-    size_t msgSize  = sizeof(unsigned int);                            // Command index
-    msgSize        += sizeof(cl_command_queue);                        // command_queue
+    size_t msgSize  = sizeof(cl_command_queue);                        // command_queue
     msgSize        += sizeof(cl_mem);                                  // image
     msgSize        += sizeof(cl_bool);                                 // blocking_write
     msgSize        += 3*sizeof(size_t);                                // origin
@@ -3089,7 +3631,6 @@ cl_int oclandEnqueueWriteImage(cl_command_queue     command_queue ,
         msgSize    += cb;                                              // ptr
     void* msg = (void*)malloc(msgSize);
     void* mptr = msg;
-    ((unsigned int*)mptr)[0]     = ocland_clEnqueueWriteImage; mptr = (unsigned int*)mptr + 1;
     ((cl_command_queue*)mptr)[0] = command_queue;              mptr = (cl_command_queue*)mptr + 1;
     ((cl_mem*)mptr)[0]           = image;                      mptr = (cl_mem*)mptr + 1;
     ((cl_bool*)mptr)[0]          = blocking_write;             mptr = (cl_bool*)mptr + 1;
@@ -3104,17 +3645,16 @@ cl_int oclandEnqueueWriteImage(cl_command_queue     command_queue ,
         mptr = (cl_event*)mptr + num_events_in_wait_list;
         memcpy(mptr, ptr, cb);
     }
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
-    free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
+    // Send the package, and wait for the answer
+    uint32_t request_id;
+    void *answer;
+    if(blocking_write == CL_TRUE)
+        answer = oclandRequest(sockfd, ocland_clEnqueueWriteImage, msg, &msgSize);
+    else
+        answer = oclandTransferRequest(sockfd, ocland_clEnqueueWriteImage, msg, &msgSize,
+                                       command_queue, NULL, cb, &request_id);
+    free(msg); msg=answer;
     mptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
     // Decript the flag, if CL_SUCCESS don't received, we can't
     // still working
     cl_int flag = ((cl_int*)mptr)[0]; mptr = (cl_int*)mptr + 1;
@@ -3133,25 +3673,21 @@ cl_int oclandEnqueueWriteImage(cl_command_queue     command_queue ,
         return flag;
     }
     // ------------------------------------------------------------
-    // Asynchronous read case:
-    // We may have received the flag, the event, and a port to open
-    // a parallel transfer channel.
+    // Asynchronous write case:
+    // We may have received the flag, and the event. The server is
+    // waiting for the data in the data channel.
     // ------------------------------------------------------------
     revent = ((cl_event*)mptr)[0]; mptr = (cl_event*)mptr + 1;
     if(event){
         *event = revent;
         addShortcut(*event, sockfd);
     }
-    unsigned int port = ((unsigned int*)mptr)[0];
-    struct dataTransferRect data;
-    data.port  = port;
-    data.fd    = *sockfd;
-    data.region = region;
-    data.row    = row_pitch;
-    data.slice  = slice_pitch;
-    data.cb    = cb;
-    data.ptr   = (void*)ptr;
-    asyncDataSendRect(sockfd, data);
+    struct dataTransfer data;
+    data.opcode     = ocland_clEnqueueWriteImage;
+    data.request_id = request_id;
+    data.cb         = cb;
+    data.ptr        = ptr;
+    asyncDataSend(sockfd, data);
     return flag;
 }
 
@@ -3174,8 +3710,7 @@ cl_mem oclandCreateImage2D(cl_context context,
     cl_bool hasPtr = CL_FALSE;
     if(host_ptr) hasPtr = CL_TRUE;
     size_t size = image_width*image_height*element_size;
-    size_t msgSize  = sizeof(unsigned int);    // Command index
-    msgSize        += sizeof(cl_context);      // context
+    size_t msgSize  = sizeof(cl_context);      // context
     msgSize        += sizeof(cl_mem_flags);    // flags
     msgSize        += sizeof(cl_image_format); // image_format
     msgSize        += sizeof(size_t);          // image_width
@@ -3185,7 +3720,6 @@ cl_mem oclandCreateImage2D(cl_context context,
     if(host_ptr) msgSize += size;              // host_ptr
     void* msg = (void*)malloc(msgSize);
     void* ptr = msg;
-    ((unsigned int*)ptr)[0]    = ocland_clCreateImage2D; ptr = (unsigned int*)ptr + 1;
     ((cl_context*)ptr)[0]      = context;                ptr = (cl_context*)ptr + 1;
     ((cl_mem_flags*)ptr)[0]    = flags;                  ptr = (cl_mem_flags*)ptr + 1;
     memcpy(ptr,image_format,sizeof(cl_image_format));    ptr = (cl_image_format*)ptr + 1;
@@ -3194,23 +3728,11 @@ cl_mem oclandCreateImage2D(cl_context context,
     ((size_t*)ptr)[0]          = image_row_pitch;        ptr = (size_t*)ptr + 1;
     ((cl_bool*)ptr)[0]         = hasPtr;                 ptr = (cl_bool*)ptr + 1;
     if(host_ptr) memcpy(ptr, host_ptr, size);
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
+    // Send the package, and get the created object
+    cl_mem memobj = (cl_mem)oclandHandleRequest(sockfd, ocland_clCreateImage2D, msg, msgSize, errcode_ret);
     free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
-    ptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
-    // Decript the data
-    cl_int flag = ((cl_int*)ptr)[0]; ptr = (cl_int*)ptr  + 1;
-    if(errcode_ret) *errcode_ret = flag;
-    if(flag != CL_SUCCESS)
+    if(!memobj)
         return NULL;
-    cl_mem memobj = ((cl_mem*)ptr)[0];
     addShortcut((void*)memobj, sockfd);
     return memobj;
 }
@@ -3236,8 +3758,7 @@ cl_mem oclandCreateImage3D(cl_context context,
     cl_bool hasPtr = CL_FALSE;
     if(host_ptr) hasPtr = CL_TRUE;
     size_t size = image_width*image_height*image_depth*element_size;
-    size_t msgSize  = sizeof(unsigned int);    // Command index
-    msgSize        += sizeof(cl_context);      // context
+    size_t msgSize  = sizeof(cl_context);      // context
     msgSize        += sizeof(cl_mem_flags);    // flags
     msgSize        += sizeof(cl_image_format); // image_format
     msgSize        += sizeof(size_t);          // image_width
@@ -3249,7 +3770,6 @@ cl_mem oclandCreateImage3D(cl_context context,
     if(host_ptr) msgSize += size;              // host_ptr
     void* msg = (void*)malloc(msgSize);
     void* ptr = msg;
-    ((unsigned int*)ptr)[0]    = ocland_clCreateImage3D; ptr = (unsigned int*)ptr + 1;
     ((cl_context*)ptr)[0]      = context;                ptr = (cl_context*)ptr + 1;
     ((cl_mem_flags*)ptr)[0]    = flags;                  ptr = (cl_mem_flags*)ptr + 1;
     memcpy(ptr,image_format,sizeof(cl_image_format));    ptr = (cl_image_format*)ptr + 1;
@@ -3260,23 +3780,11 @@ cl_mem oclandCreateImage3D(cl_context context,
     ((size_t*)ptr)[0]          = image_slice_pitch;      ptr = (size_t*)ptr + 1;
     ((cl_bool*)ptr)[0]         = hasPtr;                 ptr = (cl_bool*)ptr + 1;
     if(host_ptr) memcpy(ptr, host_ptr, size);
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
+    // Send the package, and get the created object
+    cl_mem memobj = (cl_mem)oclandHandleRequest(sockfd, ocland_clCreateImage3D, msg, msgSize, errcode_ret);
     free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
-    ptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
-    // Decript the data
-    cl_int flag = ((cl_int*)ptr)[0]; ptr = (cl_int*)ptr  + 1;
-    if(errcode_ret) *errcode_ret = flag;
-    if(flag != CL_SUCCESS)
+    if(!memobj)
         return NULL;
-    cl_mem memobj = ((cl_mem*)ptr)[0];
     addShortcut((void*)memobj, sockfd);
     return memobj;
 }
@@ -3299,37 +3807,23 @@ cl_mem oclandCreateSubBuffer(cl_mem                    buffer ,
         return CL_INVALID_MEM_OBJECT;
     }
     // Build the package
-    size_t msgSize  = sizeof(unsigned int);                  // Command index
-    msgSize        += sizeof(cl_mem);                        // context
+    size_t msgSize  = sizeof(cl_mem);                        // context
     msgSize        += sizeof(cl_mem_flags);                  // flags
     msgSize        += sizeof(cl_buffer_create_type);         // buffer_create_type
     if(buffer_create_type == CL_BUFFER_CREATE_TYPE_REGION)
         msgSize        += sizeof(cl_buffer_region);          // buffer_create_info
     void* msg = (void*)malloc(msgSize);
     void* ptr = msg;
-    ((unsigned int*)ptr)[0]          = ocland_clCreateSubBuffer; ptr = (unsigned int*)ptr + 1;
     ((cl_mem*)ptr)[0]                = buffer;                   ptr = (cl_mem*)ptr + 1;
     ((cl_buffer_create_type*)ptr)[0] = flags;                    ptr = (cl_buffer_create_type*)ptr + 1;
     if(buffer_create_type == CL_BUFFER_CREATE_TYPE_REGION){
         memcpy(ptr,buffer_create_info,sizeof(cl_buffer_region));
     }
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
+    // Send the package, and get the created object
+    cl_mem memobj = (cl_mem)oclandHandleRequest(sockfd, ocland_clCreateSubBuffer, msg, msgSize, errcode_ret);
     free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
-    ptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
-    // Decript the data
-    cl_int flag = ((cl_int*)ptr)[0]; ptr = (cl_int*)ptr  + 1;
-    if(errcode_ret) *errcode_ret = flag;
-    if(flag != CL_SUCCESS)
+    if(!memobj)
         return NULL;
-    cl_mem memobj = ((cl_mem*)ptr)[0];
     addShortcut((void*)memobj, sockfd);
     return memobj;
 }
@@ -3343,23 +3837,14 @@ cl_event oclandCreateUserEvent(cl_context     context ,
         return CL_INVALID_CONTEXT;
     }
     // Build the package
-    size_t msgSize  = sizeof(unsigned int);                  // Command index
-    msgSize        += sizeof(cl_context);                    // context
+    size_t msgSize  = sizeof(cl_context);                    // context
     void* msg = (void*)malloc(msgSize);
     void* ptr = msg;
-    ((unsigned int*)ptr)[0] = ocland_clCreateUserEvent; ptr = (unsigned int*)ptr + 1;
     ((cl_context*)ptr)[0]   = context;                  ptr = (cl_context*)ptr + 1;
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
-    free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
+    // Send the package, and wait for the answer
+    void *answer = oclandRequest(sockfd, ocland_clCreateUserEvent, msg, &msgSize);
+    free(msg); msg=answer;
     ptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
     // Decript the data
     cl_int flag = ((cl_int*)ptr)[0]; ptr = (cl_int*)ptr  + 1;
     if(errcode_ret) *errcode_ret = flag;
@@ -3379,25 +3864,16 @@ cl_int oclandSetUserEventStatus(cl_event    event ,
         return CL_INVALID_EVENT;
     }
     // Build the package
-    size_t msgSize  = sizeof(unsigned int);            // Command index
-    msgSize        += sizeof(cl_event);                // event
+    size_t msgSize  = sizeof(cl_event);                // event
     msgSize        += sizeof(cl_int);                  // execution_status
     void* msg = (void*)malloc(msgSize);
     void* ptr = msg;
-    ((unsigned int*)ptr)[0] = ocland_clSetUserEventStatus; ptr = (unsigned int*)ptr + 1;
     ((cl_event*)ptr)[0]     = event;                       ptr = (cl_event*)ptr + 1;
     ((cl_int*)ptr)[0]       = execution_status;            ptr = (cl_int*)ptr + 1;
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
-    free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
+    // Send the package, and wait for the answer
+    void *answer = oclandRequest(sockfd, ocland_clSetUserEventStatus, msg, &msgSize);
+    free(msg); msg=answer;
     ptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
     // Decript the data
     cl_int flag = ((cl_int*)ptr)[0];
     return flag;
@@ -3418,89 +3894,8 @@ cl_int oclandEnqueueReadBufferRect(cl_command_queue     command_queue ,
                                    const cl_event *     event_wait_list ,
                                    cl_event *           event)
 {
-    char buffer[BUFF_SIZE];
-    cl_bool want_event = CL_FALSE;
-    // Look for a shortcut
-    int *sockfd = getShortcut(command_queue);
-    if(!sockfd){
-        return CL_INVALID_COMMAND_QUEUE;
-    }
-    // Execute the command on server
-    unsigned int commDim = strlen("clEnqueueReadBufferRect")+1;
-    Send(sockfd, &commDim, sizeof(unsigned int), 0);
-    // Send command to perform
-    strcpy(buffer, "clEnqueueReadBufferRect");
-    Send(sockfd, buffer, strlen(buffer)+1, 0);
-    // Send parameters. Host origin will be omissed for the
-    // server, and all the responsability to generate store
-    // the input data is rely to the client.
-    Send(sockfd, &command_queue, sizeof(cl_command_queue), 0);
-    Send(sockfd, &mem, sizeof(cl_mem), 0);
-    Send(sockfd, &blocking_read, sizeof(cl_bool), 0);
-    Send(sockfd, buffer_origin, 3*sizeof(size_t), 0);
-    Send(sockfd, region, 3*sizeof(size_t), 0);
-    Send(sockfd, &buffer_row_pitch, sizeof(size_t), 0);
-    Send(sockfd, &buffer_slice_pitch, sizeof(size_t), 0);
-    Send(sockfd, &host_row_pitch, sizeof(size_t), 0);
-    Send(sockfd, &host_slice_pitch, sizeof(size_t), 0);
-    Send(sockfd, &num_events_in_wait_list, sizeof(cl_uint), 0);
-    if(num_events_in_wait_list)
-        Send(sockfd, &event_wait_list, num_events_in_wait_list*sizeof(cl_event), 0);
-    if(event)
-        want_event = CL_TRUE;
-    Send(sockfd, &want_event, sizeof(cl_bool), 0);
-    // And request flag, and event if needed
-    cl_int flag = CL_INVALID_CONTEXT;
-    Recv(sockfd, &flag, sizeof(cl_int), MSG_WAITALL);
-    if(flag != CL_SUCCESS)
-        return flag;
-    if(event){
-        Recv(sockfd, event, sizeof(cl_event), MSG_WAITALL);
-        addShortcut(*event, sockfd);
-    }
-    size_t origin = host_origin[0] +
-                    host_origin[1]*host_row_pitch +
-                    host_origin[2]*host_slice_pitch;
-    // In case of blocking simply receive the data.
-    // In rect reading process the data will read in
-    // blocks of host_row_pitch size, along all the
-    // region specified.
-    if(blocking_read == CL_TRUE){
-        unsigned int i, j, k, n;
-        // Receive first the buffer purposed by server,
-        // in order to can send data larger than the transfer
-        // buffer.
-        size_t buffsize;
-        Recv(sockfd, &buffsize, sizeof(size_t), MSG_WAITALL);
-        if(!buffsize){
-            return CL_OUT_OF_HOST_MEMORY;
-        }
-        // Compute the number of packages needed per row
-        n = host_row_pitch / buffsize;
-        for(j=0;j<region[1];j++){
-            for(k=0;k<region[2];k++){
-                // Receive package by pieces
-                for(i=0;i<n;i++){
-                    Send(sockfd, ptr + i*buffsize + origin, buffsize, 0);
-                }
-                if(host_row_pitch % buffsize){
-                    // Remains some data to transfer
-                    Send(sockfd, ptr + n*buffsize + origin, host_row_pitch % buffsize, 0);
-                }
-                // Compute the new origin
-                origin += host_row_pitch;
-            }
-        }
-        return flag;
-    }
-    // In the non blocking case more complex operations are requested
-    struct dataTransferRect data;
-    data.region = region;
-    data.row    = host_row_pitch;
-    data.slice  = host_slice_pitch;
-    data.ptr    = ptr + origin;
-    asyncDataRecvRect(sockfd, data);
-    return flag;
+    // The server does not serve this command yet
+    return CL_INVALID_OPERATION;
 }
 
 cl_int oclandEnqueueWriteBufferRect(cl_command_queue     command_queue ,
@@ -3518,87 +3913,8 @@ cl_int oclandEnqueueWriteBufferRect(cl_command_queue     command_queue ,
                                     const cl_event *     event_wait_list ,
                                     cl_event *           event)
 {
-    char buffer[BUFF_SIZE];
-    cl_bool want_event = CL_FALSE;
-    // Look for a shortcut
-    int *sockfd = getShortcut(command_queue);
-    if(!sockfd){
-        return CL_INVALID_COMMAND_QUEUE;
-    }
-    // Execute the command on server
-    unsigned int commDim = strlen("clEnqueueWriteBufferRect")+1;
-    Send(sockfd, &commDim, sizeof(unsigned int), 0);
-    // Send command to perform
-    strcpy(buffer, "clEnqueueWriteBufferRect");
-    Send(sockfd, buffer, strlen(buffer)+1, 0);
-    // Send parameters
-    Send(sockfd, &command_queue, sizeof(cl_command_queue), 0);
-    Send(sockfd, &mem, sizeof(cl_mem), 0);
-    Send(sockfd, &blocking_write, sizeof(cl_bool), 0);
-    Send(sockfd, buffer_origin, 3*sizeof(size_t), 0);
-    Send(sockfd, region, 3*sizeof(size_t), 0);
-    Send(sockfd, &buffer_row_pitch, sizeof(size_t), 0);
-    Send(sockfd, &buffer_slice_pitch, sizeof(size_t), 0);
-    Send(sockfd, &host_row_pitch, sizeof(size_t), 0);
-    Send(sockfd, &host_slice_pitch, sizeof(size_t), 0);
-    Send(sockfd, &num_events_in_wait_list, sizeof(cl_uint), 0);
-    if(num_events_in_wait_list)
-        Send(sockfd, &event_wait_list, num_events_in_wait_list*sizeof(cl_event), 0);
-    if(event)
-        want_event = CL_TRUE;
-    Send(sockfd, &want_event, sizeof(cl_bool), 0);
-    // And request flag, and event if request
-    cl_int flag = CL_INVALID_CONTEXT;
-    Recv(sockfd, &flag, sizeof(cl_int), MSG_WAITALL);
-    if(flag != CL_SUCCESS)
-        return flag;
-    if(event){
-        Recv(sockfd, event, sizeof(cl_event), MSG_WAITALL);
-        addShortcut(*event, sockfd);
-    }
-    // In case of blocking simply receive the data
-    if(blocking_write == CL_TRUE){
-        unsigned int i,j,k,n;
-        // Receive first the buffer purposed by server,
-        // in order to can send data larger than the transfer
-        // buffer.
-        size_t buffsize;
-        Recv(sockfd, &buffsize, sizeof(size_t), MSG_WAITALL);
-        if(!buffsize){
-            return CL_OUT_OF_HOST_MEMORY;
-        }
-        // Compute the number of packages needed
-        n = host_row_pitch / buffsize;
-        // Send package by pieces
-        size_t origin=0;
-        for(j=0;j<region[1];j++){
-            for(k=0;k<region[2];k++){
-                // Receive package by pieces
-                for(i=0;i<n;i++){
-                    Send(sockfd, (void*)ptr + i*buffsize + origin, buffsize, 0);
-                }
-                if(host_row_pitch % buffsize){
-                    // Remains some data to transfer
-                    Send(sockfd, (void*)ptr + n*buffsize + origin, host_row_pitch % buffsize, 0);
-                }
-                // Compute the new origin
-                origin += host_row_pitch;
-            }
-        }
-        // Get new flag after clEnqueueWriteBuffer has been
-        // called in the server
-        flag = CL_INVALID_CONTEXT;
-        Recv(sockfd, &flag, sizeof(cl_int), MSG_WAITALL);
-        return flag;
-    }
-    // In the non blocking case more complex operations are requested
-    struct dataTransferRect data;
-    data.region = region;
-    data.row    = host_row_pitch;
-    data.slice  = host_slice_pitch;
-    data.ptr    = (void*)ptr;
-    asyncDataSendRect(sockfd, data);
-    return flag;
+    // The server does not serve this command yet
+    return CL_INVALID_OPERATION;
 }
 
 cl_int oclandEnqueueCopyBufferRect(cl_command_queue     command_queue ,
@@ -3615,46 +3931,8 @@ cl_int oclandEnqueueCopyBufferRect(cl_command_queue     command_queue ,
                                    const cl_event *     event_wait_list ,
                                    cl_event *           event)
 {
-    char buffer[BUFF_SIZE];
-    cl_bool want_event = CL_FALSE;
-    // Look for a shortcut
-    int *sockfd = getShortcut(command_queue);
-    if(!sockfd){
-        return CL_INVALID_COMMAND_QUEUE;
-    }
-    // Execute the command on server
-    unsigned int commDim = strlen("clEnqueueCopyBufferRect")+1;
-    Send(sockfd, &commDim, sizeof(unsigned int), 0);
-    // Send command to perform
-    strcpy(buffer, "clEnqueueCopyBufferRect");
-    Send(sockfd, buffer, strlen(buffer)+1, 0);
-    // Send parameters
-    Send(sockfd, &command_queue, sizeof(cl_command_queue), 0);
-    Send(sockfd, &src_buffer, sizeof(cl_mem), 0);
-    Send(sockfd, &dst_buffer, sizeof(cl_mem), 0);
-    Send(sockfd, src_origin, 3*sizeof(size_t), 0);
-    Send(sockfd, dst_origin, 3*sizeof(size_t), 0);
-    Send(sockfd, region, 3*sizeof(size_t), 0);
-    Send(sockfd, &src_row_pitch, sizeof(size_t), 0);
-    Send(sockfd, &src_slice_pitch, sizeof(size_t), 0);
-    Send(sockfd, &dst_row_pitch, sizeof(size_t), 0);
-    Send(sockfd, &dst_slice_pitch, sizeof(size_t), 0);
-    Send(sockfd, &num_events_in_wait_list, sizeof(cl_uint), 0);
-    if(num_events_in_wait_list)
-        Send(sockfd, &event_wait_list, num_events_in_wait_list*sizeof(cl_event), 0);
-    if(event)
-        want_event = CL_TRUE;
-    Send(sockfd, &want_event, sizeof(cl_bool), 0);
-    // And request flag, and event if request
-    cl_int flag = CL_INVALID_CONTEXT;
-    Recv(sockfd, &flag, sizeof(cl_int), MSG_WAITALL);
-    if(flag != CL_SUCCESS)
-        return flag;
-    if((flag != CL_SUCCESS) && (event)){
-        Recv(sockfd, event, sizeof(cl_event), MSG_WAITALL);
-        addShortcut(*event, sockfd);
-    }
-    return flag;
+    // The server does not serve this command yet
+    return CL_INVALID_OPERATION;
 }
 
 // -------------------------------------------- //
@@ -3670,144 +3948,20 @@ cl_int oclandCreateSubDevices(cl_device_id                         in_device,
                               cl_device_id                       * out_devices,
                               cl_uint                            * num_devices)
 {
-    unsigned int i;
-    char buffer[BUFF_SIZE];
-    // Ensure that ocland is already running
-    // and exist servers to use
-    if(!oclandInit()){
-        return CL_INVALID_DEVICE;
-    }
-    // Try platform in all servers
-    for(i=0;i<servers->num_servers;i++){
-        if(servers->sockets[i] < 0)
-            continue;
-        int *sockfd = &(servers->sockets[i]);
-        // Send starting command declaration
-        unsigned int commDim = strlen("clCreateSubDevices")+1;
-        Send(sockfd, &commDim, sizeof(unsigned int), 0);
-        // Send command to perform
-        strcpy(buffer, "clCreateSubDevices");
-        Send(sockfd, buffer, strlen(buffer)+1, 0);
-        // Send parameters (we need to send size of properties)
-        Send(sockfd, &in_device, sizeof(cl_platform_id), 0);
-        size_t sProps = 0;
-        if(properties){
-            // Only CL_CONTEXT_PLATFORM will be supported, D3D ar GL can't be enabled in network
-            sProps = num_properties*sizeof(cl_device_partition_property);
-            Send(sockfd, &sProps, sizeof(size_t), 0);
-            Send(sockfd, properties, sProps, 0);
-        }
-        else{
-            Send(sockfd, &sProps, sizeof(size_t), 0);
-        }
-        Send(sockfd, &num_entries, sizeof(cl_uint), 0);
-        // And request flag and real size of object
-        cl_int flag = CL_INVALID_DEVICE;
-        cl_uint size = 0;
-        Recv(sockfd, &flag, sizeof(cl_int), MSG_WAITALL);
-        Recv(sockfd, &size, sizeof(cl_uint), MSG_WAITALL);
-        if(flag != CL_SUCCESS){
-            // 2 possibilities, not right server or error
-            if(flag == CL_INVALID_DEVICE)
-                continue;
-            return flag;
-        }
-        if(!num_entries){
-            if(num_devices) *num_devices = size;
-            if(*sockfd < 0)
-                return CL_INVALID_DEVICE;
-            return CL_SUCCESS;
-        }
-        // Get returned info
-        Recv(sockfd, out_devices, size*sizeof(cl_device_id), MSG_WAITALL);
-        if(num_devices) *num_devices = size;
-        // A little bit special case when data transfer could failed
-        if(*sockfd < 0)
-            continue;
-        return CL_SUCCESS;
-    }
-    // Device not found on any server
-    return CL_INVALID_DEVICE;
+    // The server does not serve this command yet
+    return CL_INVALID_OPERATION;
 }
 
 cl_int oclandRetainDevice(cl_device_id device)
 {
-    unsigned int i;
-    char buffer[BUFF_SIZE];
-    // Ensure that ocland is already running
-    // and exist servers to use
-    if(!oclandInit()){
-        return CL_INVALID_DEVICE;
-    }
-    // Try platform in all servers
-    for(i=0;i<servers->num_servers;i++){
-        if(servers->sockets[i] < 0)
-            continue;
-        int *sockfd = &(servers->sockets[i]);
-        // Send starting command declaration
-        unsigned int commDim = strlen("clRetainDevice")+1;
-        Send(sockfd, &commDim, sizeof(unsigned int), 0);
-        // Send command to perform
-        strcpy(buffer, "clRetainDevice");
-        Send(sockfd, buffer, strlen(buffer)+1, 0);
-        // Send parameters (we need to send size of properties)
-        Send(sockfd, &device, sizeof(cl_platform_id), 0);
-        // And request flag and real size of object
-        cl_int flag = CL_INVALID_DEVICE;
-        Recv(sockfd, &flag, sizeof(cl_int), MSG_WAITALL);
-        if(flag != CL_SUCCESS){
-            // 2 possibilities, not right server or error
-            if(flag == CL_INVALID_DEVICE)
-                continue;
-            return flag;
-        }
-        // A little bit special case when data transfer could failed
-        if(*sockfd < 0)
-            continue;
-        return CL_SUCCESS;
-    }
-    // Device not found on any server
-    return CL_INVALID_DEVICE;
+    // The server does not serve this command yet
+    return CL_INVALID_OPERATION;
 }
 
 cl_int oclandReleaseDevice(cl_device_id device)
 {
-    unsigned int i;
-    char buffer[BUFF_SIZE];
-    // Ensure that ocland is already running
-    // and exist servers to use
-    if(!oclandInit()){
-        return CL_INVALID_DEVICE;
-    }
-    // Try platform in all servers
-    for(i=0;i<servers->num_servers;i++){
-        if(servers->sockets[i] < 0)
-            continue;
-        int *sockfd = &(servers->sockets[i]);
-        // Send starting command declaration
-        unsigned int commDim = strlen("clReleaseDevice")+1;
-        Send(sockfd, &commDim, sizeof(unsigned int), 0);
-        // Send command to perform
-        strcpy(buffer, "clReleaseDevice");
-        Send(sockfd, buffer, strlen(buffer)+1, 0);
-        // Send parameters (we need to send size of properties)
-        Send(sockfd, &device, sizeof(cl_platform_id), 0);
-        // And request flag and real size of object
-        cl_int flag = CL_INVALID_DEVICE;
-        Recv(sockfd, &flag, sizeof(cl_int), MSG_WAITALL);
-        if(flag != CL_SUCCESS){
-            // 2 possibilities, not right server or error
-            if(flag == CL_INVALID_DEVICE)
-                continue;
-            return flag;
-        }
-        // A little bit special case when data transfer could failed
-        if(*sockfd < 0)
-            continue;
-        return CL_SUCCESS;
-    }
-    // Device not found on any server
-    return CL_INVALID_DEVICE;
+    // The server does not serve this command yet
+    return CL_INVALID_OPERATION;
 }
 
 cl_mem oclandCreateImage(cl_context              context,
@@ -3827,8 +3981,7 @@ cl_mem oclandCreateImage(cl_context              context,
     size_t size = image_desc->image_width*image_desc->image_height*image_desc->image_depth*element_size;
     cl_bool hasPtr = CL_FALSE;
     if(host_ptr) hasPtr = CL_TRUE;
-    size_t msgSize  = sizeof(unsigned int);    // Command index
-    msgSize        += sizeof(cl_context);      // context
+    size_t msgSize  = sizeof(cl_context);      // context
     msgSize        += sizeof(cl_mem_flags);    // flags
     msgSize        += sizeof(cl_image_format); // image_format
     msgSize        += sizeof(cl_image_desc);   // cl_image_desc
@@ -3836,30 +3989,17 @@ cl_mem oclandCreateImage(cl_context              context,
     if(host_ptr) msgSize += size;              // host_ptr
     void* msg = (void*)malloc(msgSize);
     void* ptr = msg;
-    ((unsigned int*)ptr)[0]    = ocland_clCreateImage; ptr = (unsigned int*)ptr + 1;
     ((cl_context*)ptr)[0]      = context;              ptr = (cl_context*)ptr + 1;
     ((cl_mem_flags*)ptr)[0]    = flags;                ptr = (cl_mem_flags*)ptr + 1;
     memcpy(ptr,image_format,sizeof(cl_image_format));  ptr = (cl_image_format*)ptr + 1;
     memcpy(ptr,image_desc,sizeof(cl_image_desc));      ptr = (cl_image_desc*)ptr + 1;
     ((cl_bool*)ptr)[0]         = hasPtr;                 ptr = (cl_bool*)ptr + 1;
     if(host_ptr) memcpy(ptr, host_ptr, size);
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
+    // Send the package, and get the created object
+    cl_mem memobj = (cl_mem)oclandHandleRequest(sockfd, ocland_clCreateImage, msg, msgSize, errcode_ret);
     free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
-    ptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
-    // Decript the data
-    cl_int flag = ((cl_int*)ptr)[0]; ptr = (cl_int*)ptr  + 1;
-    if(errcode_ret) *errcode_ret = flag;
-    if(flag != CL_SUCCESS)
+    if(!memobj)
         return NULL;
-    cl_mem memobj = ((cl_mem*)ptr)[0];
     addShortcut((void*)memobj, sockfd);
     return memobj;
 }
@@ -3870,60 +4010,9 @@ cl_program oclandCreateProgramWithBuiltInKernels(cl_context             context
                                                  const char *           kernel_names ,
                                                  cl_int *               errcode_ret)
 {
-    unsigned int i,n;
-    char buffer[BUFF_SIZE];
-    cl_program program = NULL;
-    cl_int flag = CL_INVALID_CONTEXT;
-    // Ensure that ocland is already running
-    // and exist servers to use
-    if(!oclandInit()){
-        if(errcode_ret) *errcode_ret = CL_INVALID_CONTEXT;
-        return NULL;
-    }
-    // Look for a shortcut for the context
-    int *sockfd = getShortcut(context);
-    if(!sockfd){
-        if(errcode_ret) *errcode_ret = CL_INVALID_CONTEXT;
-        return NULL;
-    }
-    // Execute the command on server
-    unsigned int commDim = strlen("clCreateProgramWithBuiltInKernels")+1;
-    Send(sockfd, &commDim, sizeof(unsigned int), 0);
-    // Send command to perform
-    strcpy(buffer, "clCreateProgramWithBuiltInKernels");
-    Send(sockfd, buffer, strlen(buffer)+1, 0);
-    // Send parameters
-    Send(sockfd, &context, sizeof(cl_context), 0);
-    Send(sockfd, &num_devices, sizeof(cl_uint), 0);
-    Send(sockfd, device_list, num_devices*sizeof(cl_device_id), 0);
-    size_t size = (strlen(kernel_names)+1)*sizeof(char);
-    Send(sockfd, &size, sizeof(size_t), 0);
-    // Receive first the buffer purposed by server,
-    // in order to can send data larger than the transfer
-    // buffer.
-    size_t buffsize;
-    Recv(sockfd, &buffsize, sizeof(size_t), MSG_WAITALL);
-    if(!buffsize){
-        if(errcode_ret) *errcode_ret = CL_OUT_OF_HOST_MEMORY;
-        return NULL;
-    }
-    // Compute the number of packages needed
-    n = size / buffsize;
-    // Send package by pieces
-    for(i=0;i<n;i++){
-        Send(sockfd, kernel_names + i*buffsize, buffsize, 0);
-    }
-    if(size % buffsize){
-        // Remains some data to transfer
-        Send(sockfd, kernel_names + n*buffsize, size % buffsize, 0);
-    }
-    // And request flag and result
-    Recv(sockfd, &flag, sizeof(cl_int), MSG_WAITALL);
-    Recv(sockfd, &program, sizeof(cl_program), MSG_WAITALL);
-    if(errcode_ret) *errcode_ret = flag;
-    // Register the buffer
-    addShortcut((void*)program, sockfd);
-    return program;
+    // The server does not serve this command yet
+    if(errcode_ret) *errcode_ret = CL_INVALID_OPERATION;
+    return NULL;
 }
 
 cl_int oclandCompileProgram(cl_program            program ,
@@ -3936,71 +4025,8 @@ cl_int oclandCompileProgram(cl_program            program ,
                             void (CL_CALLBACK *   pfn_notify)(cl_program  program , void *  user_data),
                             void *                user_data)
 {
-    unsigned int i,j,n;
-    char buffer[BUFF_SIZE];
-    cl_int flag = CL_INVALID_PROGRAM;
-    // Ensure that ocland is already running
-    // and exist servers to use
-    if(!oclandInit()){
-        return CL_INVALID_PROGRAM;
-    }
-    // Look for a shortcut
-    int *sockfd = getShortcut(program);
-    if(!sockfd){
-        return CL_INVALID_PROGRAM;
-    }
-    // Execute the command on server
-    unsigned int commDim = strlen("clCompileProgram")+1;
-    Send(sockfd, &commDim, sizeof(unsigned int), 0);
-    // Send command to perform
-    strcpy(buffer, "clCompileProgram");
-    Send(sockfd, buffer, strlen(buffer)+1, 0);
-    // Send parameters
-    Send(sockfd, &program, sizeof(cl_program), 0);
-    Send(sockfd, &num_devices, sizeof(cl_uint), 0);
-    if(num_devices)
-        Send(sockfd, device_list, num_devices*sizeof(cl_device_id), 0);
-    size_t size = (strlen(options)+1)*sizeof(char);
-    Send(sockfd, &size, sizeof(size_t), 0);
-    // Receive first the buffer purposed by server,
-    // in order to can send data larger than the transfer
-    // buffer.
-    size_t buffsize;
-    Recv(sockfd, &buffsize, sizeof(size_t), MSG_WAITALL);
-    if(!buffsize){
-        return CL_OUT_OF_HOST_MEMORY;
-    }
-    // Compute the number of packages needed
-    n = size / buffsize;
-    // Send package by pieces
-    for(i=0;i<n;i++){
-        Send(sockfd, options + i*buffsize, buffsize, 0);
-    }
-    if(size % buffsize){
-        // Remains some data to transfer
-        Send(sockfd, options + n*buffsize, size % buffsize, 0);
-    }
-    Send(sockfd, &num_input_headers, sizeof(cl_uint), 0);
-    if(num_input_headers){
-        Send(sockfd, input_headers, num_input_headers*sizeof(cl_program), 0);
-        for(i=0;i<num_input_headers;i++){
-            size = (strlen(header_include_names[i])+1)*sizeof(char);
-            Send(sockfd, &size, sizeof(size_t), 0);
-            // Compute the number of packages needed
-            n = size / buffsize;
-            // Send package by pieces
-            for(j=0;j<n;j++){
-                Send(sockfd, header_include_names[i] + j*buffsize, buffsize, 0);
-            }
-            if(size % buffsize){
-                // Remains some data to transfer
-                Send(sockfd, header_include_names[i] + n*buffsize, size % buffsize, 0);
-            }
-        }
-    }
-    // And request flag and result
-    Recv(sockfd, &flag, sizeof(cl_int), MSG_WAITALL);
-    return flag;
+    // The server does not serve this command yet
+    return CL_INVALID_OPERATION;
 }
 
 cl_program oclandLinkProgram(cl_context            context ,
@@ -4013,105 +4039,15 @@ cl_program oclandLinkProgram(cl_context            context ,
                              void *                user_data ,
                              cl_int *              errcode_ret)
 {
-    unsigned int i,n;
-    char buffer[BUFF_SIZE];
-    cl_program program = NULL;
-    cl_int flag = CL_INVALID_CONTEXT;
-    // Ensure that ocland is already running
-    // and exist servers to use
-    if(!oclandInit()){
-        if(errcode_ret) *errcode_ret=CL_INVALID_CONTEXT;
-        return program;
-    }
-    // Look for a shortcut
-    int *sockfd = getShortcut(context);
-    if(!sockfd){
-        if(errcode_ret) *errcode_ret=CL_INVALID_CONTEXT;
-        return program;
-    }
-    // Execute the command on server
-    unsigned int commDim = strlen("clLinkProgram")+1;
-    Send(sockfd, &commDim, sizeof(unsigned int), 0);
-    // Send command to perform
-    strcpy(buffer, "clLinkProgram");
-    Send(sockfd, buffer, strlen(buffer)+1, 0);
-    // Send parameters
-    Send(sockfd, &context, sizeof(cl_context), 0);
-    Send(sockfd, &num_devices, sizeof(cl_uint), 0);
-    if(num_devices)
-        Send(sockfd, device_list, num_devices*sizeof(cl_device_id), 0);
-    size_t size = (strlen(options)+1)*sizeof(char);
-    Send(sockfd, &size, sizeof(size_t), 0);
-    // Receive first the buffer purposed by server,
-    // in order to can send data larger than the transfer
-    // buffer.
-    size_t buffsize;
-    Recv(sockfd, &buffsize, sizeof(size_t), MSG_WAITALL);
-    if(!buffsize){
-        if(errcode_ret) *errcode_ret=CL_OUT_OF_HOST_MEMORY;
-        return program;
-    }
-    // Compute the number of packages needed
-    n = size / buffsize;
-    // Send package by pieces
-    for(i=0;i<n;i++){
-        Send(sockfd, options + i*buffsize, buffsize, 0);
-    }
-    if(size % buffsize){
-        // Remains some data to transfer
-        Send(sockfd, options + n*buffsize, size % buffsize, 0);
-    }
-    Send(sockfd, &num_input_programs, sizeof(cl_uint), 0);
-    Send(sockfd, input_programs, num_input_programs*sizeof(cl_program), 0);
-    // And request flag and result
-    Recv(sockfd, &flag, sizeof(cl_int), MSG_WAITALL);
-    Recv(sockfd, &program, sizeof(cl_program), MSG_WAITALL);
-    if(errcode_ret) *errcode_ret = flag;
-    if(flag == CL_SUCCESS){
-        // Register the new pointer
-        addShortcut((void *)program, sockfd);
-    }
-    return program;
+    // The server does not serve this command yet
+    if(errcode_ret) *errcode_ret = CL_INVALID_OPERATION;
+    return NULL;
 }
 
 cl_int oclandUnloadPlatformCompiler(cl_platform_id  platform)
 {
-    unsigned int i;
-    char buffer[BUFF_SIZE];
-    // Ensure that ocland is already running
-    // and exist servers to use
-    if(!oclandInit()){
-        return CL_INVALID_CONTEXT;
-    }
-    // Try platform in all servers
-    for(i=0;i<servers->num_servers;i++){
-        if(servers->sockets[i] < 0)
-            continue;
-        int *sockfd = &(servers->sockets[i]);
-        // Send starting command declaration
-        unsigned int commDim = strlen("clUnloadPlatformCompiler")+1;
-        Send(sockfd, &commDim, sizeof(unsigned int), 0);
-        // Send command to perform
-        strcpy(buffer, "clUnloadPlatformCompiler");
-        Send(sockfd, buffer, strlen(buffer)+1, 0);
-        // Send parameters
-        Send(sockfd, &platform, sizeof(cl_platform_id), 0);
-        // And request flag and real size of object
-        cl_int flag = CL_INVALID_PLATFORM;
-        Recv(sockfd, &flag, sizeof(cl_int), MSG_WAITALL);
-        if(flag != CL_SUCCESS){
-            // 2 possibilities, not right server or error
-            if(flag == CL_INVALID_PLATFORM)
-                continue;
-            return flag;
-        }
-        // Little bit special case when data transfer could failed
-        if(*sockfd < 0)
-            continue;
-        return CL_SUCCESS;
-    }
-    // Platform not found on any server
-    return CL_INVALID_PLATFORM;
+    // The server does not serve this command yet
+    return CL_INVALID_OPERATION;
 }
 
 cl_int oclandGetKernelArgInfo(cl_kernel            kernel ,
@@ -4127,35 +4063,73 @@ cl_int oclandGetKernelArgInfo(cl_kernel            kernel ,
         return CL_INVALID_KERNEL;
     }
     // Build the package
-    size_t msgSize  = sizeof(unsigned int);        // Command index
-    msgSize        += sizeof(cl_kernel);           // kernel
+    size_t msgSize  = sizeof(cl_kernel);           // kernel
     msgSize        += sizeof(cl_uint);             // arg_index
     msgSize        += sizeof(cl_kernel_arg_info);  // param_name
     msgSize        += sizeof(size_t);              // param_value_size
     void* msg = (void*)malloc(msgSize);
     void* ptr = msg;
-    ((unsigned int*)ptr)[0]   = ocland_clGetKernelArgInfo; ptr = (unsigned int*)ptr + 1;
     ((cl_kernel*)ptr)[0]      = kernel;           ptr = (cl_kernel*)ptr + 1;
     ((cl_uint*)ptr)[0]        = arg_index;        ptr = (cl_uint*)ptr + 1;
     ((cl_kernel_arg_info*)ptr)[0] = param_name;   ptr = (cl_kernel_arg_info*)ptr + 1;
     ((size_t*)ptr)[0]         = param_value_size; ptr = (size_t*)ptr + 1;
-    // Send the package (first the size, and then the data)
-    lock(*sockfd);
-    Send(sockfd, &msgSize, sizeof(size_t), 0);
-    Send(sockfd, msg, msgSize, 0);
-    free(msg); msg=NULL;
-    // Receive the package (first size, and then data)
-    Recv(sockfd, &msgSize, sizeof(size_t), MSG_WAITALL);
-    msg = (void*)malloc(msgSize);
+    // Send the package, and wait for the answer
+    // The value is received straight into param_value
+    void *answer = oclandSinkRequest(sockfd, ocland_clGetKernelArgInfo, msg, &msgSize,
+                                     sizeof(cl_int) + sizeof(size_t),
+                                     param_value, param_value ? param_value_size : 0);
+    free(msg); msg=answer;
     ptr = msg;
-    Recv(sockfd, msg, msgSize, MSG_WAITALL);
-    unlock(*sockfd);
     // Decript the data
     cl_int flag     = ((cl_int*)ptr)[0]; ptr = (cl_int*)ptr + 1;
     size_t size_ret = ((size_t*)ptr)[0]; ptr = (size_t*)ptr + 1;
     if(param_value_size_ret) *param_value_size_ret = size_ret;
-    if( (flag == CL_SUCCESS) && param_value )
+    if( (flag == CL_SUCCESS) && param_value &&
+        (msgSize >= sizeof(cl_int) + sizeof(size_t) + size_ret) )
         memcpy(param_value, ptr, size_ret);
+    free(msg); msg=NULL;
+    return flag;
+}
+
+cl_int oclandGetKernelArgsAddress(cl_kernel                          kernel ,
+                                  cl_uint *                          num_args ,
+                                  cl_kernel_arg_address_qualifier ** arg_address)
+{
+    *num_args    = 0;
+    *arg_address = NULL;
+    // Get the server
+    int *sockfd = getShortcut(kernel);
+    if(!sockfd){
+        return CL_INVALID_KERNEL;
+    }
+    // Build the package
+    size_t msgSize  = sizeof(cl_kernel);      // kernel
+    void* msg = (void*)malloc(msgSize);
+    if(!msg)
+        return CL_OUT_OF_HOST_MEMORY;
+    ((cl_kernel*)msg)[0] = kernel;
+    // Send the package, and wait for the answer
+    void *answer = oclandRequest(sockfd, ocland_kernelArgsAddress, msg, &msgSize);
+    free(msg); msg=answer;
+    // Decript the data
+    cl_int flag = CL_OUT_OF_RESOURCES;
+    cl_uint n = 0;
+    if(msgSize >= sizeof(cl_int) + sizeof(cl_uint)){
+        memcpy(&flag, msg, sizeof(cl_int));
+        memcpy(&n, (cl_int*)msg + 1, sizeof(cl_uint));
+    }
+    if((flag == CL_SUCCESS) && n){
+        size_t size = n*sizeof(cl_kernel_arg_address_qualifier);
+        if(msgSize < sizeof(cl_int) + sizeof(cl_uint) + size)
+            flag = CL_OUT_OF_RESOURCES;
+        else if(!(*arg_address = (cl_kernel_arg_address_qualifier*)malloc(size)))
+            flag = CL_OUT_OF_HOST_MEMORY;
+        else{
+            memcpy(*arg_address, (char*)msg + sizeof(cl_int) + sizeof(cl_uint), size);
+            *num_args = n;
+        }
+    }
+    free(msg); msg=NULL;
     return flag;
 }
 
@@ -4169,40 +4143,8 @@ cl_int oclandEnqueueFillBuffer(cl_command_queue    command_queue ,
                                const cl_event *    event_wait_list ,
                                cl_event *          event)
 {
-    char buffer[BUFF_SIZE];
-    cl_bool want_event = CL_FALSE;
-    // Look for a shortcut
-    int *sockfd = getShortcut(command_queue);
-    if(!sockfd){
-        return CL_INVALID_COMMAND_QUEUE;
-    }
-    // Execute the command on server
-    unsigned int commDim = strlen("clEnqueueFillBuffer")+1;
-    Send(sockfd, &commDim, sizeof(unsigned int), 0);
-    // Send command to perform
-    strcpy(buffer, "clEnqueueFillBuffer");
-    Send(sockfd, buffer, strlen(buffer)+1, 0);
-    // Send parameters
-    Send(sockfd, &command_queue, sizeof(cl_command_queue), 0);
-    Send(sockfd, &mem, sizeof(cl_mem), 0);
-    Send(sockfd, &pattern_size, sizeof(size_t), 0);
-    Send(sockfd, &pattern, pattern_size, 0);
-    Send(sockfd, &offset, sizeof(size_t), 0);
-    Send(sockfd, &cb, sizeof(size_t), 0);
-    Send(sockfd, &num_events_in_wait_list, sizeof(cl_uint), 0);
-    if(num_events_in_wait_list)
-        Send(sockfd, &event_wait_list, num_events_in_wait_list*sizeof(cl_event), 0);
-    if(event)
-        want_event = CL_TRUE;
-    Send(sockfd, &want_event, sizeof(cl_bool), 0);
-    // And request flag, and event if request
-    cl_int flag = CL_INVALID_CONTEXT;
-    Recv(sockfd, &flag, sizeof(cl_int), MSG_WAITALL);
-    if((flag == CL_SUCCESS) && (event)){
-        Recv(sockfd, event, sizeof(cl_event), MSG_WAITALL);
-        addShortcut(*event, sockfd);
-    }
-    return flag;
+    // The server does not serve this command yet
+    return CL_INVALID_OPERATION;
 }
 
 cl_int oclandEnqueueFillImage(cl_command_queue    command_queue ,
@@ -4215,40 +4157,8 @@ cl_int oclandEnqueueFillImage(cl_command_queue    command_queue ,
                               const cl_event *    event_wait_list ,
                               cl_event *          event)
 {
-    char buffer[BUFF_SIZE];
-    cl_bool want_event = CL_FALSE;
-    // Look for a shortcut
-    int *sockfd = getShortcut(command_queue);
-    if(!sockfd){
-        return CL_INVALID_COMMAND_QUEUE;
-    }
-    // Execute the command on server
-    unsigned int commDim = strlen("clEnqueueFillImage")+1;
-    Send(sockfd, &commDim, sizeof(unsigned int), 0);
-    // Send command to perform
-    strcpy(buffer, "clEnqueueFillImage");
-    Send(sockfd, buffer, strlen(buffer)+1, 0);
-    // Send parameters
-    Send(sockfd, &command_queue, sizeof(cl_command_queue), 0);
-    Send(sockfd, &image, sizeof(cl_mem), 0);
-    Send(sockfd, &fill_color_size, sizeof(size_t), 0);
-    Send(sockfd, &fill_color, fill_color_size, 0);
-    Send(sockfd, origin, 3*sizeof(size_t), 0);
-    Send(sockfd, region, 3*sizeof(size_t), 0);
-    Send(sockfd, &num_events_in_wait_list, sizeof(cl_uint), 0);
-    if(num_events_in_wait_list)
-        Send(sockfd, &event_wait_list, num_events_in_wait_list*sizeof(cl_event), 0);
-    if(event)
-        want_event = CL_TRUE;
-    Send(sockfd, &want_event, sizeof(cl_bool), 0);
-    // And request flag, and event if request
-    cl_int flag = CL_INVALID_CONTEXT;
-    Recv(sockfd, &flag, sizeof(cl_int), MSG_WAITALL);
-    if((flag == CL_SUCCESS) && (event)){
-        Recv(sockfd, event, sizeof(cl_event), MSG_WAITALL);
-        addShortcut(*event, sockfd);
-    }
-    return flag;
+    // The server does not serve this command yet
+    return CL_INVALID_OPERATION;
 }
 
 cl_int oclandEnqueueMigrateMemObjects(cl_command_queue        command_queue ,
@@ -4259,38 +4169,8 @@ cl_int oclandEnqueueMigrateMemObjects(cl_command_queue        command_queue ,
                                       const cl_event *        event_wait_list ,
                                       cl_event *              event)
 {
-    char buffer[BUFF_SIZE];
-    cl_bool want_event = CL_FALSE;
-    // Look for a shortcut
-    int *sockfd = getShortcut(command_queue);
-    if(!sockfd){
-        return CL_INVALID_COMMAND_QUEUE;
-    }
-    // Execute the command on server
-    unsigned int commDim = strlen("clEnqueueMigrateMemObjects")+1;
-    Send(sockfd, &commDim, sizeof(unsigned int), 0);
-    // Send command to perform
-    strcpy(buffer, "clEnqueueMigrateMemObjects");
-    Send(sockfd, buffer, strlen(buffer)+1, 0);
-    // Send parameters
-    Send(sockfd, &command_queue, sizeof(cl_command_queue), 0);
-    Send(sockfd, &num_mem_objects, sizeof(cl_uint), 0);
-    Send(sockfd, mem_objects, num_mem_objects*sizeof(cl_mem), 0);
-    Send(sockfd, &flags, sizeof(cl_mem_migration_flags), 0);
-    Send(sockfd, &num_events_in_wait_list, sizeof(cl_uint), 0);
-    if(num_events_in_wait_list)
-        Send(sockfd, &event_wait_list, num_events_in_wait_list*sizeof(cl_event), 0);
-    if(event)
-        want_event = CL_TRUE;
-    Send(sockfd, &want_event, sizeof(cl_bool), 0);
-    // And request flag, and event if request
-    cl_int flag = CL_INVALID_CONTEXT;
-    Recv(sockfd, &flag, sizeof(cl_int), MSG_WAITALL);
-    if((flag == CL_SUCCESS) && (event)){
-        Recv(sockfd, event, sizeof(cl_event), MSG_WAITALL);
-        addShortcut(*event, sockfd);
-    }
-    return flag;
+    // The server does not serve this command yet
+    return CL_INVALID_OPERATION;
 }
 
 cl_int oclandEnqueueMarkerWithWaitList(cl_command_queue  command_queue ,
@@ -4298,35 +4178,8 @@ cl_int oclandEnqueueMarkerWithWaitList(cl_command_queue  command_queue ,
                                        const cl_event *   event_wait_list ,
                                        cl_event *         event)
 {
-    char buffer[BUFF_SIZE];
-    cl_bool want_event = CL_FALSE;
-    // Look for a shortcut
-    int *sockfd = getShortcut(command_queue);
-    if(!sockfd){
-        return CL_INVALID_COMMAND_QUEUE;
-    }
-    // Execute the command on server
-    unsigned int commDim = strlen("clEnqueueMarkerWithWaitList")+1;
-    Send(sockfd, &commDim, sizeof(unsigned int), 0);
-    // Send command to perform
-    strcpy(buffer, "clEnqueueMarkerWithWaitList");
-    Send(sockfd, buffer, strlen(buffer)+1, 0);
-    // Send parameters
-    Send(sockfd, &command_queue, sizeof(cl_command_queue), 0);
-    Send(sockfd, &num_events_in_wait_list, sizeof(cl_uint), 0);
-    if(num_events_in_wait_list)
-        Send(sockfd, &event_wait_list, num_events_in_wait_list*sizeof(cl_event), 0);
-    if(event)
-        want_event = CL_TRUE;
-    Send(sockfd, &want_event, sizeof(cl_bool), 0);
-    // And request flag, and event if request
-    cl_int flag = CL_INVALID_CONTEXT;
-    Recv(sockfd, &flag, sizeof(cl_int), MSG_WAITALL);
-    if((flag == CL_SUCCESS) && (event)){
-        Recv(sockfd, event, sizeof(cl_event), MSG_WAITALL);
-        addShortcut(*event, sockfd);
-    }
-    return flag;
+    // The server does not serve this command yet
+    return CL_INVALID_OPERATION;
 }
 
 cl_int oclandEnqueueBarrierWithWaitList(cl_command_queue  command_queue ,
@@ -4334,33 +4187,6 @@ cl_int oclandEnqueueBarrierWithWaitList(cl_command_queue  command_queue ,
                                         const cl_event *   event_wait_list ,
                                         cl_event *         event)
 {
-    char buffer[BUFF_SIZE];
-    cl_bool want_event = CL_FALSE;
-    // Look for a shortcut
-    int *sockfd = getShortcut(command_queue);
-    if(!sockfd){
-        return CL_INVALID_COMMAND_QUEUE;
-    }
-    // Execute the command on server
-    unsigned int commDim = strlen("clEnqueueBarrierWithWaitList")+1;
-    Send(sockfd, &commDim, sizeof(unsigned int), 0);
-    // Send command to perform
-    strcpy(buffer, "clEnqueueBarrierWithWaitList");
-    Send(sockfd, buffer, strlen(buffer)+1, 0);
-    // Send parameters
-    Send(sockfd, &command_queue, sizeof(cl_command_queue), 0);
-    Send(sockfd, &num_events_in_wait_list, sizeof(cl_uint), 0);
-    if(num_events_in_wait_list)
-        Send(sockfd, &event_wait_list, num_events_in_wait_list*sizeof(cl_event), 0);
-    if(event)
-        want_event = CL_TRUE;
-    Send(sockfd, &want_event, sizeof(cl_bool), 0);
-    // And request flag, and event if request
-    cl_int flag = CL_INVALID_CONTEXT;
-    Recv(sockfd, &flag, sizeof(cl_int), MSG_WAITALL);
-    if((flag == CL_SUCCESS) && (event)){
-        Recv(sockfd, event, sizeof(cl_event), MSG_WAITALL);
-        addShortcut(*event, sockfd);
-    }
-    return flag;
+    // The server does not serve this command yet
+    return CL_INVALID_OPERATION;
 }
@@ -19,7 +19,9 @@
 #include <ocland/client/ocland_opencl.h>
 
 #include <stdio.h>
+#include <stdint.h>
 #include <string.h>
+#include <pthread.h>
 
 // Log macros
 #define WHERESTR  "[file %s, line %d]: "
@@ -34,52 +36,118 @@
     #define VERBOSE_OUT(flag)
 #endif
 
-#ifndef MAX_N_PLATFORMS
-    #define MAX_N_PLATFORMS 1<<16 //   65536
-#endif
-#ifndef MAX_N_DEVICES
-    #define MAX_N_DEVICES 1<<16   //   65536
-#endif
-#ifndef MAX_N_CONTEXTS
-    #define MAX_N_CONTEXTS 1<<16  //   65536
-#endif
-#ifndef MAX_N_QUEUES
-    #define MAX_N_QUEUES 1<<16    //   65536
-#endif
-#ifndef MAX_N_MEMS
-    #define MAX_N_MEMS 1<<20      // 1048576
-#endif
-#ifndef MAX_N_PROGRAMS
-    #define MAX_N_PROGRAMS 1<<20  // 1048576
-#endif
-#ifndef MAX_N_KERNELS
-    #define MAX_N_KERNELS 1<<20   // 1048576
-#endif
-#ifndef MAX_N_EVENTS
-    #define MAX_N_EVENTS 1<<20    // 1048576
-#endif
-
 #define SYMB(f) \
 typeof(icd_##f) f __attribute__ ((alias ("icd_" #f), visibility("default")))
 
 #pragma GCC visibility push(hidden)
 
 cl_uint num_master_platforms = 0;
-struct _cl_platform_id master_platforms[MAX_N_PLATFORMS];
-cl_uint num_master_devices = 0;
-struct _cl_device_id master_devices[MAX_N_DEVICES];
-cl_uint num_master_contexts = 0;
-cl_context master_contexts[MAX_N_CONTEXTS];
-cl_uint num_master_queues = 0;
-cl_command_queue master_queues[MAX_N_QUEUES];
-cl_uint num_master_mems = 0;
-cl_mem master_mems[MAX_N_MEMS];
-cl_uint num_master_programs = 0;
-cl_program master_programs[MAX_N_PROGRAMS];
-cl_uint num_master_kernels = 0;
-cl_kernel master_kernels[MAX_N_KERNELS];
-cl_uint num_master_events = 0;
-cl_event master_events[MAX_N_EVENTS];
+struct _cl_platform_id *master_platforms = NULL;
+struct icd_objects_st icd_platforms = {NULL, NULL};
+struct icd_objects_st icd_devices = {NULL, NULL};
+struct icd_objects_st icd_contexts = {NULL, NULL};
+struct icd_objects_st icd_queues = {NULL, NULL};
+struct icd_objects_st icd_mems = {NULL, NULL};
+struct icd_objects_st icd_programs = {NULL, NULL};
+struct icd_objects_st icd_kernels = {NULL, NULL};
+struct icd_objects_st icd_events = {NULL, NULL};
+/// Mutex protecting the registered objects
+pthread_mutex_t icd_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/// Hash table key of an object or server instance
+#define ICD_KEY(ptr) ((uint64_t)(uintptr_t)(ptr))
+
+/** Register an ICD object, so the server instance which it wraps can
+ * be translated back to it.
+ * @param t Registered objects of the same kind.
+ * @param object ICD object.
+ * @param ptr Server instance wrapped by the object.
+ * @return CL_SUCCESS if the object has been registered,
+ * CL_OUT_OF_HOST_MEMORY otherwise.
+ */
+static cl_int addObject(struct icd_objects_st *t, void *object, void *ptr)
+{
+    cl_int flag = CL_SUCCESS;
+    pthread_mutex_lock(&icd_mutex);
+    if(!t->objects)
+        t->objects = createHashTable();
+    if(!t->ptrs)
+        t->ptrs = createHashTable();
+    if(!t->objects || !t->ptrs){
+        pthread_mutex_unlock(&icd_mutex);
+        return CL_OUT_OF_HOST_MEMORY;
+    }
+    if(hashTableInsert(t->ptrs, ICD_KEY(object), ptr)){
+        pthread_mutex_unlock(&icd_mutex);
+        return CL_OUT_OF_HOST_MEMORY;
+    }
+    // Objects which creation failed have not a server instance
+    if(ptr && hashTableInsert(t->objects, ICD_KEY(ptr), object)){
+        hashTableRemove(t->ptrs, ICD_KEY(object), NULL);
+        flag = CL_OUT_OF_HOST_MEMORY;
+    }
+    pthread_mutex_unlock(&icd_mutex);
+    return flag;
+}
+
+/** Unregister an ICD object.
+ * @param t Registered objects of the same kind.
+ * @param object ICD object.
+ */
+static void delObject(struct icd_objects_st *t, void *object)
+{
+    void *ptr = NULL, *owner = NULL;
+    pthread_mutex_lock(&icd_mutex);
+    if(t->ptrs && hashTableRemove(t->ptrs, ICD_KEY(object), &ptr)){
+        // The server instance may have been wrapped again meanwhile
+        if(hashTableFind(t->objects, ICD_KEY(ptr), &owner) && (owner == object))
+            hashTableRemove(t->objects, ICD_KEY(ptr), NULL);
+    }
+    pthread_mutex_unlock(&icd_mutex);
+}
+
+/** Look if an ICD object is registered.
+ * @param t Registered objects of the same kind.
+ * @param object ICD object.
+ * @return CL_TRUE if the object is registered, CL_FALSE otherwise.
+ */
+static cl_bool hasObject(struct icd_objects_st *t, void *object)
+{
+    cl_bool found = CL_FALSE;
+    pthread_mutex_lock(&icd_mutex);
+    if(t->ptrs && hashTableFind(t->ptrs, ICD_KEY(object), NULL))
+        found = CL_TRUE;
+    pthread_mutex_unlock(&icd_mutex);
+    return found;
+}
+
+/** Get the ICD object wrapping a server instance.
+ * @param t Registered objects of the same kind.
+ * @param ptr Server instance.
+ * @return ICD object, NULL if the server instance is not wrapped by any
+ * registered object.
+ */
+static void* getObject(struct icd_objects_st *t, void *ptr)
+{
+    void *object = NULL;
+    pthread_mutex_lock(&icd_mutex);
+    if(t->objects)
+        hashTableFind(t->objects, ICD_KEY(ptr), &object);
+    pthread_mutex_unlock(&icd_mutex);
+    return object;
+}
+
+/** Replace a server instance, returned by the server, by the ICD object
+ * which wraps it. Unknown instances are not modified.
+ * @param t Registered objects of the same kind.
+ * @param ptr Server instance to be replaced.
+ */
+static void icdObject(struct icd_objects_st *t, void **ptr)
+{
+    void *object = getObject(t, *ptr);
+    if(object)
+        *ptr = object;
+}
 
 // --------------------------------------------------------------
 // Platforms
@@ -110,12 +178,21 @@ __GetPlatformIDs(cl_uint num_entries,
         }
         flag = oclandGetPlatformIDs(num_master_platforms,server_platforms,NULL);
         if(flag != CL_SUCCESS){
+            num_master_platforms = 0;
+            free(server_platforms); server_platforms=NULL;
             return flag;
         }
+        master_platforms = (struct _cl_platform_id*)malloc(num_master_platforms*sizeof(struct _cl_platform_id));
+        if(!master_platforms){
+            num_master_platforms = 0;
+            free(server_platforms); server_platforms=NULL;
+            return CL_OUT_OF_HOST_MEMORY;
+        }
         // Send data to master_platforms
         for(i=0;i<num_master_platforms;i++){
             master_platforms[i].dispatch = &master_dispatch;
             master_platforms[i].ptr      = server_platforms[i];
+            addObject(&icd_platforms, &master_platforms[i], server_platforms[i]);
         }
         free(server_platforms); server_platforms=NULL;
     }
@@ -191,7 +268,7 @@ icd_clGetDeviceIDs(cl_platform_id   platform,
         VERBOSE_OUT(CL_INVALID_VALUE);
         return CL_INVALID_VALUE;
     }
-    cl_uint i,j,n;
+    cl_uint i,n;
     // Init devices array
     cl_int flag = oclandGetDeviceIDs(platform->ptr, device_type, 0, NULL, &n);
     if(flag != CL_SUCCESS){
@@ -210,35 +287,31 @@ icd_clGetDeviceIDs(cl_platform_id   platform,
     }
     for(i=0;i<n;i++){
         // Test if device has been already stored
-        flag = CL_SUCCESS;
-        for(j=0;j<num_master_devices;j++){
-            if(master_devices[j].ptr == server_devices[i]){
-                flag = CL_INVALID_DEVICE;
-                break;
-            }
-        }
-        if(flag != CL_SUCCESS)
+        if(getObject(&icd_devices, server_devices[i]))
             continue;
         // Add the new device
-        num_master_devices++;
-        if(num_master_devices > MAX_N_DEVICES){
-            VERBOSE_OUT(CL_OUT_OF_RESOURCES);
-            return CL_OUT_OF_RESOURCES;
+        cl_device_id device = (cl_device_id)calloc(1, sizeof(struct _cl_device_id));
+        if(!device){
+            free(server_devices); server_devices=NULL;
+            VERBOSE_OUT(CL_OUT_OF_HOST_MEMORY);
+            return CL_OUT_OF_HOST_MEMORY;
+        }
+        device->dispatch = &master_dispatch;
+        device->ptr      = server_devices[i];
+        flag = addObject(&icd_devices, device, device->ptr);
+        if(flag != CL_SUCCESS){
+            free(device);
+            free(server_devices); server_devices=NULL;
+            VERBOSE_OUT(flag);
+            return flag;
         }
-        master_devices[num_master_devices-1].dispatch = &master_dispatch;
-        master_devices[num_master_devices-1].ptr      = server_devices[i];
     }
     // Send requested data
     if( num_devices != NULL )
         *num_devices = n;
     if( devices ) {
         for(i=0;i<(n<num_entries?n:num_entries);i++){
-            for(j=0;j<num_master_devices;j++){
-                if(master_devices[j].ptr == server_devices[i]){
-                    devices[i] = &master_devices[j];
-                    break;
-                }
-            }
+            devices[i] = getObject(&icd_devices, server_devices[i]);
         }
     }
     free(server_devices); server_devices=NULL;
@@ -255,17 +328,10 @@ icd_clGetDeviceInfo(cl_device_id    device,
                     size_t *        param_value_size_ret) CL_API_SUFFIX__VERSION_1_0
 {
     VERBOSE_IN();
-    cl_uint i;
     cl_int flag = oclandGetDeviceInfo(device->ptr, param_name, param_value_size, param_value, param_value_size_ret);
     // If requested data is a platform, must be convinently corrected
     if((param_name == CL_DEVICE_PLATFORM) && param_value){
-        cl_platform_id *platform = param_value;
-        for(i=0;i<num_master_platforms;i++){
-            if(master_platforms[i].ptr == *platform){
-                *platform = (void*) &master_platforms[i];
-                break;
-            }
-        }
+        icdObject(&icd_platforms, param_value);
     }
     VERBOSE_OUT(flag);
     return flag;
@@ -310,9 +376,8 @@ icd_clCreateSubDevices(cl_device_id                         in_device,
             device->dispatch = &master_dispatch;
             device->ptr      = out_devices[i];
             device->rcount   = 1;
-            num_master_devices++;
-            master_devices[num_master_devices-1] = *device;
-            out_devices[i]   = &master_devices[num_master_devices-1];
+            addObject(&icd_devices, device, device->ptr);
+            out_devices[i]   = device;
         }
     }
     VERBOSE_OUT(CL_SUCCESS);
@@ -340,21 +405,13 @@ icd_clReleaseDevice(cl_device_id device) CL_API_SUFFIX__VERSION_1_2
     if(device->rcount)
         return CL_SUCCESS;
     // Reference count has reached 0, object should be destroyed
-    cl_uint i,j;
     cl_int flag = oclandReleaseDevice(device->ptr);
     if(flag != CL_SUCCESS){
         VERBOSE_OUT(flag);
         return flag;
     }
+    delObject(&icd_devices, device);
     free(device);
-    for(i=0;i<num_master_devices;i++){
-        if(&master_devices[i] == device){
-            for(j=i+1;j<num_master_devices;j++)
-                master_devices[j-1] = master_devices[j];
-            break;
-        }
-    }
-    num_master_devices--;
     VERBOSE_OUT(CL_SUCCESS);
     return CL_SUCCESS;
 }
@@ -417,8 +474,7 @@ icd_clCreateContext(const cl_context_properties * properties,
     context->dispatch = &master_dispatch;
     context->ptr = oclandCreateContext(properties, num_properties, num_devices, devs, NULL, NULL, &flag);
     context->rcount = 1;
-    num_master_contexts++;
-    master_contexts[num_master_contexts-1] = context;
+    addObject(&icd_contexts, context, context->ptr);
     if(errcode_ret) *errcode_ret = flag;
     VERBOSE_OUT(flag);
     return context;
@@ -471,7 +527,7 @@ icd_clCreateContextFromType(const cl_context_properties * properties,
     context->dispatch = &master_dispatch;
     context->ptr      = oclandCreateContextFromType(properties, num_properties, device_type, NULL, NULL, &flag);
     context->rcount   = 1;
-    master_contexts[num_master_contexts-1] = context;
+    addObject(&icd_contexts, context, context->ptr);
     if(errcode_ret) *errcode_ret = flag;
     VERBOSE_OUT(flag);
     return context;
@@ -500,17 +556,9 @@ icd_clReleaseContext(cl_context context) CL_API_SUFFIX__VERSION_1_0
         return CL_SUCCESS;
     }
     // Reference count has reached 0, object should be destroyed
-    cl_uint i,j;
     cl_int flag = oclandReleaseContext(context->ptr);
+    delObject(&icd_contexts, context);
     free(context);
-    for(i=0;i<num_master_contexts;i++){
-        if(master_contexts[i] == context){
-            for(j=i+1;j<num_master_contexts;j++)
-                master_contexts[j-1] = master_contexts[j];
-            break;
-        }
-    }
-    num_master_contexts--;
     VERBOSE_OUT(flag);
     return flag;
 }
@@ -524,19 +572,13 @@ icd_clGetContextInfo(cl_context         context,
                      size_t *           param_value_size_ret) CL_API_SUFFIX__VERSION_1_0
 {
     VERBOSE_IN();
-    cl_uint i,j,n;
+    cl_uint i,n;
     cl_int flag = oclandGetContextInfo(context->ptr, param_name, param_value_size, param_value, param_value_size_ret);
     // If requested data is the devices, must be convinently corrected
     if((param_name == CL_CONTEXT_DEVICES) && param_value){
         n = param_value_size / sizeof(cl_device_id);
         for(i=0;i<n;i++){
-            cl_device_id *device = param_value + i*sizeof(cl_device_id);
-            for(j=0;j<num_master_devices;j++){
-                if(master_devices[j].ptr == *device){
-                    *device = (void*) &master_devices[j];
-                    break;
-                }
-            }
+            icdObject(&icd_devices, param_value + i*sizeof(cl_device_id));
         }
     }
     // If requested data is the context properties, platform can be inside, and then must be corrected
@@ -575,8 +617,7 @@ icd_clCreateCommandQueue(cl_context                     context,
     queue->dispatch = &master_dispatch;
     queue->ptr      = oclandCreateCommandQueue(context->ptr,device->ptr,properties,&flag);
     queue->rcount   = 1;
-    num_master_queues++;
-    master_queues[num_master_queues-1] = queue;
+    addObject(&icd_queues, queue, queue->ptr);
     if(errcode_ret) * errcode_ret = flag;
     VERBOSE_OUT(flag);
     return queue;
@@ -605,17 +646,9 @@ icd_clReleaseCommandQueue(cl_command_queue command_queue) CL_API_SUFFIX__VERSION
         return CL_SUCCESS;
     }
     // Reference count has reached 0, object should be destroyed
-    cl_uint i,j;
     cl_int flag = oclandReleaseCommandQueue(command_queue->ptr);
+    delObject(&icd_queues, command_queue);
     free(command_queue);
-    for(i=0;i<num_master_queues;i++){
-        if(master_queues[i] == command_queue){
-            for(j=i+1;j<num_master_queues;j++)
-                master_queues[j-1] = master_queues[j];
-            break;
-        }
-    }
-    num_master_queues--;
     VERBOSE_OUT(flag);
     return flag;
 }
@@ -629,27 +662,14 @@ icd_clGetCommandQueueInfo(cl_command_queue      command_queue,
                           size_t *              param_value_size_ret) CL_API_SUFFIX__VERSION_1_0
 {
     VERBOSE_IN();
-    cl_uint i;
     cl_int flag = oclandGetCommandQueueInfo(command_queue->ptr,param_name,param_value_size,param_value,param_value_size_ret);
     // If requested data is a context, must be convinently corrected
     if((param_name == CL_QUEUE_CONTEXT) && param_value){
-        cl_context *context = param_value;
-        for(i=0;i<num_master_contexts;i++){
-            if(master_contexts[i]->ptr == *context){
-                *context = (void*) master_contexts[i];
-                break;
-            }
-        }
+        icdObject(&icd_contexts, param_value);
     }
     // If requested data is a device, must be convinently corrected
     if((param_name == CL_QUEUE_DEVICE) && param_value){
-        cl_device_id *device = param_value;
-        for(i=0;i<num_master_devices;i++){
-            if(master_devices[i].ptr == *device){
-                *device = (void*) &master_devices[i];
-                break;
-            }
-        }
+        icdObject(&icd_devices, param_value);
     }
     VERBOSE_OUT(flag);
     return flag;
@@ -702,8 +722,7 @@ icd_clCreateBuffer(cl_context    context ,
     mem_obj->size         = size;
     mem_obj->element_size = 0;
     mem_obj->rcount       = 1;
-    num_master_mems++;
-    master_mems[num_master_mems-1] = mem_obj;
+    addObject(&icd_mems, mem_obj, mem_obj->ptr);
     if(errcode_ret) *errcode_ret = flag;
     VERBOSE_OUT(flag);
     return mem_obj;
@@ -732,25 +751,9 @@ icd_clReleaseMemObject(cl_mem memobj) CL_API_SUFFIX__VERSION_1_0
         return CL_SUCCESS;
     }
     // Reference count has reached 0, object should be destroyed
-    cl_uint i,j;
     cl_int flag = oclandReleaseMemObject(memobj->ptr);
+    delObject(&icd_mems, memobj);
     free(memobj);
-
-    for(i=0;i<num_master_mems;i++){
-    }
-
-    for(i=0;i<num_master_mems;i++){
-        if(master_mems[i] == memobj){
-            for(j=i+1;j<num_master_mems;j++){
-                master_mems[j-1] = master_mems[j];
-            }
-            break;
-        }
-    }
-    num_master_mems--;
-
-    for(i=0;i<num_master_mems;i++){
-    }
     VERBOSE_OUT(flag);
     return flag;
 }
@@ -781,27 +784,14 @@ icd_clGetMemObjectInfo(cl_mem            memobj ,
                        size_t *          param_value_size_ret) CL_API_SUFFIX__VERSION_1_0
 {
     VERBOSE_IN();
-    cl_uint i;
     cl_int flag = oclandGetMemObjectInfo(memobj->ptr,param_name,param_value_size,param_value,param_value_size_ret);
     // If requested data is a context, must be convinently corrected
     if((param_name == CL_MEM_CONTEXT) && param_value){
-        cl_context *context = param_value;
-        for(i=0;i<num_master_contexts;i++){
-            if(master_contexts[i]->ptr == *context){
-                *context = (void*) master_contexts[i];
-                break;
-            }
-        }
+        icdObject(&icd_contexts, param_value);
     }
     // If requested data is a memory object, must be convinently corrected
     if((param_name == CL_MEM_ASSOCIATED_MEMOBJECT) && param_value){
-        cl_mem *mem = param_value;
-        for(i=0;i<num_master_mems;i++){
-            if(master_mems[i]->ptr == *mem){
-                *mem = (void*) master_mems[i];
-                break;
-            }
-        }
+        icdObject(&icd_mems, param_value);
     }
     VERBOSE_OUT(flag);
     return flag;
@@ -853,8 +843,7 @@ icd_clCreateSubBuffer(cl_mem                    buffer ,
     mem_obj->size         = ((cl_buffer_region*)buffer_create_info)->size;
     mem_obj->element_size = 0;
     mem_obj->rcount       = 1;
-    num_master_mems++;
-    master_mems[num_master_mems-1] = mem_obj;
+    addObject(&icd_mems, mem_obj, mem_obj->ptr);
     if(errcode_ret) *errcode_ret = flag;
     VERBOSE_OUT(flag);
     return mem_obj;
@@ -962,8 +951,7 @@ icd_clCreateImage(cl_context              context,
     mem_obj->ptr      = oclandCreateImage(context->ptr, flags, image_format, image_desc,
                                           element_size, host_ptr, &flag);
     mem_obj->rcount   = 1;
-    num_master_mems++;
-    master_mems[num_master_mems-1] = mem_obj;
+    addObject(&icd_mems, mem_obj, mem_obj->ptr);
     if(errcode_ret) *errcode_ret = flag;
     VERBOSE_OUT(flag);
     return mem_obj;
@@ -1060,8 +1048,7 @@ icd_clCreateImage2D(cl_context              context ,
                                        image_row_pitch, element_size,
                                        host_ptr, &flag);
     mem_obj->rcount = 1;
-    num_master_mems++;
-    master_mems[num_master_mems-1] = mem_obj;
+    addObject(&icd_mems, mem_obj, mem_obj->ptr);
     if(errcode_ret) *errcode_ret = flag;
     VERBOSE_OUT(flag);
     return mem_obj;
@@ -1160,8 +1147,7 @@ icd_clCreateImage3D(cl_context              context,
                                        image_row_pitch, image_slice_pitch, element_size,
                                        host_ptr, &flag);
     mem_obj->rcount = 1;
-    num_master_mems++;
-    master_mems[num_master_mems-1] = mem_obj;
+    addObject(&icd_mems, mem_obj, mem_obj->ptr);
     if(errcode_ret) *errcode_ret = flag;
     VERBOSE_OUT(flag);
     return mem_obj;
@@ -1192,8 +1178,7 @@ icd_clCreateSampler(cl_context           context ,
                                               addressing_mode,filter_mode,
                                               &flag);
     mem_obj->rcount = 1;
-    num_master_mems++;
-    master_mems[num_master_mems-1] = (cl_mem)mem_obj;
+    addObject(&icd_mems, mem_obj, mem_obj->ptr);
     if(errcode_ret) *errcode_ret = flag;
     VERBOSE_OUT(flag);
     return mem_obj;
@@ -1222,17 +1207,9 @@ icd_clReleaseSampler(cl_sampler  sampler) CL_API_SUFFIX__VERSION_1_0
         return CL_SUCCESS;
     }
     // Reference count has reached 0, object should be destroyed
-    cl_uint i,j;
     cl_int flag = oclandReleaseSampler(sampler->ptr);
+    delObject(&icd_mems, sampler);
     free(sampler);
-    for(i=0;i<num_master_mems;i++){
-        if(master_mems[i] == (cl_mem)sampler){
-            for(j=i+1;j<num_master_mems;j++)
-                master_mems[j-1] = master_mems[j];
-            break;
-        }
-    }
-    num_master_mems--;
     VERBOSE_OUT(flag);
     return flag;
 }
@@ -1246,17 +1223,10 @@ icd_clGetSamplerInfo(cl_sampler          sampler ,
                      size_t *            param_value_size_ret) CL_API_SUFFIX__VERSION_1_0
 {
     VERBOSE_IN();
-    cl_uint i;
     cl_int flag = oclandGetSamplerInfo(sampler->ptr,param_name,param_value_size,param_value,param_value_size_ret);
     // If requested data is a context, must be convinently corrected
     if((param_name == CL_SAMPLER_CONTEXT) && param_value){
-        cl_context *context = param_value;
-        for(i=0;i<num_master_contexts;i++){
-            if(master_contexts[i]->ptr == *context){
-                *context = (void*) master_contexts[i];
-                break;
-            }
-        }
+        icdObject(&icd_contexts, param_value);
     }
     VERBOSE_OUT(flag);
     return flag;
@@ -1299,8 +1269,7 @@ icd_clCreateProgramWithSource(cl_context         context ,
     program->dispatch = &master_dispatch;
     program->ptr = oclandCreateProgramWithSource(context->ptr,count,strings,lengths,&flag);
     program->rcount = 1;
-    num_master_programs++;
-    master_programs[num_master_programs-1] = program;
+    addObject(&icd_programs, program, program->ptr);
     if(errcode_ret) *errcode_ret = flag;
     VERBOSE_OUT(flag);
     return program;
@@ -1343,8 +1312,7 @@ icd_clCreateProgramWithBinary(cl_context                      context ,
                                                  lengths,binaries,binary_status,
                                                  &flag);
     program->rcount = 1;
-    num_master_programs++;
-    master_programs[num_master_programs-1] = program;
+    addObject(&icd_programs, program, program->ptr);
     if(errcode_ret) *errcode_ret = flag;
     VERBOSE_OUT(flag);
     return program;
@@ -1373,22 +1341,40 @@ icd_clReleaseProgram(cl_program  program) CL_API_SUFFIX__VERSION_1_0
         return CL_SUCCESS;
     }
     // Reference count has reached 0, object should be destroyed
-    cl_uint i,j;
     cl_int flag = oclandReleaseProgram(program->ptr);
+    delObject(&icd_programs, program);
     free(program);
-    for(i=0;i<num_master_programs;i++){
-        if(master_programs[i] == program){
-            for(j=i+1;j<num_master_programs;j++)
-                master_programs[j-1] = master_programs[j];
-            break;
-        }
-    }
-    num_master_programs--;
     VERBOSE_OUT(flag);
     return flag;
 }
 SYMB(clReleaseProgram);
 
+/** @struct buildNotify_st
+ * Notification function of a build, which must receive the ICD program
+ * instead of the server one.
+ */
+struct buildNotify_st
+{
+    /// ICD program
+    cl_program program;
+    /// User notification function
+    void (CL_CALLBACK *pfn_notify)(cl_program program, void *user_data);
+    /// User data
+    void *user_data;
+};
+
+/** Notification function passed to the server builds, which calls the
+ * user one with the ICD program.
+ * @param program Server program.
+ * @param user_data Build notification data, which is destroyed.
+ */
+static void CL_CALLBACK buildNotify(cl_program program, void *user_data)
+{
+    struct buildNotify_st *n = (struct buildNotify_st*)user_data;
+    n->pfn_notify(n->program, n->user_data);
+    free(n);
+}
+
 CL_API_ENTRY cl_int CL_API_CALL
 icd_clBuildProgram(cl_program            program ,
                    cl_uint               num_devices ,
@@ -1399,14 +1385,7 @@ icd_clBuildProgram(cl_program            program ,
 {
     VERBOSE_IN();
     cl_uint i;
-    /** callbacks can't be implemented trought network, so
-     * if you request a callback CL_OUT_OF_RESOURCES will
-     * be reported.
-     */
-    if(pfn_notify || user_data){
-        VERBOSE_OUT(CL_OUT_OF_RESOURCES);
-        return CL_OUT_OF_RESOURCES;
-    }
+    struct buildNotify_st *n = NULL;
     if((!pfn_notify  &&  user_data  ) ||
        ( num_devices && !device_list) ||
        (!num_devices &&  device_list) ){
@@ -1418,7 +1397,24 @@ icd_clBuildProgram(cl_program            program ,
     for(i=0;i<num_devices;i++){
         devs[i] = device_list[i]->ptr;
     }
-    cl_int flag = oclandBuildProgram(program->ptr,num_devices,devs,options,NULL,NULL);
+    /** The server notifies the build through the data channel,
+     * so the user function is called with the ICD program.
+     */
+    if(pfn_notify){
+        n = (struct buildNotify_st*)malloc(sizeof(struct buildNotify_st));
+        if(!n){
+            VERBOSE_OUT(CL_OUT_OF_HOST_MEMORY);
+            return CL_OUT_OF_HOST_MEMORY;
+        }
+        n->program    = program;
+        n->pfn_notify = pfn_notify;
+        n->user_data  = user_data;
+    }
+    cl_int flag = oclandBuildProgram(program->ptr,num_devices,devs,options,
+                                     n ? buildNotify : NULL, (void*)n);
+    // The notification is only called if the program has been built
+    if(n && (flag != CL_SUCCESS) && (flag != CL_BUILD_PROGRAM_FAILURE))
+        free(n);
     VERBOSE_OUT(flag);
     return flag;
 }
@@ -1432,29 +1428,17 @@ icd_clGetProgramInfo(cl_program          program ,
                      size_t *            param_value_size_ret) CL_API_SUFFIX__VERSION_1_0
 {
     VERBOSE_IN();
-    cl_uint i,j,n;
+    cl_uint i,n;
     cl_int flag = oclandGetProgramInfo(program->ptr,param_name,param_value_size,param_value,param_value_size_ret);
     // If requested data is a context, must be convinently corrected
     if((param_name == CL_PROGRAM_CONTEXT) && param_value){
-        cl_context *context = param_value;
-        for(i=0;i<num_master_contexts;i++){
-            if(master_contexts[i]->ptr == *context){
-                *context = (void*) master_contexts[i];
-                break;
-            }
-        }
+        icdObject(&icd_contexts, param_value);
     }
     // If requested data is the devices list, must be convinently corrected
     if((param_name == CL_PROGRAM_DEVICES) && param_value){
         n = param_value_size / sizeof(cl_device_id);
         for(i=0;i<n;i++){
-            cl_device_id *device = param_value + i*sizeof(cl_device_id);
-            for(j=0;j<num_master_devices;j++){
-                if(master_devices[j].ptr == *device){
-                    *device = (void*) &master_devices[j];
-                    break;
-                }
-            }
+            icdObject(&icd_devices, param_value + i*sizeof(cl_device_id));
         }
     }
     VERBOSE_OUT(flag);
@@ -1508,8 +1492,7 @@ icd_clCreateProgramWithBuiltInKernels(cl_context             context ,
     program->ptr = oclandCreateProgramWithBuiltInKernels(context->ptr,num_devices,devices,
                                                          kernel_names,&flag);
     program->rcount = 1;
-    num_master_programs++;
-    master_programs[num_master_programs-1] = program;
+    addObject(&icd_programs, program, program->ptr);
     if(errcode_ret) *errcode_ret = flag;
     VERBOSE_OUT(flag);
     return program;
@@ -1632,8 +1615,7 @@ icd_clLinkProgram(cl_context            context ,
     program->ptr = oclandLinkProgram(context->ptr,num_devices,devices,options,num_input_programs,programs,NULL,NULL,&flag);
     free(devices); devices=NULL;
     free(programs); programs=NULL;
-    num_master_programs++;
-    master_programs[num_master_programs-1] = program;
+    addObject(&icd_programs, program, program->ptr);
     if(errcode_ret) *errcode_ret = flag;
     VERBOSE_OUT(flag);
     return program;
@@ -1654,6 +1636,22 @@ SYMB(clUnloadPlatformCompiler);
 // Kernels
 // --------------------------------------------------------------
 
+/** Fetch the arguments metadata of a kernel, which is stored in the
+ * kernel to don't ask it to the server each time an argument is set.
+ * All the arguments are fetched with a single request, the first time
+ * that an argument which may be a memory object is set. The address
+ * qualifier of the arguments which can't be queried (i.e. platforms
+ * without clGetKernelArgInfo support) is considered global.
+ * @param kernel Kernel, which server instance has been already created.
+ */
+static void kernelArgs(cl_kernel kernel)
+{
+    if(kernel->args_fetched)
+        return;
+    kernel->args_fetched = CL_TRUE;
+    oclandGetKernelArgsAddress(kernel->ptr, &(kernel->num_args), &(kernel->arg_address));
+}
+
 CL_API_ENTRY cl_kernel CL_API_CALL
 icd_clCreateKernel(cl_program       program ,
                    const char *     kernel_name ,
@@ -1670,8 +1668,10 @@ icd_clCreateKernel(cl_program       program ,
     kernel->dispatch = &master_dispatch;
     kernel->ptr = oclandCreateKernel(program->ptr,kernel_name,&flag);
     kernel->rcount = 1;
-    num_master_kernels++;
-    master_kernels[num_master_kernels-1] = kernel;
+    kernel->args_fetched = CL_FALSE;
+    kernel->num_args = 0;
+    kernel->arg_address = NULL;
+    addObject(&icd_kernels, kernel, kernel->ptr);
     if(errcode_ret) *errcode_ret = flag;
     VERBOSE_OUT(flag);
     return kernel;
@@ -1710,9 +1710,11 @@ icd_clCreateKernelsInProgram(cl_program      program ,
             kernel->dispatch = &master_dispatch;
             kernel->ptr      = kernels[i];
             kernel->rcount   = 1;
+            kernel->args_fetched = CL_FALSE;
+            kernel->num_args     = 0;
+            kernel->arg_address  = NULL;
             kernels[i]       = kernel;
-            num_master_kernels++;
-            master_kernels[num_master_kernels-1] = kernel;
+            addObject(&icd_kernels, kernel, kernel->ptr);
         }
     }
     VERBOSE_OUT(CL_SUCCESS);
@@ -1742,17 +1744,10 @@ icd_clReleaseKernel(cl_kernel    kernel) CL_API_SUFFIX__VERSION_1_0
         return CL_SUCCESS;
     }
     // Reference count has reached 0, object should be destroyed
-    cl_uint i,j;
     cl_int flag = oclandReleaseKernel(kernel->ptr);
+    delObject(&icd_kernels, kernel);
+    free(kernel->arg_address);
     free(kernel);
-    for(i=0;i<num_master_kernels;i++){
-        if(master_kernels[i] == kernel){
-            for(j=i+1;j<num_master_kernels;j++)
-                master_kernels[j-1] = master_kernels[j];
-            break;
-        }
-    }
-    num_master_kernels--;
     VERBOSE_OUT(flag);
     return flag;
 }
@@ -1775,28 +1770,24 @@ icd_clSetKernelArg(cl_kernel     kernel ,
      * specification, so can be unavailable in some platforms.
      * In case that clGetKernelArgInfo fails we will consider that is a
      * cl_mem object.
-     * @note Due to the need of calling clGetKernelArgInfo in some cases
-     * does this function relatively slow, and is strongly recommended
-     * try to don't call if is not necessary.
+     * @note clGetKernelArgInfo is called just once for each argument,
+     * the first time that an argument which may be a memory object is
+     * set, so this function doesn't need to wait for additional answers
+     * from the server later.
      */
     cl_int flag;
     if(arg_size == sizeof(cl_mem)){
-        cl_uint i;
         // Can be a cl_mem object
         cl_mem mem_obj = * (cl_mem*)(arg_value);
-        for(i=0;i<num_master_mems;i++){
-            if(master_mems[i] == mem_obj){
-                cl_kernel_arg_address_qualifier arg_address = CL_KERNEL_ARG_ADDRESS_GLOBAL;
-                flag = oclandGetKernelArgInfo(kernel->ptr,arg_index,
-                                              CL_KERNEL_ARG_ADDRESS_QUALIFIER,
-                                              sizeof(cl_kernel_arg_address_qualifier),&arg_address, NULL);
-                if(    ( arg_address == CL_KERNEL_ARG_ADDRESS_GLOBAL )
-                    || ( flag == CL_INVALID_KERNEL ) )
-                {
-                    flag = oclandSetKernelArg(kernel->ptr,arg_index,arg_size,&(mem_obj->ptr));
-                    VERBOSE_OUT(flag);
-                    return flag;
-                }
+        if(hasObject(&icd_mems, mem_obj)){
+            kernelArgs(kernel);
+            if(    ( arg_index >= kernel->num_args )
+                || ( kernel->arg_address[arg_index] == CL_KERNEL_ARG_ADDRESS_GLOBAL )
+                || ( kernel->arg_address[arg_index] == CL_KERNEL_ARG_ADDRESS_CONSTANT ) )
+            {
+                flag = oclandSetKernelArg(kernel->ptr,arg_index,arg_size,&(mem_obj->ptr));
+                VERBOSE_OUT(flag);
+                return flag;
             }
         }
     }
@@ -1814,27 +1805,14 @@ icd_clGetKernelInfo(cl_kernel        kernel ,
                     size_t *         param_value_size_ret) CL_API_SUFFIX__VERSION_1_0
 {
     VERBOSE_IN();
-    cl_uint i;
     cl_int flag = oclandGetKernelInfo(kernel->ptr,param_name,param_value_size,param_value,param_value_size_ret);
     // If requested data is a context, must be convinently corrected
     if((param_name == CL_KERNEL_CONTEXT) && param_value){
-        cl_context *context = param_value;
-        for(i=0;i<num_master_contexts;i++){
-            if(master_contexts[i]->ptr == *context){
-                *context = (void*) master_contexts[i];
-                break;
-            }
-        }
+        icdObject(&icd_contexts, param_value);
     }
     // If requested data is a program, must be convinently corrected
     if((param_name == CL_KERNEL_PROGRAM) && param_value){
-        cl_program *program = param_value;
-        for(i=0;i<num_master_programs;i++){
-            if(master_programs[i]->ptr == *program){
-                *program = (void*) master_programs[i];
-                break;
-            }
-        }
+        icdObject(&icd_programs, param_value);
     }
     VERBOSE_OUT(flag);
     return flag;
@@ -1904,17 +1882,10 @@ icd_clGetEventInfo(cl_event          event ,
                    size_t *          param_value_size_ret) CL_API_SUFFIX__VERSION_1_0
 {
     VERBOSE_IN();
-    cl_uint i;
     cl_int flag = oclandGetEventInfo(event->ptr,param_name,param_value_size,param_value,param_value_size_ret);
     // If requested data is a command queue, must be convinently corrected
     if((param_name == CL_EVENT_COMMAND_QUEUE) && param_value){
-        cl_command_queue *queue = param_value;
-        for(i=0;i<num_master_queues;i++){
-            if(master_queues[i]->ptr == *queue){
-                *queue = (void*) master_queues[i];
-                break;
-            }
-        }
+        icdObject(&icd_queues, param_value);
     }
     VERBOSE_OUT(flag);
     return flag;
@@ -1943,17 +1914,9 @@ icd_clReleaseEvent(cl_event  event) CL_API_SUFFIX__VERSION_1_0
         return CL_SUCCESS;
     }
     // Reference count has reached 0, object should be destroyed
-    cl_uint i,j;
     cl_int flag = oclandReleaseEvent(event->ptr);
+    delObject(&icd_events, event);
     free(event);
-    for(i=0;i<num_master_events;i++){
-        if(master_events[i] == event){
-            for(j=i+1;j<num_master_events;j++)
-                master_events[j-1] = master_events[j];
-            break;
-        }
-    }
-    num_master_events--;
     VERBOSE_OUT(flag);
     return flag;
 }
@@ -1988,8 +1951,7 @@ icd_clCreateUserEvent(cl_context     context ,
     event->dispatch = &master_dispatch;
     event->ptr      = oclandCreateUserEvent(context->ptr,&flag);
     event->rcount   = 1;
-    num_master_events++;
-    master_events[num_master_events-1] = event;
+    addObject(&icd_events, event, event->ptr);
     if(errcode_ret) *errcode_ret = flag;
     VERBOSE_OUT(flag);
     return event;
@@ -2104,8 +2066,7 @@ icd_clEnqueueReadBuffer(cl_command_queue     command_queue ,
         e->ptr = *event;
         e->rcount = 1;
         *event = e;
-        num_master_events++;
-        master_events[num_master_events-1] = e;
+        addObject(&icd_events, e, e->ptr);
     }
     VERBOSE_OUT(CL_SUCCESS);
     return CL_SUCCESS;
@@ -2164,8 +2125,7 @@ icd_clEnqueueWriteBuffer(cl_command_queue    command_queue ,
         e->ptr = *event;
         e->rcount = 1;
         *event = e;
-        num_master_events++;
-        master_events[num_master_events-1] = e;
+        addObject(&icd_events, e, e->ptr);
     }
     VERBOSE_OUT(CL_SUCCESS);
     return CL_SUCCESS;
@@ -2221,8 +2181,7 @@ icd_clEnqueueCopyBuffer(cl_command_queue     command_queue ,
         e->ptr = *event;
         e->rcount = 1;
         *event = e;
-        num_master_events++;
-        master_events[num_master_events-1] = e;
+        addObject(&icd_events, e, e->ptr);
     }
     return CL_SUCCESS;
 }
@@ -2298,8 +2257,7 @@ icd_clEnqueueReadImage(cl_command_queue      command_queue ,
         e->ptr = *event;
         e->rcount = 1;
         *event = e;
-        num_master_events++;
-        master_events[num_master_events-1] = e;
+        addObject(&icd_events, e, e->ptr);
     }
     VERBOSE_OUT(CL_SUCCESS);
     return CL_SUCCESS;
@@ -2377,8 +2335,7 @@ icd_clEnqueueWriteImage(cl_command_queue     command_queue ,
         e->ptr = *event;
         e->rcount = 1;
         *event = e;
-        num_master_events++;
-        master_events[num_master_events-1] = e;
+        addObject(&icd_events, e, e->ptr);
     }
     VERBOSE_OUT(CL_SUCCESS);
     return CL_SUCCESS;
@@ -2442,8 +2399,7 @@ icd_clEnqueueCopyImage(cl_command_queue      command_queue ,
         e->ptr = *event;
         e->rcount = 1;
         *event = e;
-        num_master_events++;
-        master_events[num_master_events-1] = e;
+        addObject(&icd_events, e, e->ptr);
     }
     VERBOSE_OUT(CL_SUCCESS);
     return CL_SUCCESS;
@@ -2505,8 +2461,7 @@ icd_clEnqueueCopyImageToBuffer(cl_command_queue  command_queue ,
         e->ptr = *event;
         e->rcount = 1;
         *event = e;
-        num_master_events++;
-        master_events[num_master_events-1] = e;
+        addObject(&icd_events, e, e->ptr);
     }
     VERBOSE_OUT(CL_SUCCESS);
     return CL_SUCCESS;
@@ -2568,8 +2523,7 @@ icd_clEnqueueCopyBufferToImage(cl_command_queue  command_queue ,
         e->ptr = *event;
         e->rcount = 1;
         *event = e;
-        num_master_events++;
-        master_events[num_master_events-1] = e;
+        addObject(&icd_events, e, e->ptr);
     }
     VERBOSE_OUT(CL_SUCCESS);
     return CL_SUCCESS;
@@ -2693,8 +2647,7 @@ icd_clEnqueueNDRangeKernel(cl_command_queue  command_queue ,
         e->ptr = *event;
         e->rcount = 1;
         *event = e;
-        num_master_events++;
-        master_events[num_master_events-1] = e;
+        addObject(&icd_events, e, e->ptr);
     }
     VERBOSE_OUT(CL_SUCCESS);
     return CL_SUCCESS;
@@ -2832,8 +2785,7 @@ icd_clEnqueueReadBufferRect(cl_command_queue     command_queue ,
         e->ptr = *event;
         e->rcount = 1;
         *event = e;
-        num_master_events++;
-        master_events[num_master_events-1] = e;
+        addObject(&icd_events, e, e->ptr);
     }
     VERBOSE_OUT(CL_SUCCESS);
     return CL_SUCCESS;
@@ -2922,8 +2874,7 @@ icd_clEnqueueWriteBufferRect(cl_command_queue     command_queue ,
         e->ptr = *event;
         e->rcount = 1;
         *event = e;
-        num_master_events++;
-        master_events[num_master_events-1] = e;
+        addObject(&icd_events, e, e->ptr);
     }
     VERBOSE_OUT(CL_SUCCESS);
     return CL_SUCCESS;
@@ -3008,8 +2959,7 @@ icd_clEnqueueCopyBufferRect(cl_command_queue     command_queue ,
         e->ptr = *event;
         e->rcount = 1;
         *event = e;
-        num_master_events++;
-        master_events[num_master_events-1] = e;
+        addObject(&icd_events, e, e->ptr);
     }
     VERBOSE_OUT(CL_SUCCESS);
     return CL_SUCCESS;
@@ -3071,8 +3021,7 @@ icd_clEnqueueFillBuffer(cl_command_queue    command_queue ,
         e->ptr = *event;
         e->rcount = 1;
         *event = e;
-        num_master_events++;
-        master_events[num_master_events-1] = e;
+        addObject(&icd_events, e, e->ptr);
     }
     VERBOSE_OUT(CL_SUCCESS);
     return CL_SUCCESS;
@@ -3156,8 +3105,7 @@ icd_clEnqueueFillImage(cl_command_queue    command_queue ,
         e->ptr = *event;
         e->rcount = 1;
         *event = e;
-        num_master_events++;
-        master_events[num_master_events-1] = e;
+        addObject(&icd_events, e, e->ptr);
     }
     VERBOSE_OUT(CL_SUCCESS);
     return CL_SUCCESS;
@@ -3235,8 +3183,7 @@ icd_clEnqueueMigrateMemObjects(cl_command_queue        command_queue ,
         e->ptr = *event;
         e->rcount = 1;
         *event = e;
-        num_master_events++;
-        master_events[num_master_events-1] = e;
+        addObject(&icd_events, e, e->ptr);
     }
     VERBOSE_OUT(CL_SUCCESS);
     return CL_SUCCESS;
@@ -3286,8 +3233,7 @@ icd_clEnqueueMarkerWithWaitList(cl_command_queue  command_queue ,
         e->ptr = *event;
         e->rcount = 1;
         *event = e;
-        num_master_events++;
-        master_events[num_master_events-1] = e;
+        addObject(&icd_events, e, e->ptr);
     }
     VERBOSE_OUT(CL_SUCCESS);
     return CL_SUCCESS;
@@ -3337,8 +3283,7 @@ icd_clEnqueueBarrierWithWaitList(cl_command_queue  command_queue ,
         e->ptr = *event;
         e->rcount = 1;
         *event = e;
-        num_master_events++;
-        master_events[num_master_events-1] = e;
+        addObject(&icd_events, e, e->ptr);
     }
     VERBOSE_OUT(CL_SUCCESS);
     return CL_SUCCESS;
@@ -16,76 +16,248 @@
  *  along with ocland.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <pthread.h>
+#include <sched.h>
+
 #include <ocland/client/shortcut.h>
 
+/// Initial number of slots of the shortcuts table
+#define SHORTCUT_CAPACITY 1024u
+/// Key of the slots never used
+#define SHORTCUT_EMPTY ((uintptr_t)0)
+/// Key of the slots which shortcut has been removed
+#define SHORTCUT_DELETED ((uintptr_t)1)
+
 static unsigned int num_shortcuts = 0;
-static shortcut *shortcuts = NULL;
+static struct shortcut_table_st *shortcuts = NULL;
+/// Mutex serializing the threads which modify the shortcuts
+static pthread_mutex_t shortcuts_mutex = PTHREAD_MUTEX_INITIALIZER;
+/// Current readers epoch, increased each time the table is replaced
+static unsigned int epoch = 0;
+/// Number of readers which started on an even/odd epoch
+static unsigned long readers[2] = {0, 0};
+
+/** Hash an ocland pointer. The pointers are aligned, so their bits must
+ * be mixed before taking the lower ones.
+ * @param key Ocland server pointer.
+ * @return Hash of the pointer.
+ */
+static size_t hashShortcut(uintptr_t key)
+{
+    uint64_t h = (uint64_t)key;
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ull;
+    h ^= h >> 33;
+    return (size_t)h;
+}
+
+/** Create an empty shortcuts table.
+ * @param capacity Number of slots, a power of 2.
+ * @return Shortcuts table, NULL if it can't be allocated.
+ */
+static struct shortcut_table_st* createShortcuts(size_t capacity)
+{
+    struct shortcut_table_st *t = (struct shortcut_table_st*)malloc(
+        sizeof(struct shortcut_table_st));
+    if(!t)
+        return NULL;
+    t->capacity = capacity;
+    t->used     = 0;
+    t->keys     = (uintptr_t*)calloc(capacity, sizeof(uintptr_t));
+    t->sockets  = (int**)calloc(capacity, sizeof(int*));
+    if(!t->keys || !t->sockets){
+        free(t->keys);
+        free(t->sockets);
+        free(t);
+        return NULL;
+    }
+    return t;
+}
+
+/** Destroy a shortcuts table.
+ * @param t Shortcuts table.
+ */
+static void destroyShortcuts(struct shortcut_table_st *t)
+{
+    free(t->keys);
+    free(t->sockets);
+    free(t);
+}
+
+/** Look for the slot of an ocland pointer. Must be called with
+ * shortcuts_mutex locked.
+ * @param t Shortcuts table.
+ * @param key Ocland server pointer.
+ * @param found 1 if the pointer is stored, 0 otherwise.
+ * @return Slot of the pointer if it is stored, or the slot where it
+ * should be stored otherwise (reusing the first removed shortcut of the
+ * probe sequence).
+ */
+static size_t findShortcut(struct shortcut_table_st *t, uintptr_t key, int *found)
+{
+    size_t mask = t->capacity - 1;
+    size_t i = hashShortcut(key) & mask;
+    size_t slot = t->capacity;
+    while(t->keys[i] != SHORTCUT_EMPTY){
+        if(t->keys[i] == key){
+            *found = 1;
+            return i;
+        }
+        if((t->keys[i] == SHORTCUT_DELETED) && (slot == t->capacity))
+            slot = i;
+        i = (i + 1) & mask;
+    }
+    *found = 0;
+    return (slot == t->capacity) ? i : slot;
+}
+
+/** Wait until all the readers which may be still accessing a replaced
+ * shortcuts table finish. Must be called with shortcuts_mutex locked.
+ */
+static void waitReaders()
+{
+    unsigned int e = __atomic_fetch_add(&epoch, 1, __ATOMIC_SEQ_CST);
+    while(__atomic_load_n(&readers[e & 1], __ATOMIC_SEQ_CST))
+        sched_yield();
+}
+
+/** Replace the shortcuts table by a new one, without the removed
+ * shortcuts, and large enough to store a new shortcut. Must be called
+ * with shortcuts_mutex locked.
+ * @return 0 if the table has been replaced, -1 otherwise.
+ */
+static int rehashShortcuts()
+{
+    size_t i, j;
+    int found;
+    struct shortcut_table_st *old = shortcuts;
+    size_t capacity = old ? old->capacity : SHORTCUT_CAPACITY;
+    // Keep the live shortcuts below half of the table
+    while(2 * (num_shortcuts + 1) > capacity)
+        capacity *= 2;
+    struct shortcut_table_st *t = createShortcuts(capacity);
+    if(!t)
+        return -1;
+    if(old){
+        for(i=0;i<old->capacity;i++){
+            if(old->keys[i] <= SHORTCUT_DELETED)
+                continue;
+            j = findShortcut(t, old->keys[i], &found);
+            t->keys[j]    = old->keys[i];
+            t->sockets[j] = old->sockets[i];
+            t->used++;
+        }
+    }
+    __atomic_store_n(&shortcuts, t, __ATOMIC_SEQ_CST);
+    if(old){
+        waitReaders();
+        destroyShortcuts(old);
+    }
+    return 0;
+}
 
 unsigned int addShortcut(void* ocl_ptr, int* socket)
 {
-    // Look if the shortcut already exist
-    if(getShortcut(ocl_ptr)){
+    uintptr_t key = (uintptr_t)ocl_ptr;
+    unsigned int n;
+    size_t i;
+    int found;
+    if(key <= SHORTCUT_DELETED){
         return num_shortcuts;
     }
+    pthread_mutex_lock(&shortcuts_mutex);
     if(!shortcuts){
-        shortcuts = (shortcut*)malloc( (num_shortcuts + 1) * sizeof(shortcut));
-        if(!shortcuts){
-            num_shortcuts = 0;
+        if(rehashShortcuts()){
+            pthread_mutex_unlock(&shortcuts_mutex);
             return 0;
         }
     }
-    else{
-        shortcuts = (shortcut*)realloc( shortcuts, (num_shortcuts + 1) * sizeof(shortcut));
-        if(!shortcuts){
-            num_shortcuts = 0;
-            return 0;
+    // Look if the shortcut already exist
+    i = findShortcut(shortcuts, key, &found);
+    if(found){
+        n = num_shortcuts;
+        pthread_mutex_unlock(&shortcuts_mutex);
+        return n;
+    }
+    if(shortcuts->keys[i] == SHORTCUT_EMPTY){
+        // A new slot is taken, keep the table at most 3/4 full
+        if(4 * (shortcuts->used + 1) > 3 * shortcuts->capacity){
+            if(rehashShortcuts()){
+                n = num_shortcuts;
+                pthread_mutex_unlock(&shortcuts_mutex);
+                return n;
+            }
+            i = findShortcut(shortcuts, key, &found);
         }
+        shortcuts->used++;
     }
-    // Store new shortcut
-    shortcuts[num_shortcuts].ocl_ptr = ocl_ptr;
-    shortcuts[num_shortcuts].socket = socket;
-    num_shortcuts++;
-    return num_shortcuts;
+    // Store new shortcut, publishing the key after the socket
+    __atomic_store_n(&shortcuts->sockets[i], socket, __ATOMIC_RELAXED);
+    __atomic_store_n(&shortcuts->keys[i], key, __ATOMIC_RELEASE);
+    n = ++num_shortcuts;
+    pthread_mutex_unlock(&shortcuts_mutex);
+    return n;
 }
 
 unsigned int delShortcut(void* ocl_ptr)
 {
-    unsigned int i,id=0;
-    // Look if the pointer don't exist
-    if(!getShortcut(ocl_ptr)){
+    uintptr_t key = (uintptr_t)ocl_ptr;
+    unsigned int n;
+    size_t i;
+    int found = 0;
+    if(key <= SHORTCUT_DELETED){
         return num_shortcuts;
     }
-    if(num_shortcuts == 1){
-        num_shortcuts = 0;
-        if(shortcuts) free(shortcuts); shortcuts=NULL;
-        return 0;
-    }
-    shortcut *backup = shortcuts;
-    shortcuts = (shortcut*)malloc( (num_shortcuts - 1) * sizeof(shortcut));
-    if(!shortcuts){
-        if(backup) free(backup); backup=NULL;
-        num_shortcuts = 0;
-        return 0;
-    }
-    // Store queues not affected
-    for(i=0;i<num_shortcuts;i++){
-        if(ocl_ptr == backup[i].ocl_ptr){
-            continue;
-        }
-        shortcuts[id] = backup[i];
-        id++;
+    pthread_mutex_lock(&shortcuts_mutex);
+    if(shortcuts)
+        i = findShortcut(shortcuts, key, &found);
+    // Look if the pointer don't exist
+    if(!found){
+        n = num_shortcuts;
+        pthread_mutex_unlock(&shortcuts_mutex);
+        return n;
     }
-    num_shortcuts--;
-    if(backup) free(backup); backup=NULL;
-    return num_shortcuts;
+    // The slot is just marked, so the probe sequences of the concurrent
+    // readers are not broken
+    __atomic_store_n(&shortcuts->keys[i], SHORTCUT_DELETED, __ATOMIC_RELEASE);
+    n = --num_shortcuts;
+    pthread_mutex_unlock(&shortcuts_mutex);
+    return n;
 }
 
 int* getShortcut(void* ocl_ptr)
 {
-    unsigned int i;
-    for(i=0;i<num_shortcuts;i++){
-        if(ocl_ptr == shortcuts[i].ocl_ptr)
-            return shortcuts[i].socket;
+    uintptr_t key = (uintptr_t)ocl_ptr;
+    uintptr_t k;
+    unsigned int e;
+    size_t i, mask;
+    int *socket = NULL;
+    if(key <= SHORTCUT_DELETED){
+        return NULL;
+    }
+    // Register as reader of the current epoch, so the table will not be
+    // destroyed while it is read
+    while(1){
+        e = __atomic_load_n(&epoch, __ATOMIC_SEQ_CST);
+        __atomic_fetch_add(&readers[e & 1], 1, __ATOMIC_SEQ_CST);
+        if(__atomic_load_n(&epoch, __ATOMIC_SEQ_CST) == e)
+            break;
+        __atomic_fetch_sub(&readers[e & 1], 1, __ATOMIC_SEQ_CST);
+    }
+    struct shortcut_table_st *t = __atomic_load_n(&shortcuts, __ATOMIC_SEQ_CST);
+    if(t){
+        mask = t->capacity - 1;
+        i = hashShortcut(key) & mask;
+        while((k = __atomic_load_n(&t->keys[i], __ATOMIC_ACQUIRE)) != SHORTCUT_EMPTY){
+            if(k == key){
+                socket = __atomic_load_n(&t->sockets[i], __ATOMIC_RELAXED);
+                break;
+            }
+            i = (i + 1) & mask;
+        }
     }
-    return NULL;
+    __atomic_fetch_sub(&readers[e & 1], 1, __ATOMIC_SEQ_CST);
+    return socket;
 }
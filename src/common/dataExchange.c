@@ -17,6 +17,7 @@
  */
 
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <errno.h>
 #include <netinet/in.h>
 #include <netinet/tcp.h>
@@ -370,17 +371,12 @@ ssize_t Send(int *socket, const void *buffer, size_t length, int flags)
 {
     if(*socket < 0)
         return 0;
-    // Compare data with the buffer length in order to switch on/off
-    // the Nagle's algorithm.
-    int tcp_nodelay_flag = 1;
-    int buffsize=0;
-    getsockopt(*socket, SOL_SOCKET, SO_SNDBUF, &buffsize, sizeof(int));
-    if((int)length >= buffsize){
-        tcp_nodelay_flag = 0;
-    }
-    setsockopt(*socket, SOL_SOCKET, TCP_NODELAY, &tcp_nodelay_flag, sizeof(int));
-    // Send the data
-    ssize_t sent = send(*socket, buffer, length, flags);
+    // The Nagle's algorithm is switched off once, when the connection is
+    // established, and the packages are sent in a single call (see
+    // SendVector), so nothing must be set here.
+    // Send the data. A broken connection must be reported as an error,
+    // instead of raising SIGPIPE, which would kill the whole process
+    ssize_t sent = send(*socket, buffer, length, flags | MSG_NOSIGNAL);
     /*
     if(sent != length){
         #ifdef OCLAND_LOG_VERBOSE
@@ -397,3 +393,70 @@ ssize_t Send(int *socket, const void *buffer, size_t length, int flags)
     */
     return sent;
 }
+
+ssize_t SendVector(int *socket, const struct iovec *iov, int iovcnt)
+{
+    struct iovec vec[iovcnt];
+    struct msghdr message;
+    size_t length = 0;
+    ssize_t sent, total = 0;
+    int i, n = 0;
+    if(*socket < 0)
+        return 0;
+    // Discard the empty pieces, which can't be modified
+    for(i=0;i<iovcnt;i++){
+        if(!iov[i].iov_len)
+            continue;
+        vec[n++] = iov[i];
+        length  += iov[i].iov_len;
+    }
+    memset(&message, 0, sizeof(struct msghdr));
+    message.msg_iov    = vec;
+    message.msg_iovlen = n;
+    while((size_t)total < length){
+        sent = sendmsg(*socket, &message, MSG_NOSIGNAL);
+        if(sent < 0){
+            if(errno == EINTR)
+                continue;
+            return -1;
+        }
+        total += sent;
+        // Skip the pieces already sent, if the message has been split
+        while(message.msg_iovlen && (size_t)sent >= message.msg_iov[0].iov_len){
+            sent -= message.msg_iov[0].iov_len;
+            message.msg_iov++;
+            message.msg_iovlen--;
+        }
+        if(message.msg_iovlen){
+            message.msg_iov[0].iov_base = (char*)message.msg_iov[0].iov_base + sent;
+            message.msg_iov[0].iov_len -= sent;
+        }
+    }
+    return total;
+}
+
+ssize_t SendPackage(int *socket, const struct oclandHeader_st *header, const void *data)
+{
+    struct iovec iov[2];
+    iov[0].iov_base = (void*)header;
+    iov[0].iov_len  = sizeof(struct oclandHeader_st);
+    iov[1].iov_base = (void*)data;
+    iov[1].iov_len  = header->length;
+    ssize_t sent = SendVector(socket, iov, 2);
+    if(sent != (ssize_t)(sizeof(struct oclandHeader_st) + header->length))
+        return -1;
+    return (ssize_t)header->length;
+}
+
+ssize_t RecvHeader(int *socket, struct oclandHeader_st *header, int flags)
+{
+    ssize_t readed = Recv(socket, header, sizeof(struct oclandHeader_st), flags);
+    if(readed != sizeof(struct oclandHeader_st))
+        return readed;
+    if( (header->magic   != OCLAND_MAGIC) ||
+        (header->version != OCLAND_PROTOCOL_VERSION) ){
+        errno = EPROTO;
+        return -1;
+    }
+    return readed;
+}
@@ -0,0 +1,197 @@
+/*
+ *  This file is part of ocland, a free cloud OpenCL interface.
+ *  Copyright (C) 2012  Jose Luis Cercos Pita <jl.cercos@upm.es>
+ *
+ *  ocland is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ocland is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ocland.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <ocland/common/hashTable.h>
+
+/// Initial number of slots
+#define HASH_TABLE_CAPACITY 16u
+
+/** Hash a key. The objects addresses are aligned, so the bits must be
+ * mixed before taking the lower ones.
+ * @param key Key.
+ * @return Hash of the key.
+ */
+static uint64_t hashKey(uint64_t key)
+{
+    key ^= key >> 33;
+    key *= 0xFF51AFD7ED558CCDull;
+    key ^= key >> 33;
+    key *= 0xC4CEB9FE1A85EC53ull;
+    key ^= key >> 33;
+    return key;
+}
+
+/** Look for the slot of a key, or the empty slot where it should be
+ * stored.
+ * @param t Hash table.
+ * @param key Key.
+ * @return Slot index.
+ */
+static size_t findSlot(hash_table t, uint64_t key)
+{
+    size_t mask = t->capacity - 1;
+    size_t i = (size_t)hashKey(key) & mask;
+    while(t->keys[i] && (t->keys[i] != key))
+        i = (i + 1) & mask;
+    return i;
+}
+
+/** Change the number of slots of the hash table, storing again the keys.
+ * @param t Hash table.
+ * @param capacity New number of slots, a power of 2.
+ * @return 0 if the table has been resized, -1 otherwise.
+ */
+static int resizeHashTable(hash_table t, size_t capacity)
+{
+    size_t i, j;
+    uint64_t *keys = t->keys;
+    void **values = t->values;
+    size_t old_capacity = t->capacity;
+    t->keys   = (uint64_t*)calloc(capacity, sizeof(uint64_t));
+    t->values = (void**)malloc(capacity*sizeof(void*));
+    if(!t->keys || !t->values){
+        free(t->keys);
+        free(t->values);
+        t->keys   = keys;
+        t->values = values;
+        return -1;
+    }
+    t->capacity = capacity;
+    for(i=0;i<old_capacity;i++){
+        if(!keys[i])
+            continue;
+        j = findSlot(t, keys[i]);
+        t->keys[j]   = keys[i];
+        t->values[j] = values[i];
+    }
+    free(keys);
+    free(values);
+    return 0;
+}
+
+hash_table createHashTable()
+{
+    hash_table t = (hash_table)malloc(sizeof(struct hash_table_st));
+    if(!t)
+        return NULL;
+    t->capacity = HASH_TABLE_CAPACITY;
+    t->count    = 0;
+    t->keys     = (uint64_t*)calloc(t->capacity, sizeof(uint64_t));
+    t->values   = (void**)malloc(t->capacity*sizeof(void*));
+    if(!t->keys || !t->values){
+        free(t->keys);
+        free(t->values);
+        free(t);
+        return NULL;
+    }
+    return t;
+}
+
+void destroyHashTable(hash_table t)
+{
+    if(!t)
+        return;
+    free(t->keys);
+    free(t->values);
+    free(t);
+}
+
+int hashTableInsert(hash_table t, uint64_t key, void *value)
+{
+    if(!key)
+        return -1;
+    // Keep the table at most 3/4 full, so the probe sequences are short
+    if(4*(t->count + 1) > 3*t->capacity){
+        if(resizeHashTable(t, 2*t->capacity))
+            return -1;
+    }
+    size_t i = findSlot(t, key);
+    if(!t->keys[i]){
+        t->keys[i] = key;
+        t->count++;
+    }
+    t->values[i] = value;
+    return 0;
+}
+
+int hashTableFind(hash_table t, uint64_t key, void **value)
+{
+    if(!key)
+        return 0;
+    size_t i = findSlot(t, key);
+    if(!t->keys[i])
+        return 0;
+    if(value)
+        *value = t->values[i];
+    return 1;
+}
+
+int hashTableRemove(hash_table t, uint64_t key, void **value)
+{
+    size_t mask = t->capacity - 1;
+    size_t i, j, k;
+    if(!key)
+        return 0;
+    i = findSlot(t, key);
+    if(!t->keys[i])
+        return 0;
+    if(value)
+        *value = t->values[i];
+    // Shift back the following keys of the probe sequence, so no key
+    // becomes unreachable (no tombstones are required)
+    j = i;
+    while(1){
+        j = (j + 1) & mask;
+        if(!t->keys[j])
+            break;
+        k = (size_t)hashKey(t->keys[j]) & mask;
+        // Skip the keys which home slot is cyclically in (i, j]
+        if( (i <= j) ? ((i < k) && (k <= j)) : ((i < k) || (k <= j)) )
+            continue;
+        t->keys[i]   = t->keys[j];
+        t->values[i] = t->values[j];
+        i = j;
+    }
+    t->keys[i] = 0;
+    t->count--;
+    return 1;
+}
+
+size_t hashTableCount(hash_table t)
+{
+    return t->count;
+}
+
+int hashTableNext(hash_table t, size_t *index, uint64_t *key, void **value)
+{
+    while(*index < t->capacity){
+        size_t i = (*index)++;
+        if(!t->keys[i])
+            continue;
+        if(key)
+            *key = t->keys[i];
+        if(value)
+            *value = t->values[i];
+        return 1;
+    }
+    return 0;
+}
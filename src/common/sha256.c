@@ -0,0 +1,142 @@
+/*
+ *  This file is part of ocland, a free cloud OpenCL interface.
+ *  Copyright (C) 2012  Jose Luis Cercos Pita <jl.cercos@upm.es>
+ *
+ *  ocland is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ocland is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ocland.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include <ocland/common/sha256.h>
+
+/// Round constants
+static const uint32_t K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+/// Rotate a 32 bits word to the right
+#define ROTR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+/** Hash a block of 64 bytes.
+ * @param c Digest.
+ * @param block Block data.
+ */
+static void sha256Block(sha256 *c, const unsigned char *block)
+{
+    unsigned int i;
+    uint32_t w[64], a, b, d, e, f, g, h, t1, t2, cc;
+    for(i=0;i<16;i++){
+        w[i] = ((uint32_t)block[4*i] << 24) | ((uint32_t)block[4*i + 1] << 16) |
+               ((uint32_t)block[4*i + 2] << 8) | (uint32_t)block[4*i + 3];
+    }
+    for(i=16;i<64;i++){
+        uint32_t s0 = ROTR(w[i - 15], 7) ^ ROTR(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = ROTR(w[i - 2], 17) ^ ROTR(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+    a = c->state[0]; b = c->state[1]; cc = c->state[2]; d = c->state[3];
+    e = c->state[4]; f = c->state[5]; g = c->state[6]; h = c->state[7];
+    for(i=0;i<64;i++){
+        t1 = h + (ROTR(e, 6) ^ ROTR(e, 11) ^ ROTR(e, 25)) + ((e & f) ^ (~e & g)) + K[i] + w[i];
+        t2 = (ROTR(a, 2) ^ ROTR(a, 13) ^ ROTR(a, 22)) + ((a & b) ^ (a & cc) ^ (b & cc));
+        h = g; g = f; f = e; e = d + t1;
+        d = cc; cc = b; b = a; a = t1 + t2;
+    }
+    c->state[0] += a; c->state[1] += b; c->state[2] += cc; c->state[3] += d;
+    c->state[4] += e; c->state[5] += f; c->state[6] += g; c->state[7] += h;
+}
+
+void sha256Init(sha256 *c)
+{
+    c->state[0] = 0x6a09e667; c->state[1] = 0xbb67ae85;
+    c->state[2] = 0x3c6ef372; c->state[3] = 0xa54ff53a;
+    c->state[4] = 0x510e527f; c->state[5] = 0x9b05688c;
+    c->state[6] = 0x1f83d9ab; c->state[7] = 0x5be0cd19;
+    c->length = 0;
+    c->used = 0;
+}
+
+void sha256Update(sha256 *c, const void *data, size_t size)
+{
+    const unsigned char *ptr = (const unsigned char*)data;
+    c->length += size;
+    // Complete the pending block
+    if(c->used){
+        size_t n = 64 - c->used;
+        if(n > size)
+            n = size;
+        memcpy(c->block + c->used, ptr, n);
+        c->used += n; ptr += n; size -= n;
+        if(c->used < 64)
+            return;
+        sha256Block(c, c->block);
+        c->used = 0;
+    }
+    // Hash the full blocks directly from the data
+    while(size >= 64){
+        sha256Block(c, ptr);
+        ptr += 64; size -= 64;
+    }
+    memcpy(c->block, ptr, size);
+    c->used = size;
+}
+
+void sha256Final(sha256 *c, unsigned char *digest)
+{
+    unsigned int i;
+    uint64_t bits = 8 * c->length;
+    // Padding: a bit 1, zeros, and the length in bits
+    c->block[c->used++] = 0x80;
+    if(c->used > 56){
+        memset(c->block + c->used, 0, 64 - c->used);
+        sha256Block(c, c->block);
+        c->used = 0;
+    }
+    memset(c->block + c->used, 0, 56 - c->used);
+    for(i=0;i<8;i++)
+        c->block[56 + i] = (unsigned char)(bits >> (56 - 8*i));
+    sha256Block(c, c->block);
+    for(i=0;i<8;i++){
+        digest[4*i]     = (unsigned char)(c->state[i] >> 24);
+        digest[4*i + 1] = (unsigned char)(c->state[i] >> 16);
+        digest[4*i + 2] = (unsigned char)(c->state[i] >> 8);
+        digest[4*i + 3] = (unsigned char)(c->state[i]);
+    }
+}
+
+void sha256Contents(unsigned char        kind,
+                    uint32_t             count,
+                    const void * const * data,
+                    const size_t *       lengths,
+                    unsigned char *      digest)
+{
+    uint32_t i;
+    sha256 c;
+    sha256Init(&c);
+    sha256Update(&c, &kind, sizeof(unsigned char));
+    sha256Update(&c, &count, sizeof(uint32_t));
+    for(i=0;i<count;i++){
+        uint64_t length = (uint64_t)lengths[i];
+        sha256Update(&c, &length, sizeof(uint64_t));
+        sha256Update(&c, data[i], lengths[i]);
+    }
+    sha256Final(&c, digest);
+}
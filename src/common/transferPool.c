@@ -0,0 +1,148 @@
+/*
+ *  This file is part of ocland, a free cloud OpenCL interface.
+ *  Copyright (C) 2012  Jose Luis Cercos Pita <jl.cercos@upm.es>
+ *
+ *  ocland is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ocland is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ocland.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include <ocland/common/transferPool.h>
+
+transfer_pool createTransferPool(unsigned int max_workers, size_t budget)
+{
+    transfer_pool p = (transfer_pool)malloc(sizeof(struct transfer_pool_st));
+    if(!p)
+        return NULL;
+    p->max_workers  = max_workers ? max_workers : 1;
+    p->num_workers  = 0;
+    p->idle_workers = 0;
+    p->first        = NULL;
+    p->last         = NULL;
+    p->queued       = 0;
+    p->depth        = 0;
+    p->outstanding  = 0;
+    p->budget       = budget;
+    pthread_mutex_init(&(p->mutex), NULL);
+    pthread_cond_init(&(p->work_cond), NULL);
+    pthread_cond_init(&(p->done_cond), NULL);
+    return p;
+}
+
+/** Worker thread, which performs the queued transfers.
+ * @param data Transfer pool.
+ * @return NULL
+ */
+static void *worker_thread(void *data)
+{
+    transfer_pool p = (transfer_pool)data;
+    struct transfer_task_st *t;
+    pthread_mutex_lock(&(p->mutex));
+    while(1){
+        while(!p->first){
+            p->idle_workers++;
+            pthread_cond_wait(&(p->work_cond), &(p->mutex));
+            p->idle_workers--;
+        }
+        t = p->first;
+        p->first = t->next;
+        if(!p->first)
+            p->last = NULL;
+        p->queued--;
+        pthread_mutex_unlock(&(p->mutex));
+        t->run(t->data);
+        pthread_mutex_lock(&(p->mutex));
+        p->depth--;
+        p->outstanding -= t->cb;
+        pthread_cond_broadcast(&(p->done_cond));
+        free(t); t = NULL;
+    }
+    pthread_mutex_unlock(&(p->mutex));
+    return NULL;
+}
+
+void transferPoolSubmit(transfer_pool p, void *(*run)(void*), void *data, size_t cb)
+{
+    pthread_t thread;
+    struct transfer_task_st *t = NULL;
+    if(p)
+        t = (struct transfer_task_st*)malloc(sizeof(struct transfer_task_st));
+    if(!t){
+        run(data);
+        return;
+    }
+    t->run  = run;
+    t->data = data;
+    t->cb   = cb;
+    t->next = NULL;
+    pthread_mutex_lock(&(p->mutex));
+    // Backpressure, wait until the outstanding transfers release the
+    // memory
+    if(p->budget && p->outstanding && (p->outstanding + cb > p->budget)){
+        printf("WARNING: %u transfers holding %lu bytes are pending, waiting for them\n",
+               p->depth, (unsigned long)p->outstanding); fflush(stdout);
+        while(p->outstanding && (p->outstanding + cb > p->budget))
+            pthread_cond_wait(&(p->done_cond), &(p->mutex));
+    }
+    // Queue the transfer
+    if(p->last)
+        p->last->next = t;
+    else
+        p->first = t;
+    p->last = t;
+    p->queued++;
+    p->depth++;
+    p->outstanding += cb;
+    // Launch a new worker if the idle ones are not enough
+    if((p->idle_workers < p->queued) && (p->num_workers < p->max_workers)){
+        int rc = pthread_create(&thread, NULL, worker_thread, (void *)p);
+        if(rc){
+            printf("ERROR: Thread creation has failed with the return code %d\n", rc); fflush(stdout);
+        }
+        else{
+            pthread_detach(thread);
+            p->num_workers++;
+        }
+    }
+    if(!p->num_workers){
+        // Nobody can perform the transfer, so it is the only one in the
+        // queue. Do it in this thread
+        p->first = p->last = NULL;
+        p->queued--;
+        pthread_mutex_unlock(&(p->mutex));
+        run(data);
+        pthread_mutex_lock(&(p->mutex));
+        p->depth--;
+        p->outstanding -= cb;
+        pthread_cond_broadcast(&(p->done_cond));
+        pthread_mutex_unlock(&(p->mutex));
+        free(t); t = NULL;
+        return;
+    }
+    pthread_cond_signal(&(p->work_cond));
+    pthread_mutex_unlock(&(p->mutex));
+}
+
+void transferPoolStatus(transfer_pool p, unsigned int *depth, size_t *outstanding)
+{
+    pthread_mutex_lock(&(p->mutex));
+    if(depth)
+        *depth = p->depth;
+    if(outstanding)
+        *outstanding = p->outstanding;
+    pthread_mutex_unlock(&(p->mutex));
+}
@@ -17,6 +17,7 @@
  */
 
 #include <sys/socket.h>
+#include <sys/epoll.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <stdio.h>
@@ -28,15 +29,62 @@
 #include <ocland/common/dataExchange.h>
 #include <ocland/server/dispatcher.h>
 #include <ocland/server/ocland_cl.h>
+#include <ocland/server/ocland_stats.h>
+#include <ocland/server/ocland_cache.h>
+#include <ocland/server/ocland_mem.h>
+#include <ocland/server/ocland_event.h>
 
 #ifndef BUFF_SIZE
     #define BUFF_SIZE 1025u
 #endif
 
+#ifndef OCLAND_REQUEST_ARENA
+    #define OCLAND_REQUEST_ARENA 16777216u
+#endif
+
+/// Size of the first block of the requests arenas
+#define ARENA_BLOCK 65536u
+/// Offset of the data in the arena blocks, keeping it aligned for any
+/// data type
+#define ARENA_HEADER ((sizeof(struct arena_block_st) + 15) & ~(size_t)15)
+
+/** @struct arena_block_st Block of memory of a requests arena.
+ */
+struct arena_block_st{
+    /// Size of the block data
+    size_t size;
+    /// Size of the block data already allocated
+    size_t used;
+    /// Previous block of the arena
+    struct arena_block_st *next;
+};
+
 typedef int(*func)(int* clientfd, char* buffer, validator v, void* data);
 
+/// Header of the request which is being served by each worker thread
+static __thread struct oclandHeader_st request;
+
+/// Validator of the client which is being served by each worker thread
+static __thread validator request_v = NULL;
+
+/// Data channel of the client which is being served by each worker thread
+static __thread data_channel request_channel = NULL;
+
+/// First error of the batch being served by each worker thread, NULL
+/// if the thread is not serving a batch
+static __thread cl_int *batch_error = NULL;
+
+/// Memory arena where each worker thread receives the requests and
+/// builds its answers
+static __thread struct arena_block_st *arena = NULL;
+
+static int ocland_batch(int* clientfd, char* buffer, validator v, void* data);
+static int ocland_channelToken(int* clientfd, char* buffer, validator v, void* data);
+static int ocland_channelAttach(int* clientfd, char* buffer, validator v, void* data);
+static int ocland_serverStats(int* clientfd, char* buffer, validator v, void* data);
+
 /// List of functions to dispatch request from client
-static func dispatchFunctions[75] =
+static func dispatchFunctions[82] =
 {
     &ocland_clGetPlatformIDs,
     &ocland_clGetPlatformInfo,
@@ -113,27 +161,267 @@ static func dispatchFunctions[75] =
     NULL, // &ocland_clEnqueueBarrierWithWaitList
     &ocland_clCreateImage2D,
     &ocland_clCreateImage3D,
+    &ocland_batch,
+    &ocland_channelToken,
+    &ocland_channelAttach,
+    &ocland_prefetchInfo,
+    &ocland_createProgramWithDigest,
+    &ocland_serverStats,
+    &ocland_kernelArgsAddress,
 };
 
-void *client_thread(void *socket)
+/// Name of each command, used to print the statistics
+static const char *dispatchNames[sizeof(dispatchFunctions) / sizeof(func)] =
+{
+    "clGetPlatformIDs",
+    "clGetPlatformInfo",
+    "clGetDeviceIDs",
+    "clGetDeviceInfo",
+    "clCreateContext",
+    "clCreateContextFromType",
+    "clRetainContext",
+    "clReleaseContext",
+    "clGetContextInfo",
+    "clCreateCommandQueue",
+    "clRetainCommandQueue",
+    "clReleaseCommandQueue",
+    "clGetCommandQueueInfo",
+    "clCreateBuffer",
+    "clRetainMemObject",
+    "clReleaseMemObject",
+    "clGetSupportedImageFormats",
+    "clGetMemObjectInfo",
+    "clGetImageInfo",
+    "clCreateSampler",
+    "clRetainSampler",
+    "clReleaseSampler",
+    "clGetSamplerInfo",
+    "clCreateProgramWithSource",
+    "clCreateProgramWithBinary",
+    "clRetainProgram",
+    "clReleaseProgram",
+    "clBuildProgram",
+    "clGetProgramBuildInfo",
+    "clCreateKernel",
+    "clCreateKernelsInProgram",
+    "clRetainKernel",
+    "clReleaseKernel",
+    "clSetKernelArg",
+    "clGetKernelInfo",
+    "clGetKernelWorkGroupInfo",
+    "clWaitForEvents",
+    "clGetEventInfo",
+    "clRetainEvent",
+    "clReleaseEvent",
+    "clGetEventProfilingInfo",
+    "clFlush",
+    "clFinish",
+    "clEnqueueReadBuffer",
+    "clEnqueueWriteBuffer",
+    "clEnqueueCopyBuffer",
+    "clEnqueueCopyImage",
+    "clEnqueueCopyImageToBuffer",
+    "clEnqueueCopyBufferToImage",
+    "clEnqueueNDRangeKernel",
+    "clCreateSubBuffer",
+    "clCreateUserEvent",
+    "clSetUserEventStatus",
+    "clEnqueueReadBufferRect",
+    "clEnqueueWriteBufferRect",
+    "clEnqueueCopyBufferRect",
+    "clEnqueueReadImage",
+    "clEnqueueWriteImage",
+    "clCreateSubDevices",
+    "clRetainDevice",
+    "clReleaseDevice",
+    "clCreateImage",
+    "clCreateProgramWithBuiltInKernels",
+    "clCompileProgram",
+    "clLinkProgram",
+    "clUnloadPlatformCompiler",
+    "clGetProgramInfo",
+    "clGetKernelArgInfo",
+    "clEnqueueFillBuffer",
+    "clEnqueueFillImage",
+    "clEnqueueMigrateMemObjects",
+    "clEnqueueMarkerWithWaitList",
+    "clEnqueueBarrierWithWaitList",
+    "clCreateImage2D",
+    "clCreateImage3D",
+    "batch",
+    "channelToken",
+    "channelAttach",
+    "prefetchInfo",
+    "createProgramWithDigest",
+    "serverStats",
+    "kernelArgsAddress",
+};
+
+workers initWorkers(unsigned int num_workers,
+                    unsigned int queue_size,
+                    struct client_st *clients,
+                    int epollfd,
+                    int closedfd)
+{
+    unsigned int i;
+    if(!num_workers){
+        long n = sysconf(_SC_NPROCESSORS_ONLN);
+        num_workers = (n > 0) ? (unsigned int)n : 1;
+    }
+    if(!queue_size)
+        queue_size = 1;
+    workers w = (workers)malloc(sizeof(struct workers_st));
+    if(!w)
+        return NULL;
+    w->num_workers = num_workers;
+    w->queue_size  = queue_size;
+    w->queue_head  = 0;
+    w->queue_count = 0;
+    w->clients     = clients;
+    w->epollfd     = epollfd;
+    w->closedfd    = closedfd;
+    w->queue       = (unsigned int*)malloc(queue_size*sizeof(unsigned int));
+    w->threads     = (pthread_t*)malloc(num_workers*sizeof(pthread_t));
+    if(!w->queue || !w->threads){
+        free(w->queue);
+        free(w->threads);
+        free(w);
+        return NULL;
+    }
+    pthread_mutex_init(&(w->mutex), NULL);
+    pthread_cond_init(&(w->not_empty), NULL);
+    pthread_cond_init(&(w->not_full), NULL);
+    for(i=0;i<num_workers;i++){
+        int rc = pthread_create(&(w->threads[i]), NULL, client_thread, (void *)w);
+        if(rc){
+            printf("ERROR: Thread creation has failed with the return code %d\n", rc); fflush(stdout);
+            w->num_workers = i;
+            break;
+        }
+        pthread_detach(w->threads[i]);
+    }
+    if(!w->num_workers){
+        free(w->queue);
+        free(w->threads);
+        free(w);
+        return NULL;
+    }
+    return w;
+}
+
+void queueClient(workers w, unsigned int slot)
+{
+    pthread_mutex_lock(&(w->mutex));
+    while(w->queue_count == w->queue_size)
+        pthread_cond_wait(&(w->not_full), &(w->mutex));
+    w->queue[(w->queue_head + w->queue_count) % w->queue_size] = slot;
+    w->queue_count++;
+    pthread_cond_signal(&(w->not_empty));
+    pthread_mutex_unlock(&(w->mutex));
+}
+
+void *client_thread(void *w)
 {
     char buffer[BUFF_SIZE];
-    int *clientfd = (int*)socket;
-    validator v = NULL;
-    initValidator(&v);
-    // Work until client still connected
-    while(*clientfd >= 0){
-        dispatch(clientfd, buffer, v);
-    }
-    closeValidator(&v);
+    workers pool = (workers)w;
+    struct epoll_event ev;
+    while(1){
+        // Take the next client
+        pthread_mutex_lock(&(pool->mutex));
+        while(!pool->queue_count)
+            pthread_cond_wait(&(pool->not_empty), &(pool->mutex));
+        unsigned int slot = pool->queue[pool->queue_head];
+        pool->queue_head = (pool->queue_head + 1) % pool->queue_size;
+        pool->queue_count--;
+        pthread_cond_signal(&(pool->not_full));
+        pthread_mutex_unlock(&(pool->mutex));
+        // Serve the request
+        struct client_st *client = &(pool->clients[slot]);
+        int fd = client->socket;
+        request_channel = client->channel;
+        dispatch(&(client->socket), buffer, client->v);
+        request_channel = NULL;
+        if(client->socket < 0){
+            // Client disconnected, the socket is already closed
+            // (and therefore removed from the events poll), or it
+            // has been attached to a data channel (and it will not
+            // be rearmed), so we only need to release the slot.
+            closeValidator(&(client->v));
+            closeChannel(client->channel);
+            client->channel = NULL;
+            write(pool->closedfd, &slot, sizeof(unsigned int));
+            continue;
+        }
+        // Watch the client again
+        memset(&ev, 0, sizeof(ev));
+        ev.events   = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+        ev.data.u32 = slot;
+        epoll_ctl(pool->epollfd, EPOLL_CTL_MOD, fd, &ev);
+    }
     pthread_exit(NULL);
     return NULL;
 }
 
+void* requestAlloc(size_t size)
+{
+    struct arena_block_st *block;
+    if(size > SIZE_MAX - ARENA_HEADER - 15)
+        return NULL;
+    size = (size + 15) & ~(size_t)15;
+    if(!size)
+        size = 16;
+    if(!arena || (arena->size - arena->used < size)){
+        // Add a new block, the previous ones are kept until the request
+        // is finished
+        size_t block_size = (size > ARENA_BLOCK) ? size : ARENA_BLOCK;
+        block = (struct arena_block_st*)malloc(ARENA_HEADER + block_size);
+        if(!block)
+            return NULL;
+        block->size = block_size;
+        block->used = 0;
+        block->next = arena;
+        arena = block;
+    }
+    void *ptr = (char*)arena + ARENA_HEADER + arena->used;
+    arena->used += size;
+    return ptr;
+}
+
+/** Release the memory allocated by the request which has been
+ * dispatched by the calling thread (see requestAlloc).
+ */
+static void resetArena()
+{
+    struct arena_block_st *block;
+    size_t total = 0;
+    if(!arena)
+        return;
+    if(!arena->next && (arena->size <= OCLAND_REQUEST_ARENA)){
+        arena->used = 0;
+        return;
+    }
+    // The request has not fit in a block. Grow the arena to fit it in
+    // one block the next time, unless it is too large
+    while(arena){
+        block = arena;
+        arena = block->next;
+        total += block->size;
+        free(block);
+    }
+    if(total > OCLAND_REQUEST_ARENA)
+        return;
+    arena = (struct arena_block_st*)malloc(ARENA_HEADER + total);
+    if(!arena)
+        return;
+    arena->size = total;
+    arena->used = 0;
+    arena->next = NULL;
+}
+
 int dispatch(int* clientfd, char* buffer, validator v)
 {
-    size_t commSize = 0;
-    int flag = Recv(clientfd,&commSize,sizeof(size_t),MSG_DONTWAIT | MSG_PEEK);
+    struct oclandHeader_st header;
+    int flag = Recv(clientfd,&header,sizeof(struct oclandHeader_st),MSG_DONTWAIT | MSG_PEEK);
     if(flag < 0){
         return 0;
     }
@@ -148,37 +436,325 @@ int dispatch(int* clientfd, char* buffer, validator v)
         *clientfd = -1;
         return 1;
     }
-    flag = Recv(clientfd,&commSize,sizeof(size_t),MSG_WAITALL);
-    void *msg = (void*)malloc(commSize);
-    if(!msg){
+    flag = RecvHeader(clientfd,&header,MSG_WAITALL);
+    if( (flag != sizeof(struct oclandHeader_st)) ||
+        (header.opcode >= sizeof(dispatchFunctions) / sizeof(func)) ||
+        (!dispatchFunctions[header.opcode]) ){
+        // Unknown protocol, or unsupported command
         struct sockaddr_in adr_inet;
         socklen_t len_inet;
         len_inet = sizeof(adr_inet);
         getsockname(*clientfd, (struct sockaddr*)&adr_inet, &len_inet);
-        printf("Can't allocate memory for the package from %s (%lu bytes requested)", inet_ntoa(adr_inet.sin_addr), commSize);
+        printf("Invalid package received from %s", inet_ntoa(adr_inet.sin_addr));
         printf(", disconnected for protection...\n"); fflush(stdout);
         close(*clientfd);
         *clientfd = -1;
         return 1;
     }
-    flag = Recv(clientfd,msg,commSize,MSG_WAITALL);
-    if(!flag){
-        // Peer called to close connection
+    struct request_stats_st stats;
+    statsBegin(&stats, header.opcode, sizeof(struct oclandHeader_st) + header.length);
+    void *msg = NULL;
+    if(header.length)
+        msg = requestAlloc(header.length);
+    if(header.length && !msg){
         struct sockaddr_in adr_inet;
         socklen_t len_inet;
         len_inet = sizeof(adr_inet);
         getsockname(*clientfd, (struct sockaddr*)&adr_inet, &len_inet);
-        printf("%s disconnected while operating\n", inet_ntoa(adr_inet.sin_addr)); fflush(stdout);
+        printf("Can't allocate memory for the package from %s (%lu bytes requested)", inet_ntoa(adr_inet.sin_addr), (size_t)header.length);
+        printf(", disconnected for protection...\n"); fflush(stdout);
+        statsEnd(&stats);
         close(*clientfd);
         *clientfd = -1;
         return 1;
     }
-    // Extract the command from the message
-    unsigned int comm = ((unsigned int*)msg)[0];
-    void *data = ((unsigned int*)msg) + 1;
-    // Call the command
-    flag = dispatchFunctions[comm] (clientfd, buffer, v, data);
-    free(msg);
+    if(header.length){
+        flag = Recv(clientfd,msg,header.length,MSG_WAITALL);
+        if(!flag){
+            // Peer called to close connection
+            struct sockaddr_in adr_inet;
+            socklen_t len_inet;
+            len_inet = sizeof(adr_inet);
+            getsockname(*clientfd, (struct sockaddr*)&adr_inet, &len_inet);
+            printf("%s disconnected while operating\n", inet_ntoa(adr_inet.sin_addr)); fflush(stdout);
+            statsEnd(&stats);
+            resetArena();
+            close(*clientfd);
+            *clientfd = -1;
+            return 1;
+        }
+    }
+    // Call the command, the answer will be sent with the same request
+    // identifier
+    request = header;
+    request_v = v;
+    statsPhase(OCLAND_PHASE_CALL);
+    flag = dispatchFunctions[header.opcode] (clientfd, buffer, v, msg);
+    statsEnd(&stats);
+    resetArena();
     msg = NULL;
     return flag;
 }
+
+ssize_t Reply(int* clientfd, const void* msg, size_t msgSize)
+{
+    return ReplyData(clientfd, msg, msgSize, NULL, 0);
+}
+
+ssize_t ReplyData(int* clientfd, const void* msg, size_t msgSize, const void* data, size_t dataSize)
+{
+    if( (request.flags & OCLAND_FLAG_HANDLE) &&
+        (msgSize >= sizeof(cl_int) + sizeof(void*)) &&
+        (((cl_int*)msg)[0] == CL_SUCCESS) ){
+        // The created object (just after the flag) will be identified
+        // by the client generated handle
+        void *object = ((void**)((cl_int*)msg + 1))[0];
+        registerHandle(request_v, OCLAND_HANDLE(request.request_id), object);
+    }
+    cl_int flag = (msgSize >= sizeof(cl_int)) ? ((cl_int*)msg)[0] : CL_SUCCESS;
+    if(batch_error){
+        // The answers of the batched packages are not sent, we only
+        // keep the first error to notify it at the end of the batch
+        if(*batch_error == CL_SUCCESS)
+            *batch_error = flag;
+        statsReply(0, flag);
+        return msgSize;
+    }
+    statsReply(sizeof(struct oclandHeader_st) + msgSize + dataSize, flag);
+    struct oclandHeader_st header = request;
+    header.flags  = 0;
+    header.length = msgSize + dataSize;
+    struct iovec iov[3];
+    iov[0].iov_base = &header;
+    iov[0].iov_len  = sizeof(struct oclandHeader_st);
+    iov[1].iov_base = (void*)msg;
+    iov[1].iov_len  = msgSize;
+    iov[2].iov_base = (void*)data;
+    iov[2].iov_len  = dataSize;
+    statsPhase(OCLAND_PHASE_REPLY);
+    ssize_t sent = SendVector(clientfd, iov, 3);
+    statsPhase(OCLAND_PHASE_CALL);
+    if(sent != (ssize_t)(sizeof(struct oclandHeader_st) + msgSize + dataSize))
+        return -1;
+    return msgSize + dataSize;
+}
+
+const struct oclandHeader_st* requestHeader()
+{
+    return &request;
+}
+
+data_channel requestChannel()
+{
+    return request_channel;
+}
+
+void dispatcherStats()
+{
+    struct oclandCacheStats_st cache;
+    struct oclandTransferStats_st transfers;
+    cl_command_queue *queues = NULL;
+    cl_uint i, num_queues, depth;
+    double age;
+    dumpStats(dispatchNames, sizeof(dispatchFunctions) / sizeof(func));
+    programCacheStats(&cache);
+    printf("Programs cache: %lu hits, %lu misses, %lu stores, %lu evictions, %lu entries (%lu bytes)\n",
+           (unsigned long)cache.hits, (unsigned long)cache.misses,
+           (unsigned long)cache.stores, (unsigned long)cache.evictions,
+           (unsigned long)cache.entries, (unsigned long)cache.size);
+    printf("Programs sources: %lu hits, %lu misses\n",
+           (unsigned long)cache.source_hits, (unsigned long)cache.source_misses);
+    oclandTransfersStatus(&transfers);
+    printf("Transfers: %lu in flight, holding %lu of %lu bytes\n",
+           (unsigned long)transfers.depth, (unsigned long)transfers.outstanding,
+           (unsigned long)transfers.budget);
+    num_queues = oclandQueuesInFlight(0, NULL);
+    if(num_queues)
+        queues = (cl_command_queue*)malloc(num_queues*sizeof(cl_command_queue));
+    if(queues){
+        cl_uint found = oclandQueuesInFlight(num_queues, queues);
+        if(found < num_queues)
+            num_queues = found;
+        for(i=0;i<num_queues;i++){
+            oclandQueueStatus(queues[i], &depth, &age);
+            if(depth)
+                printf("Command queue %p: %u events in flight since %.3f s\n",
+                       (void*)queues[i], depth, age);
+        }
+        free(queues); queues = NULL;
+    }
+    fflush(stdout);
+}
+
+/** Dispatch a batch of packages sent together by the client, which
+ * do not need an answer each one. The packages are served in order,
+ * and a single answer is sent with the first error found (or
+ * CL_SUCCESS if all the packages have been successfully served).
+ * @param clientfd Client connection socket.
+ * @param buffer Buffer to exchange data.
+ * @param v Validator.
+ * @param data Packages (header and data of each one).
+ * @return 0 if message can't be dispatched, 1 otherwise.
+ */
+static int ocland_batch(int* clientfd, char* buffer, validator v, void* data)
+{
+    struct oclandHeader_st batch = request, header;
+    struct request_stats_st stats;
+    cl_int flag = CL_SUCCESS;
+    size_t offset = 0;
+    batch_error = &flag;
+    while(offset < batch.length){
+        // Validate the package
+        if(batch.length - offset < sizeof(struct oclandHeader_st)){
+            flag = CL_INVALID_VALUE;
+            break;
+        }
+        memcpy(&header, (char*)data + offset, sizeof(struct oclandHeader_st));
+        offset += sizeof(struct oclandHeader_st);
+        if( (header.magic   != OCLAND_MAGIC) ||
+            (header.version != OCLAND_PROTOCOL_VERSION) ||
+            (header.opcode >= sizeof(dispatchFunctions) / sizeof(func)) ||
+            (!dispatchFunctions[header.opcode]) ||
+            (dispatchFunctions[header.opcode] == &ocland_batch) ||
+            (header.length > batch.length - offset) ){
+            flag = CL_INVALID_VALUE;
+            break;
+        }
+        // Serve it, accounting it as a separate request
+        request = header;
+        statsBegin(&stats, header.opcode, sizeof(struct oclandHeader_st) + header.length);
+        statsPhase(OCLAND_PHASE_CALL);
+        dispatchFunctions[header.opcode] (clientfd, buffer, v, (char*)data + offset);
+        statsEnd(&stats);
+        offset += header.length;
+        if(*clientfd < 0)
+            break;
+    }
+    batch_error = NULL;
+    request = batch;
+    Reply(clientfd, &flag, sizeof(cl_int));
+    return 1;
+}
+
+/** Send to the client the token required to attach a connection as its
+ * data channel (see ocland_channelAttach).
+ * @param clientfd Client connection socket.
+ * @param buffer Buffer to exchange data.
+ * @param v Validator.
+ * @param data Request data (empty).
+ * @return 0 if message can't be dispatched, 1 otherwise.
+ */
+static int ocland_channelToken(int* clientfd, char* buffer, validator v, void* data)
+{
+    cl_int flag = CL_SUCCESS;
+    uint64_t token = 0;
+    if(request_channel)
+        token = request_channel->token;
+    else
+        flag = CL_OUT_OF_HOST_MEMORY;
+    size_t msgSize = sizeof(cl_int) + sizeof(uint64_t);
+    char msg[sizeof(cl_int) + sizeof(uint64_t)];
+    memcpy(msg, &flag, sizeof(cl_int));
+    memcpy(msg + sizeof(cl_int), &token, sizeof(uint64_t));
+    Reply(clientfd, msg, msgSize);
+    return 1;
+}
+
+/** Attach the connection to the data channel of another client session,
+ * identified by the token given by ocland_channelToken. On success the
+ * connection is not served anymore as a commands channel, and its slot
+ * is released.
+ * @param clientfd Client connection socket.
+ * @param buffer Buffer to exchange data.
+ * @param v Validator.
+ * @param data Request data (the token).
+ * @return 0 if message can't be dispatched, 1 otherwise.
+ */
+static int ocland_channelAttach(int* clientfd, char* buffer, validator v, void* data)
+{
+    cl_int flag = CL_INVALID_VALUE;
+    if(batch_error || (request.length != sizeof(uint64_t))){
+        Reply(clientfd, &flag, sizeof(cl_int));
+        return 1;
+    }
+    uint64_t token;
+    memcpy(&token, data, sizeof(uint64_t));
+    flag = attachChannel(token, *clientfd);
+    Reply(clientfd, &flag, sizeof(cl_int));
+    if(flag == CL_SUCCESS){
+        // The socket is owned by the data channel now
+        struct sockaddr_in adr_inet;
+        socklen_t len_inet;
+        len_inet = sizeof(adr_inet);
+        getsockname(*clientfd, (struct sockaddr*)&adr_inet, &len_inet);
+        printf("%s data channel attached\n", inet_ntoa(adr_inet.sin_addr)); fflush(stdout);
+        *clientfd = -1;
+    }
+    return 1;
+}
+
+/** Send to the client the counters of the requests served by the
+ * server (see oclandOpcodeStats_st), the counters of the programs cache
+ * (see oclandCacheStats_st), the transfers in flight (see
+ * oclandTransferStats_st), and the work in flight of each command queue
+ * (see oclandQueueStats_st).
+ * @param clientfd Client connection socket.
+ * @param buffer Buffer to exchange data.
+ * @param v Validator.
+ * @param data Request data (empty).
+ * @return 0 if message can't be dispatched, 1 otherwise.
+ */
+static int ocland_serverStats(int* clientfd, char* buffer, validator v, void* data)
+{
+    cl_int flag = CL_SUCCESS;
+    uint32_t i, num_opcodes = sizeof(dispatchFunctions) / sizeof(func);
+    cl_command_queue *queues = NULL;
+    cl_uint depth;
+    double age;
+    size_t msgSize = sizeof(cl_int) + sizeof(uint32_t);
+    size_t dataSize = num_opcodes*sizeof(struct oclandOpcodeStats_st);
+    dataSize += sizeof(struct oclandCacheStats_st);
+    dataSize += sizeof(struct oclandTransferStats_st);
+    // The command queues with work in flight can change meanwhile, so
+    // just the ones found the first time are reported
+    uint32_t num_queues = oclandQueuesInFlight(0, NULL);
+    if(num_queues){
+        queues = (cl_command_queue*)requestAlloc(num_queues*sizeof(cl_command_queue));
+        if(!queues)
+            num_queues = 0;
+        else{
+            uint32_t found = oclandQueuesInFlight(num_queues, queues);
+            if(found < num_queues)
+                num_queues = found;
+        }
+    }
+    dataSize += sizeof(uint32_t) + num_queues*sizeof(struct oclandQueueStats_st);
+    void *msg = requestAlloc(msgSize + dataSize);
+    if(!msg){
+        flag = CL_OUT_OF_HOST_MEMORY;
+        Reply(clientfd, &flag, sizeof(cl_int));
+        return 1;
+    }
+    memcpy(msg, &flag, sizeof(cl_int));
+    memcpy((char*)msg + sizeof(cl_int), &num_opcodes, sizeof(uint32_t));
+    void *ptr = (char*)msg + msgSize;
+    getStats((struct oclandOpcodeStats_st*)ptr, num_opcodes);
+    ptr = (struct oclandOpcodeStats_st*)ptr + num_opcodes;
+    programCacheStats((struct oclandCacheStats_st*)ptr);
+    ptr = (struct oclandCacheStats_st*)ptr + 1;
+    oclandTransfersStatus((struct oclandTransferStats_st*)ptr);
+    ptr = (struct oclandTransferStats_st*)ptr + 1;
+    memcpy(ptr, &num_queues, sizeof(uint32_t));
+    ptr = (uint32_t*)ptr + 1;
+    for(i=0;i<num_queues;i++){
+        struct oclandQueueStats_st queue;
+        oclandQueueStatus(queues[i], &depth, &age);
+        queue.command_queue = (uint64_t)(uintptr_t)queues[i];
+        queue.depth         = depth;
+        queue.age           = age;
+        memcpy(ptr, &queue, sizeof(struct oclandQueueStats_st));
+        ptr = (char*)ptr + sizeof(struct oclandQueueStats_st);
+    }
+    Reply(clientfd, msg, msgSize + dataSize);
+    return 1;
+}
@@ -23,13 +23,11 @@
  * virtualization tool in order to use it with any OpenCL
  * based program. So ocland is the first OpenCL cloud
  * computing tookit. \n
- * ocland needs 510XX TCP ports open (Area code). ocland
- * server will bind to port 51000 listening for clients,
- * but since the clients can perform asynchronous memory
- * transfers, additional ports will be binded, so please
- * open TCP ports at least 2 times the maximum number of
- * clients allowed (to 32 default clients TCP Ports from
- * 51000 to 51064 must be open). \n
+ * ocland needs the TCP port 51000 open (Area code). ocland
+ * server will bind to port 51000 listening for clients.
+ * The asynchronous memory transfers are performed through
+ * a second connection to the same port, so no more ports
+ * must be open. \n
  * Please, read README file and user manual in order to
  * know how to use ocland. \n
  * Ocland have two main components, the server, that is an
@@ -42,6 +40,8 @@
  */
 
 #include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
 #include <netinet/in.h>
 #include <netinet/tcp.h>
 #include <arpa/inet.h>
@@ -50,10 +50,14 @@
 #include <unistd.h>
 #include <getopt.h>
 #include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <pthread.h>
 
 #include <ocland/server/log.h>
 #include <ocland/server/validator.h>
 #include <ocland/server/dispatcher.h>
+#include <ocland/server/ocland_cache.h>
 
 /** Maximum number of client connections
  * accepted by server. Variable must be
@@ -85,11 +89,52 @@
     #define PACKAGE_STRING "ocland 0.0.00"
 #endif
 
+/** Number of worker threads serving the clients
+ * requests. If 0, a thread for each client which can
+ * be connected (MAX_CLIENTS) will be launched, so the
+ * clients blocked in a synchronous command (e.g.
+ * clFinish) can't stall the other ones. Variable must
+ * be defined by autotools.
+ */
+#ifndef OCLAND_WORKERS
+    #define OCLAND_WORKERS 0u
+#endif
+
+/** Maximum number of clients waiting for a worker.
+ * Variable must be defined by autotools.
+ */
+#ifndef OCLAND_WORKERS_QUEUE
+    #define OCLAND_WORKERS_QUEUE MAX_CLIENTS
+#endif
+
+/** Directory where the built programs binaries are cached.
+ */
+#ifndef OCLAND_PROGRAM_CACHE_DIR
+    #define OCLAND_PROGRAM_CACHE_DIR "/var/cache/ocland"
+#endif
+
+/** Maximum size (in bytes) of the cached programs binaries. If 0,
+ * the cache is disabled. Variable must be defined by autotools.
+ */
+#ifndef OCLAND_PROGRAM_CACHE_SIZE
+    #define OCLAND_PROGRAM_CACHE_SIZE 268435456u
+#endif
+
+/// Number of worker threads
+static unsigned int num_workers = OCLAND_WORKERS;
+/// Programs binaries cache directory
+static const char *cache_dir = OCLAND_PROGRAM_CACHE_DIR;
+/// Programs binaries cache maximum size
+static size_t cache_size = OCLAND_PROGRAM_CACHE_SIZE;
+
 /// Valid command line sort options.
-static const char *opts = "l:vh?";
+static const char *opts = "l:w:c:s:vh?";
 /// Valid command line long options.
 static const struct option longOpts[] = {
     { "log-file", required_argument, NULL, 'l' },
+    { "workers", required_argument, NULL, 'w' },
+    { "cache-dir", required_argument, NULL, 'c' },
+    { "cache-size", required_argument, NULL, 's' },
     { "version", no_argument, NULL, 'v' },
     { "help", no_argument, NULL, 'h' },
     { NULL, no_argument, NULL, 0 }
@@ -107,6 +152,13 @@ void displayUsage()
     printf("Required arguments for long options are also required for the short ones.\n");
     printf("  -l, --log-file=LOG           Output log file. If unset /var/log/ocland.log\n");
     printf("                                 will used\n");
+    printf("  -w, --workers=N              Number of threads serving the clients. If 0\n");
+    printf("                                 one thread for each client will be used\n");
+    printf("  -c, --cache-dir=DIR          Directory where the built programs binaries are\n");
+    printf("                                 cached. If unset %s\n", OCLAND_PROGRAM_CACHE_DIR);
+    printf("                                 will used\n");
+    printf("  -s, --cache-size=BYTES       Maximum size of the cached programs binaries. If 0\n");
+    printf("                                 the cache is disabled\n");
     printf("  -v, --version                Show ocland name and version\n");
     printf("  -h, --help                   Show this help page\n");
 }
@@ -129,6 +181,18 @@ void parseOptions(int argc, char *argv[])
                 }
                 break;
 
+            case 'w':
+                num_workers = (unsigned int)strtoul(optarg, NULL, 10);
+                break;
+
+            case 'c':
+                cache_dir = optarg;
+                break;
+
+            case 's':
+                cache_size = (size_t)strtoull(optarg, NULL, 10);
+                break;
+
             case 'v':
                 printf(PACKAGE_STRING);
                 printf("\n");
@@ -169,15 +233,15 @@ int main(int argc, char *argv[])
     // ------------------------------
     int switch_on  = 1;
     int switch_off = 0;
-    int serverfd = 0, *clientfd = NULL;
-    validator *v = NULL;
-    unsigned int n_clientfd = 0, i,j;
+    int serverfd = 0, epollfd = -1, closedfd[2], signalsfd = -1;
+    sigset_t signals;
+    struct client_st *clients = NULL;
+    workers w = NULL;
+    unsigned int *free_slots = NULL, n_free_slots = 0, i, j, e;
     struct sockaddr_in serv_addr;
-
-    char buffer[BUFF_SIZE];
+    struct epoll_event ev, events[MAX_CLIENTS + 3];
 
     memset(&serv_addr, '0', sizeof(serv_addr));
-    memset(buffer, '0', sizeof(buffer));
 
     serverfd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
     if(serverfd < 0){
@@ -203,71 +267,164 @@ int main(int argc, char *argv[])
     // ------------------------------
     // Start serving
     // ------------------------------
-    clientfd = (int*) malloc(MAX_CLIENTS*sizeof(int));
-    v = (validator*) malloc(MAX_CLIENTS*sizeof(validator));
+    // The clients are stored in fixed slots, so the events loop can
+    // reference each client by its slot index, and a stack of free
+    // slots is kept in order to get a new one without scanning.
+    clients = (struct client_st*) malloc(MAX_CLIENTS*sizeof(struct client_st));
+    free_slots = (unsigned int*) malloc(MAX_CLIENTS*sizeof(unsigned int));
     for(i=0;i<MAX_CLIENTS;i++){
-        clientfd[i] = -1;
+        clients[i].socket = -1;
+        clients[i].v = NULL;
+        clients[i].channel = NULL;
+        free_slots[i] = MAX_CLIENTS - 1 - i;
+    }
+    n_free_slots = MAX_CLIENTS;
+    epollfd = epoll_create1(0);
+    if(epollfd < 0){
+        printf("Can't create the events poll!\n");
+        return EXIT_FAILURE;
+    }
+    // The workers report the disconnected clients using a pipe
+    if(pipe(closedfd)){
+        printf("Can't create the disconnections pipe!\n");
+        return EXIT_FAILURE;
+    }
+    // SIGUSR1 prints the requests statistics. The signal is blocked
+    // before launching the workers, which inherit the mask, so it is
+    // only received through the events poll
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGUSR1);
+    if(!pthread_sigmask(SIG_BLOCK, &signals, NULL))
+        signalsfd = signalfd(-1, &signals, 0);
+    if(!num_workers)
+        num_workers = MAX_CLIENTS;
+    if(num_workers < MAX_CLIENTS){
+        printf("WARNING: Less workers than clients, the clients blocked in a synchronous command may stall the other ones.\n");
+    }
+    w = initWorkers(num_workers, OCLAND_WORKERS_QUEUE, clients, epollfd, closedfd[1]);
+    if(!w){
+        printf("Can't launch the workers!\n");
+        return EXIT_FAILURE;
+    }
+    printf("%u workers will serve the clients.\n", w->num_workers);
+    fflush(stdout);
+    if(initProgramCache(cache_dir, cache_size) != CL_SUCCESS){
+        printf("Can't use \"%s\" to cache the programs binaries, the cache will be disabled.\n", cache_dir);
+        cache_size = 0;
+    }
+    if(cache_size){
+        struct oclandCacheStats_st stats;
+        programCacheStats(&stats);
+        printf("%lu programs binaries cached in \"%s\".\n", (unsigned long)stats.entries, cache_dir);
+    }
+    fflush(stdout);
+    // The server socket is tagged with MAX_CLIENTS, the pipe with
+    // MAX_CLIENTS + 1, and the signals with MAX_CLIENTS + 2, that can't
+    // be clients slots.
+    memset(&ev, 0, sizeof(ev));
+    ev.events   = EPOLLIN;
+    ev.data.u32 = MAX_CLIENTS;
+    if(epoll_ctl(epollfd, EPOLL_CTL_ADD, serverfd, &ev)){
+        printf("Can't register the server socket in the events poll!\n");
+        return EXIT_FAILURE;
+    }
+    memset(&ev, 0, sizeof(ev));
+    ev.events   = EPOLLIN;
+    ev.data.u32 = MAX_CLIENTS + 1;
+    if(epoll_ctl(epollfd, EPOLL_CTL_ADD, closedfd[0], &ev)){
+        printf("Can't register the disconnections pipe in the events poll!\n");
+        return EXIT_FAILURE;
+    }
+    memset(&ev, 0, sizeof(ev));
+    ev.events   = EPOLLIN;
+    ev.data.u32 = MAX_CLIENTS + 2;
+    if((signalsfd < 0) || epoll_ctl(epollfd, EPOLL_CTL_ADD, signalsfd, &ev)){
+        printf("Can't register the signals in the events poll, the statistics will not be printed!\n");
+        fflush(stdout);
     }
     while(1)
     {
-        // Accepts new connection if possible
-        int fd = accept(serverfd, (struct sockaddr*)NULL, NULL);
-        if(fd >= 0){
-            clientfd[n_clientfd] = fd;
-            initValidator(&(v[n_clientfd]));
-            struct sockaddr_in adr_inet;
-            socklen_t len_inet;
-            len_inet = sizeof(adr_inet);
-            getsockname(fd, (struct sockaddr*)&adr_inet, &len_inet);
-            n_clientfd++;
-            printf("%s connected, hello!\n", inet_ntoa(adr_inet.sin_addr)); fflush(stdout);
-            printf("%u connection slots free.\n", MAX_CLIENTS - n_clientfd); fflush(stdout);
-        }
-        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY,  (char *) &switch_on, sizeof(int));
-        setsockopt(fd, IPPROTO_TCP, TCP_QUICKACK, (char *) &switch_on, sizeof(int));
-        // Count new number of clients (to manage lost ones)
-        unsigned int n = n_clientfd;
-        n_clientfd = 0;
-        for(i=0;i<MAX_CLIENTS;i++){
-            if(clientfd[i] >= 0){
-                n_clientfd++;
-            }
+        // Sleep until a client sends something or a new client arrives
+        int n_events = epoll_wait(epollfd, events, MAX_CLIENTS + 3, -1);
+        if(n_events < 0){
+            if(errno == EINTR)
+                continue;
+            printf("Events poll failure!\n"); fflush(stdout);
+            break;
         }
-        if(n != n_clientfd){
-            printf("%u connection slots free.\n", MAX_CLIENTS - n_clientfd); fflush(stdout);
-            if(!(MAX_CLIENTS - n_clientfd)){
-                printf("NO MORE CLIENTS WILL BE ACCEPTED\n"); fflush(stdout);
+        for(e=0;e<(unsigned int)n_events;e++){
+            i = events[e].data.u32;
+            if(i == MAX_CLIENTS){
+                // Accepts all the pending connections while slots remain
+                while(n_free_slots){
+                    int fd = accept(serverfd, (struct sockaddr*)NULL, NULL);
+                    if(fd < 0)
+                        break;
+                    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY,  (char *) &switch_on, sizeof(int));
+                    setsockopt(fd, IPPROTO_TCP, TCP_QUICKACK, (char *) &switch_on, sizeof(int));
+                    j = free_slots[--n_free_slots];
+                    clients[j].socket = fd;
+                    initValidator(&(clients[j].v));
+                    clients[j].channel = createChannel();
+                    // The socket is disarmed after each event, so only one
+                    // worker can serve the client at the same time.
+                    memset(&ev, 0, sizeof(ev));
+                    ev.events   = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+                    ev.data.u32 = j;
+                    if(epoll_ctl(epollfd, EPOLL_CTL_ADD, fd, &ev)){
+                        printf("Can't register the client socket in the events poll!\n"); fflush(stdout);
+                        closeValidator(&(clients[j].v));
+                        closeChannel(clients[j].channel);
+                        clients[j].channel = NULL;
+                        clients[j].socket = -1;
+                        close(fd);
+                        n_free_slots++;
+                        continue;
+                    }
+                    struct sockaddr_in adr_inet;
+                    socklen_t len_inet;
+                    len_inet = sizeof(adr_inet);
+                    getsockname(fd, (struct sockaddr*)&adr_inet, &len_inet);
+                    printf("%s connected, hello!\n", inet_ntoa(adr_inet.sin_addr)); fflush(stdout);
+                    printf("%u connection slots free.\n", n_free_slots); fflush(stdout);
+                }
+                if(!n_free_slots){
+                    // Stop listening until a client leaves
+                    printf("NO MORE CLIENTS WILL BE ACCEPTED\n"); fflush(stdout);
+                    epoll_ctl(epollfd, EPOLL_CTL_DEL, serverfd, NULL);
+                }
+                continue;
             }
-            // Sort the clients at the start of the array
-            for(i=0;i<n_clientfd;i++){
-                if(clientfd[i] < 0){
-                    // Look for next non-negative
-                    j = i+1;
-                    while(clientfd[j] < 0)
-                        j++;
-                    // Swap them
-                    clientfd[i] = clientfd[j];
-                    clientfd[j] = -1;
-                    v[i]        = v[j];
+            if(i == MAX_CLIENTS + 1){
+                // A client has been disconnected, release its slot
+                if(read(closedfd[0], &j, sizeof(unsigned int)) != sizeof(unsigned int))
+                    continue;
+                clients[j].v = NULL;
+                if(!n_free_slots){
+                    memset(&ev, 0, sizeof(ev));
+                    ev.events   = EPOLLIN;
+                    ev.data.u32 = MAX_CLIENTS;
+                    epoll_ctl(epollfd, EPOLL_CTL_ADD, serverfd, &ev);
                 }
+                free_slots[n_free_slots++] = j;
+                printf("%u connection slots free.\n", n_free_slots); fflush(stdout);
+                continue;
             }
-        }
-        // Serve to the clients
-        for(i=0;i<n_clientfd;i++){
-            dispatch(&(clientfd[i]), buffer, v[i]);
-            if(clientfd[i] < 0){
-                // Client disconnected
-                closeValidator(&(v[i]));
+            if(i == MAX_CLIENTS + 2){
+                // Statistics requested
+                struct signalfd_siginfo info;
+                if(read(signalsfd, &info, sizeof(info)) != sizeof(info))
+                    continue;
+                dispatcherStats();
+                continue;
             }
-        }
-        if(!n_clientfd){
-            // We can wait a little bit more if not any
-            // client is connected.
-            usleep(1000);
+            // Let a worker to serve the client
+            queueClient(w, i);
         }
     }
-    free(clientfd); clientfd=0;
-    free(v); v = NULL;
+    close(epollfd);
+    free(clients); clients=NULL;
+    free(free_slots); free_slots = NULL;
     return EXIT_SUCCESS;
 
 
@@ -0,0 +1,273 @@
+/*
+ *  This file is part of ocland, a free cloud OpenCL interface.
+ *  Copyright (C) 2012  Jose Luis Cercos Pita <jl.cercos@upm.es>
+ *
+ *  ocland is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ocland is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ocland.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include <ocland/server/ocland_build.h>
+#include <ocland/server/ocland_cache.h>
+#include <ocland/common/transferPool.h>
+
+#ifndef OCLAND_BUILD_WORKERS
+    #define OCLAND_BUILD_WORKERS 8u
+#endif
+
+/// Workers performing the programs builds
+static transfer_pool builds = NULL;
+/// Builds pool initialization control
+static pthread_once_t builds_once = PTHREAD_ONCE_INIT;
+
+/** Create the pool of workers performing the programs builds.
+ */
+static void initBuilds()
+{
+    builds = createTransferPool(OCLAND_BUILD_WORKERS, 0);
+}
+
+/** @struct build_st Program being built, maybe for several devices in
+ * parallel.
+ */
+struct build_st{
+    /// Program
+    cl_program program;
+    /// Number of devices requested by the client
+    cl_uint num_devices;
+    /// Devices requested by the client, NULL for all the devices
+    cl_device_id *device_list;
+    /// Build options
+    char *options;
+    /// Devices built in parallel, one per worker
+    cl_device_id *devices;
+    /// Number of builds launched (1 if the devices are built together)
+    cl_uint num_tasks;
+    /// Number of builds not finished yet
+    cl_uint pending;
+    /// Error code of the build, the first error reported by a device
+    cl_int flag;
+    /// Data channel of the client, NULL for synchronous builds
+    data_channel channel;
+    /// Command index of the request which started the build
+    uint32_t opcode;
+    /// Identifier of the request which started the build
+    uint32_t request_id;
+    /// Mutex protecting the pending builds
+    pthread_mutex_t mutex;
+    /// Condition signaled when all the builds have finished
+    pthread_cond_t cond;
+};
+
+/** @struct build_task_st Build of a device, performed by a worker.
+ */
+struct build_task_st{
+    /// Program being built
+    struct build_st *build;
+    /// Index of the device in the built devices
+    cl_uint index;
+};
+
+/** Release the data of a build.
+ * @param b Build data.
+ */
+static void freeBuild(struct build_st *b)
+{
+    pthread_mutex_destroy(&(b->mutex));
+    pthread_cond_destroy(&(b->cond));
+    free(b->device_list); b->device_list = NULL;
+    free(b->options); b->options = NULL;
+    free(b->devices); b->devices = NULL;
+    free(b);
+}
+
+/** Finish an asynchronous build, storing the binaries and sending the
+ * error code to the client.
+ * @param b Build data.
+ */
+static void finishBuild(struct build_st *b)
+{
+    if(b->flag == CL_SUCCESS)
+        storeCachedProgram(b->program, b->num_devices, b->device_list, b->options);
+    channelSend(b->channel, b->opcode, b->request_id, &(b->flag), sizeof(cl_int));
+    releaseChannel(b->channel);
+    clReleaseProgram(b->program);
+    freeBuild(b);
+}
+
+/** Thread which builds a program for a device, or for all the requested
+ * devices if they are built together.
+ * @param data Build task.
+ * @return NULL
+ */
+static void *buildThread(void *data)
+{
+    struct build_task_st *t = (struct build_task_st*)data;
+    struct build_st *b = t->build;
+    data_channel channel = b->channel;
+    cl_uint pending;
+    cl_int flag;
+    if(b->num_tasks > 1)
+        flag = clBuildProgram(b->program, 1, &(b->devices[t->index]),
+                              b->options, NULL, NULL);
+    else
+        flag = clBuildProgram(b->program, b->num_devices, b->device_list,
+                              b->options, NULL, NULL);
+    free(t); t = NULL;
+    pthread_mutex_lock(&(b->mutex));
+    if(b->flag == CL_SUCCESS)
+        b->flag = flag;
+    pending = --(b->pending);
+    if(!pending)
+        pthread_cond_broadcast(&(b->cond));
+    pthread_mutex_unlock(&(b->mutex));
+    // The synchronous builds are released by the waiting thread
+    if(!pending && channel)
+        finishBuild(b);
+    return NULL;
+}
+
+/** Get the devices which can be built in parallel.
+ * @param b Build data.
+ * @return Number of devices. If 1, the devices must be built together.
+ */
+static cl_uint buildDevices(struct build_st *b)
+{
+    cl_uint n = b->num_devices;
+    cl_int flag;
+    if(!b->device_list){
+        flag = clGetProgramInfo(b->program, CL_PROGRAM_NUM_DEVICES,
+                                sizeof(cl_uint), &n, NULL);
+        if(flag != CL_SUCCESS)
+            return 1;
+    }
+    if(n < 2)
+        return 1;
+    b->devices = (cl_device_id*)malloc(n*sizeof(cl_device_id));
+    if(!b->devices)
+        return 1;
+    if(b->device_list){
+        memcpy(b->devices, b->device_list, n*sizeof(cl_device_id));
+        return n;
+    }
+    flag = clGetProgramInfo(b->program, CL_PROGRAM_DEVICES,
+                            n*sizeof(cl_device_id), b->devices, NULL);
+    if(flag != CL_SUCCESS){
+        free(b->devices); b->devices = NULL;
+        return 1;
+    }
+    return n;
+}
+
+cl_int buildProgram(cl_program           program,
+                    cl_uint              num_devices,
+                    const cl_device_id * device_list,
+                    const char *         options,
+                    data_channel         channel,
+                    uint32_t             opcode,
+                    uint32_t             request_id)
+{
+    cl_uint i, num_tasks, pending;
+    cl_int flag;
+    struct build_task_st *t;
+    struct build_st *b = (struct build_st*)calloc(1, sizeof(struct build_st));
+    if(!b)
+        return CL_OUT_OF_HOST_MEMORY;
+    b->program     = program;
+    b->num_devices = device_list ? num_devices : 0;
+    b->channel     = channel;
+    b->opcode      = opcode;
+    b->request_id  = request_id;
+    b->flag        = CL_SUCCESS;
+    flag = CL_SUCCESS;
+    if(device_list && num_devices){
+        b->device_list = (cl_device_id*)malloc(num_devices*sizeof(cl_device_id));
+        if(b->device_list)
+            memcpy(b->device_list, device_list, num_devices*sizeof(cl_device_id));
+        else
+            flag = CL_OUT_OF_HOST_MEMORY;
+    }
+    if(options){
+        b->options = strdup(options);
+        if(!b->options)
+            flag = CL_OUT_OF_HOST_MEMORY;
+    }
+    if(flag != CL_SUCCESS){
+        free(b->device_list); b->device_list = NULL;
+        free(b->options); b->options = NULL;
+        free(b);
+        return flag;
+    }
+    pthread_mutex_init(&(b->mutex), NULL);
+    pthread_cond_init(&(b->cond), NULL);
+    num_tasks = buildDevices(b);
+    b->num_tasks = num_tasks;
+    b->pending   = num_tasks;
+    if(!channel && (num_tasks == 1)){
+        // Nothing to parallelize, build it right now
+        flag = clBuildProgram(program, b->num_devices, b->device_list,
+                              b->options, NULL, NULL);
+        if(flag == CL_SUCCESS)
+            storeCachedProgram(program, b->num_devices, b->device_list, b->options);
+        freeBuild(b);
+        return flag;
+    }
+    if(channel){
+        // The build will outlive the request
+        clRetainProgram(program);
+        retainChannel(channel);
+    }
+    pthread_once(&builds_once, initBuilds);
+    for(i=0;i<num_tasks;i++){
+        t = (struct build_task_st*)malloc(sizeof(struct build_task_st));
+        if(!t)
+            break;
+        t->build = b;
+        t->index = i;
+        // The asynchronous build may be released by the worker as soon
+        // as the last device is submitted
+        transferPoolSubmit(builds, buildThread, (void*)t, 0);
+    }
+    if(i < num_tasks){
+        // Account the builds which will never be launched
+        pthread_mutex_lock(&(b->mutex));
+        b->flag = CL_OUT_OF_HOST_MEMORY;
+        b->pending -= num_tasks - i;
+        pending = b->pending;
+        pthread_mutex_unlock(&(b->mutex));
+        if(channel && !i){
+            // Nothing has been launched, so the client is not notified
+            releaseChannel(channel);
+            clReleaseProgram(program);
+            freeBuild(b);
+            return CL_OUT_OF_HOST_MEMORY;
+        }
+        if(channel && !pending)
+            finishBuild(b);
+    }
+    if(channel)
+        return CL_SUCCESS;
+    pthread_mutex_lock(&(b->mutex));
+    while(b->pending)
+        pthread_cond_wait(&(b->cond), &(b->mutex));
+    flag = b->flag;
+    pthread_mutex_unlock(&(b->mutex));
+    if(flag == CL_SUCCESS)
+        storeCachedProgram(program, b->num_devices, b->device_list, b->options);
+    freeBuild(b);
+    return flag;
+}
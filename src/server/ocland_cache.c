@@ -0,0 +1,860 @@
+/*
+ *  This file is part of ocland, a free cloud OpenCL interface.
+ *  Copyright (C) 2012  Jose Luis Cercos Pita <jl.cercos@upm.es>
+ *
+ *  ocland is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ocland is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ocland.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <dirent.h>
+#include <utime.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+#include <ocland/common/sha256.h>
+#include <ocland/common/hashTable.h>
+#include <ocland/server/ocland_cache.h>
+
+/// Extension of the cached files
+#define CACHE_EXTENSION ".bin"
+/// Prefix of the cached files being written
+#define CACHE_TEMP_PREFIX ".ocland"
+
+/** @struct cache_entry_st Binary, or programs sources, stored in the
+ * cache. The entries are sorted from the most to the least recently
+ * used one.
+ */
+struct cache_entry_st{
+    /// Key of the entry: the digest of the sources, or the key of the
+    /// binary (see deviceKey)
+    unsigned char key[SHA256_SIZE];
+    /// Size of the entry file
+    size_t size;
+    /// Previous (more recently used) entry
+    struct cache_entry_st *prev;
+    /// Next (less recently used) entry
+    struct cache_entry_st *next;
+};
+
+/** @struct cache_file_st File found in the cache directory.
+ */
+struct cache_file_st{
+    /// Cache entry
+    struct cache_entry_st *entry;
+    /// Last time the entry was used
+    struct timespec mtime;
+};
+
+/// Directory where the entries are stored
+static char *cache_dir = NULL;
+/// Maximum size of the entries, 0 if the cache is disabled
+static size_t cache_max_size = 0;
+/// Stored entries (key -> struct cache_entry_st)
+static hash_table cache_entries = NULL;
+/// Most recently used entry
+static struct cache_entry_st *cache_first = NULL;
+/// Least recently used entry
+static struct cache_entry_st *cache_last = NULL;
+/// Digest of the contents of each program (program -> digest)
+static hash_table program_contents = NULL;
+/// Program replaced by each program built from the cached binaries
+/// (cached program -> replaced program)
+static hash_table program_substitutes = NULL;
+/// Cache counters
+static struct oclandCacheStats_st cache_stats = {0, 0, 0, 0, 0, 0, 0, 0};
+/// Mutex protecting the cache data
+static pthread_mutex_t cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/// Hash table key of a program
+#define PROGRAM_KEY(program) ((uint64_t)(uintptr_t)(program))
+
+/** Hash table key of an entry.
+ * @param key Entry key.
+ * @return Hash table key, which is never 0.
+ */
+static uint64_t entryKey(const unsigned char *key)
+{
+    uint64_t k;
+    memcpy(&k, key, sizeof(uint64_t));
+    return k ? k : 1;
+}
+
+/** Path of the file of an entry.
+ * @param key Entry key.
+ * @return Path, which must be freed with free(). NULL if it can't be
+ * allocated.
+ */
+static char* entryPath(const unsigned char *key)
+{
+    unsigned int i;
+    size_t len = strlen(cache_dir);
+    char *path = (char*)malloc(len + 1 + 2*SHA256_SIZE + strlen(CACHE_EXTENSION) + 1);
+    if(!path)
+        return NULL;
+    strcpy(path, cache_dir);
+    path[len++] = '/';
+    for(i=0;i<SHA256_SIZE;i++){
+        sprintf(path + len, "%02x", key[i]);
+        len += 2;
+    }
+    strcpy(path + len, CACHE_EXTENSION);
+    return path;
+}
+
+/** Get the key of an entry from its file name.
+ * @param name File name.
+ * @param key Entry key.
+ * @return 1 if the file is a cached entry, 0 otherwise.
+ */
+static int parseEntryName(const char *name, unsigned char *key)
+{
+    unsigned int i, byte;
+    if(strlen(name) != 2*SHA256_SIZE + strlen(CACHE_EXTENSION))
+        return 0;
+    if(strcmp(name + 2*SHA256_SIZE, CACHE_EXTENSION))
+        return 0;
+    for(i=0;i<SHA256_SIZE;i++){
+        if(!strchr("0123456789abcdef", name[2*i]) ||
+           !strchr("0123456789abcdef", name[2*i + 1]))
+            return 0;
+        if(sscanf(name + 2*i, "%2x", &byte) != 1)
+            return 0;
+        key[i] = (unsigned char)byte;
+    }
+    return 1;
+}
+
+/** Remove an entry from the used list.
+ * @param e Entry.
+ */
+static void unlinkEntry(struct cache_entry_st *e)
+{
+    if(e->prev) e->prev->next = e->next; else cache_first = e->next;
+    if(e->next) e->next->prev = e->prev; else cache_last = e->prev;
+    e->prev = NULL;
+    e->next = NULL;
+}
+
+/** Set an entry as the most recently used one.
+ * @param e Entry, which is not in the used list.
+ */
+static void pushEntry(struct cache_entry_st *e)
+{
+    e->prev = NULL;
+    e->next = cache_first;
+    if(cache_first) cache_first->prev = e; else cache_last = e;
+    cache_first = e;
+}
+
+/** Look for an entry.
+ * @param key Entry key.
+ * @return Entry, NULL if it is not stored.
+ */
+static struct cache_entry_st* findEntry(const unsigned char *key)
+{
+    struct cache_entry_st *e = NULL;
+    if(!hashTableFind(cache_entries, entryKey(key), (void**)&e))
+        return NULL;
+    if(memcmp(e->key, key, SHA256_SIZE))
+        return NULL;
+    return e;
+}
+
+/** Discard an entry, removing its file.
+ * @param e Entry.
+ */
+static void discardEntry(struct cache_entry_st *e)
+{
+    char *path = entryPath(e->key);
+    if(path)
+        unlink(path);
+    free(path); path = NULL;
+    unlinkEntry(e);
+    hashTableRemove(cache_entries, entryKey(e->key), NULL);
+    cache_stats.entries--;
+    cache_stats.size -= e->size;
+    free(e);
+}
+
+/** Discard the least recently used entries until the cache size is
+ * not greater than the maximum.
+ */
+static void evictEntries()
+{
+    while(cache_last && (cache_stats.size > cache_max_size)){
+        discardEntry(cache_last);
+        cache_stats.evictions++;
+    }
+}
+
+/** Compare the cached files by their last use time.
+ * @param a First file.
+ * @param b Second file.
+ * @return Comparison result, as qsort requires.
+ */
+static int compareFiles(const void *a, const void *b)
+{
+    const struct timespec *ta = &(((const struct cache_file_st*)a)->mtime);
+    const struct timespec *tb = &(((const struct cache_file_st*)b)->mtime);
+    if(ta->tv_sec != tb->tv_sec)
+        return (ta->tv_sec > tb->tv_sec) - (ta->tv_sec < tb->tv_sec);
+    return (ta->tv_nsec > tb->tv_nsec) - (ta->tv_nsec < tb->tv_nsec);
+}
+
+cl_int initProgramCache(const char *dir, size_t max_size)
+{
+    DIR *d;
+    struct dirent *ent;
+    struct stat st;
+    struct cache_file_st *files = NULL, *new_files;
+    size_t num_files = 0, max_files = 0, i;
+    unsigned char key[SHA256_SIZE];
+    if(!max_size)
+        return CL_SUCCESS;
+    if(mkdir(dir, 0755) && (errno != EEXIST))
+        return CL_INVALID_VALUE;
+    d = opendir(dir);
+    if(!d)
+        return CL_INVALID_VALUE;
+    cache_dir = strdup(dir);
+    cache_entries = createHashTable();
+    program_contents = createHashTable();
+    program_substitutes = createHashTable();
+    if(!cache_dir || !cache_entries || !program_contents || !program_substitutes){
+        closedir(d);
+        free(cache_dir); cache_dir = NULL;
+        destroyHashTable(cache_entries); cache_entries = NULL;
+        destroyHashTable(program_contents); program_contents = NULL;
+        destroyHashTable(program_substitutes); program_substitutes = NULL;
+        return CL_INVALID_VALUE;
+    }
+    // Collect the entries stored by the previous executions
+    while((ent = readdir(d))){
+        if(!strncmp(ent->d_name, CACHE_TEMP_PREFIX, strlen(CACHE_TEMP_PREFIX))){
+            // Entry which writing was interrupted
+            char *path = (char*)malloc(strlen(dir) + 1 + strlen(ent->d_name) + 1);
+            if(path){
+                sprintf(path, "%s/%s", dir, ent->d_name);
+                unlink(path);
+            }
+            free(path); path = NULL;
+            continue;
+        }
+        if(!parseEntryName(ent->d_name, key))
+            continue;
+        char *path = entryPath(key);
+        if(!path || stat(path, &st) || !S_ISREG(st.st_mode)){
+            free(path); path = NULL;
+            continue;
+        }
+        free(path); path = NULL;
+        if(num_files == max_files){
+            max_files = max_files ? 2*max_files : 64;
+            new_files = (struct cache_file_st*)realloc(files, max_files*sizeof(struct cache_file_st));
+            if(!new_files)
+                break;
+            files = new_files;
+        }
+        struct cache_entry_st *e = (struct cache_entry_st*)malloc(sizeof(struct cache_entry_st));
+        if(!e)
+            break;
+        memcpy(e->key, key, SHA256_SIZE);
+        e->size = (size_t)st.st_size;
+        files[num_files].entry = e;
+        files[num_files].mtime = st.st_mtim;
+        num_files++;
+    }
+    closedir(d);
+    // Register them from the least to the most recently used one
+    if(num_files)
+        qsort(files, num_files, sizeof(struct cache_file_st), compareFiles);
+    pthread_mutex_lock(&cache_mutex);
+    for(i=0;i<num_files;i++){
+        struct cache_entry_st *e = files[i].entry;
+        if(findEntry(e->key) || hashTableInsert(cache_entries, entryKey(e->key), e)){
+            free(e);
+            continue;
+        }
+        pushEntry(e);
+        cache_stats.entries++;
+        cache_stats.size += e->size;
+    }
+    free(files); files = NULL;
+    cache_max_size = max_size;
+    evictEntries();
+    pthread_mutex_unlock(&cache_mutex);
+    return CL_SUCCESS;
+}
+
+void setProgramContents(cl_program program, const unsigned char *contents)
+{
+    unsigned char *digest = NULL, *old = NULL;
+    if(!cache_max_size)
+        return;
+    digest = (unsigned char*)malloc(SHA256_SIZE);
+    if(!digest)
+        return;
+    memcpy(digest, contents, SHA256_SIZE);
+    pthread_mutex_lock(&cache_mutex);
+    if(hashTableRemove(program_contents, PROGRAM_KEY(program), (void**)&old))
+        free(old);
+    if(hashTableInsert(program_contents, PROGRAM_KEY(program), digest))
+        free(digest);
+    pthread_mutex_unlock(&cache_mutex);
+}
+
+void unsetProgramContents(cl_program program)
+{
+    unsigned char *digest = NULL;
+    if(!cache_max_size)
+        return;
+    pthread_mutex_lock(&cache_mutex);
+    if(hashTableRemove(program_contents, PROGRAM_KEY(program), (void**)&digest))
+        free(digest);
+    pthread_mutex_unlock(&cache_mutex);
+}
+
+void substituteProgram(cl_program program, cl_program cached)
+{
+    unsigned char *digest = NULL;
+    if(!cache_max_size)
+        return;
+    pthread_mutex_lock(&cache_mutex);
+    if(hashTableFind(program_contents, PROGRAM_KEY(program), (void**)&digest)){
+        unsigned char *copy = (unsigned char*)malloc(SHA256_SIZE);
+        if(copy){
+            memcpy(copy, digest, SHA256_SIZE);
+            if(hashTableRemove(program_contents, PROGRAM_KEY(cached), (void**)&digest))
+                free(digest);
+            if(hashTableInsert(program_contents, PROGRAM_KEY(cached), copy))
+                free(copy);
+        }
+    }
+    hashTableRemove(program_substitutes, PROGRAM_KEY(cached), NULL);
+    hashTableInsert(program_substitutes, PROGRAM_KEY(cached), (void*)program);
+    pthread_mutex_unlock(&cache_mutex);
+}
+
+cl_program substitutedProgram(cl_program program)
+{
+    cl_program replaced = program;
+    if(!cache_max_size)
+        return program;
+    pthread_mutex_lock(&cache_mutex);
+    if(!hashTableFind(program_substitutes, PROGRAM_KEY(program), (void**)&replaced))
+        replaced = program;
+    pthread_mutex_unlock(&cache_mutex);
+    return replaced;
+}
+
+cl_program unsubstituteProgram(cl_program cached)
+{
+    cl_program replaced = NULL;
+    if(!cache_max_size)
+        return NULL;
+    pthread_mutex_lock(&cache_mutex);
+    if(!hashTableRemove(program_substitutes, PROGRAM_KEY(cached), (void**)&replaced))
+        replaced = NULL;
+    pthread_mutex_unlock(&cache_mutex);
+    return replaced;
+}
+
+/** Compute the key of the binary of a program for a device, which
+ * depends on the program contents, the build options, and the device
+ * and driver.
+ * @param contents Digest of the program contents.
+ * @param device Device.
+ * @param options Build options. Can be NULL.
+ * @param key Resulting key.
+ * @return CL_SUCCESS, or the error returned querying the device.
+ */
+static cl_int deviceKey(const unsigned char *contents,
+                        cl_device_id         device,
+                        const char *         options,
+                        unsigned char *      key)
+{
+    unsigned int i;
+    sha256 c;
+    cl_int flag;
+    const cl_device_info params[3] = {CL_DEVICE_NAME,
+                                      CL_DEVICE_VENDOR,
+                                      CL_DRIVER_VERSION};
+    if(!options)
+        options = "";
+    sha256Init(&c);
+    sha256Update(&c, contents, SHA256_SIZE);
+    sha256Update(&c, options, strlen(options) + 1);
+    for(i=0;i<3;i++){
+        size_t size = 0;
+        flag = clGetDeviceInfo(device, params[i], 0, NULL, &size);
+        if(flag != CL_SUCCESS)
+            return flag;
+        char *value = (char*)malloc(size);
+        if(!value)
+            return CL_OUT_OF_HOST_MEMORY;
+        flag = clGetDeviceInfo(device, params[i], size, value, NULL);
+        if(flag != CL_SUCCESS){
+            free(value); value = NULL;
+            return flag;
+        }
+        sha256Update(&c, value, size);
+        free(value); value = NULL;
+    }
+    sha256Final(&c, key);
+    return CL_SUCCESS;
+}
+
+/** Load an entry from the cache.
+ * @param key Entry key.
+ * @param size Size of the entry.
+ * @return Entry data, which must be freed with free(). NULL if it is
+ * not stored.
+ */
+static unsigned char* loadEntry(const unsigned char *key, size_t *size)
+{
+    struct cache_entry_st *e;
+    unsigned char *binary = NULL;
+    char *path = NULL;
+    FILE *f = NULL;
+    pthread_mutex_lock(&cache_mutex);
+    e = findEntry(key);
+    if(!e || !e->size){
+        pthread_mutex_unlock(&cache_mutex);
+        return NULL;
+    }
+    unlinkEntry(e);
+    pushEntry(e);
+    *size = e->size;
+    pthread_mutex_unlock(&cache_mutex);
+    path = entryPath(key);
+    if(path)
+        f = fopen(path, "rb");
+    if(f){
+        binary = (unsigned char*)malloc(*size);
+        if(binary && (fread(binary, 1, *size, f) != *size)){
+            free(binary); binary = NULL;
+        }
+        fclose(f); f = NULL;
+    }
+    if(binary){
+        // Remember the last use for the following executions
+        utime(path, NULL);
+    }
+    else{
+        // The file has been lost or modified
+        pthread_mutex_lock(&cache_mutex);
+        e = findEntry(key);
+        if(e)
+            discardEntry(e);
+        pthread_mutex_unlock(&cache_mutex);
+    }
+    free(path); path = NULL;
+    return binary;
+}
+
+/** Store an entry in the cache. The file is written with a temporary
+ * name and renamed afterwards, so partially written entries are never
+ * loaded.
+ * @param key Entry key.
+ * @param binary Entry data.
+ * @param size Size of the entry.
+ */
+static void storeEntry(const unsigned char *key, const unsigned char *binary, size_t size)
+{
+    struct cache_entry_st *e;
+    char *path = NULL, *tmp = NULL;
+    size_t written = 0;
+    int fd;
+    if(!size || (size > cache_max_size))
+        return;
+    path = entryPath(key);
+    tmp = (char*)malloc(strlen(cache_dir) + 1 + strlen(CACHE_TEMP_PREFIX) + 7);
+    if(!path || !tmp){
+        free(path); path = NULL;
+        free(tmp); tmp = NULL;
+        return;
+    }
+    sprintf(tmp, "%s/%sXXXXXX", cache_dir, CACHE_TEMP_PREFIX);
+    fd = mkstemp(tmp);
+    if(fd < 0){
+        free(path); path = NULL;
+        free(tmp); tmp = NULL;
+        return;
+    }
+    while(written < size){
+        ssize_t n = write(fd, binary + written, size - written);
+        if(n <= 0)
+            break;
+        written += (size_t)n;
+    }
+    close(fd);
+    if((written < size) || rename(tmp, path)){
+        unlink(tmp);
+        free(path); path = NULL;
+        free(tmp); tmp = NULL;
+        return;
+    }
+    free(path); path = NULL;
+    free(tmp); tmp = NULL;
+    pthread_mutex_lock(&cache_mutex);
+    e = findEntry(key);
+    if(e){
+        // Another thread stored the same entry meanwhile
+        cache_stats.size -= e->size;
+        unlinkEntry(e);
+    }
+    else{
+        e = (struct cache_entry_st*)malloc(sizeof(struct cache_entry_st));
+        if(!e || hashTableInsert(cache_entries, entryKey(key), e)){
+            free(e); e = NULL;
+            pthread_mutex_unlock(&cache_mutex);
+            return;
+        }
+        memcpy(e->key, key, SHA256_SIZE);
+        cache_stats.entries++;
+    }
+    e->size = size;
+    pushEntry(e);
+    cache_stats.size += size;
+    cache_stats.stores++;
+    evictEntries();
+    pthread_mutex_unlock(&cache_mutex);
+}
+
+/** Store the binaries of a program already built.
+ * @param program Program.
+ * @param num_devices Number of devices which binaries must be stored.
+ * @param devices Devices which binaries must be stored.
+ * @param keys Key of the binary of each device.
+ */
+static void storeBinaries(cl_program           program,
+                          cl_uint              num_devices,
+                          const cl_device_id * devices,
+                          const unsigned char *keys)
+{
+    cl_uint i, j, num_program_devices = 0;
+    cl_device_id *program_devices = NULL;
+    size_t *sizes = NULL;
+    unsigned char **binaries = NULL;
+    cl_int flag;
+    flag = clGetProgramInfo(program, CL_PROGRAM_NUM_DEVICES, sizeof(cl_uint),
+                            &num_program_devices, NULL);
+    if((flag != CL_SUCCESS) || !num_program_devices)
+        return;
+    program_devices = (cl_device_id*)malloc(num_program_devices*sizeof(cl_device_id));
+    sizes = (size_t*)malloc(num_program_devices*sizeof(size_t));
+    binaries = (unsigned char**)calloc(num_program_devices, sizeof(unsigned char*));
+    flag = CL_OUT_OF_HOST_MEMORY;
+    if(program_devices && sizes && binaries){
+        flag = clGetProgramInfo(program, CL_PROGRAM_DEVICES,
+                                num_program_devices*sizeof(cl_device_id),
+                                program_devices, NULL);
+    }
+    if(flag == CL_SUCCESS){
+        flag = clGetProgramInfo(program, CL_PROGRAM_BINARY_SIZES,
+                                num_program_devices*sizeof(size_t),
+                                sizes, NULL);
+    }
+    if(flag == CL_SUCCESS){
+        // Only the binaries of the built devices are downloaded
+        for(j=0;j<num_program_devices;j++){
+            for(i=0;i<num_devices;i++){
+                if(devices[i] == program_devices[j])
+                    break;
+            }
+            if((i == num_devices) || !sizes[j])
+                continue;
+            binaries[j] = (unsigned char*)malloc(sizes[j]);
+        }
+        flag = clGetProgramInfo(program, CL_PROGRAM_BINARIES,
+                                num_program_devices*sizeof(unsigned char*),
+                                binaries, NULL);
+    }
+    if(flag == CL_SUCCESS){
+        for(i=0;i<num_devices;i++){
+            for(j=0;j<num_program_devices;j++){
+                if(devices[i] == program_devices[j])
+                    break;
+            }
+            if((j == num_program_devices) || !binaries[j])
+                continue;
+            storeEntry(keys + i*SHA256_SIZE, binaries[j], sizes[j]);
+        }
+    }
+    if(binaries){
+        for(j=0;j<num_program_devices;j++){
+            free(binaries[j]); binaries[j] = NULL;
+        }
+    }
+    free(program_devices); program_devices = NULL;
+    free(sizes); sizes = NULL;
+    free(binaries); binaries = NULL;
+}
+
+/** Get the cache keys of the binaries of a program.
+ * @param program Program.
+ * @param num_devices Number of devices in device_list.
+ * @param device_list Devices to build the program for. If NULL, all
+ * the devices associated to the program.
+ * @param options Build options. Can be NULL.
+ * @param n Returned number of devices.
+ * @param devices Returned devices, which must be freed with free().
+ * @param keys Returned key of the binary of each device, which must be
+ * freed with free().
+ * @return CL_SUCCESS, CL_INVALID_VALUE if the cache is disabled or the
+ * contents of the program are unknown, or the error returned querying
+ * the program or its devices.
+ */
+static cl_int programKeys(cl_program           program,
+                          cl_uint              num_devices,
+                          const cl_device_id * device_list,
+                          const char *         options,
+                          cl_uint *            n,
+                          cl_device_id **      devices,
+                          unsigned char **     keys)
+{
+    cl_uint i;
+    unsigned char contents[SHA256_SIZE], *digest = NULL;
+    cl_int flag = CL_INVALID_VALUE;
+    *n = num_devices;
+    *devices = NULL;
+    *keys = NULL;
+    // Look for the contents the program has been created from
+    pthread_mutex_lock(&cache_mutex);
+    if(cache_max_size &&
+       hashTableFind(program_contents, PROGRAM_KEY(program), (void**)&digest)){
+        memcpy(contents, digest, SHA256_SIZE);
+        flag = CL_SUCCESS;
+    }
+    pthread_mutex_unlock(&cache_mutex);
+    if((flag != CL_SUCCESS) || ((device_list == NULL) != (num_devices == 0)))
+        return CL_INVALID_VALUE;
+    // Get the devices to build
+    if(!device_list){
+        flag = clGetProgramInfo(program, CL_PROGRAM_NUM_DEVICES,
+                                sizeof(cl_uint), n, NULL);
+        if(flag != CL_SUCCESS)
+            return flag;
+    }
+    if(!*n)
+        return CL_INVALID_VALUE;
+    *devices = (cl_device_id*)malloc(*n*sizeof(cl_device_id));
+    *keys    = (unsigned char*)malloc(*n*SHA256_SIZE);
+    flag = CL_OUT_OF_HOST_MEMORY;
+    if(*devices && *keys){
+        flag = CL_SUCCESS;
+        if(device_list)
+            memcpy(*devices, device_list, *n*sizeof(cl_device_id));
+        else{
+            flag = clGetProgramInfo(program, CL_PROGRAM_DEVICES,
+                                    *n*sizeof(cl_device_id), *devices, NULL);
+        }
+    }
+    for(i=0;(flag == CL_SUCCESS) && (i<*n);i++)
+        flag = deviceKey(contents, (*devices)[i], options, *keys + i*SHA256_SIZE);
+    if(flag != CL_SUCCESS){
+        free(*devices); *devices = NULL;
+        free(*keys); *keys = NULL;
+    }
+    return flag;
+}
+
+cl_program loadCachedProgram(cl_program           program,
+                             cl_uint              num_devices,
+                             const cl_device_id * device_list,
+                             const char *         options,
+                             cl_int *             errcode_ret)
+{
+    cl_uint i, n;
+    cl_device_id *devices = NULL;
+    unsigned char *keys = NULL;
+    size_t *lengths = NULL;
+    unsigned char **binaries = NULL;
+    cl_context context = NULL;
+    cl_program cached = NULL;
+    cl_int flag;
+    flag = programKeys(program, num_devices, device_list, options,
+                       &n, &devices, &keys);
+    if(flag != CL_SUCCESS)
+        return NULL;
+    lengths  = (size_t*)calloc(n, sizeof(size_t));
+    binaries = (unsigned char**)calloc(n, sizeof(unsigned char*));
+    if(!lengths || !binaries)
+        flag = CL_OUT_OF_HOST_MEMORY;
+    // Look for the binaries of all the devices
+    for(i=0;(flag == CL_SUCCESS) && (i<n);i++){
+        binaries[i] = loadEntry(keys + i*SHA256_SIZE, &(lengths[i]));
+        if(!binaries[i])
+            flag = CL_INVALID_BINARY;
+    }
+    if(flag == CL_SUCCESS){
+        flag = clGetProgramInfo(program, CL_PROGRAM_CONTEXT,
+                                sizeof(cl_context), &context, NULL);
+    }
+    if(flag == CL_SUCCESS){
+        cached = clCreateProgramWithBinary(context, n, devices, lengths,
+                                           (const unsigned char**)binaries,
+                                           NULL, &flag);
+        if(flag != CL_SUCCESS)
+            cached = NULL;
+    }
+    if(cached){
+        flag = clBuildProgram(cached, n, devices, options, NULL, NULL);
+        if(flag != CL_SUCCESS){
+            clReleaseProgram(cached);
+            cached = NULL;
+        }
+    }
+    pthread_mutex_lock(&cache_mutex);
+    if(cached)
+        cache_stats.hits++;
+    else
+        cache_stats.misses++;
+    pthread_mutex_unlock(&cache_mutex);
+    if(cached)
+        *errcode_ret = CL_SUCCESS;
+    for(i=0;binaries && (i<n);i++){
+        free(binaries[i]); binaries[i] = NULL;
+    }
+    free(devices); devices = NULL;
+    free(keys); keys = NULL;
+    free(lengths); lengths = NULL;
+    free(binaries); binaries = NULL;
+    return cached;
+}
+
+void storeCachedProgram(cl_program           program,
+                        cl_uint              num_devices,
+                        const cl_device_id * device_list,
+                        const char *         options)
+{
+    cl_uint n;
+    cl_device_id *devices = NULL;
+    unsigned char *keys = NULL;
+    cl_int flag;
+    flag = programKeys(program, num_devices, device_list, options,
+                       &n, &devices, &keys);
+    if(flag != CL_SUCCESS)
+        return;
+    storeBinaries(program, n, devices, keys);
+    free(devices); devices = NULL;
+    free(keys); keys = NULL;
+}
+
+void storeProgramSources(const unsigned char * contents,
+                         cl_uint               count,
+                         const char * const *  strings,
+                         const size_t *        lengths)
+{
+    cl_uint i;
+    size_t size = sizeof(uint32_t) + count*sizeof(uint64_t);
+    unsigned char *data, *ptr;
+    if(!cache_max_size)
+        return;
+    pthread_mutex_lock(&cache_mutex);
+    if(findEntry(contents)){
+        pthread_mutex_unlock(&cache_mutex);
+        return;
+    }
+    pthread_mutex_unlock(&cache_mutex);
+    for(i=0;i<count;i++)
+        size += lengths[i];
+    data = (unsigned char*)malloc(size);
+    if(!data)
+        return;
+    // Number of sources, length of each one, and the sources
+    ptr = data;
+    uint32_t n = (uint32_t)count;
+    memcpy(ptr, &n, sizeof(uint32_t)); ptr += sizeof(uint32_t);
+    for(i=0;i<count;i++){
+        uint64_t length = (uint64_t)lengths[i];
+        memcpy(ptr, &length, sizeof(uint64_t)); ptr += sizeof(uint64_t);
+    }
+    for(i=0;i<count;i++){
+        memcpy(ptr, strings[i], lengths[i]); ptr += lengths[i];
+    }
+    storeEntry(contents, data, size);
+    free(data); data = NULL;
+}
+
+cl_program createCachedProgram(cl_context            context,
+                               const unsigned char * contents,
+                               cl_int *              errcode_ret)
+{
+    cl_uint i, count = 0;
+    size_t size = 0, offset;
+    unsigned char *data;
+    const char **strings = NULL;
+    size_t *lengths = NULL;
+    cl_program program = NULL;
+    uint32_t n;
+    data = loadEntry(contents, &size);
+    if(data && (size >= sizeof(uint32_t))){
+        memcpy(&n, data, sizeof(uint32_t));
+        count = (cl_uint)n;
+    }
+    offset = sizeof(uint32_t) + (size_t)count*sizeof(uint64_t);
+    if(count && (count <= (size - sizeof(uint32_t)) / sizeof(uint64_t))){
+        strings = (const char**)malloc(count*sizeof(const char*));
+        lengths = (size_t*)malloc(count*sizeof(size_t));
+    }
+    if(!strings || !lengths){
+        pthread_mutex_lock(&cache_mutex);
+        cache_stats.source_misses++;
+        pthread_mutex_unlock(&cache_mutex);
+        free(data); data = NULL;
+        free(strings); strings = NULL;
+        free(lengths); lengths = NULL;
+        *errcode_ret = CL_INVALID_VALUE;
+        return NULL;
+    }
+    for(i=0;i<count;i++){
+        uint64_t length;
+        memcpy(&length, data + sizeof(uint32_t) + i*sizeof(uint64_t), sizeof(uint64_t));
+        if(length > size - offset)
+            break;
+        strings[i] = (const char*)(data + offset);
+        lengths[i] = (size_t)length;
+        offset += lengths[i];
+    }
+    if(i == count){
+        program = clCreateProgramWithSource(context, count, strings, lengths, errcode_ret);
+        if(*errcode_ret == CL_SUCCESS)
+            setProgramContents(program, contents);
+    }
+    else{
+        *errcode_ret = CL_INVALID_VALUE;
+    }
+    pthread_mutex_lock(&cache_mutex);
+    if(program)
+        cache_stats.source_hits++;
+    else
+        cache_stats.source_misses++;
+    pthread_mutex_unlock(&cache_mutex);
+    free(data); data = NULL;
+    free(strings); strings = NULL;
+    free(lengths); lengths = NULL;
+    return program;
+}
+
+void programCacheStats(struct oclandCacheStats_st *stats)
+{
+    pthread_mutex_lock(&cache_mutex);
+    memcpy(stats, &cache_stats, sizeof(struct oclandCacheStats_st));
+    pthread_mutex_unlock(&cache_mutex);
+}
@@ -0,0 +1,459 @@
+/*
+ *  This file is part of ocland, a free cloud OpenCL interface.
+ *  Copyright (C) 2012  Jose Luis Cercos Pita <jl.cercos@upm.es>
+ *
+ *  ocland is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ocland is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ocland.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <sys/socket.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <fcntl.h>
+#include <time.h>
+#include <pthread.h>
+
+#include <ocland/common/dataExchange.h>
+#include <ocland/server/ocland_channel.h>
+
+#ifndef BUFF_SIZE
+    #define BUFF_SIZE 1025u
+#endif
+
+#ifndef OCLAND_TRANSFER_CHUNK
+    #define OCLAND_TRANSFER_CHUNK 4194304u
+#endif
+
+/// Chunks of a streamed transfer which can be staged at the same time
+#define OCLAND_CHANNEL_CHUNKS 2u
+
+/// Data channels of the connected clients
+static data_channel channels = NULL;
+/// Mutex protecting the data channels list
+static pthread_mutex_t channels_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/** Generate a new token. The token is the only proof that a data
+ * connection belongs to a session, so it must not be predictable.
+ * @return Random token.
+ */
+static uint64_t newToken()
+{
+    uint64_t token = 0;
+    int fd = open("/dev/urandom", O_RDONLY);
+    if(fd >= 0){
+        ssize_t readed = read(fd, &token, sizeof(uint64_t));
+        close(fd);
+        if(readed == sizeof(uint64_t))
+            return token;
+    }
+    // Poor fallback, better than nothing
+    token  = ((uint64_t)rand() << 32) ^ (uint64_t)rand();
+    token ^= (uint64_t)time(NULL) ^ (uint64_t)(uintptr_t)&token;
+    return token;
+}
+
+data_channel createChannel()
+{
+    data_channel c = (data_channel)malloc(sizeof(struct channel_st));
+    if(!c)
+        return NULL;
+    c->socket    = -1;
+    c->closed    = CL_FALSE;
+    c->refs      = 1;
+    c->transfers = NULL;
+    pthread_mutex_init(&(c->mutex), NULL);
+    pthread_mutex_init(&(c->send_mutex), NULL);
+    pthread_cond_init(&(c->cond), NULL);
+    pthread_mutex_lock(&channels_mutex);
+    c->token = newToken();
+    c->next  = channels;
+    channels = c;
+    pthread_mutex_unlock(&channels_mutex);
+    return c;
+}
+
+void closeChannel(data_channel c)
+{
+    data_channel *prev;
+    struct channel_transfer_st *t;
+    if(!c)
+        return;
+    // Nobody else can attach a connection to the channel
+    pthread_mutex_lock(&channels_mutex);
+    for(prev=&channels;*prev;prev=&((*prev)->next)){
+        if(*prev == c){
+            *prev = c->next;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&channels_mutex);
+    pthread_mutex_lock(&(c->mutex));
+    c->closed = CL_TRUE;
+    if(c->socket >= 0){
+        // The receiver thread will abort the pending transfers
+        shutdown(c->socket, SHUT_RDWR);
+    }
+    else{
+        for(t=c->transfers;t;t=t->next){
+            if(!t->status)
+                t->status = -1;
+        }
+    }
+    // Wake up the receiver thread if it is waiting for the consumers
+    pthread_cond_broadcast(&(c->cond));
+    pthread_mutex_unlock(&(c->mutex));
+    releaseChannel(c);
+}
+
+/** Destroy a transfer, including its not consumed chunks.
+ * @param t Transfer.
+ */
+static void freeTransfer(struct channel_transfer_st *t)
+{
+    while(t->first){
+        struct channel_chunk_st *chunk = t->first;
+        t->first = chunk->next;
+        free(chunk);
+    }
+    free(t);
+}
+
+void retainChannel(data_channel c)
+{
+    pthread_mutex_lock(&(c->mutex));
+    c->refs++;
+    pthread_mutex_unlock(&(c->mutex));
+}
+
+void releaseChannel(data_channel c)
+{
+    pthread_mutex_lock(&(c->mutex));
+    c->refs--;
+    if(c->refs){
+        pthread_mutex_unlock(&(c->mutex));
+        return;
+    }
+    pthread_mutex_unlock(&(c->mutex));
+    // Nobody is using the channel anymore
+    if(c->socket >= 0)
+        close(c->socket);
+    while(c->transfers){
+        struct channel_transfer_st *t = c->transfers;
+        c->transfers = t->next;
+        freeTransfer(t);
+    }
+    pthread_mutex_destroy(&(c->mutex));
+    pthread_mutex_destroy(&(c->send_mutex));
+    pthread_cond_destroy(&(c->cond));
+    free(c);
+}
+
+/** Thread that receives the data sent by the client through the data
+ * channel, storing it in the memory of the matching expected transfer.
+ * @param data Data channel.
+ * @return NULL
+ */
+static void *channel_thread(void *data)
+{
+    char buffer[BUFF_SIZE];
+    data_channel c = (data_channel)data;
+    struct oclandHeader_st header;
+    struct channel_transfer_st *t;
+    int fd = c->socket;
+    while(RecvHeader(&fd, &header, MSG_WAITALL) == sizeof(struct oclandHeader_st)){
+        // Look for the transfer
+        pthread_mutex_lock(&(c->mutex));
+        for(t=c->transfers;t;t=t->next){
+            if((t->request_id == header.request_id) && !t->status)
+                break;
+        }
+        pthread_mutex_unlock(&(c->mutex));
+        if(!t || (header.length > t->cb - t->received)){
+            // Nobody is expecting this data, discard it
+            printf("WARNING: Unexpected data received in the data channel (request %u)\n", header.request_id); fflush(stdout);
+            uint64_t remaining = header.length;
+            while(remaining){
+                size_t n = (remaining > BUFF_SIZE) ? BUFF_SIZE : (size_t)remaining;
+                if(Recv(&fd, buffer, n, MSG_WAITALL) != (ssize_t)n)
+                    break;
+                remaining -= n;
+            }
+            if(remaining)
+                break;
+            continue;
+        }
+        // The transfer can't be removed while its status is 0, so
+        // we can receive the data without locking the channel
+        uint64_t remaining = header.length;
+        if(t->ptr){
+            if(remaining && (Recv(&fd, (char*)t->ptr + t->received, remaining, MSG_WAITALL) != (ssize_t)remaining))
+                break;
+            remaining = 0;
+            pthread_mutex_lock(&(c->mutex));
+            t->received += header.length;
+            pthread_mutex_unlock(&(c->mutex));
+        }
+        // Streamed transfer, the data is queued in chunks to be consumed
+        // meanwhile the next ones are arriving. Once the consumer is
+        // reading them, just OCLAND_CHANNEL_CHUNKS chunks can be staged,
+        // so the socket is not read anymore until the consumer releases
+        // them, keeping the staging memory in the budget reserved for the
+        // transfer. The consumer may be still waiting for the commands
+        // the transfer depends on, which can be blocked by the client
+        // (e.g. by a user event), so meanwhile the chunks are kept as
+        // they arrive instead of blocking the whole data channel
+        while(remaining){
+            size_t n = (remaining > OCLAND_TRANSFER_CHUNK) ? OCLAND_TRANSFER_CHUNK : (size_t)remaining;
+            pthread_mutex_lock(&(c->mutex));
+            while(t->consuming && (t->staged >= OCLAND_CHANNEL_CHUNKS) && !c->closed)
+                pthread_cond_wait(&(c->cond), &(c->mutex));
+            if(c->closed){
+                pthread_mutex_unlock(&(c->mutex));
+                break;
+            }
+            t->staged++;
+            pthread_mutex_unlock(&(c->mutex));
+            struct channel_chunk_st *chunk = (struct channel_chunk_st*)malloc(sizeof(struct channel_chunk_st) + n);
+            if(chunk){
+                chunk->ptr = (void*)(chunk + 1);
+                if(Recv(&fd, chunk->ptr, n, MSG_WAITALL) != (ssize_t)n){
+                    free(chunk); chunk = NULL;
+                }
+            }
+            pthread_mutex_lock(&(c->mutex));
+            if(!chunk){
+                t->staged--;
+                pthread_mutex_unlock(&(c->mutex));
+                break;
+            }
+            chunk->offset = t->received;
+            chunk->size   = n;
+            chunk->next   = NULL;
+            if(t->last)
+                t->last->next = chunk;
+            else
+                t->first = chunk;
+            t->last = chunk;
+            t->received += n;
+            pthread_cond_broadcast(&(c->cond));
+            pthread_mutex_unlock(&(c->mutex));
+            remaining -= n;
+        }
+        if(remaining)
+            break;
+        pthread_mutex_lock(&(c->mutex));
+        if(t->received == t->cb){
+            t->status = 1;
+            pthread_cond_broadcast(&(c->cond));
+        }
+        pthread_mutex_unlock(&(c->mutex));
+    }
+    // Connection lost, abort the pending transfers
+    pthread_mutex_lock(&(c->mutex));
+    c->closed = CL_TRUE;
+    for(t=c->transfers;t;t=t->next){
+        if(!t->status)
+            t->status = -1;
+    }
+    pthread_cond_broadcast(&(c->cond));
+    pthread_mutex_unlock(&(c->mutex));
+    releaseChannel(c);
+    pthread_exit(NULL);
+    return NULL;
+}
+
+cl_int attachChannel(uint64_t token, int socket)
+{
+    data_channel c;
+    pthread_mutex_lock(&channels_mutex);
+    for(c=channels;c;c=c->next){
+        if(c->token == token)
+            break;
+    }
+    if(!c){
+        pthread_mutex_unlock(&channels_mutex);
+        return CL_INVALID_VALUE;
+    }
+    pthread_mutex_lock(&(c->mutex));
+    if((c->socket >= 0) || c->closed){
+        pthread_mutex_unlock(&(c->mutex));
+        pthread_mutex_unlock(&channels_mutex);
+        return CL_INVALID_VALUE;
+    }
+    // The receiver thread keeps a reference
+    c->refs++;
+    c->socket = socket;
+    int rc = pthread_create(&(c->thread), NULL, channel_thread, (void *)c);
+    if(rc){
+        printf("ERROR: Thread creation has failed with the return code %d\n", rc); fflush(stdout);
+        c->refs--;
+        c->socket = -1;
+        pthread_mutex_unlock(&(c->mutex));
+        pthread_mutex_unlock(&channels_mutex);
+        return CL_OUT_OF_HOST_MEMORY;
+    }
+    pthread_detach(c->thread);
+    pthread_mutex_unlock(&(c->mutex));
+    pthread_mutex_unlock(&channels_mutex);
+    return CL_SUCCESS;
+}
+
+ssize_t channelSend(data_channel c, uint32_t opcode, uint32_t request_id, const void *ptr, size_t cb)
+{
+    struct oclandHeader_st header;
+    ssize_t sent;
+    pthread_mutex_lock(&(c->mutex));
+    int fd = c->closed ? -1 : c->socket;
+    pthread_mutex_unlock(&(c->mutex));
+    if(fd < 0)
+        return -1;
+    header.magic      = OCLAND_MAGIC;
+    header.version    = OCLAND_PROTOCOL_VERSION;
+    header.flags      = 0;
+    header.opcode     = opcode;
+    header.request_id = request_id;
+    // At least one package is sent, even if there is no data
+    size_t offset = 0;
+    do{
+        size_t n = cb - offset;
+        if(n > OCLAND_TRANSFER_CHUNK)
+            n = OCLAND_TRANSFER_CHUNK;
+        header.length = n;
+        pthread_mutex_lock(&(c->send_mutex));
+        sent = SendPackage(&fd, &header, (const char*)ptr + offset);
+        pthread_mutex_unlock(&(c->send_mutex));
+        if(sent != (ssize_t)n)
+            return -1;
+        offset += n;
+    } while(offset < cb);
+    return (ssize_t)offset;
+}
+
+/** Register a transfer which data will be sent by the client.
+ * @param c Data channel.
+ * @param request_id Identifier of the request which started the
+ * transfer.
+ * @param ptr Memory where the data must be received, NULL if the data
+ * must be queued in chunks.
+ * @param cb Size of the data.
+ * @return CL_SUCCESS, CL_INVALID_VALUE if the data channel has not been
+ * attached, or CL_OUT_OF_HOST_MEMORY.
+ */
+static cl_int expectTransfer(data_channel c, uint32_t request_id, void *ptr, size_t cb)
+{
+    struct channel_transfer_st *t = (struct channel_transfer_st*)malloc(sizeof(struct channel_transfer_st));
+    if(!t)
+        return CL_OUT_OF_HOST_MEMORY;
+    t->request_id = request_id;
+    t->ptr        = ptr;
+    t->cb         = cb;
+    t->received   = 0;
+    t->first      = NULL;
+    t->last       = NULL;
+    t->staged     = 0;
+    t->consuming  = CL_FALSE;
+    t->status     = 0;
+    pthread_mutex_lock(&(c->mutex));
+    if((c->socket < 0) || c->closed){
+        pthread_mutex_unlock(&(c->mutex));
+        free(t);
+        return CL_INVALID_VALUE;
+    }
+    t->next      = c->transfers;
+    c->transfers = t;
+    pthread_mutex_unlock(&(c->mutex));
+    return CL_SUCCESS;
+}
+
+cl_int channelExpect(data_channel c, uint32_t request_id, void *ptr, size_t cb)
+{
+    return expectTransfer(c, request_id, ptr, cb);
+}
+
+cl_int channelExpectStream(data_channel c, uint32_t request_id, size_t cb)
+{
+    return expectTransfer(c, request_id, NULL, cb);
+}
+
+struct channel_chunk_st* channelNextChunk(data_channel c, uint32_t request_id)
+{
+    struct channel_transfer_st *t;
+    struct channel_chunk_st *chunk = NULL;
+    pthread_mutex_lock(&(c->mutex));
+    while(1){
+        for(t=c->transfers;t;t=t->next){
+            if(t->request_id == request_id)
+                break;
+        }
+        if(!t)
+            break;
+        t->consuming = CL_TRUE;
+        if(t->first){
+            chunk = t->first;
+            t->first = chunk->next;
+            if(!t->first)
+                t->last = NULL;
+            break;
+        }
+        if(t->status)
+            break;
+        pthread_cond_wait(&(c->cond), &(c->mutex));
+    }
+    pthread_mutex_unlock(&(c->mutex));
+    return chunk;
+}
+
+void channelReleaseChunk(data_channel c, uint32_t request_id, struct channel_chunk_st *chunk)
+{
+    struct channel_transfer_st *t;
+    pthread_mutex_lock(&(c->mutex));
+    for(t=c->transfers;t;t=t->next){
+        if(t->request_id == request_id)
+            break;
+    }
+    if(t && t->staged){
+        t->staged--;
+        // The receiver thread may be waiting for a free chunk
+        pthread_cond_broadcast(&(c->cond));
+    }
+    pthread_mutex_unlock(&(c->mutex));
+    free(chunk);
+}
+
+cl_int channelWait(data_channel c, uint32_t request_id)
+{
+    struct channel_transfer_st *t, **prev;
+    cl_int flag = CL_OUT_OF_RESOURCES;
+    pthread_mutex_lock(&(c->mutex));
+    while(1){
+        prev = &(c->transfers);
+        for(t=*prev;t;t=t->next){
+            if(t->request_id == request_id)
+                break;
+            prev = &(t->next);
+        }
+        if(!t || t->status)
+            break;
+        pthread_cond_wait(&(c->cond), &(c->mutex));
+    }
+    if(t){
+        if(t->status > 0)
+            flag = CL_SUCCESS;
+        *prev = t->next;
+        freeTransfer(t);
+    }
+    pthread_mutex_unlock(&(c->mutex));
+    return flag;
+}
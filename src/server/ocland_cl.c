@@ -30,7 +30,11 @@
 #include <CL/cl_ext.h>
 
 #include <ocland/common/dataExchange.h>
+#include <ocland/common/sha256.h>
 #include <ocland/server/ocland_cl.h>
+#include <ocland/server/dispatcher.h>
+#include <ocland/server/ocland_cache.h>
+#include <ocland/server/ocland_build.h>
 
 #ifndef OCLAND_PORT
     #define OCLAND_PORT 51000u
@@ -63,13 +67,13 @@ int ocland_clGetPlatformIDs(int* clientfd, char* buffer, validator v, void* data
     // Decript the received data
     num_entries = ((cl_uint*)data)[0];
     if(num_entries)
-        platforms = (cl_platform_id*)malloc(num_entries*sizeof(cl_platform_id));
+        platforms = (cl_platform_id*)requestAlloc(num_entries*sizeof(cl_platform_id));
     flag = clGetPlatformIDs(num_entries, platforms, &num_platforms);
     // Build the package to send
     size_t msgSize  = sizeof(cl_int);                       // flag
     msgSize        += sizeof(cl_uint);                      // num_platforms
     msgSize        += num_platforms*sizeof(cl_platform_id); // platforms
-    void* msg = (void*)malloc(msgSize);
+    void* msg = requestAlloc(msgSize);
     void* ptr = msg;
     ((cl_int*)ptr)[0]  = flag;          ptr = (cl_int*)ptr  + 1;
     ((cl_uint*)ptr)[0] = num_platforms; ptr = (cl_uint*)ptr + 1;
@@ -77,10 +81,7 @@ int ocland_clGetPlatformIDs(int* clientfd, char* buffer, validator v, void* data
     if(n)
         memcpy(ptr, (void*)platforms, n*sizeof(cl_platform_id));
     // Send the package (first the size, then the data)
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    if(msg) free(msg); msg=NULL;
-    if(platforms) free(platforms); platforms=NULL;
+    Reply(clientfd, msg, msgSize);
     VERBOSE_OUT(flag);
     return 1;
 }
@@ -104,13 +105,11 @@ int ocland_clGetPlatformInfo(int* clientfd, char* buffer, validator v, void* dat
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);  // flag
         msgSize += sizeof(size_t);  // param_value_size_ret
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]  = flag; ptr = (cl_int*)ptr  + 1;
         ((cl_uint*)ptr)[0] = 0;    ptr = (cl_uint*)ptr + 1;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
@@ -120,18 +119,16 @@ int ocland_clGetPlatformInfo(int* clientfd, char* buffer, validator v, void* dat
         flag     = CL_INVALID_VALUE;
         msgSize  = sizeof(cl_int);  // flag
         msgSize += sizeof(size_t);  // param_value_size_ret
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]  = flag; ptr = (cl_int*)ptr  + 1;
         ((cl_uint*)ptr)[0] = 0;    ptr = (cl_uint*)ptr + 1;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
     // Get platform requested info
-    param_value = (void*)malloc(param_value_size_ret);
+    param_value = (void*)requestAlloc(param_value_size_ret);
     flag = clGetPlatformInfo(platform, param_name, param_value_size_ret, param_value, &param_value_size_ret);
     if( (param_name == CL_PLATFORM_NAME) ||
         (param_name == CL_PLATFORM_VENDOR) ||
@@ -141,28 +138,24 @@ int ocland_clGetPlatformInfo(int* clientfd, char* buffer, validator v, void* dat
         len_inet = sizeof(adr_inet);
         getsockname(*clientfd, (struct sockaddr*)&adr_inet, &len_inet);
         param_value_size_ret += (9+strlen(inet_ntoa(adr_inet.sin_addr)))*sizeof(char);
-        char *edited = (char*)malloc(param_value_size_ret);
+        char *edited = (char*)requestAlloc(param_value_size_ret);
         strcpy(edited, "ocland(");
         strcat(edited, inet_ntoa(adr_inet.sin_addr));
         strcat(edited, ") ");
         strcat(edited, (char*)param_value);
-        free(param_value);
         param_value = edited;
     }
     msgSize  = sizeof(cl_int);       // flag
     msgSize += sizeof(size_t);       // param_value_size_ret
     if(param_value)
         msgSize += param_value_size_ret; // param_value
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     ptr      = msg;
     ((cl_int*)ptr)[0] = flag;                 ptr = (cl_int*)ptr + 1;
     ((size_t*)ptr)[0] = param_value_size_ret; ptr = (size_t*)ptr + 1;
     if(param_value)
         memcpy(ptr, param_value, param_value_size_ret);
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(msg);msg=NULL;
-    free(param_value);param_value=NULL;
+    Reply(clientfd, msg, msgSize);
     VERBOSE_OUT(flag);
     return 1;
 }
@@ -183,19 +176,17 @@ int ocland_clGetDeviceIDs(int *clientfd, char* buffer, validator v, void* data)
     device_type = ((cl_device_type*)data)[0]; data = (cl_device_type*)data + 1;
     num_entries = ((cl_uint*)data)[0];
     if(num_entries)
-        devices = (cl_device_id*)malloc(num_entries*sizeof(cl_device_id));
+        devices = (cl_device_id*)requestAlloc(num_entries*sizeof(cl_device_id));
     // Ensure that platform is valid
     flag = isPlatform(v, platform);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);  // flag
         msgSize += sizeof(cl_uint); // num_devices
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]  = flag; ptr = (cl_int*)ptr  + 1;
         ((cl_uint*)ptr)[0] = 0;    ptr = (cl_uint*)ptr + 1;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
@@ -206,7 +197,7 @@ int ocland_clGetDeviceIDs(int *clientfd, char* buffer, validator v, void* data)
     msgSize  = sizeof(cl_int);                   // flag
     msgSize += sizeof(cl_uint);                  // num_devices
     msgSize += num_devices*sizeof(cl_device_id); // devices
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     ptr      = msg;
     ((cl_int*)ptr)[0]  = flag;        ptr = (cl_int*)ptr  + 1;
     ((cl_uint*)ptr)[0] = num_devices; ptr = (cl_uint*)ptr + 1;
@@ -214,10 +205,7 @@ int ocland_clGetDeviceIDs(int *clientfd, char* buffer, validator v, void* data)
     if(n)
         memcpy(ptr, (void*)devices, n*sizeof(cl_device_id));
     // Send the package (first the size, then the data)
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    if(msg) free(msg); msg=NULL;
-    if(devices) free(devices); devices=NULL;
+    Reply(clientfd, msg, msgSize);
     VERBOSE_OUT(flag);
     return 1;
 }
@@ -242,35 +230,140 @@ int ocland_clGetDeviceInfo(int* clientfd, char* buffer, validator v, void* data)
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);  // flag
         msgSize += sizeof(size_t);  // param_value_size_ret
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]  = flag; ptr = (cl_int*)ptr  + 1;
         ((cl_uint*)ptr)[0] = 0;    ptr = (cl_uint*)ptr + 1;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
     if(param_value_size)
-        param_value = (void*)malloc(param_value_size);
+        param_value = (void*)requestAlloc(param_value_size);
     flag = clGetDeviceInfo(device, param_name, param_value_size, param_value, &param_value_size_ret);
     // Build the package to send
     msgSize  = sizeof(cl_int);           // flag
     msgSize += sizeof(size_t);           // param_value_size_ret
     if(param_value_size)
         msgSize += param_value_size_ret; // param_value
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     ptr      = msg;
     ((cl_int*)ptr)[0] = flag;                 ptr = (cl_int*)ptr + 1;
     ((size_t*)ptr)[0] = param_value_size_ret; ptr = (size_t*)ptr + 1;
     if(param_value_size)
         memcpy(ptr, param_value, param_value_size_ret);
     // Send the package (first the size, then the data)
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    if(msg) free(msg); msg=NULL;
-    if(param_value) free(param_value); param_value=NULL;
+    Reply(clientfd, msg, msgSize);
+    VERBOSE_OUT(flag);
+    return 1;
+}
+
+/** Get an info of a platform or device.
+ * @param kind OCLAND_INFO_PLATFORM or OCLAND_INFO_DEVICE.
+ * @param object Platform or device.
+ * @param param_name Info to get.
+ * @param param_value_size Size of param_value.
+ * @param param_value Memory where the info is stored, NULL if just its
+ * size is requested.
+ * @param param_value_size_ret Size of the info.
+ * @return clGetPlatformInfo/clGetDeviceInfo error code.
+ */
+static cl_int objectInfo(cl_uint kind, void *object, cl_uint param_name,
+                         size_t param_value_size, void *param_value,
+                         size_t *param_value_size_ret)
+{
+    if(kind == OCLAND_INFO_PLATFORM)
+        return clGetPlatformInfo((cl_platform_id)object, param_name,
+                                 param_value_size, param_value,
+                                 param_value_size_ret);
+    return clGetDeviceInfo((cl_device_id)object, param_name,
+                           param_value_size, param_value,
+                           param_value_size_ret);
+}
+
+int ocland_prefetchInfo(int* clientfd, char* buffer, validator v, void* data)
+{
+    VERBOSE_IN();
+    cl_uint i, j, kind, num_objects, num_params;
+    void **objects = NULL;
+    cl_uint *params = NULL;
+    cl_int flag = CL_SUCCESS, *flags = NULL;
+    size_t *sizes = NULL;
+    size_t msgSize = 0;
+    void *msg = NULL, *ptr = NULL;
+    // Decript the received data
+    kind        = ((cl_uint*)data)[0];
+    num_objects = ((cl_uint*)data)[1];
+    num_params  = ((cl_uint*)data)[2]; data = (cl_uint*)data + 3;
+    if( ( (kind != OCLAND_INFO_PLATFORM) && (kind != OCLAND_INFO_DEVICE) ) ||
+        ( num_objects > OCLAND_INFO_MAX ) || ( num_params > OCLAND_INFO_MAX ) ||
+        ( requestHeader()->length < 3*sizeof(cl_uint)
+                                  + (uint64_t)num_objects*sizeof(void*)
+                                  + (uint64_t)num_params*sizeof(cl_uint) ) ){
+        flag = CL_INVALID_VALUE;
+        Reply(clientfd, &flag, sizeof(cl_int));
+        VERBOSE_OUT(flag);
+        return 1;
+    }
+    objects = (void**)data;   data = (void**)data + num_objects;
+    params  = (cl_uint*)data;
+    // Get the size of each info. The number of objects and info is
+    // bounded, so the tables size can't overflow
+    flags = (cl_int*)requestAlloc((size_t)num_objects*num_params*sizeof(cl_int));
+    sizes = (size_t*)requestAlloc((size_t)num_objects*num_params*sizeof(size_t));
+    if(!flags || !sizes){
+        flag = CL_OUT_OF_HOST_MEMORY;
+        Reply(clientfd, &flag, sizeof(cl_int));
+        VERBOSE_OUT(flag);
+        return 1;
+    }
+    msgSize = sizeof(cl_int);
+    for(i=0;i<num_objects;i++){
+        cl_int object_flag;
+        if(kind == OCLAND_INFO_PLATFORM)
+            object_flag = isPlatform(v, (cl_platform_id)objects[i]);
+        else
+            object_flag = isDevice(v, (cl_device_id)objects[i]);
+        for(j=0;j<num_params;j++){
+            size_t k = (size_t)i*num_params + j;
+            flags[k] = object_flag;
+            sizes[k] = 0;
+            if(object_flag == CL_SUCCESS)
+                flags[k] = objectInfo(kind, objects[i], params[j], 0, NULL, &(sizes[k]));
+            if(flags[k] != CL_SUCCESS)
+                sizes[k] = 0;
+            if(sizes[k] > SIZE_MAX - sizeof(cl_int) - sizeof(size_t) - msgSize)
+                flag = CL_OUT_OF_HOST_MEMORY;
+            else
+                msgSize += sizeof(cl_int) + sizeof(size_t) + sizes[k];
+        }
+    }
+    // Build the package to send
+    if(flag == CL_SUCCESS)
+        msg = requestAlloc(msgSize);
+    if(!msg){
+        flag = CL_OUT_OF_HOST_MEMORY;
+        Reply(clientfd, &flag, sizeof(cl_int));
+        VERBOSE_OUT(flag);
+        return 1;
+    }
+    ptr = msg;
+    ((cl_int*)ptr)[0] = flag; ptr = (cl_int*)ptr + 1;
+    for(i=0;i<num_objects;i++){
+        for(j=0;j<num_params;j++){
+            size_t k = (size_t)i*num_params + j;
+            void *value = (char*)ptr + sizeof(cl_int) + sizeof(size_t);
+            if(sizes[k]){
+                flags[k] = objectInfo(kind, objects[i], params[j], sizes[k], value, NULL);
+                if(flags[k] != CL_SUCCESS)
+                    memset(value, 0, sizes[k]);
+            }
+            ((cl_int*)ptr)[0] = flags[k]; ptr = (cl_int*)ptr + 1;
+            ((size_t*)ptr)[0] = sizes[k]; ptr = (size_t*)ptr + 1;
+            ptr = (char*)ptr + sizes[k];
+        }
+    }
+    Reply(clientfd, msg, msgSize);
     VERBOSE_OUT(flag);
     return 1;
 }
@@ -291,14 +384,14 @@ int ocland_clCreateContext(int* clientfd, char* buffer, validator v, void* data)
     // Decript the received data
     num_properties = ((cl_uint*)data)[0]; data = (cl_uint*)data + 1;
     if(num_properties){
-        properties = (cl_context_properties*)malloc(num_properties*sizeof(cl_context_properties));
+        properties = (cl_context_properties*)requestAlloc(num_properties*sizeof(cl_context_properties));
         for(i=0;i<num_properties;i++){
             properties[i] = ((cl_context_properties*)data)[0]; data = (cl_context_properties*)data + 1;
         }
     }
     num_devices = ((cl_uint*)data)[0]; data = (cl_uint*)data + 1;
     if(num_devices){
-        devices = (cl_device_id*)malloc(num_devices*sizeof(cl_device_id));
+        devices = (cl_device_id*)requestAlloc(num_devices*sizeof(cl_device_id));
         for(i=0;i<num_devices;i++){
             devices[i] = ((cl_device_id*)data)[0]; data = (cl_device_id*)data + 1;
         }
@@ -313,15 +406,11 @@ int ocland_clCreateContext(int* clientfd, char* buffer, validator v, void* data)
             if(flag != CL_SUCCESS){
                 msgSize  = sizeof(cl_int);      // flag
                 msgSize += sizeof(cl_context);  // context
-                msg      = (void*)malloc(msgSize);
+                msg      = requestAlloc(msgSize);
                 ptr      = msg;
                 ((cl_int*)ptr)[0]  = flag; ptr = (cl_int*)ptr  + 1;
                 ((cl_context*)ptr)[0] = context;
-                Send(clientfd, &msgSize, sizeof(size_t), 0);
-                Send(clientfd, msg, msgSize, 0);
-                free(properties);properties=NULL;
-                free(devices);devices=NULL;
-                free(msg);msg=NULL;
+                Reply(clientfd, msg, msgSize);
                 VERBOSE_OUT(flag);
                 return 1;
             }
@@ -333,15 +422,11 @@ int ocland_clCreateContext(int* clientfd, char* buffer, validator v, void* data)
         if(flag != CL_SUCCESS){
             msgSize  = sizeof(cl_int);      // flag
             msgSize += sizeof(cl_context);  // context
-            msg      = (void*)malloc(msgSize);
+            msg      = requestAlloc(msgSize);
             ptr      = msg;
             ((cl_int*)ptr)[0]  = flag; ptr = (cl_int*)ptr  + 1;
             ((cl_context*)ptr)[0] = context;
-            Send(clientfd, &msgSize, sizeof(size_t), 0);
-            Send(clientfd, msg, msgSize, 0);
-            free(properties);properties=NULL;
-            free(devices);devices=NULL;
-            free(msg);msg=NULL;
+            Reply(clientfd, msg, msgSize);
             VERBOSE_OUT(flag);
             return 1;
         }
@@ -360,15 +445,11 @@ int ocland_clCreateContext(int* clientfd, char* buffer, validator v, void* data)
     // Return the package
     msgSize  = sizeof(cl_int);      // flag
     msgSize += sizeof(cl_context);  // context
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     ptr      = msg;
     ((cl_int*)ptr)[0]     = flag;    ptr = (cl_int*)ptr  + 1;
     ((cl_context*)ptr)[0] = context;
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(properties);properties=NULL;
-    free(devices);devices=NULL;
-    free(msg);msg=NULL;
+    Reply(clientfd, msg, msgSize);
     VERBOSE_OUT(flag);
     return 1;
 }
@@ -388,7 +469,7 @@ int ocland_clCreateContextFromType(int* clientfd, char* buffer, validator v, voi
     // Decript the received data
     num_properties = ((cl_uint*)data)[0]; data = (cl_uint*)data + 1;
     if(num_properties){
-        properties = (cl_context_properties*)malloc(num_properties*sizeof(cl_context_properties));
+        properties = (cl_context_properties*)requestAlloc(num_properties*sizeof(cl_context_properties));
         for(i=0;i<num_properties;i++){
             properties[i] = ((cl_context_properties*)data)[0]; data = (cl_context_properties*)data + 1;
         }
@@ -404,14 +485,11 @@ int ocland_clCreateContextFromType(int* clientfd, char* buffer, validator v, voi
             if(flag != CL_SUCCESS){
                 msgSize  = sizeof(cl_int);      // flag
                 msgSize += sizeof(cl_context);  // context
-                msg      = (void*)malloc(msgSize);
+                msg      = requestAlloc(msgSize);
                 ptr      = msg;
                 ((cl_int*)ptr)[0]  = flag; ptr = (cl_int*)ptr  + 1;
                 ((cl_context*)ptr)[0] = context;
-                Send(clientfd, &msgSize, sizeof(size_t), 0);
-                Send(clientfd, msg, msgSize, 0);
-                free(properties);properties=NULL;
-                free(msg);msg=NULL;
+                Reply(clientfd, msg, msgSize);
                 VERBOSE_OUT(flag);
                 return 1;
             }
@@ -431,14 +509,11 @@ int ocland_clCreateContextFromType(int* clientfd, char* buffer, validator v, voi
     // Return the package
     msgSize  = sizeof(cl_int);      // flag
     msgSize += sizeof(cl_context);  // context
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     ptr      = msg;
     ((cl_int*)ptr)[0]  = flag; ptr = (cl_int*)ptr  + 1;
     ((cl_context*)ptr)[0] = context;
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(properties);properties=NULL;
-    free(msg);msg=NULL;
+    Reply(clientfd, msg, msgSize);
     VERBOSE_OUT(flag);
     return 1;
 }
@@ -452,29 +527,25 @@ int ocland_clRetainContext(int* clientfd, char* buffer, validator v, void* data)
     size_t msgSize = 0;
     void *msg = NULL, *ptr = NULL;
     // Decript the received data
-    context = ((cl_context*)data)[0];
+    context = (cl_context)handleObject(v, ((cl_context*)data)[0]);
     // Ensure that the context is valid
     flag = isContext(v, context);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);      // flag
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
     flag = clRetainContext(context);
     // Return the package
     msgSize  = sizeof(cl_int);      // flag
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     ptr      = msg;
     ((cl_int*)ptr)[0]  = flag;
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(msg);msg=NULL;
+    Reply(clientfd, msg, msgSize);
     VERBOSE_OUT(flag);
     return 1;
 }
@@ -488,17 +559,15 @@ int ocland_clReleaseContext(int* clientfd, char* buffer, validator v, void* data
     size_t msgSize = 0;
     void *msg = NULL, *ptr = NULL;
     // Decript the received data
-    context = ((cl_context*)data)[0];
+    context = (cl_context)handleObject(v, ((cl_context*)data)[0]);
     // Ensure that the context is valid
     flag = isContext(v, context);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);      // flag
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
@@ -514,12 +583,10 @@ int ocland_clReleaseContext(int* clientfd, char* buffer, validator v, void* data
     }
     // Return the package
     msgSize  = sizeof(cl_int);      // flag
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     ptr      = msg;
     ((cl_int*)ptr)[0]  = flag;
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(msg);msg=NULL;
+    Reply(clientfd, msg, msgSize);
     VERBOSE_OUT(flag);
     return 1;
 }
@@ -536,7 +603,7 @@ int ocland_clGetContextInfo(int* clientfd, char* buffer, validator v, void* data
     size_t msgSize = 0;
     void *msg = NULL, *ptr = NULL;
     // Decript the received data
-    context = ((cl_context*)data)[0];         data = (cl_context*)data + 1;
+    context = (cl_context)handleObject(v, ((cl_context*)data)[0]);         data = (cl_context*)data + 1;
     param_name = ((cl_context_info*)data)[0]; data = (cl_context_info*)data + 1;
     param_value_size = ((size_t*)data)[0];    data = (size_t*)data + 1;
     // Ensure that the context is valid
@@ -544,19 +611,17 @@ int ocland_clGetContextInfo(int* clientfd, char* buffer, validator v, void* data
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);      // flag
         msgSize += sizeof(size_t);      // param_value_size_ret
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]  = flag; ptr = (cl_int*)ptr + 1;
         ((size_t*)ptr)[0]  = 0;    ptr = (size_t*)ptr + 1;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
     // Build the required param_value
     if(param_value_size)
-        param_value = (void*)malloc(param_value_size);
+        param_value = (void*)requestAlloc(param_value_size);
     // Get the data
     flag = clGetContextInfo(context, param_name, param_value_size, param_value, &param_value_size_ret);
     // Return the package
@@ -564,16 +629,13 @@ int ocland_clGetContextInfo(int* clientfd, char* buffer, validator v, void* data
     msgSize += sizeof(size_t);       // param_value_size_ret
     if(param_value)
         msgSize += param_value_size_ret; // param_value
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     ptr      = msg;
     ((cl_int*)ptr)[0]  = flag; ptr = (cl_int*)ptr + 1;
     ((size_t*)ptr)[0]  = param_value_size_ret;    ptr = (size_t*)ptr + 1;
     if(param_value)
         memcpy(ptr, param_value, param_value_size_ret);
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(param_value);param_value=NULL;
-    free(msg);msg=NULL;
+    Reply(clientfd, msg, msgSize);
     VERBOSE_OUT(flag);
     return 1;
 }
@@ -590,7 +652,7 @@ int ocland_clCreateCommandQueue(int* clientfd, char* buffer, validator v, void*
     size_t msgSize = 0;
     void *msg = NULL, *ptr = NULL;
     // Decript the received data
-    context = ((cl_context*)data)[0];     data = (cl_context*)data + 1;
+    context = (cl_context)handleObject(v, ((cl_context*)data)[0]);     data = (cl_context*)data + 1;
     device  = ((cl_device_id*)data)[0];   data = (cl_device_id*)data + 1;
     properties = ((cl_command_queue_properties*)data)[0]; data = (cl_command_queue_properties*)data + 1;
     // Ensure that context and device are valid
@@ -598,14 +660,11 @@ int ocland_clCreateCommandQueue(int* clientfd, char* buffer, validator v, void*
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);            // flag
         msgSize += sizeof(cl_command_queue);  // command_queue
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]  = flag; ptr = (cl_int*)ptr  + 1;
         ((cl_command_queue*)ptr)[0] = command_queue;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(properties);properties=NULL;
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
@@ -613,14 +672,11 @@ int ocland_clCreateCommandQueue(int* clientfd, char* buffer, validator v, void*
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);            // flag
         msgSize += sizeof(cl_command_queue);  // command_queue
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]  = flag; ptr = (cl_int*)ptr  + 1;
         ((cl_command_queue*)ptr)[0] = command_queue;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(properties);properties=NULL;
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
@@ -638,14 +694,11 @@ int ocland_clCreateCommandQueue(int* clientfd, char* buffer, validator v, void*
     // Return the package
     msgSize  = sizeof(cl_int);            // flag
     msgSize += sizeof(cl_command_queue);  // command_queue
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     ptr      = msg;
     ((cl_int*)ptr)[0]  = flag; ptr = (cl_int*)ptr  + 1;
     ((cl_command_queue*)ptr)[0] = command_queue;
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(properties);properties=NULL;
-    free(msg);msg=NULL;
+    Reply(clientfd, msg, msgSize);
     VERBOSE_OUT(flag);
     return 1;
 }
@@ -658,29 +711,25 @@ int ocland_clRetainCommandQueue(int* clientfd, char* buffer, validator v, void*
     size_t msgSize = 0;
     void *msg = NULL, *ptr = NULL;
     // Decript the received data
-    command_queue = ((cl_command_queue*)data)[0];
+    command_queue = (cl_command_queue)handleObject(v, ((cl_command_queue*)data)[0]);
     // Ensure that the context is valid
     flag = isQueue(v, command_queue);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);      // flag
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
     flag = clRetainCommandQueue(command_queue);
     // Return the package
     msgSize  = sizeof(cl_int);      // flag
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     ptr      = msg;
     ((cl_int*)ptr)[0]  = flag;
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(msg);msg=NULL;
+    Reply(clientfd, msg, msgSize);
     VERBOSE_OUT(flag);
     return 1;
 }
@@ -693,17 +742,15 @@ int ocland_clReleaseCommandQueue(int* clientfd, char* buffer, validator v, void*
     size_t msgSize = 0;
     void *msg = NULL, *ptr = NULL;
     // Decript the received data
-    command_queue = ((cl_command_queue*)data)[0];
+    command_queue = (cl_command_queue)handleObject(v, ((cl_command_queue*)data)[0]);
     // Ensure that the context is valid
     flag = isQueue(v, command_queue);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);      // flag
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
@@ -719,12 +766,10 @@ int ocland_clReleaseCommandQueue(int* clientfd, char* buffer, validator v, void*
     }
     // Return the package
     msgSize  = sizeof(cl_int);      // flag
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     ptr      = msg;
     ((cl_int*)ptr)[0]  = flag;
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(msg);msg=NULL;
+    Reply(clientfd, msg, msgSize);
     VERBOSE_OUT(flag);
     return 1;
 }
@@ -741,7 +786,7 @@ int ocland_clGetCommandQueueInfo(int* clientfd, char* buffer, validator v, void*
     size_t msgSize = 0;
     void *msg = NULL, *ptr = NULL;
     // Decript the received data
-    command_queue = ((cl_command_queue*)data)[0];   data = (cl_command_queue*)data + 1;
+    command_queue = (cl_command_queue)handleObject(v, ((cl_command_queue*)data)[0]);   data = (cl_command_queue*)data + 1;
     param_name = ((cl_command_queue_info*)data)[0]; data = (cl_command_queue_info*)data + 1;
     param_value_size = ((size_t*)data)[0];    data = (size_t*)data + 1;
     // Ensure that the command_queue is valid
@@ -749,36 +794,34 @@ int ocland_clGetCommandQueueInfo(int* clientfd, char* buffer, validator v, void*
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);      // flag
         msgSize += sizeof(size_t);      // param_value_size_ret
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]  = flag; ptr = (cl_int*)ptr + 1;
         ((size_t*)ptr)[0]  = 0;    ptr = (size_t*)ptr + 1;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
     // Build the required param_value
     if(param_value_size)
-        param_value = (void*)malloc(param_value_size);
+        param_value = (void*)requestAlloc(param_value_size);
     // Get the data
     flag = clGetCommandQueueInfo(command_queue, param_name, param_value_size, param_value, &param_value_size_ret);
+    // Objects created with client generated handles are identified by them
+    if( (flag == CL_SUCCESS) && param_value && (param_name == CL_QUEUE_CONTEXT) )
+        ((void**)param_value)[0] = objectHandle(v, ((void**)param_value)[0]);
     // Return the package
     msgSize  = sizeof(cl_int);       // flag
     msgSize += sizeof(size_t);       // param_value_size_ret
     if(param_value)
         msgSize += param_value_size_ret; // param_value
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     ptr      = msg;
     ((cl_int*)ptr)[0]  = flag; ptr = (cl_int*)ptr + 1;
     ((size_t*)ptr)[0]  = param_value_size_ret;    ptr = (size_t*)ptr + 1;
     if(param_value)
         memcpy(ptr, param_value, param_value_size_ret);
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(param_value);param_value=NULL;
-    free(msg);msg=NULL;
+    Reply(clientfd, msg, msgSize);
     VERBOSE_OUT(flag);
     return 1;
 }
@@ -796,7 +839,7 @@ int ocland_clCreateBuffer(int* clientfd, char* buffer, validator v, void* data)
     size_t msgSize = 0;
     void *msg = NULL, *ptr = NULL;
     // Decript the received data
-    context = ((cl_context*)data)[0];     data = (cl_context*)data + 1;
+    context = (cl_context)handleObject(v, ((cl_context*)data)[0]);     data = (cl_context*)data + 1;
     flags   = ((cl_mem_flags*)data)[0];   data = (cl_mem_flags*)data + 1;
     size    = ((size_t*)data)[0];         data = (size_t*)data + 1;
     hasPtr  = ((cl_bool*)data)[0];        data = (cl_bool*)data + 1;
@@ -807,13 +850,11 @@ int ocland_clCreateBuffer(int* clientfd, char* buffer, validator v, void* data)
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);  // flag
         msgSize += sizeof(cl_mem);  // memobj
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0] = flag; ptr = (cl_int*)ptr  + 1;
         ((cl_mem*)ptr)[0] = memobj;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
@@ -825,13 +866,11 @@ int ocland_clCreateBuffer(int* clientfd, char* buffer, validator v, void* data)
     // Return the package
     msgSize  = sizeof(cl_int);            // flag
     msgSize += sizeof(cl_mem);  // memobj
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     ptr      = msg;
     ((cl_int*)ptr)[0] = flag; ptr = (cl_int*)ptr  + 1;
     ((cl_mem*)ptr)[0] = memobj;
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(msg);msg=NULL;
+    Reply(clientfd, msg, msgSize);
     VERBOSE_OUT(flag);
     return 1;
 }
@@ -844,29 +883,25 @@ int ocland_clRetainMemObject(int* clientfd, char* buffer, validator v, void* dat
     size_t msgSize = 0;
     void *msg = NULL, *ptr = NULL;
     // Decript the received data
-    memobj = ((cl_mem*)data)[0];
+    memobj = (cl_mem)handleObject(v, ((cl_mem*)data)[0]);
     // Ensure that the context is valid
     flag = isBuffer(v, memobj);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);      // flag
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
     flag = clRetainMemObject(memobj);
     // Return the package
     msgSize  = sizeof(cl_int);      // flag
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     ptr      = msg;
     ((cl_int*)ptr)[0]  = flag;
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(msg);msg=NULL;
+    Reply(clientfd, msg, msgSize);
     VERBOSE_OUT(flag);
     return 1;
 }
@@ -879,17 +914,15 @@ int ocland_clReleaseMemObject(int* clientfd, char* buffer, validator v, void* da
     size_t msgSize = 0;
     void *msg = NULL, *ptr = NULL;
     // Decript the received data
-    memobj = ((cl_mem*)data)[0];
+    memobj = (cl_mem)handleObject(v, ((cl_mem*)data)[0]);
     // Ensure that the context is valid
     flag = isBuffer(v, memobj);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);      // flag
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
@@ -899,12 +932,10 @@ int ocland_clReleaseMemObject(int* clientfd, char* buffer, validator v, void* da
     }
     // Return the package
     msgSize  = sizeof(cl_int);      // flag
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     ptr      = msg;
     ((cl_int*)ptr)[0]  = flag;
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(msg);msg=NULL;
+    Reply(clientfd, msg, msgSize);
     VERBOSE_OUT(flag);
     return 1;
 }
@@ -922,25 +953,22 @@ int ocland_clGetSupportedImageFormats(int* clientfd, char* buffer, validator v,
     size_t msgSize = 0;
     void *msg = NULL, *ptr = NULL;
     // Decript the received data
-    context     = ((cl_context*)data)[0]; data = (cl_context*)data + 1;
+    context     = (cl_context)handleObject(v, ((cl_context*)data)[0]); data = (cl_context*)data + 1;
     flags       = ((cl_mem_flags*)data)[0]; data = (cl_mem_flags*)data + 1;
     image_type  = ((cl_mem_object_type*)data)[0]; data = (cl_mem_object_type*)data + 1;
     num_entries = ((cl_uint*)data)[0];
     if(num_entries)
-        image_formats = (cl_image_format*)malloc(num_entries*sizeof(cl_image_format));
+        image_formats = (cl_image_format*)requestAlloc(num_entries*sizeof(cl_image_format));
     // Ensure that context is valid
     flag = isContext(v, context);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);  // flag
         msgSize += sizeof(cl_uint); // num_image_formats
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]  = flag; ptr = (cl_int*)ptr  + 1;
         ((cl_uint*)ptr)[0] = 0;    ptr = (cl_uint*)ptr + 1;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
-        free(image_formats);image_formats=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
@@ -949,7 +977,7 @@ int ocland_clGetSupportedImageFormats(int* clientfd, char* buffer, validator v,
     msgSize  = sizeof(cl_int);                            // flag
     msgSize += sizeof(cl_uint);                           // num_image_formats
     msgSize += num_image_formats*sizeof(cl_image_format); // image_formats
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     ptr      = msg;
     ((cl_int*)ptr)[0]  = flag;        ptr = (cl_int*)ptr  + 1;
     ((cl_uint*)ptr)[0] = num_image_formats; ptr = (cl_uint*)ptr + 1;
@@ -957,10 +985,7 @@ int ocland_clGetSupportedImageFormats(int* clientfd, char* buffer, validator v,
     if(n)
         memcpy(ptr, (void*)image_formats, n*sizeof(cl_image_format));
     // Send the package (first the size, then the data)
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    if(msg) free(msg); msg=NULL;
-    if(image_formats) free(image_formats); image_formats=NULL;
+    Reply(clientfd, msg, msgSize);
     VERBOSE_OUT(flag);
     return 1;
 }
@@ -977,7 +1002,7 @@ int ocland_clGetMemObjectInfo(int* clientfd, char* buffer, validator v, void* da
     size_t msgSize = 0;
     void *msg = NULL, *ptr = NULL;
     // Decript the received data
-    memobj           = ((cl_mem*)data)[0];      data = (cl_mem*)data + 1;
+    memobj           = (cl_mem)handleObject(v, ((cl_mem*)data)[0]);      data = (cl_mem*)data + 1;
     param_name       = ((cl_mem_info*)data)[0]; data = (cl_mem_info*)data + 1;
     param_value_size = ((size_t*)data)[0];      data = (size_t*)data + 1;
     // Ensure that the memory object is valid
@@ -985,36 +1010,34 @@ int ocland_clGetMemObjectInfo(int* clientfd, char* buffer, validator v, void* da
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);      // flag
         msgSize += sizeof(size_t);      // param_value_size_ret
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]  = flag; ptr = (cl_int*)ptr + 1;
         ((size_t*)ptr)[0]  = 0;    ptr = (size_t*)ptr + 1;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
     // Build the required param_value
     if(param_value_size)
-        param_value = (void*)malloc(param_value_size);
+        param_value = (void*)requestAlloc(param_value_size);
     // Get the data
     flag = clGetMemObjectInfo(memobj, param_name, param_value_size, param_value, &param_value_size_ret);
+    // Objects created with client generated handles are identified by them
+    if( (flag == CL_SUCCESS) && param_value && ((param_name == CL_MEM_CONTEXT) || (param_name == CL_MEM_ASSOCIATED_MEMOBJECT)) )
+        ((void**)param_value)[0] = objectHandle(v, ((void**)param_value)[0]);
     // Return the package
     msgSize  = sizeof(cl_int);       // flag
     msgSize += sizeof(size_t);       // param_value_size_ret
     if(param_value)
         msgSize += param_value_size_ret; // param_value
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     ptr      = msg;
     ((cl_int*)ptr)[0]  = flag; ptr = (cl_int*)ptr + 1;
     ((size_t*)ptr)[0]  = param_value_size_ret;    ptr = (size_t*)ptr + 1;
     if(param_value)
         memcpy(ptr, param_value, param_value_size_ret);
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(param_value);param_value=NULL;
-    free(msg);msg=NULL;
+    Reply(clientfd, msg, msgSize);
     VERBOSE_OUT(flag);
     return 1;
 }
@@ -1031,7 +1054,7 @@ int ocland_clGetImageInfo(int* clientfd, char* buffer, validator v, void* data)
     size_t msgSize = 0;
     void *msg = NULL, *ptr = NULL;
     // Decript the received data
-    image            = ((cl_mem*)data)[0];        data = (cl_mem*)data + 1;
+    image            = (cl_mem)handleObject(v, ((cl_mem*)data)[0]);        data = (cl_mem*)data + 1;
     param_name       = ((cl_image_info*)data)[0]; data = (cl_image_info*)data + 1;
     param_value_size = ((size_t*)data)[0];        data = (size_t*)data + 1;
     // Ensure that the memory object is valid
@@ -1039,19 +1062,17 @@ int ocland_clGetImageInfo(int* clientfd, char* buffer, validator v, void* data)
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);      // flag
         msgSize += sizeof(size_t);      // param_value_size_ret
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]  = flag; ptr = (cl_int*)ptr + 1;
         ((size_t*)ptr)[0]  = 0;    ptr = (size_t*)ptr + 1;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
     // Build the required param_value
     if(param_value_size)
-        param_value = (void*)malloc(param_value_size);
+        param_value = (void*)requestAlloc(param_value_size);
     // Get the data
     flag = clGetImageInfo(image, param_name, param_value_size, param_value, &param_value_size_ret);
     // Return the package
@@ -1059,16 +1080,13 @@ int ocland_clGetImageInfo(int* clientfd, char* buffer, validator v, void* data)
     msgSize += sizeof(size_t);       // param_value_size_ret
     if(param_value)
         msgSize += param_value_size_ret; // param_value
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     ptr      = msg;
     ((cl_int*)ptr)[0]  = flag; ptr = (cl_int*)ptr + 1;
     ((size_t*)ptr)[0]  = param_value_size_ret;    ptr = (size_t*)ptr + 1;
     if(param_value)
         memcpy(ptr, param_value, param_value_size_ret);
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(param_value);param_value=NULL;
-    free(msg);msg=NULL;
+    Reply(clientfd, msg, msgSize);
     VERBOSE_OUT(flag);
     return 1;
 }
@@ -1085,7 +1103,7 @@ int ocland_clCreateSampler(int* clientfd, char* buffer, validator v, void* data)
     size_t msgSize = 0;
     void *msg = NULL, *ptr = NULL;
     // Decript the received data
-    context           = ((cl_context*)data)[0];         data = (cl_context*)data + 1;
+    context           = (cl_context)handleObject(v, ((cl_context*)data)[0]);         data = (cl_context*)data + 1;
     normalized_coords = ((cl_bool*)data)[0];            data = (cl_bool*)data + 1;
     addressing_mode   = ((cl_addressing_mode*)data)[0]; data = (cl_addressing_mode*)data + 1;
     filter_mode       = ((cl_filter_mode*)data)[0];     data = (cl_filter_mode*)data + 1;
@@ -1094,13 +1112,11 @@ int ocland_clCreateSampler(int* clientfd, char* buffer, validator v, void* data)
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);      // flag
         msgSize += sizeof(cl_sampler);  // sampler
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]     = flag; ptr = (cl_int*)ptr  + 1;
         ((cl_sampler*)ptr)[0] = sampler;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
@@ -1112,13 +1128,11 @@ int ocland_clCreateSampler(int* clientfd, char* buffer, validator v, void* data)
     // Return the package
     msgSize  = sizeof(cl_int);     // flag
     msgSize += sizeof(cl_sampler); // sampler
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     ptr      = msg;
     ((cl_int*)ptr)[0]     = flag; ptr = (cl_int*)ptr  + 1;
     ((cl_sampler*)ptr)[0] = sampler;
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(msg);msg=NULL;
+    Reply(clientfd, msg, msgSize);
     VERBOSE_OUT(flag);
     return 1;
 }
@@ -1131,29 +1145,25 @@ int ocland_clRetainSampler(int* clientfd, char* buffer, validator v, void* data)
     size_t msgSize = 0;
     void *msg = NULL, *ptr = NULL;
     // Decript the received data
-    sampler = ((cl_sampler*)data)[0];
+    sampler = (cl_sampler)handleObject(v, ((cl_sampler*)data)[0]);
     // Ensure that the context is valid
     flag = isSampler(v, sampler);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);      // flag
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
     flag = clRetainSampler(sampler);
     // Return the package
     msgSize  = sizeof(cl_int);      // flag
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     ptr      = msg;
     ((cl_int*)ptr)[0]  = flag;
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(msg);msg=NULL;
+    Reply(clientfd, msg, msgSize);
     VERBOSE_OUT(flag);
     return 1;
 }
@@ -1166,17 +1176,15 @@ int ocland_clReleaseSampler(int* clientfd, char* buffer, validator v, void* data
     size_t msgSize = 0;
     void *msg = NULL, *ptr = NULL;
     // Decript the received data
-    sampler = ((cl_sampler*)data)[0];
+    sampler = (cl_sampler)handleObject(v, ((cl_sampler*)data)[0]);
     // Ensure that the context is valid
     flag = isSampler(v, sampler);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);      // flag
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
@@ -1186,12 +1194,10 @@ int ocland_clReleaseSampler(int* clientfd, char* buffer, validator v, void* data
     }
     // Return the package
     msgSize  = sizeof(cl_int);      // flag
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     ptr      = msg;
     ((cl_int*)ptr)[0]  = flag;
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(msg);msg=NULL;
+    Reply(clientfd, msg, msgSize);
     VERBOSE_OUT(flag);
     return 1;
 }
@@ -1208,7 +1214,7 @@ int ocland_clGetSamplerInfo(int* clientfd, char* buffer, validator v, void* data
     size_t msgSize = 0;
     void *msg = NULL, *ptr = NULL;
     // Decript the received data
-    sampler          = ((cl_sampler*)data)[0];      data = (cl_sampler*)data + 1;
+    sampler          = (cl_sampler)handleObject(v, ((cl_sampler*)data)[0]);      data = (cl_sampler*)data + 1;
     param_name       = ((cl_sampler_info*)data)[0]; data = (cl_sampler_info*)data + 1;
     param_value_size = ((size_t*)data)[0];          data = (size_t*)data + 1;
     // Ensure that the sampler is valid
@@ -1216,36 +1222,34 @@ int ocland_clGetSamplerInfo(int* clientfd, char* buffer, validator v, void* data
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);      // flag
         msgSize += sizeof(size_t);      // param_value_size_ret
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]  = flag; ptr = (cl_int*)ptr + 1;
         ((size_t*)ptr)[0]  = 0;    ptr = (size_t*)ptr + 1;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
     // Build the required param_value
     if(param_value_size)
-        param_value = (void*)malloc(param_value_size);
+        param_value = (void*)requestAlloc(param_value_size);
     // Get the data
     flag = clGetSamplerInfo(sampler, param_name, param_value_size, param_value, &param_value_size_ret);
+    // Objects created with client generated handles are identified by them
+    if( (flag == CL_SUCCESS) && param_value && (param_name == CL_SAMPLER_CONTEXT) )
+        ((void**)param_value)[0] = objectHandle(v, ((void**)param_value)[0]);
     // Return the package
     msgSize  = sizeof(cl_int);       // flag
     msgSize += sizeof(size_t);       // param_value_size_ret
     if(param_value)
         msgSize += param_value_size_ret; // param_value
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     ptr      = msg;
     ((cl_int*)ptr)[0]  = flag; ptr = (cl_int*)ptr + 1;
     ((size_t*)ptr)[0]  = param_value_size_ret;    ptr = (size_t*)ptr + 1;
     if(param_value)
         memcpy(ptr, param_value, param_value_size_ret);
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(param_value);param_value=NULL;
-    free(msg);msg=NULL;
+    Reply(clientfd, msg, msgSize);
     VERBOSE_OUT(flag);
     return 1;
 }
@@ -1260,44 +1264,39 @@ int ocland_clCreateProgramWithSource(int* clientfd, char* buffer, validator v, v
     char **strings = NULL;
     cl_int flag;
     cl_program program = NULL;
+    unsigned char digest[SHA256_SIZE];
     size_t msgSize = 0;
     void *msg = NULL, *ptr = NULL;
     // Decript the received data
-    context = ((cl_context*)data)[0]; data = (cl_context*)data + 1;
+    context = (cl_context)handleObject(v, ((cl_context*)data)[0]); data = (cl_context*)data + 1;
     count   = ((cl_uint*)data)[0];    data = (cl_uint*)data + 1;
-    lengths = (size_t*)malloc(count * sizeof(size_t));
-    strings = (char**)malloc(count * sizeof(char*));
+    lengths = (size_t*)requestAlloc(count * sizeof(size_t));
+    strings = (char**)requestAlloc(count * sizeof(char*));
     if(!lengths || !strings){
         flag     = CL_OUT_OF_HOST_MEMORY;
         msgSize  = sizeof(cl_int);      // flag
         msgSize += sizeof(cl_program);  // program
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]     = flag; ptr = (cl_int*)ptr  + 1;
         ((cl_program*)ptr)[0] = program;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
     memcpy(lengths, data, count * sizeof(size_t));
     data = (size_t*)data + count;
     for(i=0;i<count;i++){
-        strings[i] = (char*)malloc(lengths[i]*sizeof(char));
+        strings[i] = (char*)requestAlloc(lengths[i]*sizeof(char));
         if(!strings[i]){
             flag     = CL_OUT_OF_HOST_MEMORY;
             msgSize  = sizeof(cl_int);      // flag
             msgSize += sizeof(cl_program);  // program
-            msg      = (void*)malloc(msgSize);
+            msg      = requestAlloc(msgSize);
             ptr      = msg;
             ((cl_int*)ptr)[0]     = flag; ptr = (cl_int*)ptr  + 1;
             ((cl_program*)ptr)[0] = program;
-            Send(clientfd, &msgSize, sizeof(size_t), 0);
-            Send(clientfd, msg, msgSize, 0);
-            free(msg);msg=NULL;
-            free(lengths);lengths=NULL;
-            free(strings);strings=NULL;
+            Reply(clientfd, msg, msgSize);
             VERBOSE_OUT(flag);
             return 1;
         }
@@ -1309,18 +1308,11 @@ int ocland_clCreateProgramWithSource(int* clientfd, char* buffer, validator v, v
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);      // flag
         msgSize += sizeof(cl_program);  // program
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]     = flag; ptr = (cl_int*)ptr  + 1;
         ((cl_program*)ptr)[0] = program;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        for(i=0;i<count;i++){
-            free(strings[i]); strings[i] = NULL;
-        }
-        free(msg);msg=NULL;
-        free(lengths);lengths=NULL;
-        free(strings);strings=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
@@ -1328,22 +1320,61 @@ int ocland_clCreateProgramWithSource(int* clientfd, char* buffer, validator v, v
     program = clCreateProgramWithSource(context, count, strings, lengths, &flag);
     if(flag == CL_SUCCESS){
         registerProgram(v, program);
+        sha256Contents(OCLAND_CONTENTS_SOURCES, count, (const void* const*)strings, lengths, digest);
+        setProgramContents(program, digest);
+        storeProgramSources(digest, count, (const char* const*)strings, lengths);
     }
     // Return the package
     msgSize  = sizeof(cl_int);     // flag
     msgSize += sizeof(cl_program); // program
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     ptr      = msg;
     ((cl_int*)ptr)[0]     = flag;    ptr = (cl_int*)ptr  + 1;
     ((cl_program*)ptr)[0] = program;
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    for(i=0;i<count;i++){
-        free(strings[i]); strings[i] = NULL;
+    Reply(clientfd, msg, msgSize);
+    VERBOSE_OUT(flag);
+    return 1;
+}
+
+int ocland_createProgramWithDigest(int* clientfd, char* buffer, validator v, void* data)
+{
+    VERBOSE_IN();
+    cl_context context;
+    cl_int flag;
+    cl_program program = NULL;
+    size_t msgSize = 0;
+    void *msg = NULL, *ptr = NULL;
+    // Decript the received data
+    if(requestHeader()->length < sizeof(cl_context) + SHA256_SIZE){
+        flag     = CL_INVALID_VALUE;
+        msgSize  = sizeof(cl_int);      // flag
+        msgSize += sizeof(cl_program);  // program
+        msg      = requestAlloc(msgSize);
+        ptr      = msg;
+        ((cl_int*)ptr)[0]     = flag; ptr = (cl_int*)ptr  + 1;
+        ((cl_program*)ptr)[0] = program;
+        Reply(clientfd, msg, msgSize);
+        VERBOSE_OUT(flag);
+        return 1;
     }
-    free(msg);msg=NULL;
-    free(lengths);lengths=NULL;
-    free(strings);strings=NULL;
+    context = (cl_context)handleObject(v, ((cl_context*)data)[0]); data = (cl_context*)data + 1;
+    // Ensure that the context is valid
+    flag = isContext(v, context);
+    if(flag == CL_SUCCESS){
+        // Create the program from the stored sources
+        program = createCachedProgram(context, (const unsigned char*)data, &flag);
+        if(flag == CL_SUCCESS){
+            registerProgram(v, program);
+        }
+    }
+    // Return the package
+    msgSize  = sizeof(cl_int);     // flag
+    msgSize += sizeof(cl_program); // program
+    msg      = requestAlloc(msgSize);
+    ptr      = msg;
+    ((cl_int*)ptr)[0]     = flag;    ptr = (cl_int*)ptr  + 1;
+    ((cl_program*)ptr)[0] = program;
+    Reply(clientfd, msg, msgSize);
     VERBOSE_OUT(flag);
     return 1;
 }
@@ -1363,23 +1394,21 @@ int ocland_clCreateProgramWithBinary(int* clientfd, char* buffer, validator v, v
     size_t msgSize = 0;
     void *msg = NULL, *ptr = NULL;
     // Decript the received data
-    context       = ((cl_context*)data)[0]; data = (cl_context*)data + 1;
+    context       = (cl_context)handleObject(v, ((cl_context*)data)[0]); data = (cl_context*)data + 1;
     num_devices   = ((cl_uint*)data)[0];    data = (cl_uint*)data + 1;
-    device_list   = (cl_device_id*)malloc(num_devices * sizeof(cl_device_id));
-    lengths       = (size_t*)malloc(num_devices * sizeof(size_t));
-    binaries      = (unsigned char**)malloc(num_devices * sizeof(unsigned char*));
-    binary_status = (cl_int*)malloc(num_devices * sizeof(cl_int));
+    device_list   = (cl_device_id*)requestAlloc(num_devices * sizeof(cl_device_id));
+    lengths       = (size_t*)requestAlloc(num_devices * sizeof(size_t));
+    binaries      = (unsigned char**)requestAlloc(num_devices * sizeof(unsigned char*));
+    binary_status = (cl_int*)requestAlloc(num_devices * sizeof(cl_int));
     if(!device_list || !lengths || !binaries || !binary_status){
         flag     = CL_OUT_OF_HOST_MEMORY;
         msgSize  = sizeof(cl_int);      // flag
         msgSize += sizeof(cl_program);  // program
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]     = flag; ptr = (cl_int*)ptr  + 1;
         ((cl_program*)ptr)[0] = program;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
@@ -1388,22 +1417,16 @@ int ocland_clCreateProgramWithBinary(int* clientfd, char* buffer, validator v, v
     memcpy(lengths, data, num_devices * sizeof(size_t));
     data = (size_t*)data + num_devices;
     for(i=0;i<num_devices;i++){
-        binaries[i] = (char*)malloc(lengths[i]*sizeof(unsigned char));
+        binaries[i] = (char*)requestAlloc(lengths[i]*sizeof(unsigned char));
         if(!binaries[i]){
             flag     = CL_OUT_OF_HOST_MEMORY;
             msgSize  = sizeof(cl_int);      // flag
             msgSize += sizeof(cl_program);  // program
-            msg      = (void*)malloc(msgSize);
+            msg      = requestAlloc(msgSize);
             ptr      = msg;
             ((cl_int*)ptr)[0]     = flag; ptr = (cl_int*)ptr  + 1;
             ((cl_program*)ptr)[0] = program;
-            Send(clientfd, &msgSize, sizeof(size_t), 0);
-            Send(clientfd, msg, msgSize, 0);
-            free(msg);msg=NULL;
-            free(device_list); device_list=NULL;
-            free(lengths); lengths=NULL;
-            free(binaries); binaries=NULL;
-            free(binary_status); binary_status=NULL;
+            Reply(clientfd, msg, msgSize);
             VERBOSE_OUT(flag);
             return 1;
         }
@@ -1415,20 +1438,11 @@ int ocland_clCreateProgramWithBinary(int* clientfd, char* buffer, validator v, v
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);      // flag
         msgSize += sizeof(cl_program);  // program
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]     = flag; ptr = (cl_int*)ptr  + 1;
         ((cl_program*)ptr)[0] = program;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        for(i=0;i<num_devices;i++){
-            free(binaries[i]); binaries[i] = NULL;
-        }
-        free(msg);msg=NULL;
-        free(device_list); device_list=NULL;
-        free(lengths); lengths=NULL;
-        free(binaries); binaries=NULL;
-        free(binary_status); binary_status=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
@@ -1436,27 +1450,21 @@ int ocland_clCreateProgramWithBinary(int* clientfd, char* buffer, validator v, v
     program = clCreateProgramWithBinary(context, num_devices, device_list,
                                         lengths, binaries, binary_status, &flag);
     if(flag == CL_SUCCESS){
+        unsigned char digest[SHA256_SIZE];
         registerProgram(v, program);
+        sha256Contents(OCLAND_CONTENTS_BINARIES, num_devices, (const void* const*)binaries, lengths, digest);
+        setProgramContents(program, digest);
     }
     // Return the package
     msgSize  = sizeof(cl_int);             // flag
     msgSize += sizeof(cl_program);         // program
     msgSize += num_devices*sizeof(cl_int); // binary_status
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     ptr      = msg;
     ((cl_int*)ptr)[0]     = flag;    ptr = (cl_int*)ptr  + 1;
     ((cl_program*)ptr)[0] = program; ptr = (cl_program*)ptr  + 1;
     memcpy(ptr, binary_status, num_devices*sizeof(cl_int));
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    for(i=0;i<num_devices;i++){
-        free(binaries[i]); binaries[i] = NULL;
-    }
-    free(msg);msg=NULL;
-    free(device_list); device_list=NULL;
-    free(lengths); lengths=NULL;
-    free(binaries); binaries=NULL;
-    free(binary_status); binary_status=NULL;
+    Reply(clientfd, msg, msgSize);
     VERBOSE_OUT(flag);
     return 1;
 }
@@ -1469,29 +1477,25 @@ int ocland_clRetainProgram(int* clientfd, char* buffer, validator v, void* data)
     size_t msgSize = 0;
     void *msg = NULL, *ptr = NULL;
     // Decript the received data
-    program = ((cl_program*)data)[0];
+    program = (cl_program)handleObject(v, ((cl_program*)data)[0]);
     // Ensure that the context is valid
     flag = isProgram(v, program);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);      // flag
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
     flag = clRetainProgram(program);
     // Return the package
     msgSize  = sizeof(cl_int);      // flag
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     ptr      = msg;
     ((cl_int*)ptr)[0]  = flag;
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(msg);msg=NULL;
+    Reply(clientfd, msg, msgSize);
     VERBOSE_OUT(flag);
     return 1;
 }
@@ -1504,32 +1508,38 @@ int ocland_clReleaseProgram(int* clientfd, char* buffer, validator v, void* data
     size_t msgSize = 0;
     void *msg = NULL, *ptr = NULL;
     // Decript the received data
-    program = ((cl_program*)data)[0];
+    program = (cl_program)handleObject(v, ((cl_program*)data)[0]);
     // Ensure that the context is valid
     flag = isProgram(v, program);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);      // flag
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
+    // A program built from the cached binaries keeps alive the one it
+    // replaced (see ocland_clBuildProgram)
+    cl_program replaced = substitutedProgram(program);
     flag = clReleaseProgram(program);
     if(flag == CL_SUCCESS){
         unregisterProgram(v,program);
+        unsetProgramContents(program);
+        if(replaced != program){
+            unsubstituteProgram(program);
+            clReleaseProgram(replaced);
+            unregisterProgram(v, replaced);
+            unsetProgramContents(replaced);
+        }
     }
     // Return the package
     msgSize  = sizeof(cl_int);      // flag
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     ptr      = msg;
     ((cl_int*)ptr)[0]  = flag;
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(msg);msg=NULL;
+    Reply(clientfd, msg, msgSize);
     VERBOSE_OUT(flag);
     return 1;
 }
@@ -1538,27 +1548,27 @@ int ocland_clBuildProgram(int* clientfd, char* buffer, validator v, void* data)
 {
     VERBOSE_IN();
     unsigned int i;
-    cl_program program;
+    cl_program program, cached;
     cl_uint num_devices;
     cl_device_id *device_list=NULL;
     size_t options_size;
     char *options = NULL;
+    cl_bool notify;
+    data_channel channel = NULL;
     cl_int flag;
     size_t msgSize = 0;
     void *msg = NULL, *ptr = NULL;
     // Decript the received data
-    program     = ((cl_program*)data)[0]; data = (cl_program*)data + 1;
+    program     = (cl_program)handleObject(v, ((cl_program*)data)[0]); data = (cl_program*)data + 1;
     num_devices = ((cl_uint*)data)[0];    data = (cl_uint*)data + 1;
-    device_list = (cl_device_id*)malloc(num_devices * sizeof(cl_device_id));
+    device_list = (cl_device_id*)requestAlloc(num_devices * sizeof(cl_device_id));
     if(!device_list){
         flag     = CL_OUT_OF_HOST_MEMORY;
         msgSize  = sizeof(cl_int);      // flag
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0] = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
@@ -1566,48 +1576,72 @@ int ocland_clBuildProgram(int* clientfd, char* buffer, validator v, void* data)
     data = (cl_device_id*)data + num_devices;
     options_size = ((size_t*)data)[0]; data = (size_t*)data + 1;
     if(options_size){
-        options = (char*)malloc(options_size);
+        options = (char*)requestAlloc(options_size);
         if(!options){
             flag     = CL_OUT_OF_HOST_MEMORY;
             msgSize  = sizeof(cl_int);      // flag
-            msg      = (void*)malloc(msgSize);
+            msg      = requestAlloc(msgSize);
             ptr      = msg;
             ((cl_int*)ptr)[0] = flag;
-            Send(clientfd, &msgSize, sizeof(size_t), 0);
-            Send(clientfd, msg, msgSize, 0);
-            free(msg);msg=NULL;
-            free(device_list);device_list=NULL;
+            Reply(clientfd, msg, msgSize);
             VERBOSE_OUT(flag);
             return 1;
         }
         memcpy(options, data, options_size);
     }
+    data = (char*)data + options_size;
+    notify = ((cl_bool*)data)[0];
     // Ensure that the program is valid
     flag = isProgram(v, program);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);      // flag
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]     = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
-        free(device_list);device_list=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
-    // Build the program
-    flag = clBuildProgram(program, num_devices, device_list,
-                          options, NULL, NULL);
+    // The client waiting for a notification gets the result of the
+    // build through its data channel
+    if(notify)
+        channel = requestChannel();
+    // A program built from the cached binaries is dropped, building
+    // again the program that it replaced
+    cl_program replaced = unsubstituteProgram(program);
+    if(replaced){
+        registerAlias(v, program, replaced);
+        clReleaseProgram(program);
+        unregisterProgram(v, program);
+        unsetProgramContents(program);
+        program = replaced;
+    }
+    // Build the program, from the cached binaries if possible
+    cached = loadCachedProgram(program, num_devices, device_list,
+                               options, &flag);
+    if(!cached){
+        flag = buildProgram(program, num_devices, device_list, options,
+                            channel, requestHeader()->opcode,
+                            requestHeader()->request_id);
+    }
+    else{
+        // The client will use the program built from the cached
+        // binaries, keeping alive the replaced one
+        registerProgram(v, cached);
+        registerAlias(v, program, cached);
+        substituteProgram(program, cached);
+    }
     // Return the package
     msgSize  = sizeof(cl_int);             // flag
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     ptr      = msg;
     ((cl_int*)ptr)[0]     = flag;
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(msg);msg=NULL;
-    free(device_list);device_list=NULL;
+    Reply(clientfd, msg, msgSize);
+    if(cached && channel){
+        // Built from the cached binaries, notify it right now
+        channelSend(channel, requestHeader()->opcode,
+                    requestHeader()->request_id, &flag, sizeof(cl_int));
+    }
     VERBOSE_OUT(flag);
     return 1;
 }
@@ -1624,7 +1658,7 @@ int ocland_clGetProgramInfo(int* clientfd, char* buffer, validator v, void* data
     size_t msgSize = 0;
     void *msg = NULL, *ptr = NULL;
     // Decript the received data
-    program          = ((cl_program*)data)[0];      data = (cl_program*)data + 1;
+    program          = (cl_program)handleObject(v, ((cl_program*)data)[0]);      data = (cl_program*)data + 1;
     param_name       = ((cl_program_info*)data)[0]; data = (cl_program_info*)data + 1;
     param_value_size = ((size_t*)data)[0];          data = (size_t*)data + 1;
     // Ensure that the program is valid
@@ -1632,36 +1666,38 @@ int ocland_clGetProgramInfo(int* clientfd, char* buffer, validator v, void* data
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);      // flag
         msgSize += sizeof(size_t);      // param_value_size_ret
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]  = flag; ptr = (cl_int*)ptr + 1;
         ((size_t*)ptr)[0]  = 0;    ptr = (size_t*)ptr + 1;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
     // Build the required param_value
     if(param_value_size)
-        param_value = (void*)malloc(param_value_size);
+        param_value = (void*)requestAlloc(param_value_size);
+    // The sources of a program built from the cached binaries are the
+    // ones of the program that it replaced
+    if(param_name == CL_PROGRAM_SOURCE)
+        program = substitutedProgram(program);
     // Get the data
     flag = clGetProgramInfo(program, param_name, param_value_size, param_value, &param_value_size_ret);
+    // Objects created with client generated handles are identified by them
+    if( (flag == CL_SUCCESS) && param_value && (param_name == CL_PROGRAM_CONTEXT) )
+        ((void**)param_value)[0] = objectHandle(v, ((void**)param_value)[0]);
     // Return the package
     msgSize  = sizeof(cl_int);       // flag
     msgSize += sizeof(size_t);       // param_value_size_ret
     if(param_value)
         msgSize += param_value_size_ret; // param_value
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     ptr      = msg;
     ((cl_int*)ptr)[0]  = flag; ptr = (cl_int*)ptr + 1;
     ((size_t*)ptr)[0]  = param_value_size_ret;    ptr = (size_t*)ptr + 1;
     if(param_value)
         memcpy(ptr, param_value, param_value_size_ret);
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(param_value);param_value=NULL;
-    free(msg);msg=NULL;
+    Reply(clientfd, msg, msgSize);
     VERBOSE_OUT(flag);
     return 1;
 }
@@ -1679,7 +1715,7 @@ int ocland_clGetProgramBuildInfo(int* clientfd, char* buffer, validator v, void*
     size_t msgSize = 0;
     void *msg = NULL, *ptr = NULL;
     // Decript the received data
-    program          = ((cl_program*)data)[0];      data = (cl_program*)data + 1;
+    program          = (cl_program)handleObject(v, ((cl_program*)data)[0]);      data = (cl_program*)data + 1;
     device           = ((cl_device_id*)data)[0];    data = (cl_device_id*)data + 1;
     param_name       = ((cl_program_info*)data)[0]; data = (cl_program_info*)data + 1;
     param_value_size = ((size_t*)data)[0];          data = (size_t*)data + 1;
@@ -1688,19 +1724,17 @@ int ocland_clGetProgramBuildInfo(int* clientfd, char* buffer, validator v, void*
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);      // flag
         msgSize += sizeof(size_t);      // param_value_size_ret
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]  = flag; ptr = (cl_int*)ptr + 1;
         ((size_t*)ptr)[0]  = 0;    ptr = (size_t*)ptr + 1;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
     // Build the required param_value
     if(param_value_size)
-        param_value = (void*)malloc(param_value_size);
+        param_value = (void*)requestAlloc(param_value_size);
     // Get the data
     flag = clGetProgramBuildInfo(program, device, param_name, param_value_size, param_value, &param_value_size_ret);
     // Return the package
@@ -1708,16 +1742,13 @@ int ocland_clGetProgramBuildInfo(int* clientfd, char* buffer, validator v, void*
     msgSize += sizeof(size_t);       // param_value_size_ret
     if(param_value)
         msgSize += param_value_size_ret; // param_value
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     ptr      = msg;
     ((cl_int*)ptr)[0]  = flag; ptr = (cl_int*)ptr + 1;
     ((size_t*)ptr)[0]  = param_value_size_ret;    ptr = (size_t*)ptr + 1;
     if(param_value)
         memcpy(ptr, param_value, param_value_size_ret);
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(param_value);param_value=NULL;
-    free(msg);msg=NULL;
+    Reply(clientfd, msg, msgSize);
     VERBOSE_OUT(flag);
     return 1;
 }
@@ -1733,20 +1764,18 @@ int ocland_clCreateKernel(int* clientfd, char* buffer, validator v, void* data)
     size_t msgSize = 0;
     void *msg = NULL, *ptr = NULL;
     // Decript the received data
-    program          = ((cl_program*)data)[0]; data = (cl_program*)data + 1;
+    program          = (cl_program)handleObject(v, ((cl_program*)data)[0]); data = (cl_program*)data + 1;
     kernel_name_size = ((size_t*)data)[0];     data = (size_t*)data + 1;
-    kernel_name      = (char*)malloc(kernel_name_size);
+    kernel_name      = (char*)requestAlloc(kernel_name_size);
     if(!kernel_name){
         flag     = CL_OUT_OF_HOST_MEMORY;
         msgSize  = sizeof(cl_int);     // flag
         msgSize += sizeof(cl_kernel);  // kernel
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]    = flag; ptr = (cl_int*)ptr  + 1;
         ((cl_kernel*)ptr)[0] = kernel;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
@@ -1756,14 +1785,11 @@ int ocland_clCreateKernel(int* clientfd, char* buffer, validator v, void* data)
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);     // flag
         msgSize += sizeof(cl_kernel);  // kernel
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]    = flag; ptr = (cl_int*)ptr  + 1;
         ((cl_kernel*)ptr)[0] = kernel;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
-        free(kernel_name);kernel_name=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
@@ -1775,14 +1801,11 @@ int ocland_clCreateKernel(int* clientfd, char* buffer, validator v, void* data)
     // Return the package
     msgSize  = sizeof(cl_int);    // flag
     msgSize += sizeof(cl_kernel); // kernel
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     ptr      = msg;
     ((cl_int*)ptr)[0]     = flag;    ptr = (cl_int*)ptr  + 1;
     ((cl_kernel*)ptr)[0] = kernel;
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(msg);msg=NULL;
-    free(kernel_name);kernel_name=NULL;
+    Reply(clientfd, msg, msgSize);
     VERBOSE_OUT(flag);
     return 1;
 }
@@ -1799,21 +1822,19 @@ int ocland_clCreateKernelsInProgram(int* clientfd, char* buffer, validator v, vo
     size_t msgSize = 0;
     void *msg = NULL, *ptr = NULL;
     // Decript the received data
-    program     = ((cl_program*)data)[0]; data = (cl_program*)data + 1;
+    program     = (cl_program)handleObject(v, ((cl_program*)data)[0]); data = (cl_program*)data + 1;
     num_kernels = ((cl_uint*)data)[0];     data = (cl_uint*)data + 1;
     if(num_kernels){
-        kernels = (cl_kernel*)malloc(num_kernels*sizeof(cl_kernel));
+        kernels = (cl_kernel*)requestAlloc(num_kernels*sizeof(cl_kernel));
         if(!kernels){
             flag     = CL_OUT_OF_HOST_MEMORY;
             msgSize  = sizeof(cl_int);   // flag
             msgSize += sizeof(cl_uint);  // num_kernels_ret
-            msg      = (void*)malloc(msgSize);
+            msg      = requestAlloc(msgSize);
             ptr      = msg;
             ((cl_int*)ptr)[0]  = flag; ptr = (cl_int*)ptr  + 1;
             ((cl_uint*)ptr)[0] = num_kernels_ret;
-            Send(clientfd, &msgSize, sizeof(size_t), 0);
-            Send(clientfd, msg, msgSize, 0);
-            free(msg);msg=NULL;
+            Reply(clientfd, msg, msgSize);
             VERBOSE_OUT(flag);
             return 1;
         }
@@ -1823,14 +1844,11 @@ int ocland_clCreateKernelsInProgram(int* clientfd, char* buffer, validator v, vo
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);   // flag
         msgSize += sizeof(cl_uint);  // num_kernels_ret
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]  = flag; ptr = (cl_int*)ptr  + 1;
         ((cl_uint*)ptr)[0] = num_kernels_ret;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
-        free(kernels);kernels=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
@@ -1845,15 +1863,12 @@ int ocland_clCreateKernelsInProgram(int* clientfd, char* buffer, validator v, vo
     msgSize  = sizeof(cl_int);      // flag
     msgSize += sizeof(cl_uint);     // num_kernels_ret
     msgSize += n*sizeof(cl_kernel); // kernels
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     ptr      = msg;
     ((cl_int*)ptr)[0]  = flag;            ptr = (cl_int*)ptr  + 1;
     ((cl_uint*)ptr)[0] = num_kernels_ret; ptr = (cl_uint*)ptr + 1;
     memcpy(ptr, kernels, n*sizeof(cl_kernel));
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(msg);msg=NULL;
-    free(kernels);kernels=NULL;
+    Reply(clientfd, msg, msgSize);
     VERBOSE_OUT(flag);
     return 1;
 }
@@ -1866,29 +1881,25 @@ int ocland_clRetainKernel(int* clientfd, char* buffer, validator v, void* data)
     size_t msgSize = 0;
     void *msg = NULL, *ptr = NULL;
     // Decript the received data
-    kernel = ((cl_kernel*)data)[0];
+    kernel = (cl_kernel)handleObject(v, ((cl_kernel*)data)[0]);
     // Ensure that the kernel is valid
     flag = isKernel(v, kernel);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);      // flag
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
     flag = clRetainKernel(kernel);
     // Return the package
     msgSize  = sizeof(cl_int);      // flag
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     ptr      = msg;
     ((cl_int*)ptr)[0]  = flag;
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(msg);msg=NULL;
+    Reply(clientfd, msg, msgSize);
     VERBOSE_OUT(flag);
     return 1;
 }
@@ -1901,17 +1912,15 @@ int ocland_clReleaseKernel(int* clientfd, char* buffer, validator v, void* data)
     size_t msgSize = 0;
     void *msg = NULL, *ptr = NULL;
     // Decript the received data
-    kernel = ((cl_kernel*)data)[0];
+    kernel = (cl_kernel)handleObject(v, ((cl_kernel*)data)[0]);
     // Ensure that the kernel is valid
     flag = isKernel(v, kernel);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);      // flag
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
@@ -1921,12 +1930,10 @@ int ocland_clReleaseKernel(int* clientfd, char* buffer, validator v, void* data)
     }
     // Return the package
     msgSize  = sizeof(cl_int);      // flag
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     ptr      = msg;
     ((cl_int*)ptr)[0]  = flag;
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(msg);msg=NULL;
+    Reply(clientfd, msg, msgSize);
     VERBOSE_OUT(flag);
     return 1;
 }
@@ -1943,50 +1950,46 @@ int ocland_clSetKernelArg(int* clientfd, char* buffer, validator v, void* data)
     size_t msgSize = 0;
     void *msg = NULL, *ptr = NULL;
     // Decript the received data
-    kernel         = ((cl_kernel*)data)[0]; data = (cl_kernel*)data + 1;
+    kernel         = (cl_kernel)handleObject(v, ((cl_kernel*)data)[0]); data = (cl_kernel*)data + 1;
     arg_index      = ((cl_uint*)data)[0];   data = (cl_uint*)data + 1;
     arg_size       = ((size_t*)data)[0];    data = (size_t*)data + 1;
     arg_value_size = ((size_t*)data)[0];    data = (size_t*)data + 1;
     if(arg_value_size){
-        arg_value = (void*)malloc(arg_value_size);
+        arg_value = (void*)requestAlloc(arg_value_size);
         if(!arg_value){
             flag     = CL_OUT_OF_HOST_MEMORY;
             msgSize  = sizeof(cl_int);     // flag
-            msg      = (void*)malloc(msgSize);
+            msg      = requestAlloc(msgSize);
             ptr      = msg;
             ((cl_int*)ptr)[0]    = flag;
-            Send(clientfd, &msgSize, sizeof(size_t), 0);
-            Send(clientfd, msg, msgSize, 0);
-            free(msg);msg=NULL;
+            Reply(clientfd, msg, msgSize);
             VERBOSE_OUT(flag);
             return 1;
         }
         memcpy(arg_value, data, arg_value_size);
+        // Memory objects and samplers may be identified by client
+        // generated handles
+        if(arg_value_size == sizeof(void*))
+            ((void**)arg_value)[0] = handleObject(v, ((void**)arg_value)[0]);
     }
     // Ensure that the kernel is valid
     flag = isKernel(v, kernel);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);     // flag
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]    = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
-        free(arg_value);arg_value=NULL;
+        Reply(clientfd, msg, msgSize);
         return 1;
     }
     // Set the argument
     flag = clSetKernelArg(kernel, arg_index, arg_size, arg_value);
     // Return the package
     msgSize  = sizeof(cl_int);    // flag
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     ptr      = msg;
     ((cl_int*)ptr)[0]     = flag;
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(msg);msg=NULL;
-    free(arg_value);arg_value=NULL;
+    Reply(clientfd, msg, msgSize);
     VERBOSE_OUT(flag);
     return 1;
 }
@@ -2003,7 +2006,7 @@ int ocland_clGetKernelInfo(int* clientfd, char* buffer, validator v, void* data)
     size_t msgSize = 0;
     void *msg = NULL, *ptr = NULL;
     // Decript the received data
-    kernel = ((cl_kernel*)data)[0];          data = (cl_kernel*)data + 1;
+    kernel = (cl_kernel)handleObject(v, ((cl_kernel*)data)[0]);          data = (cl_kernel*)data + 1;
     param_name = ((cl_kernel_info*)data)[0]; data = (cl_kernel_info*)data + 1;
     param_value_size = ((size_t*)data)[0];   data = (size_t*)data + 1;
     // Ensure that the kernel is valid
@@ -2011,36 +2014,34 @@ int ocland_clGetKernelInfo(int* clientfd, char* buffer, validator v, void* data)
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);      // flag
         msgSize += sizeof(size_t);      // param_value_size_ret
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]  = flag; ptr = (cl_int*)ptr + 1;
         ((size_t*)ptr)[0]  = 0;    ptr = (size_t*)ptr + 1;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
     // Build the required param_value
     if(param_value_size)
-        param_value = (void*)malloc(param_value_size);
+        param_value = (void*)requestAlloc(param_value_size);
     // Get the data
     flag = clGetKernelInfo(kernel, param_name, param_value_size, param_value, &param_value_size_ret);
+    // Objects created with client generated handles are identified by them
+    if( (flag == CL_SUCCESS) && param_value && ((param_name == CL_KERNEL_CONTEXT) || (param_name == CL_KERNEL_PROGRAM)) )
+        ((void**)param_value)[0] = objectHandle(v, ((void**)param_value)[0]);
     // Return the package
     msgSize  = sizeof(cl_int);       // flag
     msgSize += sizeof(size_t);       // param_value_size_ret
     if(param_value)
         msgSize += param_value_size_ret; // param_value
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     ptr      = msg;
     ((cl_int*)ptr)[0]  = flag; ptr = (cl_int*)ptr + 1;
     ((size_t*)ptr)[0]  = param_value_size_ret;    ptr = (size_t*)ptr + 1;
     if(param_value)
         memcpy(ptr, param_value, param_value_size_ret);
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(param_value);param_value=NULL;
-    free(msg);msg=NULL;
+    Reply(clientfd, msg, msgSize);
     VERBOSE_OUT(flag);
     return 1;
 }
@@ -2058,7 +2059,7 @@ int ocland_clGetKernelWorkGroupInfo(int* clientfd, char* buffer, validator v, vo
     size_t msgSize = 0;
     void *msg = NULL, *ptr = NULL;
     // Decript the received data
-    kernel = ((cl_kernel*)data)[0];                     data = (cl_kernel*)data + 1;
+    kernel = (cl_kernel)handleObject(v, ((cl_kernel*)data)[0]);                     data = (cl_kernel*)data + 1;
     device = ((cl_device_id*)data)[0];                  data = (cl_device_id*)data + 1;
     param_name = ((cl_kernel_work_group_info*)data)[0]; data = (cl_kernel_work_group_info*)data + 1;
     param_value_size = ((size_t*)data)[0];              data = (size_t*)data + 1;
@@ -2067,13 +2068,11 @@ int ocland_clGetKernelWorkGroupInfo(int* clientfd, char* buffer, validator v, vo
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);      // flag
         msgSize += sizeof(size_t);      // param_value_size_ret
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]  = flag; ptr = (cl_int*)ptr + 1;
         ((size_t*)ptr)[0]  = 0;    ptr = (size_t*)ptr + 1;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
@@ -2081,19 +2080,17 @@ int ocland_clGetKernelWorkGroupInfo(int* clientfd, char* buffer, validator v, vo
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);      // flag
         msgSize += sizeof(size_t);      // param_value_size_ret
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]  = flag; ptr = (cl_int*)ptr + 1;
         ((size_t*)ptr)[0]  = 0;    ptr = (size_t*)ptr + 1;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
     // Build the required param_value
     if(param_value_size)
-        param_value = (void*)malloc(param_value_size);
+        param_value = (void*)requestAlloc(param_value_size);
     // Get the data
     flag = clGetKernelWorkGroupInfo(kernel, device, param_name, param_value_size, param_value, &param_value_size_ret);
     // Return the package
@@ -2101,16 +2098,13 @@ int ocland_clGetKernelWorkGroupInfo(int* clientfd, char* buffer, validator v, vo
     msgSize += sizeof(size_t);       // param_value_size_ret
     if(param_value)
         msgSize += param_value_size_ret; // param_value
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     ptr      = msg;
     ((cl_int*)ptr)[0]  = flag; ptr = (cl_int*)ptr + 1;
     ((size_t*)ptr)[0]  = param_value_size_ret;    ptr = (size_t*)ptr + 1;
     if(param_value)
         memcpy(ptr, param_value, param_value_size_ret);
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(param_value);param_value=NULL;
-    free(msg);msg=NULL;
+    Reply(clientfd, msg, msgSize);
     VERBOSE_OUT(flag);
     return 1;
 }
@@ -2126,16 +2120,14 @@ int ocland_clWaitForEvents(int* clientfd, char* buffer, validator v, void* data)
     void *msg = NULL, *ptr = NULL;
     // Decript the received data
     num_events = ((cl_uint*)data)[0]; data = (cl_uint*)data + 1;
-    event_list = (ocland_event*)malloc(num_events * sizeof(ocland_event));
+    event_list = (ocland_event*)requestAlloc(num_events * sizeof(ocland_event));
     if(!event_list){
         flag = CL_INVALID_CONTEXT;
         msgSize  = sizeof(cl_int);      // flag
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
@@ -2145,13 +2137,10 @@ int ocland_clWaitForEvents(int* clientfd, char* buffer, validator v, void* data)
         flag = isEvent(v, event_list[i]);
         if(flag != CL_SUCCESS){
             msgSize  = sizeof(cl_int);      // flag
-            msg      = (void*)malloc(msgSize);
+            msg      = requestAlloc(msgSize);
             ptr      = msg;
             ((cl_int*)ptr)[0]  = flag;
-            Send(clientfd, &msgSize, sizeof(size_t), 0);
-            Send(clientfd, msg, msgSize, 0);
-            free(msg);msg=NULL;
-            free(event_list);event_list=NULL;
+            Reply(clientfd, msg, msgSize);
             VERBOSE_OUT(flag);
             return 1;
         }
@@ -2159,13 +2148,10 @@ int ocland_clWaitForEvents(int* clientfd, char* buffer, validator v, void* data)
     flag = oclandWaitForEvents(num_events, event_list);
     // Return the package
     msgSize  = sizeof(cl_int);       // flag
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     ptr      = msg;
     ((cl_int*)ptr)[0]  = flag;
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(msg);msg=NULL;
-    free(event_list);event_list=NULL;
+    Reply(clientfd, msg, msgSize);
     VERBOSE_OUT(flag);
     return 1;
 }
@@ -2190,36 +2176,34 @@ int ocland_clGetEventInfo(int* clientfd, char* buffer, validator v, void* data)
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);      // flag
         msgSize += sizeof(size_t);      // param_value_size_ret
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]  = flag; ptr = (cl_int*)ptr + 1;
         ((size_t*)ptr)[0]  = 0;    ptr = (size_t*)ptr + 1;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
     // Build the required param_value
     if(param_value_size)
-        param_value = (void*)malloc(param_value_size);
+        param_value = (void*)requestAlloc(param_value_size);
     // Get the data
     flag = clGetEventInfo(event->event,param_name,param_value_size,param_value,&param_value_size_ret);
+    // Objects created with client generated handles are identified by them
+    if( (flag == CL_SUCCESS) && param_value && ((param_name == CL_EVENT_COMMAND_QUEUE) || (param_name == CL_EVENT_CONTEXT)) )
+        ((void**)param_value)[0] = objectHandle(v, ((void**)param_value)[0]);
     // Return the package
     msgSize  = sizeof(cl_int);       // flag
     msgSize += sizeof(size_t);       // param_value_size_ret
     if(param_value)
         msgSize += param_value_size_ret; // param_value
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     ptr      = msg;
     ((cl_int*)ptr)[0]  = flag; ptr = (cl_int*)ptr + 1;
     ((size_t*)ptr)[0]  = param_value_size_ret;    ptr = (size_t*)ptr + 1;
     if(param_value)
         memcpy(ptr, param_value, param_value_size_ret);
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(param_value);param_value=NULL;
-    free(msg);msg=NULL;
+    Reply(clientfd, msg, msgSize);
     VERBOSE_OUT(flag);
     return 1;
 }
@@ -2237,24 +2221,20 @@ int ocland_clRetainEvent(int* clientfd, char* buffer, validator v, void* data)
     flag = isEvent(v, event);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);      // flag
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
     flag = clRetainEvent(event->event);
     // Return the package
     msgSize  = sizeof(cl_int);      // flag
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     ptr      = msg;
     ((cl_int*)ptr)[0]  = flag;
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(msg);msg=NULL;
+    Reply(clientfd, msg, msgSize);
     VERBOSE_OUT(flag);
     return 1;
 }
@@ -2272,28 +2252,25 @@ int ocland_clReleaseEvent(int* clientfd, char* buffer, validator v, void* data)
     flag = isEvent(v, event);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);      // flag
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
     flag = clReleaseEvent(event->event);
     if(flag == CL_SUCCESS){
         unregisterEvent(v,event);
-        free(event);
+        // It may be still used by a transfer or a waiting thread
+        oclandReleaseEvent(event);
     }
     // Return the package
     msgSize  = sizeof(cl_int);      // flag
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     ptr      = msg;
     ((cl_int*)ptr)[0]  = flag;
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(msg);msg=NULL;
+    Reply(clientfd, msg, msgSize);
     VERBOSE_OUT(flag);
     return 1;
 }
@@ -2318,19 +2295,17 @@ int ocland_clGetEventProfilingInfo(int* clientfd, char* buffer, validator v, voi
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);      // flag
         msgSize += sizeof(size_t);      // param_value_size_ret
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]  = flag; ptr = (cl_int*)ptr + 1;
         ((size_t*)ptr)[0]  = 0;    ptr = (size_t*)ptr + 1;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
     // Build the required param_value
     if(param_value_size)
-        param_value = (void*)malloc(param_value_size);
+        param_value = (void*)requestAlloc(param_value_size);
     // Get the data
     flag = clGetEventProfilingInfo(event->event,param_name,param_value_size,param_value,&param_value_size_ret);
     // Return the package
@@ -2338,16 +2313,13 @@ int ocland_clGetEventProfilingInfo(int* clientfd, char* buffer, validator v, voi
     msgSize += sizeof(size_t);       // param_value_size_ret
     if(param_value)
         msgSize += param_value_size_ret; // param_value
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     ptr      = msg;
     ((cl_int*)ptr)[0]  = flag; ptr = (cl_int*)ptr + 1;
     ((size_t*)ptr)[0]  = param_value_size_ret;    ptr = (size_t*)ptr + 1;
     if(param_value)
         memcpy(ptr, param_value, param_value_size_ret);
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(param_value);param_value=NULL;
-    free(msg);msg=NULL;
+    Reply(clientfd, msg, msgSize);
     VERBOSE_OUT(flag);
     return 1;
 }
@@ -2360,29 +2332,25 @@ int ocland_clFlush(int* clientfd, char* buffer, validator v, void* data)
     size_t msgSize = 0;
     void *msg = NULL, *ptr = NULL;
     // Decript the received data
-    command_queue = ((cl_command_queue*)data)[0];
+    command_queue = (cl_command_queue)handleObject(v, ((cl_command_queue*)data)[0]);
     // Ensure that the command queue is valid
     flag = isQueue(v, command_queue);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);      // flag
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
     flag = clFlush(command_queue);
     // Return the package
     msgSize  = sizeof(cl_int);      // flag
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     ptr      = msg;
     ((cl_int*)ptr)[0]  = flag;
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(msg);msg=NULL;
+    Reply(clientfd, msg, msgSize);
     VERBOSE_OUT(flag);
     return 1;
 }
@@ -2390,78 +2358,34 @@ int ocland_clFlush(int* clientfd, char* buffer, validator v, void* data)
 int ocland_clFinish(int* clientfd, char* buffer, validator v, void* data)
 {
     VERBOSE_IN();
-    unsigned int i,j;
     cl_command_queue command_queue;
     cl_int flag;
     size_t msgSize = 0;
     void *msg = NULL, *ptr = NULL;
     // Decript the received data
-    command_queue = ((cl_command_queue*)data)[0];
+    command_queue = (cl_command_queue)handleObject(v, ((cl_command_queue*)data)[0]);
     // Ensure that the command queue is valid
     flag = isQueue(v, command_queue);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);      // flag
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
-    // Wait for all the ocland events associated to this command queue
-    cl_uint num_events = 0;
-    ocland_event *event_list = NULL;
-    for(i=0;i<v->num_events;i++){
-        if(v->events[i]->command_queue == command_queue)
-            num_events++;
-    }
-    if(num_events){
-        event_list = (ocland_event*)malloc(num_events*sizeof(ocland_event));
-        if(!event_list){
-            flag     = CL_OUT_OF_HOST_MEMORY;
-            msgSize  = sizeof(cl_int);         // flag
-            msg      = (void*)malloc(msgSize);
-            ptr      = msg;
-            ((cl_int*)ptr)[0]  = flag;
-            Send(clientfd, &msgSize, sizeof(size_t), 0);
-            Send(clientfd, msg, msgSize, 0);
-            free(msg);msg=NULL;
-            VERBOSE_OUT(flag);
-            return 1;
-        }
-        j = 0;
-        for(i=0;i<v->num_events;i++){
-            if(v->events[i]->command_queue == command_queue){
-                event_list[j] = v->events[i];
-                j++;
-            }
-        }
-        flag = oclandWaitForEvents(num_events, event_list);
-        if(flag != CL_SUCCESS){
-            flag     = 	CL_INVALID_COMMAND_QUEUE;
-            msgSize  = sizeof(cl_int);         // flag
-            msg      = (void*)malloc(msgSize);
-            ptr      = msg;
-            ((cl_int*)ptr)[0]  = flag;
-            Send(clientfd, &msgSize, sizeof(size_t), 0);
-            Send(clientfd, msg, msgSize, 0);
-            free(msg);msg=NULL;
-            VERBOSE_OUT(flag);
-            return 1;
-        }
-    }
+    // Wait for the ocland work in flight in this command queue (the
+    // network transfers)
+    oclandWaitForQueue(command_queue);
     // Wait for internal OpenCL works
     flag = clFinish(command_queue);
     // Return the package
     msgSize  = sizeof(cl_int);         // flag
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     ptr      = msg;
     ((cl_int*)ptr)[0]  = flag;
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(msg);msg=NULL;
+    Reply(clientfd, msg, msgSize);
     VERBOSE_OUT(flag);
     return 1;
 }
@@ -2485,8 +2409,8 @@ int ocland_clEnqueueReadBuffer(int* clientfd, char* buffer, validator v, void* d
     size_t msgSize = 0;
     void *msg = NULL, *mptr = NULL;
     // Decript the received data
-    command_queue = ((cl_command_queue*)data)[0];  data = (cl_command_queue*)data + 1;
-    memobj        = ((cl_mem*)data)[0];            data = (cl_mem*)data + 1;
+    command_queue = (cl_command_queue)handleObject(v, ((cl_command_queue*)data)[0]);  data = (cl_command_queue*)data + 1;
+    memobj        = (cl_mem)handleObject(v, ((cl_mem*)data)[0]);            data = (cl_mem*)data + 1;
     blocking_read = ((cl_bool*)data)[0];           data = (cl_bool*)data + 1;
     offset        = ((size_t*)data)[0];            data = (size_t*)data + 1;
     cb            = ((size_t*)data)[0];            data = (size_t*)data + 1;
@@ -2497,12 +2421,10 @@ int ocland_clEnqueueReadBuffer(int* clientfd, char* buffer, validator v, void* d
         if(!event_wait_list){
             flag     = CL_OUT_OF_HOST_MEMORY;
             msgSize  = sizeof(cl_int);
-            msg      = (void*)malloc(msgSize);
+            msg      = requestAlloc(msgSize);
             mptr      = msg;
             ((cl_int*)mptr)[0]  = flag;
-            Send(clientfd, &msgSize, sizeof(size_t), 0);
-            Send(clientfd, msg, msgSize, 0);
-            free(msg);msg=NULL;
+            Reply(clientfd, msg, msgSize);
             VERBOSE_OUT(flag);
             return 1;
         }
@@ -2512,12 +2434,10 @@ int ocland_clEnqueueReadBuffer(int* clientfd, char* buffer, validator v, void* d
     flag = isQueue(v, command_queue);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         mptr     = msg;
         ((cl_int*)mptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
         VERBOSE_OUT(flag);
         return 1;
@@ -2525,12 +2445,10 @@ int ocland_clEnqueueReadBuffer(int* clientfd, char* buffer, validator v, void* d
     flag = isBuffer(v, memobj);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         mptr     = msg;
         ((cl_int*)mptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
         VERBOSE_OUT(flag);
         return 1;
@@ -2539,12 +2457,10 @@ int ocland_clEnqueueReadBuffer(int* clientfd, char* buffer, validator v, void* d
         flag = isEvent(v, event_wait_list[i]);
         if(flag != CL_SUCCESS){
             msgSize  = sizeof(cl_int);
-            msg      = (void*)malloc(msgSize);
+            msg      = requestAlloc(msgSize);
             mptr     = msg;
             ((cl_int*)mptr)[0]  = flag;
-            Send(clientfd, &msgSize, sizeof(size_t), 0);
-            Send(clientfd, msg, msgSize, 0);
-            free(msg);msg=NULL;
+            Reply(clientfd, msg, msgSize);
             if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
             VERBOSE_OUT(flag);
             return 1;
@@ -2553,28 +2469,23 @@ int ocland_clEnqueueReadBuffer(int* clientfd, char* buffer, validator v, void* d
     flag = clGetCommandQueueInfo(command_queue, CL_QUEUE_CONTEXT, sizeof(cl_context), &context, NULL);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         mptr     = msg;
         ((cl_int*)mptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
         VERBOSE_OUT(flag);
         return 1;
     }
-    // Build required objects
-    ptr   = malloc(cb);
+    // Build required objects. The transfers stage the data by themselves
     event = (ocland_event)malloc(sizeof(struct _ocland_event));
-    if( (!ptr) || (!event) ){
+    if(!event){
         flag = CL_MEM_OBJECT_ALLOCATION_FAILURE;
         msgSize  = sizeof(cl_int);
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         mptr     = msg;
         ((cl_int*)mptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
         VERBOSE_OUT(flag);
         return 1;
@@ -2583,53 +2494,67 @@ int ocland_clEnqueueReadBuffer(int* clientfd, char* buffer, validator v, void* d
     event->status        = 1;
     event->context       = context;
     event->command_queue = command_queue;
+    event->refs          = 1;
     // ------------------------------------------------------------
     // Blocking read case:
-    // We simply call to the read method to get the data and
-    // send it to the client.
+    // We map the buffer and send the data to the client straight
+    // from the mapped memory. If the buffer can't be mapped we
+    // read it into a staging memory instead.
     // ------------------------------------------------------------
     if(blocking_read == CL_TRUE){
-        // We may wait manually for the events generated in
-        // ocland, and then we can let OpenCL to wait their
-        // self generated events.
-        if(num_events_in_wait_list){
-            oclandWaitForEvents(num_events_in_wait_list, event_wait_list);
-            free(event_wait_list); event_wait_list=NULL;
-        }
+        cl_bool mapped = CL_TRUE;
+        // All the ocland events have an OpenCL one associated, so we
+        // can let OpenCL to resolve the dependencies.
+        oclandGetEvents(num_events_in_wait_list, event_wait_list);
         // Read the data
-        flag = clEnqueueReadBuffer(command_queue,memobj,blocking_read,
-                                   offset,cb,ptr,
-                                   0,NULL,&(event->event));
+        ptr = clEnqueueMapBuffer(command_queue,memobj,CL_TRUE,CL_MAP_READ,
+                                 offset,cb,
+                                 num_events_in_wait_list,(cl_event*)event_wait_list,&(event->event),
+                                 &flag);
+        if(flag != CL_SUCCESS){
+            mapped = CL_FALSE;
+            event->event = NULL;
+            ptr  = malloc(cb);
+            flag = CL_MEM_OBJECT_ALLOCATION_FAILURE;
+            if(ptr){
+                flag = clEnqueueReadBuffer(command_queue,memobj,blocking_read,
+                                           offset,cb,ptr,
+                                           num_events_in_wait_list,(cl_event*)event_wait_list,&(event->event));
+            }
+        }
+        if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
         if(flag != CL_SUCCESS){
             msgSize  = sizeof(cl_int);
-            msg      = (void*)malloc(msgSize);
+            msg      = requestAlloc(msgSize);
             mptr     = msg;
             ((cl_int*)mptr)[0]  = flag;
-            Send(clientfd, &msgSize, sizeof(size_t), 0);
-            Send(clientfd, msg, msgSize, 0);
-            free(msg);msg=NULL;
+            Reply(clientfd, msg, msgSize);
             if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
             free(ptr); ptr=NULL;
             free(event); event=NULL;
             VERBOSE_OUT(flag);
             return 1;
         }
-        // Return the package
+        // Return the package, followed by the data without copying it
         msgSize  = sizeof(cl_int);          // flag
         msgSize += sizeof(ocland_event);    // event
-        msgSize += cb;                      // ptr
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         mptr     = msg;
         ((cl_int*)mptr)[0]       = flag;  mptr = (cl_int*)mptr + 1;
         ((ocland_event*)mptr)[0] = event; mptr = (ocland_event*)mptr + 1;
-        memcpy(mptr, ptr, cb);
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
-        free(ptr);ptr=NULL;
+        ReplyData(clientfd, msg, msgSize, ptr, cb);
+        if(mapped == CL_TRUE){
+            clEnqueueUnmapMemObject(command_queue,memobj,ptr,0,NULL,NULL);
+            clFlush(command_queue);
+        }
+        else{
+            free(ptr);
+        }
+        ptr=NULL;
         // Mark the work as done
         event->status = CL_COMPLETE;
         if(want_event != CL_TRUE){
+            clReleaseEvent(event->event);
             free(event); event = NULL;
         }
         else{
@@ -2643,17 +2568,15 @@ int ocland_clEnqueueReadBuffer(int* clientfd, char* buffer, validator v, void* d
     // We relay the complexz work to a submethod.
     // ------------------------------------------------------------
     flag = oclandEnqueueReadBuffer(clientfd,command_queue,memobj,
-                                   offset,cb,ptr,
+                                   offset,cb,
                                    num_events_in_wait_list,event_wait_list,
                                    want_event, event);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         mptr     = msg;
         ((cl_int*)mptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
         free(ptr); ptr=NULL;
         free(event); event=NULL;
@@ -2688,8 +2611,8 @@ int ocland_clEnqueueWriteBuffer(int* clientfd, char* buffer, validator v, void*
     size_t msgSize = 0;
     void *msg = NULL, *mptr = NULL;
     // Decript the received data
-    command_queue = ((cl_command_queue*)data)[0];  data = (cl_command_queue*)data + 1;
-    memobj        = ((cl_mem*)data)[0];            data = (cl_mem*)data + 1;
+    command_queue = (cl_command_queue)handleObject(v, ((cl_command_queue*)data)[0]);  data = (cl_command_queue*)data + 1;
+    memobj        = (cl_mem)handleObject(v, ((cl_mem*)data)[0]);            data = (cl_mem*)data + 1;
     blocking_write = ((cl_bool*)data)[0];           data = (cl_bool*)data + 1;
     offset        = ((size_t*)data)[0];            data = (size_t*)data + 1;
     cb            = ((size_t*)data)[0];            data = (size_t*)data + 1;
@@ -2700,12 +2623,10 @@ int ocland_clEnqueueWriteBuffer(int* clientfd, char* buffer, validator v, void*
         if(!event_wait_list){
             flag     = CL_OUT_OF_HOST_MEMORY;
             msgSize  = sizeof(cl_int);
-            msg      = (void*)malloc(msgSize);
+            msg      = requestAlloc(msgSize);
             mptr      = msg;
             ((cl_int*)mptr)[0]  = flag;
-            Send(clientfd, &msgSize, sizeof(size_t), 0);
-            Send(clientfd, msg, msgSize, 0);
-            free(msg);msg=NULL;
+            Reply(clientfd, msg, msgSize);
             VERBOSE_OUT(flag);
             return 1;
         }
@@ -2716,12 +2637,10 @@ int ocland_clEnqueueWriteBuffer(int* clientfd, char* buffer, validator v, void*
     flag = isQueue(v, command_queue);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         mptr     = msg;
         ((cl_int*)mptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
         VERBOSE_OUT(flag);
         return 1;
@@ -2729,12 +2648,10 @@ int ocland_clEnqueueWriteBuffer(int* clientfd, char* buffer, validator v, void*
     flag = isBuffer(v, memobj);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         mptr     = msg;
         ((cl_int*)mptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
         VERBOSE_OUT(flag);
         return 1;
@@ -2743,12 +2660,10 @@ int ocland_clEnqueueWriteBuffer(int* clientfd, char* buffer, validator v, void*
         flag = isEvent(v, event_wait_list[i]);
         if(flag != CL_SUCCESS){
             msgSize  = sizeof(cl_int);
-            msg      = (void*)malloc(msgSize);
+            msg      = requestAlloc(msgSize);
             mptr     = msg;
             ((cl_int*)mptr)[0]  = flag;
-            Send(clientfd, &msgSize, sizeof(size_t), 0);
-            Send(clientfd, msg, msgSize, 0);
-            free(msg);msg=NULL;
+            Reply(clientfd, msg, msgSize);
             if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
             VERBOSE_OUT(flag);
             return 1;
@@ -2757,29 +2672,29 @@ int ocland_clEnqueueWriteBuffer(int* clientfd, char* buffer, validator v, void*
     flag = clGetCommandQueueInfo(command_queue, CL_QUEUE_CONTEXT, sizeof(cl_context), &context, NULL);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         mptr     = msg;
         ((cl_int*)mptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
         VERBOSE_OUT(flag);
         return 1;
     }
-    // Build required objects
-    ptr   = malloc(cb);
+    // Build required objects. The asynchronous transfers stage the
+    // data in chunks by themselves
+    if(blocking_write == CL_TRUE)
+        ptr = malloc(cb);
     event = (ocland_event)malloc(sizeof(struct _ocland_event));
-    if( (!ptr) || (!event) ){
+    if( ((blocking_write == CL_TRUE) && (!ptr)) || (!event) ){
         flag = CL_MEM_OBJECT_ALLOCATION_FAILURE;
         msgSize  = sizeof(cl_int);
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         mptr     = msg;
         ((cl_int*)mptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
+        free(ptr); ptr=NULL;
+        free(event); event=NULL;
         VERBOSE_OUT(flag);
         return 1;
     }
@@ -2787,33 +2702,29 @@ int ocland_clEnqueueWriteBuffer(int* clientfd, char* buffer, validator v, void*
     event->status        = 1;
     event->context       = context;
     event->command_queue = command_queue;
+    event->refs          = 1;
     // ------------------------------------------------------------
     // Blocking write case:
     // We simply decript the data from the package received, and
     // call OpenCL to transfer the data.
     // ------------------------------------------------------------
     if(blocking_write == CL_TRUE){
-        // We may wait manually for the events generated in
-        // ocland, and then we can let OpenCL to wait their
-        // self generated events.
-        if(num_events_in_wait_list){
-            oclandWaitForEvents(num_events_in_wait_list, event_wait_list);
-            free(event_wait_list); event_wait_list=NULL;
-        }
+        // All the ocland events have an OpenCL one associated, so we
+        // can let OpenCL to resolve the dependencies.
+        oclandGetEvents(num_events_in_wait_list, event_wait_list);
         // Decript the data from the received package
         memcpy(ptr, data, cb);
         // Write the data
         flag = clEnqueueWriteBuffer(command_queue,memobj,blocking_write,
                                    offset,cb,ptr,
-                                   0,NULL,&(event->event));
+                                   num_events_in_wait_list,(cl_event*)event_wait_list,&(event->event));
+        if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
         if(flag != CL_SUCCESS){
             msgSize  = sizeof(cl_int);
-            msg      = (void*)malloc(msgSize);
+            msg      = requestAlloc(msgSize);
             mptr     = msg;
             ((cl_int*)mptr)[0]  = flag;
-            Send(clientfd, &msgSize, sizeof(size_t), 0);
-            Send(clientfd, msg, msgSize, 0);
-            free(msg);msg=NULL;
+            Reply(clientfd, msg, msgSize);
             if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
             free(ptr); ptr=NULL;
             free(event); event=NULL;
@@ -2823,18 +2734,17 @@ int ocland_clEnqueueWriteBuffer(int* clientfd, char* buffer, validator v, void*
         // Return the package
         msgSize  = sizeof(cl_int);          // flag
         msgSize += sizeof(ocland_event);    // event
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         mptr     = msg;
         ((cl_int*)mptr)[0]       = flag;  mptr = (cl_int*)mptr + 1;
         ((ocland_event*)mptr)[0] = event; mptr = (ocland_event*)mptr + 1;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
         free(ptr); ptr=NULL;
         // Mark the work as done
         event->status = CL_COMPLETE;
         if(want_event != CL_TRUE){
+            clReleaseEvent(event->event);
             free(event); event = NULL;
         }
         else{
@@ -2848,17 +2758,15 @@ int ocland_clEnqueueWriteBuffer(int* clientfd, char* buffer, validator v, void*
     // We relay the complex work to a submethod.
     // ------------------------------------------------------------
     flag = oclandEnqueueWriteBuffer(clientfd,command_queue,memobj,
-                                    offset,cb,ptr,
+                                    offset,cb,
                                     num_events_in_wait_list,event_wait_list,
                                     want_event, event);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         mptr     = msg;
         ((cl_int*)mptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
         free(ptr); ptr=NULL;
         free(event); event=NULL;
@@ -2893,25 +2801,23 @@ int ocland_clEnqueueCopyBuffer(int* clientfd, char* buffer, validator v, void* d
     size_t msgSize = 0;
     void *msg = NULL, *mptr = NULL;
     // Decript the received data
-    command_queue = ((cl_command_queue*)data)[0];  data = (cl_command_queue*)data + 1;
-    src_buffer    = ((cl_mem*)data)[0];            data = (cl_mem*)data + 1;
-    dst_buffer    = ((cl_mem*)data)[0];            data = (cl_mem*)data + 1;
+    command_queue = (cl_command_queue)handleObject(v, ((cl_command_queue*)data)[0]);  data = (cl_command_queue*)data + 1;
+    src_buffer    = (cl_mem)handleObject(v, ((cl_mem*)data)[0]);            data = (cl_mem*)data + 1;
+    dst_buffer    = (cl_mem)handleObject(v, ((cl_mem*)data)[0]);            data = (cl_mem*)data + 1;
     src_offset    = ((size_t*)data)[0];            data = (size_t*)data + 1;
     dst_offset    = ((size_t*)data)[0];            data = (size_t*)data + 1;
     cb            = ((size_t*)data)[0];            data = (size_t*)data + 1;
     want_event    = ((cl_bool*)data)[0];           data = (cl_bool*)data + 1;
     num_events_in_wait_list = ((cl_uint*)data)[0]; data = (cl_uint*)data + 1;
     if(num_events_in_wait_list){
-        event_wait_list = (ocland_event*)malloc(num_events_in_wait_list * sizeof(ocland_event));
+        event_wait_list = (ocland_event*)requestAlloc(num_events_in_wait_list * sizeof(ocland_event));
         if(!event_wait_list){
             flag     = CL_OUT_OF_HOST_MEMORY;
             msgSize  = sizeof(cl_int);
-            msg      = (void*)malloc(msgSize);
+            msg      = requestAlloc(msgSize);
             mptr      = msg;
             ((cl_int*)mptr)[0]  = flag;
-            Send(clientfd, &msgSize, sizeof(size_t), 0);
-            Send(clientfd, msg, msgSize, 0);
-            free(msg);msg=NULL;
+            Reply(clientfd, msg, msgSize);
             VERBOSE_OUT(flag);
             return 1;
         }
@@ -2921,13 +2827,10 @@ int ocland_clEnqueueCopyBuffer(int* clientfd, char* buffer, validator v, void* d
     flag = isQueue(v, command_queue);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         mptr     = msg;
         ((cl_int*)mptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
-        if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
@@ -2935,13 +2838,10 @@ int ocland_clEnqueueCopyBuffer(int* clientfd, char* buffer, validator v, void* d
     flag |= isBuffer(v, dst_buffer);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         mptr     = msg;
         ((cl_int*)mptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
-        if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
@@ -2949,21 +2849,17 @@ int ocland_clEnqueueCopyBuffer(int* clientfd, char* buffer, validator v, void* d
         flag = isEvent(v, event_wait_list[i]);
         if(flag != CL_SUCCESS){
             msgSize  = sizeof(cl_int);
-            msg      = (void*)malloc(msgSize);
+            msg      = requestAlloc(msgSize);
             mptr     = msg;
             ((cl_int*)mptr)[0]  = flag;
-            Send(clientfd, &msgSize, sizeof(size_t), 0);
-            Send(clientfd, msg, msgSize, 0);
-            free(msg);msg=NULL;
-            if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
+            Reply(clientfd, msg, msgSize);
             VERBOSE_OUT(flag);
             return 1;
         }
     }
     flag = clGetCommandQueueInfo(command_queue, CL_QUEUE_CONTEXT, sizeof(cl_context), &context, NULL);
     if(flag != CL_SUCCESS){
-        Send(clientfd, &flag, sizeof(cl_int), 0);
-        if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
+        Reply(clientfd, &flag, sizeof(cl_int));
         VERBOSE_OUT(flag);
         return 1;
     }
@@ -2972,13 +2868,10 @@ int ocland_clEnqueueCopyBuffer(int* clientfd, char* buffer, validator v, void* d
     if( !event ){
         flag     = CL_OUT_OF_HOST_MEMORY;
         msgSize  = sizeof(cl_int);
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         mptr     = msg;
         ((cl_int*)mptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
-        if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
@@ -2986,26 +2879,20 @@ int ocland_clEnqueueCopyBuffer(int* clientfd, char* buffer, validator v, void* d
     event->status        = 1;
     event->context       = context;
     event->command_queue = command_queue;
-    // We may wait manually for the events generated in
-    // ocland, and then we can let OpenCL to wait their
-    // self generated events.
-    if(num_events_in_wait_list){
-        oclandWaitForEvents(num_events_in_wait_list, event_wait_list);
-        free(event_wait_list); event_wait_list=NULL;
-    }
+    event->refs          = 1;
+    // All the ocland events have an OpenCL one associated, so we
+    // can let OpenCL to resolve the dependencies.
+    oclandGetEvents(num_events_in_wait_list, event_wait_list);
     // Write the data
     flag = clEnqueueCopyBuffer(command_queue,src_buffer,dst_buffer,
                                src_offset,dst_offset,cb,
-                               0,NULL,&(event->event));
+                               num_events_in_wait_list,(cl_event*)event_wait_list,&(event->event));
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         mptr     = msg;
         ((cl_int*)mptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
-        if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
+        Reply(clientfd, msg, msgSize);
         free(event); event=NULL;
         VERBOSE_OUT(flag);
         return 1;
@@ -3013,17 +2900,15 @@ int ocland_clEnqueueCopyBuffer(int* clientfd, char* buffer, validator v, void* d
     // Return the package
     msgSize  = sizeof(cl_int);          // flag
     msgSize += sizeof(ocland_event);    // event
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     mptr     = msg;
     ((cl_int*)mptr)[0]       = flag;  mptr = (cl_int*)mptr + 1;
     ((ocland_event*)mptr)[0] = event; mptr = (ocland_event*)mptr + 1;
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(msg);msg=NULL;
-    if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
+    Reply(clientfd, msg, msgSize);
     // Mark the work as done
     event->status = CL_COMPLETE;
     if(want_event != CL_TRUE){
+        clReleaseEvent(event->event);
         free(event); event = NULL;
     }
     else{
@@ -3052,25 +2937,23 @@ int ocland_clEnqueueCopyImage(int* clientfd, char* buffer, validator v, void* da
     size_t msgSize = 0;
     void *msg = NULL, *mptr = NULL;
     // Decript the received data
-    command_queue = ((cl_command_queue*)data)[0];  data = (cl_command_queue*)data + 1;
-    src_image     = ((cl_mem*)data)[0];            data = (cl_mem*)data + 1;
-    dst_image     = ((cl_mem*)data)[0];            data = (cl_mem*)data + 1;
+    command_queue = (cl_command_queue)handleObject(v, ((cl_command_queue*)data)[0]);  data = (cl_command_queue*)data + 1;
+    src_image     = (cl_mem)handleObject(v, ((cl_mem*)data)[0]);            data = (cl_mem*)data + 1;
+    dst_image     = (cl_mem)handleObject(v, ((cl_mem*)data)[0]);            data = (cl_mem*)data + 1;
     memcpy(src_origin, data, 3*sizeof(size_t));    data = (size_t*)data + 3;
     memcpy(dst_origin, data, 3*sizeof(size_t));    data = (size_t*)data + 3;
     memcpy(region,     data, 3*sizeof(size_t));    data = (size_t*)data + 3;
     want_event    = ((cl_bool*)data)[0];           data = (cl_bool*)data + 1;
     num_events_in_wait_list = ((cl_uint*)data)[0]; data = (cl_uint*)data + 1;
     if(num_events_in_wait_list){
-        event_wait_list = (ocland_event*)malloc(num_events_in_wait_list * sizeof(ocland_event));
+        event_wait_list = (ocland_event*)requestAlloc(num_events_in_wait_list * sizeof(ocland_event));
         if(!event_wait_list){
             flag     = CL_OUT_OF_HOST_MEMORY;
             msgSize  = sizeof(cl_int);
-            msg      = (void*)malloc(msgSize);
+            msg      = requestAlloc(msgSize);
             mptr      = msg;
             ((cl_int*)mptr)[0]  = flag;
-            Send(clientfd, &msgSize, sizeof(size_t), 0);
-            Send(clientfd, msg, msgSize, 0);
-            free(msg);msg=NULL;
+            Reply(clientfd, msg, msgSize);
             VERBOSE_OUT(flag);
             return 1;
         }
@@ -3080,13 +2963,10 @@ int ocland_clEnqueueCopyImage(int* clientfd, char* buffer, validator v, void* da
     flag = isQueue(v, command_queue);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         mptr     = msg;
         ((cl_int*)mptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
-        if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
@@ -3094,13 +2974,10 @@ int ocland_clEnqueueCopyImage(int* clientfd, char* buffer, validator v, void* da
     flag |= isBuffer(v, dst_image);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         mptr     = msg;
         ((cl_int*)mptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
-        if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
@@ -3108,13 +2985,10 @@ int ocland_clEnqueueCopyImage(int* clientfd, char* buffer, validator v, void* da
         flag = isEvent(v, event_wait_list[i]);
         if(flag != CL_SUCCESS){
             msgSize  = sizeof(cl_int);
-            msg      = (void*)malloc(msgSize);
+            msg      = requestAlloc(msgSize);
             mptr     = msg;
             ((cl_int*)mptr)[0]  = flag;
-            Send(clientfd, &msgSize, sizeof(size_t), 0);
-            Send(clientfd, msg, msgSize, 0);
-            free(msg);msg=NULL;
-            if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
+            Reply(clientfd, msg, msgSize);
             VERBOSE_OUT(flag);
             return 1;
         }
@@ -3122,13 +2996,10 @@ int ocland_clEnqueueCopyImage(int* clientfd, char* buffer, validator v, void* da
     flag = clGetCommandQueueInfo(command_queue, CL_QUEUE_CONTEXT, sizeof(cl_context), &context, NULL);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         mptr     = msg;
         ((cl_int*)mptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
-        if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
@@ -3137,13 +3008,10 @@ int ocland_clEnqueueCopyImage(int* clientfd, char* buffer, validator v, void* da
     if( !event ){
         flag     = CL_OUT_OF_HOST_MEMORY;
         msgSize  = sizeof(cl_int);
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         mptr     = msg;
         ((cl_int*)mptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
-        if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
@@ -3151,26 +3019,20 @@ int ocland_clEnqueueCopyImage(int* clientfd, char* buffer, validator v, void* da
     event->status        = 1;
     event->context       = context;
     event->command_queue = command_queue;
-    // We may wait manually for the events generated in
-    // ocland, and then we can let OpenCL to wait their
-    // self generated events.
-    if(num_events_in_wait_list){
-        oclandWaitForEvents(num_events_in_wait_list, event_wait_list);
-        free(event_wait_list); event_wait_list=NULL;
-    }
+    event->refs          = 1;
+    // All the ocland events have an OpenCL one associated, so we
+    // can let OpenCL to resolve the dependencies.
+    oclandGetEvents(num_events_in_wait_list, event_wait_list);
     // Write the data
     flag = clEnqueueCopyImage(command_queue,src_image,dst_image,
                               src_origin,dst_origin,region,
-                              0,NULL,&(event->event));
+                              num_events_in_wait_list,(cl_event*)event_wait_list,&(event->event));
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         mptr     = msg;
         ((cl_int*)mptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
-        if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
+        Reply(clientfd, msg, msgSize);
         free(event); event=NULL;
         VERBOSE_OUT(flag);
         return 1;
@@ -3178,17 +3040,15 @@ int ocland_clEnqueueCopyImage(int* clientfd, char* buffer, validator v, void* da
     // Return the package
     msgSize  = sizeof(cl_int);          // flag
     msgSize += sizeof(ocland_event);    // event
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     mptr     = msg;
     ((cl_int*)mptr)[0]       = flag;  mptr = (cl_int*)mptr + 1;
     ((ocland_event*)mptr)[0] = event; mptr = (ocland_event*)mptr + 1;
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(msg);msg=NULL;
-    if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
+    Reply(clientfd, msg, msgSize);
     // Mark the work as done
     event->status = CL_COMPLETE;
     if(want_event != CL_TRUE){
+        clReleaseEvent(event->event);
         free(event); event = NULL;
     }
     else{
@@ -3217,25 +3077,23 @@ int ocland_clEnqueueCopyImageToBuffer(int* clientfd, char* buffer, validator v,
     size_t msgSize = 0;
     void *msg = NULL, *mptr = NULL;
     // Decript the received data
-    command_queue = ((cl_command_queue*)data)[0];  data = (cl_command_queue*)data + 1;
-    src_image     = ((cl_mem*)data)[0];            data = (cl_mem*)data + 1;
-    dst_buffer    = ((cl_mem*)data)[0];            data = (cl_mem*)data + 1;
+    command_queue = (cl_command_queue)handleObject(v, ((cl_command_queue*)data)[0]);  data = (cl_command_queue*)data + 1;
+    src_image     = (cl_mem)handleObject(v, ((cl_mem*)data)[0]);            data = (cl_mem*)data + 1;
+    dst_buffer    = (cl_mem)handleObject(v, ((cl_mem*)data)[0]);            data = (cl_mem*)data + 1;
     memcpy(src_origin, data, 3*sizeof(size_t));    data = (size_t*)data + 3;
     memcpy(region,     data, 3*sizeof(size_t));    data = (size_t*)data + 3;
     dst_offset    = ((size_t*)data)[0];            data = (size_t*)data + 1;
     want_event    = ((cl_bool*)data)[0];           data = (cl_bool*)data + 1;
     num_events_in_wait_list = ((cl_uint*)data)[0]; data = (cl_uint*)data + 1;
     if(num_events_in_wait_list){
-        event_wait_list = (ocland_event*)malloc(num_events_in_wait_list * sizeof(ocland_event));
+        event_wait_list = (ocland_event*)requestAlloc(num_events_in_wait_list * sizeof(ocland_event));
         if(!event_wait_list){
             flag     = CL_OUT_OF_HOST_MEMORY;
             msgSize  = sizeof(cl_int);
-            msg      = (void*)malloc(msgSize);
+            msg      = requestAlloc(msgSize);
             mptr      = msg;
             ((cl_int*)mptr)[0]  = flag;
-            Send(clientfd, &msgSize, sizeof(size_t), 0);
-            Send(clientfd, msg, msgSize, 0);
-            free(msg);msg=NULL;
+            Reply(clientfd, msg, msgSize);
             VERBOSE_OUT(flag);
             return 1;
         }
@@ -3245,13 +3103,10 @@ int ocland_clEnqueueCopyImageToBuffer(int* clientfd, char* buffer, validator v,
     flag = isQueue(v, command_queue);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         mptr     = msg;
         ((cl_int*)mptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
-        if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
@@ -3259,13 +3114,10 @@ int ocland_clEnqueueCopyImageToBuffer(int* clientfd, char* buffer, validator v,
     flag |= isBuffer(v, dst_buffer);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         mptr     = msg;
         ((cl_int*)mptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
-        if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
@@ -3273,13 +3125,10 @@ int ocland_clEnqueueCopyImageToBuffer(int* clientfd, char* buffer, validator v,
         flag = isEvent(v, event_wait_list[i]);
         if(flag != CL_SUCCESS){
             msgSize  = sizeof(cl_int);
-            msg      = (void*)malloc(msgSize);
+            msg      = requestAlloc(msgSize);
             mptr     = msg;
             ((cl_int*)mptr)[0]  = flag;
-            Send(clientfd, &msgSize, sizeof(size_t), 0);
-            Send(clientfd, msg, msgSize, 0);
-            free(msg);msg=NULL;
-            if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
+            Reply(clientfd, msg, msgSize);
             VERBOSE_OUT(flag);
             return 1;
         }
@@ -3287,13 +3136,10 @@ int ocland_clEnqueueCopyImageToBuffer(int* clientfd, char* buffer, validator v,
     flag = clGetCommandQueueInfo(command_queue, CL_QUEUE_CONTEXT, sizeof(cl_context), &context, NULL);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         mptr     = msg;
         ((cl_int*)mptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
-        if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
@@ -3302,13 +3148,10 @@ int ocland_clEnqueueCopyImageToBuffer(int* clientfd, char* buffer, validator v,
     if( !event ){
         flag     = CL_OUT_OF_HOST_MEMORY;
         msgSize  = sizeof(cl_int);
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         mptr     = msg;
         ((cl_int*)mptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
-        if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
@@ -3316,26 +3159,20 @@ int ocland_clEnqueueCopyImageToBuffer(int* clientfd, char* buffer, validator v,
     event->status        = 1;
     event->context       = context;
     event->command_queue = command_queue;
-    // We may wait manually for the events generated in
-    // ocland, and then we can let OpenCL to wait their
-    // self generated events.
-    if(num_events_in_wait_list){
-        oclandWaitForEvents(num_events_in_wait_list, event_wait_list);
-        free(event_wait_list); event_wait_list=NULL;
-    }
+    event->refs          = 1;
+    // All the ocland events have an OpenCL one associated, so we
+    // can let OpenCL to resolve the dependencies.
+    oclandGetEvents(num_events_in_wait_list, event_wait_list);
     // Write the data
     flag = clEnqueueCopyImageToBuffer(command_queue,src_image,dst_buffer,
                               src_origin,region,dst_offset,
-                              0,NULL,&(event->event));
+                              num_events_in_wait_list,(cl_event*)event_wait_list,&(event->event));
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         mptr     = msg;
         ((cl_int*)mptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
-        if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
+        Reply(clientfd, msg, msgSize);
         free(event); event=NULL;
         VERBOSE_OUT(flag);
         return 1;
@@ -3343,17 +3180,15 @@ int ocland_clEnqueueCopyImageToBuffer(int* clientfd, char* buffer, validator v,
     // Return the package
     msgSize  = sizeof(cl_int);          // flag
     msgSize += sizeof(ocland_event);    // event
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     mptr     = msg;
     ((cl_int*)mptr)[0]       = flag;  mptr = (cl_int*)mptr + 1;
     ((ocland_event*)mptr)[0] = event; mptr = (ocland_event*)mptr + 1;
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(msg);msg=NULL;
-    if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
+    Reply(clientfd, msg, msgSize);
     // Mark the work as done
     event->status = CL_COMPLETE;
     if(want_event != CL_TRUE){
+        clReleaseEvent(event->event);
         free(event); event = NULL;
     }
     else{
@@ -3382,25 +3217,23 @@ int ocland_clEnqueueCopyBufferToImage(int* clientfd, char* buffer, validator v,
     size_t msgSize = 0;
     void *msg = NULL, *mptr = NULL;
     // Decript the received data
-    command_queue = ((cl_command_queue*)data)[0];  data = (cl_command_queue*)data + 1;
-    src_buffer    = ((cl_mem*)data)[0];            data = (cl_mem*)data + 1;
-    dst_image     = ((cl_mem*)data)[0];            data = (cl_mem*)data + 1;
+    command_queue = (cl_command_queue)handleObject(v, ((cl_command_queue*)data)[0]);  data = (cl_command_queue*)data + 1;
+    src_buffer    = (cl_mem)handleObject(v, ((cl_mem*)data)[0]);            data = (cl_mem*)data + 1;
+    dst_image     = (cl_mem)handleObject(v, ((cl_mem*)data)[0]);            data = (cl_mem*)data + 1;
     src_offset    = ((size_t*)data)[0];            data = (size_t*)data + 1;
     memcpy(dst_origin, data, 3*sizeof(size_t));    data = (size_t*)data + 3;
     memcpy(region,     data, 3*sizeof(size_t));    data = (size_t*)data + 3;
     want_event    = ((cl_bool*)data)[0];           data = (cl_bool*)data + 1;
     num_events_in_wait_list = ((cl_uint*)data)[0]; data = (cl_uint*)data + 1;
     if(num_events_in_wait_list){
-        event_wait_list = (ocland_event*)malloc(num_events_in_wait_list * sizeof(ocland_event));
+        event_wait_list = (ocland_event*)requestAlloc(num_events_in_wait_list * sizeof(ocland_event));
         if(!event_wait_list){
             flag     = CL_OUT_OF_HOST_MEMORY;
             msgSize  = sizeof(cl_int);
-            msg      = (void*)malloc(msgSize);
+            msg      = requestAlloc(msgSize);
             mptr      = msg;
             ((cl_int*)mptr)[0]  = flag;
-            Send(clientfd, &msgSize, sizeof(size_t), 0);
-            Send(clientfd, msg, msgSize, 0);
-            free(msg);msg=NULL;
+            Reply(clientfd, msg, msgSize);
             VERBOSE_OUT(flag);
             return 1;
         }
@@ -3410,13 +3243,10 @@ int ocland_clEnqueueCopyBufferToImage(int* clientfd, char* buffer, validator v,
     flag = isQueue(v, command_queue);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         mptr     = msg;
         ((cl_int*)mptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
-        if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
@@ -3424,13 +3254,10 @@ int ocland_clEnqueueCopyBufferToImage(int* clientfd, char* buffer, validator v,
     flag |= isBuffer(v, dst_image);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         mptr     = msg;
         ((cl_int*)mptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
-        if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
@@ -3438,13 +3265,10 @@ int ocland_clEnqueueCopyBufferToImage(int* clientfd, char* buffer, validator v,
         flag = isEvent(v, event_wait_list[i]);
         if(flag != CL_SUCCESS){
             msgSize  = sizeof(cl_int);
-            msg      = (void*)malloc(msgSize);
+            msg      = requestAlloc(msgSize);
             mptr     = msg;
             ((cl_int*)mptr)[0]  = flag;
-            Send(clientfd, &msgSize, sizeof(size_t), 0);
-            Send(clientfd, msg, msgSize, 0);
-            free(msg);msg=NULL;
-            if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
+            Reply(clientfd, msg, msgSize);
             VERBOSE_OUT(flag);
             return 1;
         }
@@ -3452,13 +3276,10 @@ int ocland_clEnqueueCopyBufferToImage(int* clientfd, char* buffer, validator v,
     flag = clGetCommandQueueInfo(command_queue, CL_QUEUE_CONTEXT, sizeof(cl_context), &context, NULL);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         mptr     = msg;
         ((cl_int*)mptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
-        if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
@@ -3467,13 +3288,10 @@ int ocland_clEnqueueCopyBufferToImage(int* clientfd, char* buffer, validator v,
     if( !event ){
         flag     = CL_OUT_OF_HOST_MEMORY;
         msgSize  = sizeof(cl_int);
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         mptr     = msg;
         ((cl_int*)mptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
-        if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
@@ -3481,26 +3299,20 @@ int ocland_clEnqueueCopyBufferToImage(int* clientfd, char* buffer, validator v,
     event->status        = 1;
     event->context       = context;
     event->command_queue = command_queue;
-    // We may wait manually for the events generated in
-    // ocland, and then we can let OpenCL to wait their
-    // self generated events.
-    if(num_events_in_wait_list){
-        oclandWaitForEvents(num_events_in_wait_list, event_wait_list);
-        free(event_wait_list); event_wait_list=NULL;
-    }
+    event->refs          = 1;
+    // All the ocland events have an OpenCL one associated, so we
+    // can let OpenCL to resolve the dependencies.
+    oclandGetEvents(num_events_in_wait_list, event_wait_list);
     // Write the data
     flag = clEnqueueCopyImageToBuffer(command_queue,src_buffer,dst_image,
                                       src_offset,dst_origin,region,
-                                      0,NULL,&(event->event));
+                                      num_events_in_wait_list,(cl_event*)event_wait_list,&(event->event));
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         mptr     = msg;
         ((cl_int*)mptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
-        if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
+        Reply(clientfd, msg, msgSize);
         free(event); event=NULL;
         VERBOSE_OUT(flag);
         return 1;
@@ -3508,17 +3320,15 @@ int ocland_clEnqueueCopyBufferToImage(int* clientfd, char* buffer, validator v,
     // Return the package
     msgSize  = sizeof(cl_int);          // flag
     msgSize += sizeof(ocland_event);    // event
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     mptr     = msg;
     ((cl_int*)mptr)[0]       = flag;  mptr = (cl_int*)mptr + 1;
     ((ocland_event*)mptr)[0] = event; mptr = (ocland_event*)mptr + 1;
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(msg);msg=NULL;
-    if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
+    Reply(clientfd, msg, msgSize);
     // Mark the work as done
     event->status = CL_COMPLETE;
     if(want_event != CL_TRUE){
+        clReleaseEvent(event->event);
         free(event); event = NULL;
     }
     else{
@@ -3549,54 +3359,48 @@ int ocland_clEnqueueNDRangeKernel(int* clientfd, char* buffer, validator v, void
     size_t msgSize = 0;
     void *msg = NULL, *mptr = NULL;
     // Decript the received data
-    command_queue = ((cl_command_queue*)data)[0];  data = (cl_command_queue*)data + 1;
-    kernel        = ((cl_kernel*)data)[0];         data = (cl_kernel*)data + 1;
+    command_queue = (cl_command_queue)handleObject(v, ((cl_command_queue*)data)[0]);  data = (cl_command_queue*)data + 1;
+    kernel        = (cl_kernel)handleObject(v, ((cl_kernel*)data)[0]);         data = (cl_kernel*)data + 1;
     work_dim      = ((cl_uint*)data)[0];           data = (cl_uint*)data + 1;
     has_global_work_offset = ((cl_bool*)data)[0];  data = (cl_bool*)data + 1;
     has_local_work_size    = ((cl_bool*)data)[0];  data = (cl_bool*)data + 1;
     if(has_global_work_offset == CL_TRUE){
-        global_work_offset = (size_t*)malloc(work_dim * sizeof(size_t));
+        global_work_offset = (size_t*)requestAlloc(work_dim * sizeof(size_t));
         if(!global_work_offset){
             flag     = CL_OUT_OF_HOST_MEMORY;
             msgSize  = sizeof(cl_int);
-            msg      = (void*)malloc(msgSize);
+            msg      = requestAlloc(msgSize);
             mptr      = msg;
             ((cl_int*)mptr)[0]  = flag;
-            Send(clientfd, &msgSize, sizeof(size_t), 0);
-            Send(clientfd, msg, msgSize, 0);
-            free(msg);msg=NULL;
+            Reply(clientfd, msg, msgSize);
             VERBOSE_OUT(flag);
             return 1;
         }
         memcpy(global_work_offset, data, work_dim * sizeof(size_t));
         data = (size_t*)data + work_dim;
     }
-    global_work_size = (size_t*)malloc(work_dim * sizeof(size_t));
+    global_work_size = (size_t*)requestAlloc(work_dim * sizeof(size_t));
     if(!global_work_size){
         flag     = CL_OUT_OF_HOST_MEMORY;
         msgSize  = sizeof(cl_int);
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         mptr      = msg;
         ((cl_int*)mptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
     memcpy(global_work_size, data, work_dim * sizeof(size_t));
     data = (size_t*)data + work_dim;
     if(has_local_work_size == CL_TRUE){
-        local_work_size = (size_t*)malloc(work_dim * sizeof(size_t));
+        local_work_size = (size_t*)requestAlloc(work_dim * sizeof(size_t));
         if(!local_work_size){
             flag     = CL_OUT_OF_HOST_MEMORY;
             msgSize  = sizeof(cl_int);
-            msg      = (void*)malloc(msgSize);
+            msg      = requestAlloc(msgSize);
             mptr      = msg;
             ((cl_int*)mptr)[0]  = flag;
-            Send(clientfd, &msgSize, sizeof(size_t), 0);
-            Send(clientfd, msg, msgSize, 0);
-            free(msg);msg=NULL;
+            Reply(clientfd, msg, msgSize);
             VERBOSE_OUT(flag);
             return 1;
         }
@@ -3606,16 +3410,14 @@ int ocland_clEnqueueNDRangeKernel(int* clientfd, char* buffer, validator v, void
     want_event    = ((cl_bool*)data)[0];           data = (cl_bool*)data + 1;
     num_events_in_wait_list = ((cl_uint*)data)[0]; data = (cl_uint*)data + 1;
     if(num_events_in_wait_list){
-        event_wait_list = (ocland_event*)malloc(num_events_in_wait_list * sizeof(ocland_event));
+        event_wait_list = (ocland_event*)requestAlloc(num_events_in_wait_list * sizeof(ocland_event));
         if(!event_wait_list){
             flag     = CL_OUT_OF_HOST_MEMORY;
             msgSize  = sizeof(cl_int);
-            msg      = (void*)malloc(msgSize);
+            msg      = requestAlloc(msgSize);
             mptr      = msg;
             ((cl_int*)mptr)[0]  = flag;
-            Send(clientfd, &msgSize, sizeof(size_t), 0);
-            Send(clientfd, msg, msgSize, 0);
-            free(msg);msg=NULL;
+            Reply(clientfd, msg, msgSize);
             VERBOSE_OUT(flag);
             return 1;
         }
@@ -3625,26 +3427,20 @@ int ocland_clEnqueueNDRangeKernel(int* clientfd, char* buffer, validator v, void
     flag = isQueue(v, command_queue);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         mptr     = msg;
         ((cl_int*)mptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
-        if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
     flag  = isKernel(v, kernel);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         mptr     = msg;
         ((cl_int*)mptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
-        if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
@@ -3652,13 +3448,10 @@ int ocland_clEnqueueNDRangeKernel(int* clientfd, char* buffer, validator v, void
         flag = isEvent(v, event_wait_list[i]);
         if(flag != CL_SUCCESS){
             msgSize  = sizeof(cl_int);
-            msg      = (void*)malloc(msgSize);
+            msg      = requestAlloc(msgSize);
             mptr     = msg;
             ((cl_int*)mptr)[0]  = flag;
-            Send(clientfd, &msgSize, sizeof(size_t), 0);
-            Send(clientfd, msg, msgSize, 0);
-            free(msg);msg=NULL;
-            if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
+            Reply(clientfd, msg, msgSize);
             VERBOSE_OUT(flag);
             return 1;
         }
@@ -3666,13 +3459,10 @@ int ocland_clEnqueueNDRangeKernel(int* clientfd, char* buffer, validator v, void
     flag = clGetCommandQueueInfo(command_queue, CL_QUEUE_CONTEXT, sizeof(cl_context), &context, NULL);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         mptr     = msg;
         ((cl_int*)mptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
-        if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
@@ -3681,13 +3471,10 @@ int ocland_clEnqueueNDRangeKernel(int* clientfd, char* buffer, validator v, void
     if( !event ){
         flag     = CL_OUT_OF_HOST_MEMORY;
         msgSize  = sizeof(cl_int);
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         mptr     = msg;
         ((cl_int*)mptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
-        if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
@@ -3695,26 +3482,20 @@ int ocland_clEnqueueNDRangeKernel(int* clientfd, char* buffer, validator v, void
     event->status        = 1;
     event->context       = context;
     event->command_queue = command_queue;
-    // We may wait manually for the events generated in
-    // ocland, and then we can let OpenCL to wait their
-    // self generated events.
-    if(num_events_in_wait_list){
-        oclandWaitForEvents(num_events_in_wait_list, event_wait_list);
-        free(event_wait_list); event_wait_list=NULL;
-    }
+    event->refs          = 1;
+    // All the ocland events have an OpenCL one associated, so we
+    // can let OpenCL to resolve the dependencies.
+    oclandGetEvents(num_events_in_wait_list, event_wait_list);
     // Write the data
     flag = clEnqueueNDRangeKernel(command_queue,kernel,work_dim,
                                   global_work_offset,global_work_size,local_work_size,
-                                  0,NULL,&(event->event));
+                                  num_events_in_wait_list,(cl_event*)event_wait_list,&(event->event));
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         mptr     = msg;
         ((cl_int*)mptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
-        if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
+        Reply(clientfd, msg, msgSize);
         free(event); event=NULL;
         VERBOSE_OUT(flag);
         return 1;
@@ -3722,17 +3503,15 @@ int ocland_clEnqueueNDRangeKernel(int* clientfd, char* buffer, validator v, void
     // Return the package
     msgSize  = sizeof(cl_int);          // flag
     msgSize += sizeof(ocland_event);    // event
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     mptr     = msg;
     ((cl_int*)mptr)[0]       = flag;  mptr = (cl_int*)mptr + 1;
     ((ocland_event*)mptr)[0] = event; mptr = (ocland_event*)mptr + 1;
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(msg);msg=NULL;
-    if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
+    Reply(clientfd, msg, msgSize);
     // Mark the work as done
     event->status = CL_COMPLETE;
     if(want_event != CL_TRUE){
+        clReleaseEvent(event->event);
         free(event); event = NULL;
     }
     else{
@@ -3763,8 +3542,8 @@ int ocland_clEnqueueReadImage(int* clientfd, char* buffer, validator v, void* da
     size_t msgSize = 0;
     void *msg = NULL, *mptr = NULL;
     // Decript the received data
-    command_queue = ((cl_command_queue*)data)[0];  data = (cl_command_queue*)data + 1;
-    memobj        = ((cl_mem*)data)[0];            data = (cl_mem*)data + 1;
+    command_queue = (cl_command_queue)handleObject(v, ((cl_command_queue*)data)[0]);  data = (cl_command_queue*)data + 1;
+    memobj        = (cl_mem)handleObject(v, ((cl_mem*)data)[0]);            data = (cl_mem*)data + 1;
     blocking_read = ((cl_bool*)data)[0];           data = (cl_bool*)data + 1;
     memcpy((void*)origin,data,3*sizeof(size_t));   data = (size_t*)data + 3;
     memcpy((void*)region,data,3*sizeof(size_t));   data = (size_t*)data + 3;
@@ -3777,12 +3556,10 @@ int ocland_clEnqueueReadImage(int* clientfd, char* buffer, validator v, void* da
         if(!event_wait_list){
             flag     = CL_OUT_OF_HOST_MEMORY;
             msgSize  = sizeof(cl_int);
-            msg      = (void*)malloc(msgSize);
+            msg      = requestAlloc(msgSize);
             mptr      = msg;
             ((cl_int*)mptr)[0]  = flag;
-            Send(clientfd, &msgSize, sizeof(size_t), 0);
-            Send(clientfd, msg, msgSize, 0);
-            free(msg);msg=NULL;
+            Reply(clientfd, msg, msgSize);
             VERBOSE_OUT(flag);
             return 1;
         }
@@ -3792,12 +3569,10 @@ int ocland_clEnqueueReadImage(int* clientfd, char* buffer, validator v, void* da
     flag = isQueue(v, command_queue);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         mptr     = msg;
         ((cl_int*)mptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
         VERBOSE_OUT(flag);
         return 1;
@@ -3805,12 +3580,10 @@ int ocland_clEnqueueReadImage(int* clientfd, char* buffer, validator v, void* da
     flag = isBuffer(v, memobj);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         mptr     = msg;
         ((cl_int*)mptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
         VERBOSE_OUT(flag);
         return 1;
@@ -3819,12 +3592,10 @@ int ocland_clEnqueueReadImage(int* clientfd, char* buffer, validator v, void* da
         flag = isEvent(v, event_wait_list[i]);
         if(flag != CL_SUCCESS){
             msgSize  = sizeof(cl_int);
-            msg      = (void*)malloc(msgSize);
+            msg      = requestAlloc(msgSize);
             mptr     = msg;
             ((cl_int*)mptr)[0]  = flag;
-            Send(clientfd, &msgSize, sizeof(size_t), 0);
-            Send(clientfd, msg, msgSize, 0);
-            free(msg);msg=NULL;
+            Reply(clientfd, msg, msgSize);
             if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
             VERBOSE_OUT(flag);
             return 1;
@@ -3833,12 +3604,10 @@ int ocland_clEnqueueReadImage(int* clientfd, char* buffer, validator v, void* da
     flag = clGetCommandQueueInfo(command_queue, CL_QUEUE_CONTEXT, sizeof(cl_context), &context, NULL);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         mptr     = msg;
         ((cl_int*)mptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
         VERBOSE_OUT(flag);
         return 1;
@@ -3849,12 +3618,10 @@ int ocland_clEnqueueReadImage(int* clientfd, char* buffer, validator v, void* da
     if(flag != CL_SUCCESS){
         flag = CL_MEM_OBJECT_ALLOCATION_FAILURE;
         msgSize  = sizeof(cl_int);
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         mptr     = msg;
         ((cl_int*)mptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
         VERBOSE_OUT(flag);
         return 1;
@@ -3865,12 +3632,10 @@ int ocland_clEnqueueReadImage(int* clientfd, char* buffer, validator v, void* da
     if( (!ptr) || (!event) ){
         flag = CL_MEM_OBJECT_ALLOCATION_FAILURE;
         msgSize  = sizeof(cl_int);
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         mptr     = msg;
         ((cl_int*)mptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
         VERBOSE_OUT(flag);
         return 1;
@@ -3879,55 +3644,48 @@ int ocland_clEnqueueReadImage(int* clientfd, char* buffer, validator v, void* da
     event->status        = 1;
     event->context       = context;
     event->command_queue = command_queue;
+    event->refs          = 1;
     // ------------------------------------------------------------
     // Blocking read case:
     // We simply call to the read method to get the data and
     // send it to the client.
     // ------------------------------------------------------------
     if(blocking_read == CL_TRUE){
-        // We may wait manually for the events generated in
-        // ocland, and then we can let OpenCL to wait their
-        // self generated events.
-        if(num_events_in_wait_list){
-            oclandWaitForEvents(num_events_in_wait_list, event_wait_list);
-            free(event_wait_list); event_wait_list=NULL;
-        }
+        // All the ocland events have an OpenCL one associated, so we
+        // can let OpenCL to resolve the dependencies.
+        oclandGetEvents(num_events_in_wait_list, event_wait_list);
         // Read the data
         flag =  clEnqueueReadImage(command_queue,memobj,blocking_read,
                                    origin,region,
                                    row_pitch,slice_pitch,ptr,
-                                   0,NULL,&(event->event));
+                                   num_events_in_wait_list,(cl_event*)event_wait_list,&(event->event));
+        if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
         if(flag != CL_SUCCESS){
             msgSize  = sizeof(cl_int);
-            msg      = (void*)malloc(msgSize);
+            msg      = requestAlloc(msgSize);
             mptr     = msg;
             ((cl_int*)mptr)[0]  = flag;
-            Send(clientfd, &msgSize, sizeof(size_t), 0);
-            Send(clientfd, msg, msgSize, 0);
-            free(msg);msg=NULL;
+            Reply(clientfd, msg, msgSize);
             if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
             free(ptr); ptr=NULL;
             free(event); event=NULL;
             VERBOSE_OUT(flag);
             return 1;
         }
-        // Return the package
+        // Return the package, followed by the data without copying it
         msgSize  = sizeof(cl_int);          // flag
         msgSize += sizeof(ocland_event);    // event
-        msgSize += cb;                      // ptr
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         mptr     = msg;
         ((cl_int*)mptr)[0]       = flag;  mptr = (cl_int*)mptr + 1;
         ((ocland_event*)mptr)[0] = event; mptr = (ocland_event*)mptr + 1;
-        memcpy(mptr, ptr, cb);
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        ReplyData(clientfd, msg, msgSize, ptr, cb);
         if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
         free(ptr); ptr=NULL;
         // Mark the work as done
         event->status = CL_COMPLETE;
         if(want_event != CL_TRUE){
+            clReleaseEvent(event->event);
             free(event); event = NULL;
         }
         else{
@@ -3948,12 +3706,10 @@ int ocland_clEnqueueReadImage(int* clientfd, char* buffer, validator v, void* da
                                    want_event, event);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         mptr     = msg;
         ((cl_int*)mptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
         free(ptr); ptr=NULL;
         free(event); event=NULL;
@@ -3990,8 +3746,8 @@ int ocland_clEnqueueWriteImage(int* clientfd, char* buffer, validator v, void* d
     size_t msgSize = 0;
     void *msg = NULL, *mptr = NULL;
     // Decript the received data
-    command_queue  = ((cl_command_queue*)data)[0];  data = (cl_command_queue*)data + 1;
-    memobj         = ((cl_mem*)data)[0];            data = (cl_mem*)data + 1;
+    command_queue  = (cl_command_queue)handleObject(v, ((cl_command_queue*)data)[0]);  data = (cl_command_queue*)data + 1;
+    memobj         = (cl_mem)handleObject(v, ((cl_mem*)data)[0]);            data = (cl_mem*)data + 1;
     blocking_write = ((cl_bool*)data)[0];           data = (cl_bool*)data + 1;
     memcpy((void*)origin,data,3*sizeof(size_t));   data = (size_t*)data + 3;
     memcpy((void*)region,data,3*sizeof(size_t));   data = (size_t*)data + 3;
@@ -4004,12 +3760,10 @@ int ocland_clEnqueueWriteImage(int* clientfd, char* buffer, validator v, void* d
         if(!event_wait_list){
             flag     = CL_OUT_OF_HOST_MEMORY;
             msgSize  = sizeof(cl_int);
-            msg      = (void*)malloc(msgSize);
+            msg      = requestAlloc(msgSize);
             mptr      = msg;
             ((cl_int*)mptr)[0]  = flag;
-            Send(clientfd, &msgSize, sizeof(size_t), 0);
-            Send(clientfd, msg, msgSize, 0);
-            free(msg);msg=NULL;
+            Reply(clientfd, msg, msgSize);
             VERBOSE_OUT(flag);
             return 1;
         }
@@ -4020,12 +3774,10 @@ int ocland_clEnqueueWriteImage(int* clientfd, char* buffer, validator v, void* d
     flag = isQueue(v, command_queue);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         mptr     = msg;
         ((cl_int*)mptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
         VERBOSE_OUT(flag);
         return 1;
@@ -4033,12 +3785,10 @@ int ocland_clEnqueueWriteImage(int* clientfd, char* buffer, validator v, void* d
     flag = isBuffer(v, memobj);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         mptr     = msg;
         ((cl_int*)mptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
         VERBOSE_OUT(flag);
         return 1;
@@ -4047,12 +3797,10 @@ int ocland_clEnqueueWriteImage(int* clientfd, char* buffer, validator v, void* d
         flag = isEvent(v, event_wait_list[i]);
         if(flag != CL_SUCCESS){
             msgSize  = sizeof(cl_int);
-            msg      = (void*)malloc(msgSize);
+            msg      = requestAlloc(msgSize);
             mptr     = msg;
             ((cl_int*)mptr)[0]  = flag;
-            Send(clientfd, &msgSize, sizeof(size_t), 0);
-            Send(clientfd, msg, msgSize, 0);
-            free(msg);msg=NULL;
+            Reply(clientfd, msg, msgSize);
             if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
             VERBOSE_OUT(flag);
             return 1;
@@ -4061,12 +3809,10 @@ int ocland_clEnqueueWriteImage(int* clientfd, char* buffer, validator v, void* d
     flag = clGetCommandQueueInfo(command_queue, CL_QUEUE_CONTEXT, sizeof(cl_context), &context, NULL);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         mptr     = msg;
         ((cl_int*)mptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
         VERBOSE_OUT(flag);
         return 1;
@@ -4077,12 +3823,10 @@ int ocland_clEnqueueWriteImage(int* clientfd, char* buffer, validator v, void* d
     if(flag != CL_SUCCESS){
         flag = CL_MEM_OBJECT_ALLOCATION_FAILURE;
         msgSize  = sizeof(cl_int);
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         mptr     = msg;
         ((cl_int*)mptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
         VERBOSE_OUT(flag);
         return 1;
@@ -4093,12 +3837,10 @@ int ocland_clEnqueueWriteImage(int* clientfd, char* buffer, validator v, void* d
     if( (!ptr) || (!event) ){
         flag = CL_MEM_OBJECT_ALLOCATION_FAILURE;
         msgSize  = sizeof(cl_int);
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         mptr     = msg;
         ((cl_int*)mptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
         VERBOSE_OUT(flag);
         return 1;
@@ -4107,34 +3849,30 @@ int ocland_clEnqueueWriteImage(int* clientfd, char* buffer, validator v, void* d
     event->status        = 1;
     event->context       = context;
     event->command_queue = command_queue;
+    event->refs          = 1;
     // ------------------------------------------------------------
     // Blocking write case:
     // We simply decript the data from the package received, and
     // call OpenCL to transfer the data.
     // ------------------------------------------------------------
     if(blocking_write == CL_TRUE){
-        // We may wait manually for the events generated in
-        // ocland, and then we can let OpenCL to wait their
-        // self generated events.
-        if(num_events_in_wait_list){
-            oclandWaitForEvents(num_events_in_wait_list, event_wait_list);
-            free(event_wait_list); event_wait_list=NULL;
-        }
+        // All the ocland events have an OpenCL one associated, so we
+        // can let OpenCL to resolve the dependencies.
+        oclandGetEvents(num_events_in_wait_list, event_wait_list);
         // Decript the data from the received package
         memcpy(ptr, data, cb);
         // Write the data
         flag = clEnqueueWriteImage(command_queue,memobj,blocking_write,
                                    origin,region,
                                    row_pitch,slice_pitch,ptr,
-                                   0,NULL,&(event->event));
+                                   num_events_in_wait_list,(cl_event*)event_wait_list,&(event->event));
+        if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
         if(flag != CL_SUCCESS){
             msgSize  = sizeof(cl_int);
-            msg      = (void*)malloc(msgSize);
+            msg      = requestAlloc(msgSize);
             mptr     = msg;
             ((cl_int*)mptr)[0]  = flag;
-            Send(clientfd, &msgSize, sizeof(size_t), 0);
-            Send(clientfd, msg, msgSize, 0);
-            free(msg);msg=NULL;
+            Reply(clientfd, msg, msgSize);
             if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
             free(ptr); ptr=NULL;
             free(event); event=NULL;
@@ -4144,18 +3882,17 @@ int ocland_clEnqueueWriteImage(int* clientfd, char* buffer, validator v, void* d
         // Return the package
         msgSize  = sizeof(cl_int);          // flag
         msgSize += sizeof(ocland_event);    // event
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         mptr     = msg;
         ((cl_int*)mptr)[0]       = flag;  mptr = (cl_int*)mptr + 1;
         ((ocland_event*)mptr)[0] = event; mptr = (ocland_event*)mptr + 1;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
         free(ptr); ptr=NULL;
         // Mark the work as done
         event->status = CL_COMPLETE;
         if(want_event != CL_TRUE){
+            clReleaseEvent(event->event);
             free(event); event = NULL;
         }
         else{
@@ -4176,12 +3913,10 @@ int ocland_clEnqueueWriteImage(int* clientfd, char* buffer, validator v, void* d
                                    want_event, event);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         mptr     = msg;
         ((cl_int*)mptr)[0]  = flag;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         if(event_wait_list) free(event_wait_list); event_wait_list=NULL;
         free(ptr); ptr=NULL;
         free(event); event=NULL;
@@ -4213,7 +3948,7 @@ int ocland_clCreateImage2D(int* clientfd, char* buffer, validator v, void* data)
     size_t msgSize = 0;
     void *msg = NULL, *ptr = NULL;
     // Decript the received data
-    context         = ((cl_context*)data)[0];      data = (cl_context*)data + 1;
+    context         = (cl_context)handleObject(v, ((cl_context*)data)[0]);      data = (cl_context*)data + 1;
     flags           = ((cl_mem_flags*)data)[0];    data = (cl_mem_flags*)data + 1;
     image_format    = ((cl_image_format*)data)[0]; data = (cl_image_format*)data + 1;
     image_width     = ((size_t*)data)[0];          data = (size_t*)data + 1;
@@ -4227,13 +3962,11 @@ int ocland_clCreateImage2D(int* clientfd, char* buffer, validator v, void* data)
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);  // flag
         msgSize += sizeof(cl_mem);  // memobj
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0] = flag; ptr = (cl_int*)ptr  + 1;
         ((cl_mem*)ptr)[0] = memobj;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
@@ -4248,13 +3981,11 @@ int ocland_clCreateImage2D(int* clientfd, char* buffer, validator v, void* data)
     // Return the package
     msgSize  = sizeof(cl_int);  // flag
     msgSize += sizeof(cl_mem);  // memobj
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     ptr      = msg;
     ((cl_int*)ptr)[0] = flag; ptr = (cl_int*)ptr  + 1;
     ((cl_mem*)ptr)[0] = memobj;
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(msg);msg=NULL;
+    Reply(clientfd, msg, msgSize);
     VERBOSE_OUT(flag);
     return 1;
 }
@@ -4277,7 +4008,7 @@ int ocland_clCreateImage3D(int* clientfd, char* buffer, validator v, void* data)
     size_t msgSize = 0;
     void *msg = NULL, *ptr = NULL;
     // Decript the received data
-    context           = ((cl_context*)data)[0];      data = (cl_context*)data + 1;
+    context           = (cl_context)handleObject(v, ((cl_context*)data)[0]);      data = (cl_context*)data + 1;
     flags             = ((cl_mem_flags*)data)[0];    data = (cl_mem_flags*)data + 1;
     image_format      = ((cl_image_format*)data)[0]; data = (cl_image_format*)data + 1;
     image_width       = ((size_t*)data)[0];          data = (size_t*)data + 1;
@@ -4293,13 +4024,11 @@ int ocland_clCreateImage3D(int* clientfd, char* buffer, validator v, void* data)
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);  // flag
         msgSize += sizeof(cl_mem);  // memobj
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0] = flag; ptr = (cl_int*)ptr  + 1;
         ((cl_mem*)ptr)[0] = memobj;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
@@ -4314,13 +4043,11 @@ int ocland_clCreateImage3D(int* clientfd, char* buffer, validator v, void* data)
     // Return the package
     msgSize  = sizeof(cl_int);            // flag
     msgSize += sizeof(cl_mem);  // memobj
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     ptr      = msg;
     ((cl_int*)ptr)[0] = flag; ptr = (cl_int*)ptr  + 1;
     ((cl_mem*)ptr)[0] = memobj;
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(msg);msg=NULL;
+    Reply(clientfd, msg, msgSize);
     VERBOSE_OUT(flag);
     return 1;
 }
@@ -4340,11 +4067,11 @@ int ocland_clCreateSubBuffer(int* clientfd, char* buffer, validator v, void* dat
     size_t msgSize = 0;
     void *msg = NULL, *ptr = NULL;
     // Decript the received data
-    memobj             = ((cl_mem*)data)[0];                data = (cl_mem*)data + 1;
+    memobj             = (cl_mem)handleObject(v, ((cl_mem*)data)[0]);                data = (cl_mem*)data + 1;
     flags              = ((cl_mem_flags*)data)[0];          data = (cl_mem_flags*)data + 1;
     buffer_create_type = ((cl_buffer_create_type*)data)[0]; data = (cl_buffer_create_type*)data + 1;
     if(buffer_create_type == CL_BUFFER_CREATE_TYPE_REGION){
-        buffer_create_info = malloc(sizeof(cl_buffer_region));
+        buffer_create_info = requestAlloc(sizeof(cl_buffer_region));
         memcpy(buffer_create_info,data,sizeof(cl_buffer_region));
         data = (cl_buffer_region*)data + 1;
     }
@@ -4353,14 +4080,11 @@ int ocland_clCreateSubBuffer(int* clientfd, char* buffer, validator v, void* dat
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);  // flag
         msgSize += sizeof(cl_mem);  // memsubobj
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0] = flag; ptr = (cl_int*)ptr  + 1;
         ((cl_mem*)ptr)[0] = memsubobj;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(buffer_create_type);buffer_create_type=NULL;
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
@@ -4373,14 +4097,11 @@ int ocland_clCreateSubBuffer(int* clientfd, char* buffer, validator v, void* dat
         flag     = CL_INVALID_MEM_OBJECT;
         msgSize  = sizeof(cl_int);  // flag
         msgSize += sizeof(cl_mem);  // memsubobj
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0] = flag; ptr = (cl_int*)ptr  + 1;
         ((cl_mem*)ptr)[0] = memsubobj;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(buffer_create_type);buffer_create_type=NULL;
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
@@ -4391,14 +4112,11 @@ int ocland_clCreateSubBuffer(int* clientfd, char* buffer, validator v, void* dat
     // Return the package
     msgSize  = sizeof(cl_int);          // flag
     msgSize += sizeof(cl_mem);          // memsubobj
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     ptr      = msg;
     ((cl_int*)ptr)[0] = flag; ptr = (cl_int*)ptr  + 1;
     ((cl_mem*)ptr)[0] = memsubobj;
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(buffer_create_type);buffer_create_type=NULL;
-    free(msg);msg=NULL;
+    Reply(clientfd, msg, msgSize);
     VERBOSE_OUT(flag);
     return 1;
 }
@@ -4412,19 +4130,17 @@ int ocland_clCreateUserEvent(int* clientfd, char* buffer, validator v, void* dat
     size_t msgSize = 0;
     void *msg = NULL, *ptr = NULL;
     // Decript the received data
-    context = ((cl_context*)data)[0];     data = (cl_context*)data + 1;
+    context = (cl_context)handleObject(v, ((cl_context*)data)[0]);     data = (cl_context*)data + 1;
     // Ensure that the context is valid
     flag = isContext(v, context);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);        // flag
         msgSize += sizeof(ocland_event);  // event
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]       = flag; ptr = (cl_int*)ptr  + 1;
         ((ocland_event*)ptr)[0] = event;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
@@ -4437,13 +4153,11 @@ int ocland_clCreateUserEvent(int* clientfd, char* buffer, validator v, void* dat
         flag     = CL_INVALID_CONTEXT;
         msgSize  = sizeof(cl_int);        // flag
         msgSize += sizeof(ocland_event);  // event
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]       = flag; ptr = (cl_int*)ptr  + 1;
         ((ocland_event*)ptr)[0] = event;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
@@ -4452,19 +4166,18 @@ int ocland_clCreateUserEvent(int* clientfd, char* buffer, validator v, void* dat
         flag     = CL_OUT_OF_HOST_MEMORY;
         msgSize  = sizeof(cl_int);        // flag
         msgSize += sizeof(ocland_event);  // event
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]       = flag; ptr = (cl_int*)ptr  + 1;
         ((ocland_event*)ptr)[0] = event;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
     event->status        = CL_COMPLETE;
     event->context       = context;
     event->command_queue = NULL;
+    event->refs          = 1;
     event->event         = clCreateUserEvent(context, &flag);
     if(flag == CL_SUCCESS){
         registerEvent(v, event);
@@ -4475,13 +4188,11 @@ int ocland_clCreateUserEvent(int* clientfd, char* buffer, validator v, void* dat
     // Return the package
     msgSize  = sizeof(cl_int);        // flag
     msgSize += sizeof(ocland_event);  // event
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     ptr      = msg;
     ((cl_int*)ptr)[0]       = flag; ptr = (cl_int*)ptr  + 1;
     ((ocland_event*)ptr)[0] = event;
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(msg);msg=NULL;
+    Reply(clientfd, msg, msgSize);
     VERBOSE_OUT(flag);
     return 1;
 }
@@ -4501,12 +4212,10 @@ int ocland_clSetUserEventStatus(int* clientfd, char* buffer, validator v, void*
     flag = isEvent(v, event);
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);        // flag
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]       = flag; ptr = (cl_int*)ptr  + 1;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
@@ -4518,24 +4227,20 @@ int ocland_clSetUserEventStatus(int* clientfd, char* buffer, validator v, void*
         // OpenCL < 1.1, so this function does not exist
         flag     = CL_INVALID_EVENT;
         msgSize  = sizeof(cl_int);        // flag
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]       = flag; ptr = (cl_int*)ptr  + 1;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
     flag = clSetUserEventStatus(event->event, execution_status);
     // Return the package
     msgSize  = sizeof(cl_int);        // flag
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     ptr      = msg;
     ((cl_int*)ptr)[0]       = flag; ptr = (cl_int*)ptr  + 1;
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(msg);msg=NULL;
+    Reply(clientfd, msg, msgSize);
     VERBOSE_OUT(flag);
     return 1;
 }
@@ -4626,6 +4331,7 @@ int ocland_clEnqueueReadBufferRect(int* clientfd, char* buffer, validator v)
     event->status        = 1;
     event->context       = context;
     event->command_queue = command_queue;
+    event->refs          = 1;
     // In case of blocking simply send the data.
     // In rect reading process the data will send in
     // blocks of host_row_pitch size, along all the
@@ -4827,6 +4533,7 @@ int ocland_clEnqueueWriteBufferRect(int* clientfd, char* buffer, validator v)
     event->status        = 1;
     event->context       = context;
     event->command_queue = command_queue;
+    event->refs          = 1;
     // Send a first flag and the event before continue working
     flag = CL_SUCCESS;
     Send(clientfd, &flag, sizeof(cl_int), 0);
@@ -5022,6 +4729,7 @@ int ocland_clEnqueueCopyBufferRect(int* clientfd, char* buffer, validator v)
     event->status        = 1;
     event->context       = context;
     event->command_queue = command_queue;
+    event->refs          = 1;
     // We may wait manually for the events provided because
     // OpenCL can only waits their events, but ocalnd event
     // can be relevant. We will not check for errors, OpenCL
@@ -5212,13 +4920,11 @@ int ocland_clCreateImage(int* clientfd, char* buffer, validator v, void* data)
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);  // flag
         msgSize += sizeof(cl_mem);  // memobj
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0] = flag; ptr = (cl_int*)ptr  + 1;
         ((cl_mem*)ptr)[0] = memobj;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
@@ -5231,13 +4937,11 @@ int ocland_clCreateImage(int* clientfd, char* buffer, validator v, void* data)
     // Return the package
     msgSize  = sizeof(cl_int);            // flag
     msgSize += sizeof(cl_mem);  // memobj
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     ptr      = msg;
     ((cl_int*)ptr)[0] = flag; ptr = (cl_int*)ptr  + 1;
     ((cl_mem*)ptr)[0] = memobj;
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(msg);msg=NULL;
+    Reply(clientfd, msg, msgSize);
     VERBOSE_OUT(flag);
     return 1;
 }
@@ -5703,7 +5407,7 @@ int ocland_clGetKernelArgInfo(int* clientfd, char* buffer, validator v, void* da
     size_t msgSize = 0;
     void *msg = NULL, *ptr = NULL;
     // Decript the received data
-    kernel = ((cl_kernel*)data)[0];              data = (cl_kernel*)data + 1;
+    kernel = (cl_kernel)handleObject(v, ((cl_kernel*)data)[0]); data = (cl_kernel*)data + 1;
     arg_index = ((cl_uint*)data)[0];             data = (cl_uint*)data + 1;
     param_name = ((cl_kernel_arg_info*)data)[0]; data = (cl_kernel_arg_info*)data + 1;
     param_value_size = ((size_t*)data)[0];       data = (size_t*)data + 1;
@@ -5712,19 +5416,17 @@ int ocland_clGetKernelArgInfo(int* clientfd, char* buffer, validator v, void* da
     if(flag != CL_SUCCESS){
         msgSize  = sizeof(cl_int);      // flag
         msgSize += sizeof(size_t);      // param_value_size_ret
-        msg      = (void*)malloc(msgSize);
+        msg      = requestAlloc(msgSize);
         ptr      = msg;
         ((cl_int*)ptr)[0]  = flag; ptr = (cl_int*)ptr + 1;
         ((size_t*)ptr)[0]  = 0;    ptr = (size_t*)ptr + 1;
-        Send(clientfd, &msgSize, sizeof(size_t), 0);
-        Send(clientfd, msg, msgSize, 0);
-        free(msg);msg=NULL;
+        Reply(clientfd, msg, msgSize);
         VERBOSE_OUT(flag);
         return 1;
     }
     // Build the required param_value
     if(param_value_size)
-        param_value = (void*)malloc(param_value_size);
+        param_value = (void*)requestAlloc(param_value_size);
     // Get the data
     struct _cl_version version = clGetKernelVersion(kernel);
     if(     (version.major <  1)
@@ -5742,16 +5444,65 @@ int ocland_clGetKernelArgInfo(int* clientfd, char* buffer, validator v, void* da
     msgSize += sizeof(size_t);       // param_value_size_ret
     if(param_value)
         msgSize += param_value_size_ret; // param_value
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     ptr      = msg;
     ((cl_int*)ptr)[0]  = flag; ptr = (cl_int*)ptr + 1;
     ((size_t*)ptr)[0]  = param_value_size_ret;    ptr = (size_t*)ptr + 1;
     if(param_value)
         memcpy(ptr, param_value, param_value_size_ret);
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(param_value);param_value=NULL;
-    free(msg);msg=NULL;
+    Reply(clientfd, msg, msgSize);
+    VERBOSE_OUT(flag);
+    return 1;
+}
+
+int ocland_kernelArgsAddress(int* clientfd, char* buffer, validator v, void* data)
+{
+    VERBOSE_IN();
+    cl_kernel kernel;
+    cl_uint i, num_args = 0;
+    cl_kernel_arg_address_qualifier *arg_address = NULL;
+    cl_int flag;
+    size_t msgSize = 0;
+    void *msg = NULL, *ptr = NULL;
+    // Decript the received data
+    kernel = (cl_kernel)handleObject(v, ((cl_kernel*)data)[0]);
+    // Ensure that the kernel is valid
+    flag = isKernel(v, kernel);
+    if(flag == CL_SUCCESS)
+        flag = clGetKernelInfo(kernel,CL_KERNEL_NUM_ARGS,sizeof(cl_uint),&num_args,NULL);
+    if(flag != CL_SUCCESS)
+        num_args = 0;
+    // Build the package to send
+    msgSize  = sizeof(cl_int);                                    // flag
+    msgSize += sizeof(cl_uint);                                   // num_args
+    msgSize += num_args*sizeof(cl_kernel_arg_address_qualifier);  // arg_address
+    msg      = requestAlloc(msgSize);
+    if(!msg){
+        flag = CL_OUT_OF_HOST_MEMORY;
+        Reply(clientfd, &flag, sizeof(cl_int));
+        VERBOSE_OUT(flag);
+        return 1;
+    }
+    ptr      = msg;
+    ((cl_int*)ptr)[0]  = flag;     ptr = (cl_int*)ptr  + 1;
+    ((cl_uint*)ptr)[0] = num_args; ptr = (cl_uint*)ptr + 1;
+    arg_address = (cl_kernel_arg_address_qualifier*)ptr;
+    if(num_args){
+        struct _cl_version version = clGetKernelVersion(kernel);
+        for(i=0;i<num_args;i++){
+            arg_address[i] = CL_KERNEL_ARG_ADDRESS_GLOBAL;
+            if(     (version.major <  1)
+                || ((version.major == 1) && (version.minor < 2))){
+                // OpenCL < 1.2, so clGetKernelArgInfo does not exist
+                continue;
+            }
+            if(clGetKernelArgInfo(kernel,i,CL_KERNEL_ARG_ADDRESS_QUALIFIER,
+                                  sizeof(cl_kernel_arg_address_qualifier),
+                                  &(arg_address[i]),NULL) != CL_SUCCESS)
+                arg_address[i] = CL_KERNEL_ARG_ADDRESS_GLOBAL;
+        }
+    }
+    Reply(clientfd, msg, msgSize);
     VERBOSE_OUT(flag);
     return 1;
 }
@@ -5839,6 +5590,7 @@ int ocland_clEnqueueFillBuffer(int* clientfd, char* buffer, validator v)
     event->status        = 1;
     event->context       = context;
     event->command_queue = command_queue;
+    event->refs          = 1;
     // We may wait manually for the events provided because
     // OpenCL can only waits their events, but ocalnd event
     // can be relevant. We will not check for errors, OpenCL
@@ -5976,6 +5728,7 @@ int ocland_clEnqueueFillImage(int* clientfd, char* buffer, validator v)
     event->status        = 1;
     event->context       = context;
     event->command_queue = command_queue;
+    event->refs          = 1;
     // We may wait manually for the events provided because
     // OpenCL can only waits their events, but ocalnd event
     // can be relevant. We will not check for errors, OpenCL
@@ -6111,6 +5864,7 @@ int ocland_clEnqueueMigrateMemObjects(int* clientfd, char* buffer, validator v)
     event->status        = 1;
     event->context       = context;
     event->command_queue = command_queue;
+    event->refs          = 1;
     // We may wait manually for the events provided because
     // OpenCL can only waits their events, but ocalnd event
     // can be relevant. We will not check for errors, OpenCL
@@ -6224,6 +5978,7 @@ int ocland_clEnqueueMarkerWithWaitList(int* clientfd, char* buffer, validator v)
     event->status        = 1;
     event->context       = context;
     event->command_queue = command_queue;
+    event->refs          = 1;
     // We may wait manually for the events provided because
     // OpenCL can only waits their events, but ocalnd event
     // can be relevant. We will not check for errors, OpenCL
@@ -6335,6 +6090,7 @@ int ocland_clEnqueueBarrierWithWaitList(int* clientfd, char* buffer, validator v
     event->status        = 1;
     event->context       = context;
     event->command_queue = command_queue;
+    event->refs          = 1;
     // We may wait manually for the events provided because
     // OpenCL can only waits their events, but ocalnd event
     // can be relevant. We will not check for errors, OpenCL
@@ -20,27 +20,217 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <string.h>
+#include <time.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
 
+#include <ocland/common/hashTable.h>
 #include <ocland/server/ocland_event.h>
 
+/** @struct queue_work_st Work in flight in a command queue.
+ */
+struct queue_work_st{
+    /// Number of events in flight
+    cl_uint depth;
+    /// Time since the command queue has work in flight
+    struct timespec since;
+    /// Number of threads waiting for the work (see oclandWaitForQueue)
+    cl_uint waiters;
+    /// Condition signaled when the work has finished
+    pthread_cond_t cond;
+};
+
+/// Work in flight of each command queue with any, NULL until the first
+/// event is initialized
+static hash_table queues_work = NULL;
+
+/// Mutex protecting the work in flight
+static pthread_mutex_t events_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/// Key of a command queue in the work in flight table
+#define QUEUE_KEY(command_queue) ((uint64_t)(uintptr_t)(command_queue))
+
+void oclandRetainEvent(ocland_event event)
+{
+    __atomic_add_fetch(&(event->refs), 1, __ATOMIC_RELAXED);
+}
+
+void oclandReleaseEvent(ocland_event event)
+{
+    if(!__atomic_sub_fetch(&(event->refs), 1, __ATOMIC_ACQ_REL))
+        free(event);
+}
+
+/** Wait until an event is completed. The status of the event is used
+ * as a futex, so just the threads waiting for this event are woken up
+ * when it is completed (see oclandSetUserEventComplete).
+ * @param event ocland event.
+ */
+static void waitEvent(ocland_event event)
+{
+    cl_int status;
+    while((status = __atomic_load_n(&(event->status), __ATOMIC_ACQUIRE)) != CL_COMPLETE)
+        syscall(SYS_futex, &(event->status), FUTEX_WAIT_PRIVATE, status, NULL, NULL, 0);
+}
+
 cl_int oclandWaitForEvents(cl_uint num_events, const ocland_event *event_list)
 {
     unsigned int i;
     cl_int flag = CL_SUCCESS;
     cl_uint  cl_num_events=0;
     cl_event cl_event_list[num_events];
-    // Wait until ocland ends the work, and set OpenCL events
+    // The events may be released by the client meanwhile they are
+    // waited, so they are retained (the OpenCL ones too)
     for(i=0;i<num_events;i++){
-        while(event_list[i]->status != CL_COMPLETE)
-            usleep(1000);
+        oclandRetainEvent(event_list[i]);
         if(event_list[i]->event){
+            cl_event_list[cl_num_events] = event_list[i]->event;
+            clRetainEvent(cl_event_list[cl_num_events]);
             cl_num_events++;
-            cl_event_list[i] = event_list[i]->event;
         }
     }
+    // Wait until ocland ends the work
+    for(i=0;i<num_events;i++){
+        waitEvent(event_list[i]);
+        oclandReleaseEvent(event_list[i]);
+    }
     // Wait for OpenCL events
     if(cl_num_events)
-        flag = clWaitForEvents(num_events, cl_event_list);
+        flag = clWaitForEvents(cl_num_events, cl_event_list);
+    for(i=0;i<cl_num_events;i++)
+        clReleaseEvent(cl_event_list[i]);
     return flag;
 
 }
+
+cl_event* oclandGetEvents(cl_uint num_events, ocland_event *event_list)
+{
+    unsigned int i;
+    cl_event *cl_event_list = (cl_event*)event_list;
+    for(i=0;i<num_events;i++){
+        cl_event_list[i] = event_list[i]->event;
+    }
+    return cl_event_list;
+}
+
+cl_int oclandInitUserEvent(ocland_event event)
+{
+    cl_int flag;
+    event->event = clCreateUserEvent(event->context, &flag);
+    if(flag != CL_SUCCESS){
+        event->event = NULL;
+        return flag;
+    }
+    // One reference for the client, and another one for the transfer
+    clRetainEvent(event->event);
+    oclandRetainEvent(event);
+    // Account the work in flight
+    struct queue_work_st *work = NULL;
+    pthread_mutex_lock(&events_mutex);
+    if(!queues_work)
+        queues_work = createHashTable();
+    if(queues_work && !hashTableFind(queues_work, QUEUE_KEY(event->command_queue), (void**)&work)){
+        work = (struct queue_work_st*)malloc(sizeof(struct queue_work_st));
+        if(work){
+            work->depth   = 0;
+            work->waiters = 0;
+            clock_gettime(CLOCK_MONOTONIC, &(work->since));
+            pthread_cond_init(&(work->cond), NULL);
+            if(hashTableInsert(queues_work, QUEUE_KEY(event->command_queue), work)){
+                pthread_cond_destroy(&(work->cond));
+                free(work); work = NULL;
+            }
+        }
+    }
+    if(work)
+        work->depth++;
+    pthread_mutex_unlock(&events_mutex);
+    return CL_SUCCESS;
+}
+
+void oclandSetUserEventComplete(ocland_event event)
+{
+    struct queue_work_st *work = NULL;
+    clSetUserEventStatus(event->event, CL_COMPLETE);
+    clReleaseEvent(event->event);
+    // The work is not in flight anymore
+    pthread_mutex_lock(&events_mutex);
+    if(queues_work && hashTableFind(queues_work, QUEUE_KEY(event->command_queue), (void**)&work)){
+        work->depth--;
+        if(!work->depth){
+            hashTableRemove(queues_work, QUEUE_KEY(event->command_queue), NULL);
+            // The last waiting thread will release the work
+            if(work->waiters)
+                pthread_cond_broadcast(&(work->cond));
+            else{
+                pthread_cond_destroy(&(work->cond));
+                free(work); work = NULL;
+            }
+        }
+    }
+    pthread_mutex_unlock(&events_mutex);
+    // Wake up just the threads waiting for this event
+    __atomic_store_n(&(event->status), CL_COMPLETE, __ATOMIC_RELEASE);
+    syscall(SYS_futex, &(event->status), FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+    // The waiting threads hold their own reference
+    oclandReleaseEvent(event);
+}
+
+cl_int oclandWaitForQueue(cl_command_queue command_queue)
+{
+    struct queue_work_st *work = NULL;
+    pthread_mutex_lock(&events_mutex);
+    if(!queues_work || !hashTableFind(queues_work, QUEUE_KEY(command_queue), (void**)&work)){
+        pthread_mutex_unlock(&events_mutex);
+        return CL_SUCCESS;
+    }
+    // The work is removed from the table as soon as it finishes, so
+    // just the threads waiting for this command queue are woken up
+    work->waiters++;
+    while(work->depth)
+        pthread_cond_wait(&(work->cond), &events_mutex);
+    work->waiters--;
+    if(!work->waiters){
+        pthread_cond_destroy(&(work->cond));
+        free(work); work = NULL;
+    }
+    pthread_mutex_unlock(&events_mutex);
+    return CL_SUCCESS;
+}
+
+void oclandQueueStatus(cl_command_queue command_queue, cl_uint *depth, double *age)
+{
+    struct queue_work_st *work = NULL;
+    struct timespec now;
+    if(depth)
+        *depth = 0;
+    if(age)
+        *age = 0.0;
+    pthread_mutex_lock(&events_mutex);
+    if(queues_work && hashTableFind(queues_work, QUEUE_KEY(command_queue), (void**)&work)){
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if(depth)
+            *depth = work->depth;
+        if(age)
+            *age = (double)(now.tv_sec - work->since.tv_sec) +
+                   1.0e-9 * (double)(now.tv_nsec - work->since.tv_nsec);
+    }
+    pthread_mutex_unlock(&events_mutex);
+}
+
+cl_uint oclandQueuesInFlight(cl_uint num_entries, cl_command_queue *command_queues)
+{
+    cl_uint n = 0;
+    size_t index = 0;
+    uint64_t key;
+    pthread_mutex_lock(&events_mutex);
+    while(queues_work && hashTableNext(queues_work, &index, &key, NULL)){
+        if(n < num_entries)
+            command_queues[n] = (cl_command_queue)(uintptr_t)key;
+        n++;
+    }
+    pthread_mutex_unlock(&events_mutex);
+    return n;
+}
@@ -28,70 +28,89 @@
 
 #include <ocland/common/dataExchange.h>
 #include <ocland/server/ocland_mem.h>
+#include <ocland/server/dispatcher.h>
+#include <ocland/server/ocland_channel.h>
+#include <ocland/common/transferPool.h>
+#include <ocland/common/hashTable.h>
 
-#ifndef OCLAND_ASYNC_FIRST_PORT
-    #define OCLAND_ASYNC_FIRST_PORT 51001u
+#ifndef BUFF_SIZE
+    #define BUFF_SIZE 1025u
 #endif
 
-#ifndef OCLAND_ASYNC_LAST_PORT
-    #define OCLAND_ASYNC_LAST_PORT 51150u
+#ifndef OCLAND_TRANSFER_WORKERS
+    #define OCLAND_TRANSFER_WORKERS 32u
 #endif
 
-#ifndef BUFF_SIZE
-    #define BUFF_SIZE 1025u
+#ifndef OCLAND_TRANSFER_BUDGET
+    #define OCLAND_TRANSFER_BUDGET 1073741824u
+#endif
+
+#ifndef OCLAND_TRANSFER_CHUNK
+    #define OCLAND_TRANSFER_CHUNK 4194304u
 #endif
 
-/** Create a port for a parallel data transfer.
- * @param async_port Returned resulting port. Can be NULL, then
- * port data will not be returned.
- * @return Server identifier, lower than 0 if couldn't be created.
+#ifndef OCLAND_CLIENT_TRANSFER_WORKERS
+    #define OCLAND_CLIENT_TRANSFER_WORKERS 4u
+#endif
+
+#ifndef OCLAND_CLIENT_TRANSFER_BUDGET
+    #define OCLAND_CLIENT_TRANSFER_BUDGET 268435456u
+#endif
+
+/// Workers performing the asynchronous transfers
+static transfer_pool transfers = NULL;
+/// Transfers of each client with any, by its data channel
+static hash_table clients_transfers = NULL;
+/// Transfers pool initialization control
+static pthread_once_t transfers_once = PTHREAD_ONCE_INIT;
+/// Number of transfers launched and not finished yet
+static unsigned int transfers_depth = 0;
+/// Memory held by the running transfers
+static size_t transfers_outstanding = 0;
+/// Mutex protecting the transfers accounting
+static pthread_mutex_t transfers_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/// Key of a client in the transfers table
+#define CLIENT_KEY(channel) ((uint64_t)(uintptr_t)(channel))
+
+/** Create the pool of workers performing the asynchronous transfers.
  */
-int openPort(unsigned int *async_port)
+static void initTransfers()
 {
-    unsigned int port = OCLAND_ASYNC_FIRST_PORT;
-    int serverfd = -1;
-    struct sockaddr_in serv_addr;
-    memset(&serv_addr, '0', sizeof(serv_addr));
-    serverfd = socket(AF_INET, SOCK_STREAM, 0);
-    if(serverfd < 0){
-        // we can't work, disconnect the client
-        printf("ERROR: New socket can't be registered for asynchronous data transfer (%s).\n", SocketsError()); fflush(stdout);
-        return serverfd;
-    }
-    int resuseAddr = 1;
-    setsockopt(serverfd, SOL_SOCKET, SO_REUSEADDR, &resuseAddr, sizeof(int));
-    serv_addr.sin_family      = AF_INET;
-    serv_addr.sin_addr.s_addr = htonl(INADDR_ANY);
-    serv_addr.sin_port        = htons(port);
-    while(bind(serverfd, (struct sockaddr*)&serv_addr, sizeof(serv_addr))){
-        port++;
-        serv_addr.sin_port    = htons(port);
-        if(port > OCLAND_ASYNC_LAST_PORT){
-            printf("WARNING: Can't find an available port for asynchronous data transfer.\n"); fflush(stdout);
-            printf("\tWaiting for an available one...\n"); fflush(stdout);
-            port = OCLAND_ASYNC_FIRST_PORT;
-            serv_addr.sin_port = htons(port);
-            usleep(1000);
-        }
-    }
-    if(async_port)
-        *async_port = port;
-    if(listen(serverfd, 1)){
-        // we can't work, disconnect the client
-        printf("ERROR: Can't listen on port %u binded.\n", port); fflush(stdout);
-        shutdown(serverfd, 2);
-        serverfd = -1;
-        return serverfd;
-    }
-    return serverfd;
+    // The budget is enforced before handing the transfers to the pool
+    // (see scheduleTransfers), so submitting them never blocks
+    transfers = createTransferPool(OCLAND_TRANSFER_WORKERS, 0);
+    clients_transfers = createHashTable();
 }
 
+/** @struct client_transfers_st Asynchronous transfers of a client. Each
+ * client can run just OCLAND_CLIENT_TRANSFER_WORKERS transfers, holding
+ * OCLAND_CLIENT_TRANSFER_BUDGET bytes, at the same time, so a client
+ * can't take the workers, or the memory, of the other ones.
+ */
+struct client_transfers_st{
+    /// Number of transfers launched and not finished yet
+    unsigned int depth;
+    /// Number of transfers running
+    unsigned int running;
+    /// Memory held by the running transfers
+    size_t outstanding;
+    /// First transfer ready to run, waiting for a worker
+    struct dataSend *first;
+    /// Last transfer ready to run, waiting for a worker
+    struct dataSend *last;
+};
+
 /** @struct dataTransfer Data needed for
  * an asynchronously transfer to client.
  */
 struct dataSend{
-    /// Socket
-    int fd;
+    /// Data channel of the client
+    data_channel channel;
+    /// Command index of the request which started the transfer
+    uint32_t opcode;
+    /// Identifier of the request which started the transfer
+    uint32_t request_id;
     /// Command queue
     cl_command_queue command_queue;
     /// Memory object
@@ -116,15 +135,188 @@ struct dataSend{
     void *ptr;
     /// Number of events to wait
     cl_uint num_events_in_wait_list;
-    /// List of events to wait
-    ocland_event *event_wait_list;
+    /// List of OpenCL events to wait, retained until the transfer
+    /// finishes (see launchDataSend)
+    cl_event *event_wait_list;
     /// CL_TRUE if the event must be preserved, CL_FALSE otherwise
     cl_bool want_event;
     /// Event associated to the transmission (can be NULL)
     ocland_event event;
+    /// Method which performs the transfer
+    void *(*run)(void*);
+    /// Memory held by the transfer while it is running
+    size_t held;
+    /// Transfers of the client, NULL if they are not accounted
+    struct client_transfers_st *client;
+    /// Number of dependencies not resolved yet, plus one meanwhile the
+    /// transfer is launched
+    cl_uint pending;
+    /// Next transfer of the client waiting for a worker
+    struct dataSend *next;
 };
 
+/** Take the transfers of a client which can run without exceeding the
+ * client limits, nor the server budget. A transfer is never held back
+ * by the budget if no other one is running.
+ * @param client Transfers of the client.
+ * @param ready End of the list where the transfers which can run are
+ * appended. It is updated to the new end of the list.
+ * @note transfers_mutex must be locked.
+ */
+static void scheduleTransfers(struct client_transfers_st *client, struct dataSend ***ready)
+{
+    struct dataSend *_data;
+    while((_data = client->first)){
+        if(client->running >= OCLAND_CLIENT_TRANSFER_WORKERS)
+            break;
+        if(    OCLAND_CLIENT_TRANSFER_BUDGET && client->running
+            && (client->outstanding + _data->held > OCLAND_CLIENT_TRANSFER_BUDGET))
+            break;
+        if(    OCLAND_TRANSFER_BUDGET && transfers_outstanding
+            && (transfers_outstanding + _data->held > OCLAND_TRANSFER_BUDGET))
+            break;
+        client->first = _data->next;
+        if(!client->first)
+            client->last = NULL;
+        client->running++;
+        client->outstanding   += _data->held;
+        transfers_outstanding += _data->held;
+        _data->next = NULL;
+        **ready = _data;
+        *ready  = &(_data->next);
+    }
+}
+
+/** Hand a list of transfers to the workers pool.
+ * @param ready Transfers which can run.
+ */
+static void submitTransfers(struct dataSend *ready)
+{
+    struct dataSend *_data;
+    while((_data = ready)){
+        ready = _data->next;
+        transferPoolSubmit(transfers, _data->run, (void *)(_data), _data->held);
+    }
+}
+
+/** Mark a dependency of a transfer as resolved. When all of them are
+ * resolved the transfer waits for a worker.
+ * @param _data Transfer data.
+ */
+static void dependencyResolved(struct dataSend* _data)
+{
+    struct client_transfers_st *client = _data->client;
+    struct dataSend *ready = NULL, **tail = &ready;
+    pthread_mutex_lock(&transfers_mutex);
+    _data->pending--;
+    if(_data->pending){
+        pthread_mutex_unlock(&transfers_mutex);
+        return;
+    }
+    _data->next = NULL;
+    if(client->last)
+        client->last->next = _data;
+    else
+        client->first = _data;
+    client->last = _data;
+    scheduleTransfers(client, &tail);
+    pthread_mutex_unlock(&transfers_mutex);
+    submitTransfers(ready);
+}
+
+#ifdef CL_API_SUFFIX__VERSION_1_1
+/** Callback called by OpenCL when a command the transfer depends on has
+ * finished.
+ * @param event OpenCL event of the command.
+ * @param status Execution status of the command.
+ * @param data Transfer data.
+ */
+static void CL_CALLBACK dependencyCallback(cl_event event, cl_int status, void *data)
+{
+    dependencyResolved((struct dataSend*)data);
+}
+#endif
+
+/** Account a finished transfer, letting the transfers held back by it
+ * run.
+ * @param _data Transfer data.
+ */
+static void finishDataSend(struct dataSend* _data)
+{
+    struct client_transfers_st *client = _data->client;
+    struct dataSend *ready = NULL, **tail = &ready;
+    size_t index = 0;
+    pthread_mutex_lock(&transfers_mutex);
+    transfers_depth--;
+    if(!client){
+        pthread_mutex_unlock(&transfers_mutex);
+        return;
+    }
+    client->depth--;
+    client->running--;
+    client->outstanding   -= _data->held;
+    transfers_outstanding -= _data->held;
+    if(!client->depth){
+        hashTableRemove(clients_transfers, CLIENT_KEY(_data->channel), NULL);
+        free(client); client = NULL;
+    }
+    // The released memory may let the transfers of any client run
+    while(hashTableNext(clients_transfers, &index, NULL, (void**)&client))
+        scheduleTransfers(client, &tail);
+    pthread_mutex_unlock(&transfers_mutex);
+    submitTransfers(ready);
+}
+
+/** Build the data of an asynchronous transfer started by the request
+ * which is being dispatched. The client data channel is retained.
+ * @return Transfer data, NULL if the client has not a data channel,
+ * or the memory can't be allocated.
+ */
+static struct dataSend* newDataSend()
+{
+    data_channel channel = requestChannel();
+    if(!channel)
+        return NULL;
+    struct dataSend* _data = (struct dataSend*)malloc(sizeof(struct dataSend));
+    if(!_data)
+        return NULL;
+    memset(_data, 0, sizeof(struct dataSend));
+    retainChannel(channel);
+    _data->channel    = channel;
+    _data->opcode     = requestHeader()->opcode;
+    _data->request_id = requestHeader()->request_id;
+    return _data;
+}
+
+/** Release the data of an asynchronous transfer, once the transfer has
+ * finished, marking the associated event as completed.
+ * @param _data Transfer data.
+ */
+static void freeDataSend(struct dataSend* _data)
+{
+    cl_uint i;
+    free(_data->buffer_origin); _data->buffer_origin = NULL;
+    free(_data->region); _data->region = NULL;
+    free(_data->ptr); _data->ptr = NULL;
+    if(_data->event){
+        // The reference of the transfer is released by
+        // oclandSetUserEventComplete, so the client one is dropped before
+        if(_data->want_event != CL_TRUE){
+            clReleaseEvent(_data->event->event);
+            oclandReleaseEvent(_data->event);
+        }
+        oclandSetUserEventComplete(_data->event); _data->event = NULL;
+    }
+    for(i=0;i<_data->num_events_in_wait_list;i++)
+        clReleaseEvent(_data->event_wait_list[i]);
+    if(_data->event_wait_list) free(_data->event_wait_list); _data->event_wait_list=NULL;
+    finishDataSend(_data);
+    releaseChannel(_data->channel);
+    free(_data); _data=NULL;
+}
+
 /** Test if all the objects exist on the same command queue.
+ on the same command queue.
  * @return CL_SUCCESS if all the objects are associated
  * with the command queue. CL_INVALID_CONTEXT if the objects
  * are associated to different command queues. Other errors
@@ -214,48 +406,127 @@ cl_int testWriteable(cl_mem mem)
     return CL_SUCCESS;
 }
 
-/** Thread that sends data from server to client.
+/** Launch an asynchronous transfer. The transfer is not handed to a
+ * worker until the commands it depends on have finished, and there are
+ * workers and memory enough for it (see scheduleTransfers), so neither
+ * the calling thread nor the workers are blocked by the transfers
+ * held back.
+ * @param start_routine Transfer method.
+ * @param _data Transfer data. The events of its wait list are retained
+ * until the transfer finishes.
+ * @param held Memory held by the transfer while it is running.
+ */
+static void launchDataSend(void *(*start_routine)(void*), struct dataSend* _data, size_t held)
+{
+    cl_uint i;
+    struct client_transfers_st *client = NULL;
+    pthread_once(&transfers_once, initTransfers);
+    _data->run  = start_routine;
+    _data->held = held;
+    // The client may release the events meanwhile
+    for(i=0;i<_data->num_events_in_wait_list;i++)
+        clRetainEvent(_data->event_wait_list[i]);
+    pthread_mutex_lock(&transfers_mutex);
+    transfers_depth++;
+    if(clients_transfers && !hashTableFind(clients_transfers, CLIENT_KEY(_data->channel), (void**)&client)){
+        client = (struct client_transfers_st*)calloc(1, sizeof(struct client_transfers_st));
+        if(client && hashTableInsert(clients_transfers, CLIENT_KEY(_data->channel), client)){
+            free(client); client = NULL;
+        }
+    }
+    if(!client){
+        // The transfer can't be accounted, so just the worker will wait
+        // for the dependencies
+        pthread_mutex_unlock(&transfers_mutex);
+        transferPoolSubmit(transfers, start_routine, (void *)(_data), held);
+        return;
+    }
+    client->depth++;
+    _data->client  = client;
+    _data->pending = _data->num_events_in_wait_list + 1;
+    pthread_mutex_unlock(&transfers_mutex);
+    for(i=0;i<_data->num_events_in_wait_list;i++){
+#ifdef CL_API_SUFFIX__VERSION_1_1
+        if(clSetEventCallback(_data->event_wait_list[i], CL_COMPLETE,
+                              dependencyCallback, (void *)(_data)) == CL_SUCCESS)
+            continue;
+#endif
+        // The worker will wait for this dependency
+        dependencyResolved(_data);
+    }
+    dependencyResolved(_data);
+}
+
+/** Memory required to stage a streamed transfer. The transfers larger
+ * than OCLAND_TRANSFER_CHUNK are double buffered, one chunk being
+ * transferred from/to the device meanwhile the other one is
+ * transferred from/to the client.
+ * @param cb Size of the data.
+ * @return Staging memory size.
+ */
+static size_t stagingSize(size_t cb)
+{
+    if(cb <= OCLAND_TRANSFER_CHUNK)
+        return cb;
+    return 2 * (size_t)OCLAND_TRANSFER_CHUNK;
+}
+
+void oclandTransfersStatus(struct oclandTransferStats_st *stats)
+{
+    pthread_mutex_lock(&transfers_mutex);
+    stats->depth       = transfers_depth;
+    stats->outstanding = transfers_outstanding;
+    pthread_mutex_unlock(&transfers_mutex);
+    stats->budget      = OCLAND_TRANSFER_BUDGET;
+}
+
+/** Thread that sends data from server to client. The data is read
+ * from the device in chunks, the next chunk being read meanwhile the
+ * current one is sent.
  * @param data struct dataTransfer casted variable.
  * @return NULL
  */
 void *asyncDataSend_thread(void *data)
 {
     struct dataSend* _data = (struct dataSend*)data;
-    // Provide a server for the data transfer
-    int fd = accept(_data->fd, (struct sockaddr*)NULL, NULL);
-    if(fd < 0){
-        // we can't work, disconnect the client
-        printf("ERROR: Can't listen on binded port.\n"); fflush(stdout);
-        shutdown(_data->fd, 2);
-        return CL_SUCCESS;
-    }
-    // We may wait manually for the events generated by ocland,
-    // and then we can wait for the OpenCL generated ones.
-    if(_data->num_events_in_wait_list){
-        oclandWaitForEvents(_data->num_events_in_wait_list, _data->event_wait_list);
+    // All the ocland events have an OpenCL one associated, so we
+    // can let OpenCL to resolve the dependencies.
+    cl_event transfer[2] = {NULL, NULL};
+    cl_event *wait_list = _data->event_wait_list;
+    size_t chunk = (_data->cb < OCLAND_TRANSFER_CHUNK) ? _data->cb : OCLAND_TRANSFER_CHUNK;
+    char *chunks[2] = {(char*)_data->ptr, (char*)_data->ptr + chunk};
+    size_t offset = 0, size, next_size;
+    unsigned int i = 0;
+    // Read the first chunk
+    if(_data->cb){
+        clEnqueueReadBuffer(_data->command_queue,_data->mem,CL_FALSE,
+                            _data->offset,chunk,chunks[0],
+                            _data->num_events_in_wait_list,wait_list,&(transfer[0]));
     }
-    // Read the buffer
-    clEnqueueReadBuffer(_data->command_queue,_data->mem,CL_FALSE,
-                        _data->offset,_data->cb,_data->ptr,
-                        0,NULL,&(_data->event->event));
-    // Return the data to the client
-    clWaitForEvents(1,&(_data->event->event));
-    Send(&fd, _data->ptr, _data->cb, 0);
+    do{
+        size = _data->cb - offset;
+        if(size > chunk)
+            size = chunk;
+        // Read the next chunk meanwhile the current one is sent
+        if(offset + size < _data->cb){
+            next_size = _data->cb - offset - size;
+            if(next_size > chunk)
+                next_size = chunk;
+            clEnqueueReadBuffer(_data->command_queue,_data->mem,CL_FALSE,
+                                _data->offset + offset + size,next_size,chunks[!i],
+                                _data->num_events_in_wait_list,wait_list,&(transfer[!i]));
+        }
+        // Return the chunk to the client
+        if(transfer[i]){
+            clWaitForEvents(1,&(transfer[i]));
+            clReleaseEvent(transfer[i]); transfer[i] = NULL;
+        }
+        channelSend(_data->channel, _data->opcode, _data->request_id, chunks[i], size);
+        offset += size;
+        i = !i;
+    } while(offset < _data->cb);
     // Clean up
-    free(_data->ptr); _data->ptr = NULL;
-    if(_data->event){
-        _data->event->status = CL_COMPLETE;
-    }
-    if(_data->want_event != CL_TRUE){
-        free(_data->event); _data->event = NULL;
-    }
-    if(_data->event_wait_list) free(_data->event_wait_list); _data->event_wait_list=NULL;
-    // shutdown(fd, 2);
-    // shutdown(_data->fd, 2);
-    close(fd);
-    close(_data->fd);
-    free(_data); _data=NULL;
-    pthread_exit(NULL);
+    freeDataSend(_data); _data=NULL;
     return NULL;
 }
 
@@ -264,7 +535,6 @@ cl_int oclandEnqueueReadBuffer(int *                clientfd ,
                                cl_mem               mem ,
                                size_t               offset ,
                                size_t               cb ,
-                               void *               ptr ,
                                cl_uint              num_events_in_wait_list ,
                                ocland_event *       event_wait_list ,
                                cl_bool              want_event ,
@@ -283,95 +553,91 @@ cl_int oclandEnqueueReadBuffer(int *                clientfd ,
     if(testReadable(mem) != CL_SUCCESS)
         return CL_INVALID_OPERATION;
     // Seems that data is correct, so we can proceed.
-    // We need to create a new connection socket in a
-    // new port in order to don't intercept the next
+    // The data will be sent through the client data
+    // channel in order to don't intercept the next
     // packets exchanged with the client (for instance
     // to call new commands).
-    unsigned int port;
-    int serverfd = openPort(&port);
-    if(serverfd < 0)
-        return CL_OUT_OF_HOST_MEMORY;
+    struct dataSend* _data = newDataSend();
+    if(!_data)
+        return CL_OUT_OF_RESOURCES;
+    // Just the chunks being transferred are staged
+    size_t staging = stagingSize(cb);
+    _data->ptr = malloc(staging);
+    if(staging && !_data->ptr){
+        releaseChannel(_data->channel);
+        free(_data); _data = NULL;
+        return CL_MEM_OBJECT_ALLOCATION_FAILURE;
+    }
+    // The command will not be enqueued until the data transfer
+    // starts, so an user event is provided meanwhile.
+    flag = oclandInitUserEvent(event);
+    if(flag != CL_SUCCESS){
+        releaseChannel(_data->channel);
+        free(_data->ptr);
+        free(_data); _data = NULL;
+        return flag;
+    }
     // Here in after we assume that the works gone fine,
     // returning CL_SUCCESS. Therefore we will package
-    // the flag, the event and the port to stablish the
-    // connection for the asynchronous data transfer.
+    // the flag and the event. The data will be tagged
+    // with the request identifier in the data channel.
     flag = CL_SUCCESS;
     msgSize  = sizeof(cl_int);          // flag
     msgSize += sizeof(ocland_event);    // event
-    msgSize += sizeof(unsigned int);    // port
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     mptr     = msg;
     ((cl_int*)mptr)[0]       = flag;  mptr = (cl_int*)mptr + 1;
-    ((ocland_event*)mptr)[0] = event; mptr = (ocland_event*)mptr + 1;
-    ((unsigned int*)mptr)[0] = port;
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(msg);msg=NULL;
+    ((ocland_event*)mptr)[0] = event;
+    Reply(clientfd, msg, msgSize);
     // We are ready to trasfer the control to a parallel thread
-    pthread_t thread;
-    struct dataSend* _data = (struct dataSend*)malloc(sizeof(struct dataSend));
-    _data->fd                      = serverfd;
     _data->command_queue           = command_queue;
     _data->mem                     = mem;
     _data->offset                  = offset;
     _data->cb                      = cb;
-    _data->ptr                     = ptr;
     _data->num_events_in_wait_list = num_events_in_wait_list;
-    _data->event_wait_list         = event_wait_list;
+    _data->event_wait_list         = oclandGetEvents(num_events_in_wait_list, event_wait_list);
     _data->want_event              = want_event;
     _data->event                   = event;
-    int rc = pthread_create(&thread, NULL, asyncDataSend_thread, (void *)(_data));
-    if(rc){
-        // we can't work, disconnect the client
-        printf("ERROR: Thread creation has failed with the return code %d\n", rc); fflush(stdout);
-        shutdown(serverfd, 2);
-    }
+    launchDataSend(asyncDataSend_thread, _data, staging);
     return CL_SUCCESS;
 }
 
-/** Thread that receives data from client.
+/** Thread that receives data from client. The data is written in the
+ * device in chunks, as soon as they are received, so the next chunk is
+ * arriving meanwhile the current one is written.
  * @param data struct dataTransfer casted variable.
  * @return NULL
  */
 void *asyncDataRecv_thread(void *data)
 {
     struct dataSend* _data = (struct dataSend*)data;
-    // Provide a server for the data transfer
-    int fd = accept(_data->fd, (struct sockaddr*)NULL, NULL);
-    if(fd < 0){
-        // we can't work, disconnect the client
-        printf("ERROR: Can't listen on binded port.\n"); fflush(stdout);
-        shutdown(_data->fd, 2);
-        return CL_SUCCESS;
-    }
-    // We may wait manually for the events generated by ocland,
-    // and then we can wait for the OpenCL generated ones.
-    if(_data->num_events_in_wait_list){
-        oclandWaitForEvents(_data->num_events_in_wait_list, _data->event_wait_list);
+    struct channel_chunk_st *chunk;
+    // All the ocland events have an OpenCL one associated, so we
+    // can let OpenCL to resolve the dependencies.
+    cl_event transfer = NULL;
+    cl_event *wait_list = _data->event_wait_list;
+    // The dependencies are resolved before start consuming the chunks,
+    // so a consumed chunk is never blocked by them. Meanwhile the data
+    // channel keeps the chunks as they arrive (see channelReleaseChunk)
+    cl_int flag = CL_SUCCESS;
+    if(_data->num_events_in_wait_list)
+        flag = clWaitForEvents(_data->num_events_in_wait_list, wait_list);
+    // Write the chunks into the buffer, or just drop them if the
+    // dependencies have failed
+    while((chunk = channelNextChunk(_data->channel, _data->request_id))){
+        if(flag == CL_SUCCESS){
+            clEnqueueWriteBuffer(_data->command_queue,_data->mem,CL_FALSE,
+                                 _data->offset + chunk->offset,chunk->size,chunk->ptr,
+                                 0,NULL,&transfer);
+            // Wait until the data is copied before releasing the chunk
+            clWaitForEvents(1,&transfer);
+            clReleaseEvent(transfer); transfer = NULL;
+        }
+        channelReleaseChunk(_data->channel, _data->request_id, chunk); chunk = NULL;
     }
-    // Receive the data
-    Recv(&fd, _data->ptr, _data->cb, MSG_WAITALL);
-    // Writre it into the buffer
-    clEnqueueWriteBuffer(_data->command_queue,_data->mem,CL_FALSE,
-                        _data->offset,_data->cb,_data->ptr,
-                        0,NULL,&(_data->event->event));
-    // Wait until the data is copied before start cleaning up
-    clWaitForEvents(1,&(_data->event->event));
+    channelWait(_data->channel, _data->request_id);
     // Clean up
-    free(_data->ptr); _data->ptr = NULL;
-    if(_data->event){
-        _data->event->status = CL_COMPLETE;
-    }
-    if(_data->want_event != CL_TRUE){
-        free(_data->event); _data->event = NULL;
-    }
-    if(_data->event_wait_list) free(_data->event_wait_list); _data->event_wait_list=NULL;
-    // shutdown(fd, 2);
-    // shutdown(_data->fd, 2); // Destroy the server to free the port
-    close(fd);
-    close(_data->fd);
-    free(_data); _data=NULL;
-    pthread_exit(NULL);
+    freeDataSend(_data); _data=NULL;
     return NULL;
 }
 
@@ -380,7 +646,6 @@ cl_int oclandEnqueueWriteBuffer(int *                clientfd ,
                                 cl_mem               mem ,
                                 size_t               offset ,
                                 size_t               cb ,
-                                void *               ptr ,
                                 cl_uint              num_events_in_wait_list ,
                                 ocland_event *       event_wait_list ,
                                 cl_bool              want_event ,
@@ -399,49 +664,55 @@ cl_int oclandEnqueueWriteBuffer(int *                clientfd ,
     if(testReadable(mem) != CL_SUCCESS)
         return CL_INVALID_OPERATION;
     // Seems that data is correct, so we can proceed.
-    // We need to create a new connection socket in a
-    // new port in order to don't intercept the next
+    // The data will be received through the client data
+    // channel in order to don't intercept the next
     // packets exchanged with the client (for instance
     // to call new commands).
-    unsigned int port;
-    int serverfd = openPort(&port);
-    if(serverfd < 0)
-        return CL_OUT_OF_HOST_MEMORY;
+    struct dataSend* _data = newDataSend();
+    if(!_data)
+        return CL_OUT_OF_RESOURCES;
+    // The command will not be enqueued until the data transfer
+    // starts, so an user event is provided meanwhile.
+    flag = oclandInitUserEvent(event);
+    if(flag != CL_SUCCESS){
+        releaseChannel(_data->channel);
+        free(_data); _data = NULL;
+        return flag;
+    }
+    // The client will send the data as soon as it receives the
+    // answer, so we must be ready to receive it before answering.
+    flag = channelExpectStream(_data->channel, _data->request_id, cb);
+    if(flag != CL_SUCCESS){
+        oclandSetUserEventComplete(event);
+        clReleaseEvent(event->event);
+        releaseChannel(_data->channel);
+        free(_data); _data = NULL;
+        return CL_OUT_OF_RESOURCES;
+    }
     // Here in after we assume that the works gone fine,
     // returning CL_SUCCESS. Therefore we will package
-    // the flag, the event and the port to stablish the
-    // connection for the asynchronous data transfer.
+    // the flag and the event. The data will be tagged
+    // with the request identifier in the data channel.
     flag = CL_SUCCESS;
     msgSize  = sizeof(cl_int);          // flag
     msgSize += sizeof(ocland_event);    // event
-    msgSize += sizeof(unsigned int);    // port
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     mptr     = msg;
     ((cl_int*)mptr)[0]       = flag;  mptr = (cl_int*)mptr + 1;
-    ((ocland_event*)mptr)[0] = event; mptr = (ocland_event*)mptr + 1;
-    ((unsigned int*)mptr)[0] = port;
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(msg);msg=NULL;
-    // We are ready to trasfer the control to a parallel thread
-    pthread_t thread;
-    struct dataSend* _data = (struct dataSend*)malloc(sizeof(struct dataSend));
-    _data->fd                      = serverfd;
+    ((ocland_event*)mptr)[0] = event;
+    Reply(clientfd, msg, msgSize);
+    // We are ready to trasfer the control to a parallel thread. The
+    // data channel keeps the chunks received meanwhile the transfer
+    // waits for a worker
     _data->command_queue           = command_queue;
     _data->mem                     = mem;
     _data->offset                  = offset;
     _data->cb                      = cb;
-    _data->ptr                     = ptr;
     _data->num_events_in_wait_list = num_events_in_wait_list;
-    _data->event_wait_list         = event_wait_list;
+    _data->event_wait_list         = oclandGetEvents(num_events_in_wait_list, event_wait_list);
     _data->want_event              = want_event;
     _data->event                   = event;
-    int rc = pthread_create(&thread, NULL, asyncDataRecv_thread, (void *)(_data));
-    if(rc){
-        // we can't work, disconnect the client
-        printf("ERROR: Thread creation has failed with the return code %d\n", rc); fflush(stdout);
-        shutdown(serverfd, 2);
-    }
+    launchDataSend(asyncDataRecv_thread, _data, stagingSize(cb));
     return CL_SUCCESS;
 }
 
@@ -452,42 +723,21 @@ cl_int oclandEnqueueWriteBuffer(int *                clientfd ,
 void *asyncDataSendImage_thread(void *data)
 {
     struct dataSend* _data = (struct dataSend*)data;
-    // Provide a server for the data transfer
-    int fd = accept(_data->fd, (struct sockaddr*)NULL, NULL);
-    if(fd < 0){
-        // we can't work, disconnect the client
-        printf("ERROR: Can't listen on binded port.\n"); fflush(stdout);
-        shutdown(_data->fd, 2);
-        return CL_SUCCESS;
-    }
-    // We may wait manually for the events generated by ocland,
-    // and then we can wait for the OpenCL generated ones.
-    if(_data->num_events_in_wait_list){
-        oclandWaitForEvents(_data->num_events_in_wait_list, _data->event_wait_list);
-    }
+    // All the ocland events have an OpenCL one associated, so we
+    // can let OpenCL to resolve the dependencies.
+    cl_event transfer = NULL;
+    cl_event *wait_list = _data->event_wait_list;
     // Read the buffer
     clEnqueueReadImage(_data->command_queue,_data->mem,CL_FALSE,
                        _data->buffer_origin,_data->region,
                        _data->buffer_row_pitch,_data->buffer_slice_pitch,
-                       _data->ptr,0,NULL,&(_data->event->event));
+                       _data->ptr,_data->num_events_in_wait_list,wait_list,&transfer);
     // Return the data to the client
-    clWaitForEvents(1,&(_data->event->event));
-    Send(&fd, _data->ptr, _data->cb, 0);
+    clWaitForEvents(1,&transfer);
+    clReleaseEvent(transfer);
+    channelSend(_data->channel, _data->opcode, _data->request_id, _data->ptr, _data->cb);
     // Clean up
-    free(_data->ptr); _data->ptr = NULL;
-    if(_data->event){
-        _data->event->status = CL_COMPLETE;
-    }
-    if(_data->want_event != CL_TRUE){
-        free(_data->event); _data->event = NULL;
-    }
-    if(_data->event_wait_list) free(_data->event_wait_list); _data->event_wait_list=NULL;
-    // shutdown(fd, 2);
-    // shutdown(_data->fd, 2); // Destroy the server to free the port
-    close(fd);
-    close(_data->fd);
-    free(_data); _data=NULL;
-    pthread_exit(NULL);
+    freeDataSend(_data); _data=NULL;
     return NULL;
 }
 
@@ -520,49 +770,59 @@ cl_int oclandEnqueueReadImage(int *                clientfd ,
     if(testReadable(image) != CL_SUCCESS)
         return CL_INVALID_OPERATION;
     // Seems that data is correct, so we can proceed.
-    // We need to create a new connection socket in a
-    // new port in order to don't intercept the next
+    // The data will be sent through the client data
+    // channel in order to don't intercept the next
     // packets exchanged with the client (for instance
     // to call new commands).
-    unsigned int port;
-    int serverfd = openPort(&port);
-    if(serverfd < 0)
+    struct dataSend* _data = newDataSend();
+    if(!_data)
+        return CL_OUT_OF_RESOURCES;
+    _data->buffer_origin = (size_t*)malloc(3*sizeof(size_t));
+    _data->region        = (size_t*)malloc(3*sizeof(size_t));
+    if(!_data->buffer_origin || !_data->region){
+        free(_data->buffer_origin);
+        free(_data->region);
+        releaseChannel(_data->channel);
+        free(_data); _data = NULL;
         return CL_OUT_OF_HOST_MEMORY;
+    }
+    // The command will not be enqueued until the data transfer
+    // starts, so an user event is provided meanwhile.
+    flag = oclandInitUserEvent(event);
+    if(flag != CL_SUCCESS){
+        free(_data->buffer_origin);
+        free(_data->region);
+        releaseChannel(_data->channel);
+        free(_data); _data = NULL;
+        return flag;
+    }
     // Here in after we assume that the works gone fine,
     // returning CL_SUCCESS. Therefore we will package
-    // the flag, the event and the port to stablish the
-    // connection for the asynchronous data transfer.
+    // the flag and the event. The data will be tagged
+    // with the request identifier in the data channel.
     flag = CL_SUCCESS;
     msgSize  = sizeof(cl_int);          // flag
     msgSize += sizeof(ocland_event);    // event
-    msgSize += sizeof(unsigned int);    // port
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     mptr     = msg;
     ((cl_int*)mptr)[0]       = flag;  mptr = (cl_int*)mptr + 1;
-    ((ocland_event*)mptr)[0] = event; mptr = (ocland_event*)mptr + 1;
-    ((unsigned int*)mptr)[0] = port;
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(msg);msg=NULL;
+    ((ocland_event*)mptr)[0] = event;
+    Reply(clientfd, msg, msgSize);
     // We are ready to trasfer the control to a parallel thread
-    pthread_t thread;
-    struct dataSend* _data = (struct dataSend*)malloc(sizeof(struct dataSend));
-    _data->fd                      = serverfd;
     _data->command_queue           = command_queue;
     _data->mem                     = image;
     _data->offset                  = offset;
     _data->cb                      = cb;
+    memcpy(_data->buffer_origin, origin, 3*sizeof(size_t));
+    memcpy(_data->region, region, 3*sizeof(size_t));
+    _data->buffer_row_pitch        = row_pitch;
+    _data->buffer_slice_pitch      = slice_pitch;
     _data->ptr                     = ptr;
     _data->num_events_in_wait_list = num_events_in_wait_list;
-    _data->event_wait_list         = event_wait_list;
+    _data->event_wait_list         = oclandGetEvents(num_events_in_wait_list, event_wait_list);
     _data->want_event              = want_event;
     _data->event                   = event;
-    int rc = pthread_create(&thread, NULL, asyncDataSendImage_thread, (void *)(_data));
-    if(rc){
-        // we can't work, disconnect the client
-        printf("ERROR: Thread creation has failed with the return code %d\n", rc); fflush(stdout);
-        shutdown(serverfd, 2);
-    }
+    launchDataSend(asyncDataSendImage_thread, _data, _data->cb);
     return CL_SUCCESS;
 }
 
@@ -573,43 +833,23 @@ cl_int oclandEnqueueReadImage(int *                clientfd ,
 void *asyncDataRecvImage_thread(void *data)
 {
     struct dataSend* _data = (struct dataSend*)data;
-    // Provide a server for the data transfer
-    int fd = accept(_data->fd, (struct sockaddr*)NULL, NULL);
-    if(fd < 0){
-        // we can't work, disconnect the client
-        printf("ERROR: Can't listen on binded port.\n"); fflush(stdout);
-        shutdown(_data->fd, 2);
-        return CL_SUCCESS;
-    }
-    // We may wait manually for the events generated by ocland,
-    // and then we can wait for the OpenCL generated ones.
-    if(_data->num_events_in_wait_list){
-        oclandWaitForEvents(_data->num_events_in_wait_list, _data->event_wait_list);
+    // All the ocland events have an OpenCL one associated, so we
+    // can let OpenCL to resolve the dependencies.
+    cl_event transfer = NULL;
+    cl_event *wait_list = _data->event_wait_list;
+    // Wait for the data
+    if(channelWait(_data->channel, _data->request_id) == CL_SUCCESS){
+        // Writre it into the buffer
+        clEnqueueWriteImage(_data->command_queue,_data->mem,CL_FALSE,
+                            _data->buffer_origin,_data->region,
+                            _data->buffer_row_pitch,_data->buffer_slice_pitch,
+                            _data->ptr,_data->num_events_in_wait_list,wait_list,&transfer);
+        // Wait until the data is copied before start cleaning up
+        clWaitForEvents(1,&transfer);
+        clReleaseEvent(transfer);
     }
-    // Receive the data
-    Recv(&fd, _data->ptr, _data->cb, MSG_WAITALL);
-    // Writre it into the buffer
-    clEnqueueWriteImage(_data->command_queue,_data->mem,CL_FALSE,
-                        _data->buffer_origin,_data->region,
-                        _data->buffer_row_pitch,_data->buffer_slice_pitch,
-                        _data->ptr,0,NULL,&(_data->event->event));
-    // Wait until the data is copied before start cleaning up
-    clWaitForEvents(1,&(_data->event->event));
     // Clean up
-    free(_data->ptr); _data->ptr = NULL;
-    if(_data->event){
-        _data->event->status = CL_COMPLETE;
-    }
-    if(_data->want_event != CL_TRUE){
-        free(_data->event); _data->event = NULL;
-    }
-    if(_data->event_wait_list) free(_data->event_wait_list); _data->event_wait_list=NULL;
-    // shutdown(fd, 2);
-    // shutdown(_data->fd, 2); // Destroy the server to free the port
-    close(fd);
-    close(_data->fd);
-    free(_data); _data=NULL;
-    pthread_exit(NULL);
+    freeDataSend(_data); _data=NULL;
     return NULL;
 }
 
@@ -642,49 +882,71 @@ cl_int oclandEnqueueWriteImage(int *                clientfd ,
     if(testReadable(image) != CL_SUCCESS)
         return CL_INVALID_OPERATION;
     // Seems that data is correct, so we can proceed.
-    // We need to create a new connection socket in a
-    // new port in order to don't intercept the next
+    // The data will be received through the client data
+    // channel in order to don't intercept the next
     // packets exchanged with the client (for instance
     // to call new commands).
-    unsigned int port;
-    int serverfd = openPort(&port);
-    if(serverfd < 0)
+    struct dataSend* _data = newDataSend();
+    if(!_data)
+        return CL_OUT_OF_RESOURCES;
+    _data->buffer_origin = (size_t*)malloc(3*sizeof(size_t));
+    _data->region        = (size_t*)malloc(3*sizeof(size_t));
+    if(!_data->buffer_origin || !_data->region){
+        free(_data->buffer_origin);
+        free(_data->region);
+        releaseChannel(_data->channel);
+        free(_data); _data = NULL;
         return CL_OUT_OF_HOST_MEMORY;
+    }
+    // The command will not be enqueued until the data transfer
+    // starts, so an user event is provided meanwhile.
+    flag = oclandInitUserEvent(event);
+    if(flag != CL_SUCCESS){
+        free(_data->buffer_origin);
+        free(_data->region);
+        releaseChannel(_data->channel);
+        free(_data); _data = NULL;
+        return flag;
+    }
+    // The client will send the data as soon as it receives the
+    // answer, so we must be ready to receive it before answering.
+    flag = channelExpect(_data->channel, _data->request_id, ptr, cb);
+    if(flag != CL_SUCCESS){
+        oclandSetUserEventComplete(event);
+        clReleaseEvent(event->event);
+        free(_data->buffer_origin);
+        free(_data->region);
+        releaseChannel(_data->channel);
+        free(_data); _data = NULL;
+        return CL_OUT_OF_RESOURCES;
+    }
     // Here in after we assume that the works gone fine,
     // returning CL_SUCCESS. Therefore we will package
-    // the flag, the event and the port to stablish the
-    // connection for the asynchronous data transfer.
+    // the flag and the event. The data will be tagged
+    // with the request identifier in the data channel.
     flag = CL_SUCCESS;
     msgSize  = sizeof(cl_int);          // flag
     msgSize += sizeof(ocland_event);    // event
-    msgSize += sizeof(unsigned int);    // port
-    msg      = (void*)malloc(msgSize);
+    msg      = requestAlloc(msgSize);
     mptr     = msg;
     ((cl_int*)mptr)[0]       = flag;  mptr = (cl_int*)mptr + 1;
-    ((ocland_event*)mptr)[0] = event; mptr = (ocland_event*)mptr + 1;
-    ((unsigned int*)mptr)[0] = port;
-    Send(clientfd, &msgSize, sizeof(size_t), 0);
-    Send(clientfd, msg, msgSize, 0);
-    free(msg);msg=NULL;
+    ((ocland_event*)mptr)[0] = event;
+    Reply(clientfd, msg, msgSize);
     // We are ready to trasfer the control to a parallel thread
-    pthread_t thread;
-    struct dataSend* _data = (struct dataSend*)malloc(sizeof(struct dataSend));
-    _data->fd                      = serverfd;
     _data->command_queue           = command_queue;
     _data->mem                     = image;
     _data->offset                  = offset;
     _data->cb                      = cb;
+    memcpy(_data->buffer_origin, origin, 3*sizeof(size_t));
+    memcpy(_data->region, region, 3*sizeof(size_t));
+    _data->buffer_row_pitch        = row_pitch;
+    _data->buffer_slice_pitch      = slice_pitch;
     _data->ptr                     = ptr;
     _data->num_events_in_wait_list = num_events_in_wait_list;
-    _data->event_wait_list         = event_wait_list;
+    _data->event_wait_list         = oclandGetEvents(num_events_in_wait_list, event_wait_list);
     _data->want_event              = want_event;
     _data->event                   = event;
-    int rc = pthread_create(&thread, NULL, asyncDataRecvImage_thread, (void *)(_data));
-    if(rc){
-        // we can't work, disconnect the client
-        printf("ERROR: Thread creation has failed with the return code %d\n", rc); fflush(stdout);
-        shutdown(serverfd, 2);
-    }
+    launchDataSend(asyncDataRecvImage_thread, _data, _data->cb);
     return CL_SUCCESS;
 }
 
@@ -697,64 +959,25 @@ cl_int oclandEnqueueWriteImage(int *                clientfd ,
  */
 void *asyncDataSendRect_thread(void *data)
 {
-    unsigned int i,j,k,n;
-    size_t buffsize = BUFF_SIZE*sizeof(char);
     struct dataSend* _data = (struct dataSend*)data;
-    // We may wait manually for the events provided because
-    // OpenCL can only waits their events, but ocalnd event
-    // can be relevant. We will not check for errors,
-    // assuming than events can be wrong, but is to late to
-    // try to report a fail.
-    if(_data->num_events_in_wait_list){
-        oclandWaitForEvents(_data->num_events_in_wait_list, _data->event_wait_list);
-    }
+    // All the ocland events have an OpenCL one associated, so we
+    // can let OpenCL to resolve the dependencies.
+    cl_event transfer = NULL;
+    cl_event *wait_list = _data->event_wait_list;
     // Call to OpenCL
     size_t host_origin[3] = {0, 0, 0};
     clEnqueueReadBufferRect(_data->command_queue,_data->mem,CL_FALSE,
                             _data->buffer_origin,host_origin,_data->region,
                             _data->buffer_row_pitch,_data->buffer_slice_pitch,
                             _data->host_row_pitch,_data->host_slice_pitch,
-                            _data->ptr,0,NULL,&(_data->event->event));
-    // Start sending data to client
-    int *fd = &(_data->fd);
-    Send(fd, &buffsize, sizeof(size_t), 0);
-    // Compute the number of packages needed
-    n = _data->host_row_pitch / buffsize;
+                            _data->ptr,_data->num_events_in_wait_list,wait_list,&transfer);
     // Wait until data is copied here. We will not test
     // for errors, user can do it later
-    clWaitForEvents(1,&(_data->event->event));
+    clWaitForEvents(1,&transfer);
+    clReleaseEvent(transfer);
     // Send the rows
-    size_t origin = 0;
-    for(j=0;j<_data->region[1];j++){
-        for(k=0;k<_data->region[2];k++){
-            // Send package by pieces
-            for(i=0;i<n;i++){
-                Send(fd, _data->ptr + i*buffsize + origin, buffsize, 0);
-            }
-            if(_data->host_row_pitch % buffsize){
-                // Remains some data to arrive
-                Send(fd, _data->ptr + n*buffsize + origin, _data->host_row_pitch % buffsize, 0);
-            }
-            // Compute the new origin
-            origin += _data->host_row_pitch;
-        }
-    }
-    free(_data->buffer_origin); _data->buffer_origin = NULL;
-    free(_data->region); _data->region = NULL;
-    free(_data->ptr); _data->ptr = NULL;
-    if(_data->event){
-        _data->event->status = CL_COMPLETE;
-    }
-    if(_data->want_event != CL_TRUE){
-        free(_data->event); _data->event = NULL;
-    }
-    if(_data->event_wait_list) free(_data->event_wait_list); _data->event_wait_list=NULL;
-    // shutdown(fd, 2);
-    // shutdown(_data->fd, 2); // Destroy the server to free the port
-    close(fd);
-    close(_data->fd);
-    free(_data); _data=NULL;
-    pthread_exit(NULL);
+    channelSend(_data->channel, _data->opcode, _data->request_id, _data->ptr, _data->cb);
+    freeDataSend(_data); _data=NULL;
     return NULL;
 }
 
@@ -776,7 +999,7 @@ cl_int oclandEnqueueReadBufferRect(int *                clientfd ,
     cl_int flag;
     // Test that the objects command queue matchs
     if(testCommandQueue(command_queue,mem,num_events_in_wait_list,event_wait_list) != CL_SUCCESS)
-        return flag;
+        return CL_INVALID_CONTEXT;
     // Test if the size is not out of bounds
     size_t cb =   buffer_origin[0]
                 + buffer_origin[1]*buffer_row_pitch
@@ -785,51 +1008,39 @@ cl_int oclandEnqueueReadBufferRect(int *                clientfd ,
                 + region[1]*buffer_row_pitch
                 + region[2]*buffer_slice_pitch;
     if(testSize(mem, cb) != CL_SUCCESS)
-        return flag;
+        return CL_INVALID_VALUE;
     // Test if the memory can be accessed
     if(testReadable(mem) != CL_SUCCESS)
-        return flag;
+        return CL_INVALID_OPERATION;
     // Seems that data is correct, so we can proceed.
-    // We need to create a new connection socket in a
-    // new port in order to don't interfiere the next
+    // The data will be sent through the client data
+    // channel in order to don't interfiere the next
     // packets exchanged with the client (for instance
     // to call new commands).
-    unsigned int port;
-    int serverfd = openPort(&port);
-    if(serverfd < 0){
-        shutdown(*clientfd, 2);
-        *clientfd = -1;
-        return CL_OUT_OF_HOST_MEMORY;
+    struct dataSend* _data = newDataSend();
+    if(!_data)
+        return CL_OUT_OF_RESOURCES;
+    // The command will not be enqueued until the data transfer
+    // starts, so an user event is provided meanwhile.
+    flag = oclandInitUserEvent(event);
+    if(flag != CL_SUCCESS){
+        releaseChannel(_data->channel);
+        free(_data); _data = NULL;
+        return flag;
     }
     // Here in after we assume that the works gone fine,
-    // returning CL_SUCCESS. We need to do it in order to
-    // avoid sending the port before the flag.
+    // returning CL_SUCCESS.
     flag = CL_SUCCESS;
     Send(clientfd, &flag, sizeof(cl_int), 0);
     if(want_event == CL_TRUE){
         Send(clientfd, &event, sizeof(ocland_event), 0);
     }
-    // We have a new connection socket ready, reports it to
-    // the client and wait until he connects with us.
-    Send(clientfd, &port, sizeof(unsigned int), 0);
-    int fd = accept(serverfd, (struct sockaddr*)NULL, NULL);
-    if(fd < 0){
-        // we can't work, disconnect the client
-        printf("ERROR: Can't listen on port %u binded.\n", port); fflush(stdout);
-        shutdown(serverfd, 2);
-        shutdown(*clientfd, 2);
-        *clientfd = -1;
-        return CL_SUCCESS;
-    }
-    // Now we have a new socket connected to client, so
-    // hereinafter we rely the work to a new thread, that
-    // will call to clEnqueueReadBuffer and will send the
-    // data to the client.
-    pthread_t thread;
-    struct dataSend* _data = (struct dataSend*)malloc(sizeof(struct dataSend));
-    _data->fd                      = fd;
+    // Hereinafter we rely the work to a new thread, that
+    // will call to clEnqueueReadBufferRect and will send
+    // the data to the client.
     _data->command_queue           = command_queue;
     _data->mem                     = mem;
+    _data->cb                      = host_row_pitch*region[1]*region[2];
     _data->buffer_origin           = (size_t*)malloc(3*sizeof(size_t));
     _data->buffer_origin[0]        = buffer_origin[0];
     _data->buffer_origin[1]        = buffer_origin[1];
@@ -844,17 +1055,10 @@ cl_int oclandEnqueueReadBufferRect(int *                clientfd ,
     _data->host_slice_pitch        = host_slice_pitch;
     _data->ptr                     = ptr;
     _data->num_events_in_wait_list = num_events_in_wait_list;
-    _data->event_wait_list         = event_wait_list;
+    _data->event_wait_list         = oclandGetEvents(num_events_in_wait_list, event_wait_list);
     _data->want_event              = want_event;
     _data->event                   = event;
-    int rc = pthread_create(&thread, NULL, asyncDataSendRect_thread, (void *)(_data));
-    if(rc){
-        // we can't work, disconnect the client
-        printf("ERROR: Thread creation has failed with the return code %d\n", rc); fflush(stdout);
-        shutdown(serverfd, 2);
-        shutdown(*clientfd, 2);
-        *clientfd = -1;
-    }
+    launchDataSend(asyncDataSendRect_thread, _data, _data->cb);
     return CL_SUCCESS;
 }
 
@@ -864,64 +1068,26 @@ cl_int oclandEnqueueReadBufferRect(int *                clientfd ,
  */
 void *asyncDataRecvRect_thread(void *data)
 {
-    unsigned int i,j,k,n;
-    size_t buffsize = BUFF_SIZE*sizeof(char);
     struct dataSend* _data = (struct dataSend*)data;
     size_t host_origin[3] = {0, 0, 0};
-    // Receive the data
-    int *fd = &(_data->fd);
-    Send(fd, &buffsize, sizeof(size_t), 0);
-    // Compute the number of packages needed
-    n = _data->host_row_pitch / buffsize;
+    // All the ocland events have an OpenCL one associated, so we
+    // can let OpenCL to resolve the dependencies.
+    cl_event transfer = NULL;
+    cl_event *wait_list = _data->event_wait_list;
     // Receive the rows
-    size_t origin = 0;
-    for(j=0;j<_data->region[1];j++){
-        for(k=0;k<_data->region[2];k++){
-            // Receive package by pieces
-            for(i=0;i<n;i++){
-                Recv(fd, _data->ptr + i*buffsize + origin, buffsize, MSG_WAITALL);
-            }
-            if(_data->host_row_pitch % buffsize){
-                // Remains some data to arrive
-                Recv(fd, _data->ptr + n*buffsize + origin, _data->host_row_pitch % buffsize, MSG_WAITALL);
-            }
-            // Compute the new origin
-            origin += _data->host_row_pitch;
-        }
-    }
-    // We may wait manually for the events provided because
-    // OpenCL can only waits their events, but ocland event
-    // can be relevant. We will not check for errors,
-    // assuming than events can be wrong, but is to late to
-    // try to report a fail.
-    if(_data->num_events_in_wait_list){
-        oclandWaitForEvents(_data->num_events_in_wait_list, _data->event_wait_list);
-    }
-    // Call to OpenCL
-    clEnqueueWriteBufferRect(_data->command_queue,_data->mem,CL_FALSE,
-                             _data->buffer_origin,host_origin,_data->region,
-                             _data->buffer_row_pitch,_data->buffer_slice_pitch,
-                             _data->host_row_pitch,_data->host_slice_pitch,
-                             _data->ptr,0,NULL,&(_data->event->event));
-    // Wait until data is copied here. We will not test
-    // for errors, user can do it later
-    clWaitForEvents(1,&(_data->event->event));
-    free(_data->buffer_origin); _data->buffer_origin = NULL;
-    free(_data->region); _data->region = NULL;
-    free(_data->ptr); _data->ptr = NULL;
-    if(_data->event){
-        _data->event->status = CL_COMPLETE;
+    if(channelWait(_data->channel, _data->request_id) == CL_SUCCESS){
+        // Call to OpenCL
+        clEnqueueWriteBufferRect(_data->command_queue,_data->mem,CL_FALSE,
+                                 _data->buffer_origin,host_origin,_data->region,
+                                 _data->buffer_row_pitch,_data->buffer_slice_pitch,
+                                 _data->host_row_pitch,_data->host_slice_pitch,
+                                 _data->ptr,_data->num_events_in_wait_list,wait_list,&transfer);
+        // Wait until data is copied here. We will not test
+        // for errors, user can do it later
+        clWaitForEvents(1,&transfer);
+        clReleaseEvent(transfer);
     }
-    if(_data->want_event != CL_TRUE){
-        free(_data->event); _data->event = NULL;
-    }
-    if(_data->event_wait_list) free(_data->event_wait_list); _data->event_wait_list=NULL;
-    // shutdown(fd, 2);
-    // shutdown(_data->fd, 2); // Destroy the server to free the port
-    close(fd);
-    close(_data->fd);
-    free(_data); _data=NULL;
-    pthread_exit(NULL);
+    freeDataSend(_data); _data=NULL;
     return NULL;
 }
 
@@ -940,6 +1106,7 @@ cl_int oclandEnqueueWriteBufferRect(int *                clientfd ,
                                     cl_bool              want_event ,
                                     ocland_event         event)
 {
+    cl_int flag;
     // Test that the objects command queue matchs
     if(testCommandQueue(command_queue,mem,num_events_in_wait_list,event_wait_list) != CL_SUCCESS)
         return CL_INVALID_CONTEXT;
@@ -956,38 +1123,38 @@ cl_int oclandEnqueueWriteBufferRect(int *                clientfd ,
     if(testWriteable(mem) != CL_SUCCESS)
         return CL_INVALID_OPERATION;
     // Seems that data is correct, so we can proceed.
-    // We need to create a new connection socket in a
-    // new port in order to don't interfiere the next
+    // The data will be received through the client data
+    // channel in order to don't interfiere the next
     // packets exchanged with the client (for instance
     // to call new commands).
-    unsigned int port;
-    int serverfd = openPort(&port);
-    if(serverfd < 0){
-        shutdown(*clientfd, 2);
-        *clientfd = -1;
-        return CL_OUT_OF_HOST_MEMORY;
+    struct dataSend* _data = newDataSend();
+    if(!_data)
+        return CL_OUT_OF_RESOURCES;
+    // The command will not be enqueued until the data transfer
+    // starts, so an user event is provided meanwhile.
+    flag = oclandInitUserEvent(event);
+    if(flag != CL_SUCCESS){
+        releaseChannel(_data->channel);
+        free(_data); _data = NULL;
+        return flag;
     }
-    // We have a new connection socket ready, reports it to
-    // the client and wait until he connects with us.
-    Send(clientfd, &port, sizeof(unsigned int), 0);
-    int fd = accept(serverfd, (struct sockaddr*)NULL, NULL);
-    if(fd < 0){
-        // we can't work, disconnect the client
-        printf("ERROR: Can't listen on port %u binded.\n", port); fflush(stdout);
-        shutdown(serverfd, 2);
-        shutdown(*clientfd, 2);
-        *clientfd = -1;
-        return CL_OUT_OF_HOST_MEMORY;
+    // The client will send the data as soon as it receives the
+    // answer, so we must be ready to receive it before answering.
+    cb = host_row_pitch*region[1]*region[2];
+    flag = channelExpect(_data->channel, _data->request_id, ptr, cb);
+    if(flag != CL_SUCCESS){
+        oclandSetUserEventComplete(event);
+        clReleaseEvent(event->event);
+        releaseChannel(_data->channel);
+        free(_data); _data = NULL;
+        return CL_OUT_OF_RESOURCES;
     }
-    // Now we have a new socket connected to client, so
-    // hereinafter we rely the work to a new thread, that
-    // will call to clEnqueueReadBuffer and will send the
-    // data to the client.
-    pthread_t thread;
-    struct dataSend* _data = (struct dataSend*)malloc(sizeof(struct dataSend));
-    _data->fd                      = fd;
+    // Hereinafter we rely the work to a new thread, that
+    // will call to clEnqueueWriteBufferRect when the data
+    // has been received.
     _data->command_queue           = command_queue;
     _data->mem                     = mem;
+    _data->cb                      = cb;
     _data->buffer_origin           = (size_t*)malloc(3*sizeof(size_t));
     _data->buffer_origin[0]        = buffer_origin[0];
     _data->buffer_origin[1]        = buffer_origin[1];
@@ -1002,18 +1169,10 @@ cl_int oclandEnqueueWriteBufferRect(int *                clientfd ,
     _data->host_slice_pitch        = host_slice_pitch;
     _data->ptr                     = ptr;
     _data->num_events_in_wait_list = num_events_in_wait_list;
-    _data->event_wait_list         = event_wait_list;
+    _data->event_wait_list         = oclandGetEvents(num_events_in_wait_list, event_wait_list);
     _data->want_event              = want_event;
     _data->event                   = event;
-    int rc = pthread_create(&thread, NULL, asyncDataRecvRect_thread, (void *)(_data));
-    if(rc){
-        // we can't work, disconnect the client
-        printf("ERROR: Thread creation has failed with the return code %d\n", rc); fflush(stdout);
-        shutdown(serverfd, 2);
-        shutdown(*clientfd, 2);
-        *clientfd = -1;
-        return CL_OUT_OF_HOST_MEMORY;
-    }
+    launchDataSend(asyncDataRecvRect_thread, _data, _data->cb);
     return CL_SUCCESS;
 }
 #endif // CL_API_SUFFIX__VERSION_1_1
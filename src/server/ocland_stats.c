@@ -0,0 +1,219 @@
+/*
+ *  This file is part of ocland, a free cloud OpenCL interface.
+ *  Copyright (C) 2012  Jose Luis Cercos Pita <jl.cercos@upm.es>
+ *
+ *  ocland is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ocland is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ocland.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#include <ocland/server/ocland_stats.h>
+
+/** Add a value to a counter owned by the calling thread. The counters
+ * are read by other threads, so they are stored atomically, but no
+ * locked operation is required.
+ */
+#define STATS_ADD(counter, value) \
+    __atomic_store_n(&(counter), (counter) + (value), __ATOMIC_RELAXED)
+
+/** @struct stats_table_st Counters of the requests served by a worker
+ * thread. Each thread owns its counters, so they are updated without
+ * contention, and they are summed up when requested.
+ */
+struct stats_table_st{
+    /// Counters of each opcode
+    struct oclandOpcodeStats_st opcodes[OCLAND_STATS_OPCODES];
+    /// Next table
+    struct stats_table_st *next;
+};
+
+/// Counters of the calling thread
+static __thread struct stats_table_st *table = NULL;
+/// Request being timed by the calling thread
+static __thread struct request_stats_st *current = NULL;
+/// Counters of all the threads
+static struct stats_table_st *tables = NULL;
+/// Mutex protecting the list of counters
+static pthread_mutex_t tables_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/** Get the current time.
+ * @return Monotonic time, in nanoseconds.
+ */
+static uint64_t now()
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec * 1000000000ull + (uint64_t)t.tv_nsec;
+}
+
+/** Get the latency histogram bucket of a time.
+ * @param ns Time, in nanoseconds.
+ * @return Bucket index.
+ */
+static unsigned int latencyBucket(uint64_t ns)
+{
+    uint64_t us = ns / 1000u;
+    unsigned int i = us ? 64u - (unsigned int)__builtin_clzll(us) : 0u;
+    if(i >= OCLAND_LATENCY_BUCKETS)
+        i = OCLAND_LATENCY_BUCKETS - 1;
+    return i;
+}
+
+void statsBegin(struct request_stats_st *s, uint32_t opcode, size_t bytes_in)
+{
+    uint64_t t = now();
+    if(current)
+        current->time[current->phase] += t - current->since;
+    memset(s, 0, sizeof(struct request_stats_st));
+    s->opcode   = opcode;
+    s->phase    = OCLAND_PHASE_DECODE;
+    s->since    = t;
+    s->bytes_in = bytes_in;
+    s->parent   = current;
+    current     = s;
+}
+
+void statsPhase(unsigned int phase)
+{
+    struct request_stats_st *s = current;
+    if(!s || (s->phase == phase))
+        return;
+    uint64_t t = now();
+    s->time[s->phase] += t - s->since;
+    s->phase = phase;
+    s->since = t;
+}
+
+void statsReply(size_t bytes_out, cl_int flag)
+{
+    if(!current)
+        return;
+    current->bytes_out += bytes_out;
+    if(flag != CL_SUCCESS)
+        current->error = CL_TRUE;
+}
+
+void statsEnd(struct request_stats_st *s)
+{
+    unsigned int i;
+    uint64_t t = now();
+    s->time[s->phase] += t - s->since;
+    current = s->parent;
+    if(current)
+        current->since = t;
+    if(s->opcode >= OCLAND_STATS_OPCODES)
+        return;
+    if(!table){
+        table = (struct stats_table_st*)calloc(1, sizeof(struct stats_table_st));
+        if(!table)
+            return;
+        pthread_mutex_lock(&tables_mutex);
+        table->next = tables;
+        tables = table;
+        pthread_mutex_unlock(&tables_mutex);
+    }
+    struct oclandOpcodeStats_st *o = &(table->opcodes[s->opcode]);
+    STATS_ADD(o->calls, 1);
+    if(s->error)
+        STATS_ADD(o->errors, 1);
+    STATS_ADD(o->bytes_in, s->bytes_in);
+    STATS_ADD(o->bytes_out, s->bytes_out);
+    for(i=0;i<OCLAND_NUM_PHASES;i++){
+        STATS_ADD(o->time[i], s->time[i]);
+        STATS_ADD(o->latency[i][latencyBucket(s->time[i])], 1);
+    }
+}
+
+void getStats(struct oclandOpcodeStats_st *stats, unsigned int num_opcodes)
+{
+    unsigned int i, j, k;
+    struct stats_table_st *t;
+    memset(stats, 0, num_opcodes*sizeof(struct oclandOpcodeStats_st));
+    if(num_opcodes > OCLAND_STATS_OPCODES)
+        num_opcodes = OCLAND_STATS_OPCODES;
+    pthread_mutex_lock(&tables_mutex);
+    for(t=tables;t;t=t->next){
+        for(i=0;i<num_opcodes;i++){
+            struct oclandOpcodeStats_st *o = &(t->opcodes[i]);
+            stats[i].calls     += __atomic_load_n(&(o->calls), __ATOMIC_RELAXED);
+            stats[i].errors    += __atomic_load_n(&(o->errors), __ATOMIC_RELAXED);
+            stats[i].bytes_in  += __atomic_load_n(&(o->bytes_in), __ATOMIC_RELAXED);
+            stats[i].bytes_out += __atomic_load_n(&(o->bytes_out), __ATOMIC_RELAXED);
+            for(j=0;j<OCLAND_NUM_PHASES;j++){
+                stats[i].time[j] += __atomic_load_n(&(o->time[j]), __ATOMIC_RELAXED);
+                for(k=0;k<OCLAND_LATENCY_BUCKETS;k++)
+                    stats[i].latency[j][k] += __atomic_load_n(&(o->latency[j][k]), __ATOMIC_RELAXED);
+            }
+        }
+    }
+    pthread_mutex_unlock(&tables_mutex);
+}
+
+/** Get the latency which is not exceeded by a fraction of the requests,
+ * from its histogram.
+ * @param latency Latency histogram.
+ * @param calls Number of requests.
+ * @param fraction Fraction of the requests.
+ * @return Upper bound of the histogram bucket, in microseconds.
+ */
+static uint64_t latencyPercentile(const uint64_t *latency, uint64_t calls, double fraction)
+{
+    unsigned int i;
+    uint64_t count = 0;
+    for(i=0;i<OCLAND_LATENCY_BUCKETS - 1;i++){
+        count += latency[i];
+        if(count >= fraction * calls)
+            break;
+    }
+    return (uint64_t)1 << i;
+}
+
+void dumpStats(const char * const *names, unsigned int num_opcodes)
+{
+    unsigned int i, j;
+    const char *phases[OCLAND_NUM_PHASES] = {"decode", "validate", "call", "reply"};
+    struct oclandOpcodeStats_st *stats = (struct oclandOpcodeStats_st*)malloc(
+        num_opcodes*sizeof(struct oclandOpcodeStats_st));
+    if(!stats)
+        return;
+    getStats(stats, num_opcodes);
+    printf("Requests served (mean/p99 times in microseconds):\n");
+    printf("%-34s %10s %8s %12s %12s", "opcode", "calls", "errors", "bytes in", "bytes out");
+    for(j=0;j<OCLAND_NUM_PHASES;j++)
+        printf(" %18s", phases[j]);
+    printf("\n");
+    for(i=0;i<num_opcodes;i++){
+        struct oclandOpcodeStats_st *o = &(stats[i]);
+        if(!o->calls)
+            continue;
+        if(names && names[i])
+            printf("%-34s", names[i]);
+        else
+            printf("%-34u", i);
+        printf(" %10lu %8lu %12lu %12lu", (unsigned long)o->calls,
+               (unsigned long)o->errors, (unsigned long)o->bytes_in,
+               (unsigned long)o->bytes_out);
+        for(j=0;j<OCLAND_NUM_PHASES;j++){
+            printf(" %9.1f/%-8lu", o->time[j] / (1000.0 * o->calls),
+                   (unsigned long)latencyPercentile(o->latency[j], o->calls, 0.99));
+        }
+        printf("\n");
+    }
+    fflush(stdout);
+    free(stats);
+}